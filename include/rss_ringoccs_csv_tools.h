@@ -34,6 +34,20 @@
 #include <stddef.h>
 #include <stdio.h>
 
+/*  Methods for rssringoccs_CSV_Interp_Columns.                               */
+typedef enum {
+
+    /*  Straight lines between the points.                                    */
+    rssringoccs_Interp_Linear = 0,
+
+    /*  The natural cubic spline, with zero second derivative at the ends.    */
+    rssringoccs_Interp_Cubic = 1,
+
+    /*  Monotone cubic Hermite interpolation, as in PCHIP. This does not      *
+     *  overshoot the data, unlike the spline.                                */
+    rssringoccs_Interp_Monotone = 2
+} rssringoccs_Interp_Enum;
+
 /*  Data structure for the GEO.TAB files on the PDS.                          */
 typedef struct rssringoccs_GeoCSV_Def {
     double *t_oet_spm_vals;
@@ -111,6 +125,13 @@ typedef struct rssringoccs_TauCSV_Def {
     char *error_message;
 } rssringoccs_TauCSV;
 
+/*  The contents of a file, mapped or read into memory.                       */
+typedef struct rssringoccs_CSV_File_Def {
+    char *data;
+    size_t size;
+    tmpl_Bool is_mapped;
+} rssringoccs_CSV_File;
+
 /*  Data structure that contains all of the data from all four CSV formats    *
  *  interpolated so that the values are a function of radius, not time.       */
 typedef struct rssringoccs_CSVData_Def {
@@ -139,27 +160,183 @@ typedef struct rssringoccs_CSVData_Def {
     size_t n_elements;
     tmpl_Bool error_occurred;
     char *error_message;
+
+    /*  For data loaded from a cache file, the file the columns point into.   *
+     *  Its data pointer is NULL if the columns were allocated with malloc.   */
+    rssringoccs_CSV_File cache;
 } rssringoccs_CSVData;
 
+/*  Bits for the columns of rssringoccs_CSVData, in the order of the members, *
+ *  for rssringoccs_Extract_CSV_Data_Selected. The Fresnel transform, for     *
+ *  example, needs only RHO_KM, PHI_DEG, B_DEG, D_KM and F_SKY_HZ.            */
+#define RSSRINGOCCS_CSV_B_DEG (1UL << 0)
+#define RSSRINGOCCS_CSV_D_KM (1UL << 1)
+#define RSSRINGOCCS_CSV_F_SKY_HZ (1UL << 2)
+#define RSSRINGOCCS_CSV_P_NORM (1UL << 3)
+#define RSSRINGOCCS_CSV_RAW_TAU (1UL << 4)
+#define RSSRINGOCCS_CSV_PHASE_DEG (1UL << 5)
+#define RSSRINGOCCS_CSV_PHI_DEG (1UL << 6)
+#define RSSRINGOCCS_CSV_PHI_RL_DEG (1UL << 7)
+#define RSSRINGOCCS_CSV_RAW_TAU_THRESHOLD (1UL << 8)
+#define RSSRINGOCCS_CSV_RHO_CORR_POLE_KM (1UL << 9)
+#define RSSRINGOCCS_CSV_RHO_CORR_TIMING_KM (1UL << 10)
+#define RSSRINGOCCS_CSV_RHO_DOT_KMS (1UL << 11)
+#define RSSRINGOCCS_CSV_RHO_KM (1UL << 12)
+#define RSSRINGOCCS_CSV_RX_KM (1UL << 13)
+#define RSSRINGOCCS_CSV_RY_KM (1UL << 14)
+#define RSSRINGOCCS_CSV_RZ_KM (1UL << 15)
+#define RSSRINGOCCS_CSV_T_OET_SPM (1UL << 16)
+#define RSSRINGOCCS_CSV_T_RET_SPM (1UL << 17)
+#define RSSRINGOCCS_CSV_T_SET_SPM (1UL << 18)
+#define RSSRINGOCCS_CSV_TAU_PHASE (1UL << 19)
+#define RSSRINGOCCS_CSV_TAU_POWER (1UL << 20)
+#define RSSRINGOCCS_CSV_TAU_VALS (1UL << 21)
+#define RSSRINGOCCS_CSV_ALL_COLUMNS ((1UL << 22) - 1UL)
+
+/*  The numeric columns of a comma separated file. data[m][n] is the value in *
+ *  column m of row n. Bit m of columns is set if column m was read, and      *
+ *  data[m] is NULL otherwise.                                                */
+typedef struct rssringoccs_CSV_Columns_Def {
+    double **data;
+    size_t n_columns;
+    size_t n_rows;
+    unsigned long columns;
+    tmpl_Bool error_occurred;
+    char *error_message;
+} rssringoccs_CSV_Columns;
+
+/*  Reads every column of a comma separated file of numbers in one pass. The  *
+ *  number of columns is that of the first row, and every row must have the   *
+ *  same number. Blank lines are skipped.                                     */
+extern void
+rssringoccs_CSV_Read_Columns(rssringoccs_CSV_Columns *csv,
+                             const char *filename);
+
+/*  As rssringoccs_CSV_Read_Columns, for a file sorted by its first column in *
+ *  either direction, keeping only the rows whose first column is between     *
+ *  x_min and x_max. The rows to parse are found by a binary search over      *
+ *  blocks of the file, so most of a large file is never read. Rows in error  *
+ *  messages are counted from the first row parsed.                           */
+extern void
+rssringoccs_CSV_Read_Columns_Range(rssringoccs_CSV_Columns *csv,
+                                   const char *filename,
+                                   double x_min,
+                                   double x_max);
+
+/*  Reads the columns of a comma separated file whose bit is set in columns,  *
+ *  and with range non-NULL, only the rows whose first column is between      *
+ *  range[0] and range[1], as rssringoccs_CSV_Read_Columns_Range does. The    *
+ *  other columns are neither allocated nor parsed. Columns past the bits of  *
+ *  an unsigned long are always read, and with a range so is the first.       */
+extern void
+rssringoccs_CSV_Read_Selected(rssringoccs_CSV_Columns *csv,
+                              const char *filename,
+                              const double *range,
+                              unsigned long columns);
+
+/*  Parses a number from str, reading no further than end. Leading blanks are *
+ *  skipped. Returns a pointer past the last character used, and str, with    *
+ *  *val set to zero, if there is no number.                                  */
+extern const char *
+rssringoccs_CSV_Parse_Double(const char *str, const char *end, double *val);
+
+/*  Interpolates the n_columns columns y[k], sampled at the n_pts points x,   *
+ *  which must be increasing, onto the n_out points x_out, writing y_out[k].  *
+ *  The interval and weights of each output point are found once and used     *
+ *  for every column. x_out may be in any order, but is fastest when sorted,  *
+ *  in either direction. Points outside of x take the value at the nearest    *
+ *  end. Returns false if n_pts is zero or memory could not be allocated.     */
+extern tmpl_Bool
+rssringoccs_CSV_Interp_Columns(const double *x,
+                               const double * const *y,
+                               size_t n_pts,
+                               const double *x_out,
+                               double * const *y_out,
+                               size_t n_out,
+                               size_t n_columns,
+                               rssringoccs_Interp_Enum method);
+
+extern void
+rssringoccs_Destroy_CSV_Columns_Members(rssringoccs_CSV_Columns *csv);
+
+/*  Maps filename into memory, privately, or reads it whole if mmap is not    *
+ *  available. An empty file gives a NULL data pointer. Returns false if the  *
+ *  file can not be read.                                                     */
+extern tmpl_Bool
+rssringoccs_CSV_File_Open(rssringoccs_CSV_File *file, const char *filename);
+
+extern void rssringoccs_CSV_File_Close(rssringoccs_CSV_File *file);
+
 extern rssringoccs_GeoCSV *
 rssringoccs_Get_Geo(const char *filename, tmpl_Bool use_deprecated);
 
+/*  As rssringoccs_Get_Geo, reading only the columns whose bits are set in    *
+ *  columns. Bit m is for the m-th member of rssringoccs_GeoCSV, which is     *
+ *  column m of the file. The other members are NULL.                         */
+extern rssringoccs_GeoCSV *
+rssringoccs_Get_Geo_Selected(const char *filename,
+                             tmpl_Bool use_deprecated,
+                             unsigned long columns);
+
 extern void rssringoccs_Destroy_GeoCSV_Members(rssringoccs_GeoCSV *geo);
 extern void rssringoccs_Destroy_GeoCSV(rssringoccs_GeoCSV **geo);
 
 extern rssringoccs_DLPCSV *
 rssringoccs_Get_DLP(const char *filename, tmpl_Bool use_deprecated);
 
+/*  As rssringoccs_Get_DLP, keeping only the rows with rho_km_vals between    *
+ *  rho_min and rho_max.                                                      */
+extern rssringoccs_DLPCSV *
+rssringoccs_Get_DLP_Range(const char *filename,
+                          tmpl_Bool use_deprecated,
+                          double rho_min,
+                          double rho_max);
+
+/*  As rssringoccs_Get_DLP, reading only the columns whose bits are set in    *
+ *  columns, and with range non-NULL, only the rows with rho_km_vals between  *
+ *  range[0] and range[1]. Bit m is for the m-th member of rssringoccs_DLPCSV *
+ *  which is column m of the current format. The other members are NULL.      */
+extern rssringoccs_DLPCSV *
+rssringoccs_Get_DLP_Selected(const char *filename,
+                             tmpl_Bool use_deprecated,
+                             const double *range,
+                             unsigned long columns);
+
 extern void rssringoccs_Destroy_DLPCSV_Members(rssringoccs_DLPCSV *dlp);
 extern void rssringoccs_Destroy_DLPCSV(rssringoccs_DLPCSV **dlp);
 
 extern rssringoccs_CalCSV *rssringoccs_Get_Cal(const char *filename);
+
+/*  As rssringoccs_Get_Cal, reading only the columns whose bits are set in    *
+ *  columns. Bit m is for the m-th member of rssringoccs_CalCSV, which is     *
+ *  column m of the file. The other members are NULL.                         */
+extern rssringoccs_CalCSV *
+rssringoccs_Get_Cal_Selected(const char *filename, unsigned long columns);
+
 extern void rssringoccs_Destroy_CalCSV_Members(rssringoccs_CalCSV *cal);
 extern void rssringoccs_Destroy_CalCSV(rssringoccs_CalCSV **cal);
 
 extern rssringoccs_TauCSV *
 rssringoccs_Get_Tau(const char *filename, tmpl_Bool use_deprecated);
 
+/*  As rssringoccs_Get_Tau, keeping only the rows with rho_km_vals between    *
+ *  rho_min and rho_max.                                                      */
+extern rssringoccs_TauCSV *
+rssringoccs_Get_Tau_Range(const char *filename,
+                          tmpl_Bool use_deprecated,
+                          double rho_min,
+                          double rho_max);
+
+/*  As rssringoccs_Get_Tau, reading only the columns whose bits are set in    *
+ *  columns, and with range non-NULL, only the rows with rho_km_vals between  *
+ *  range[0] and range[1]. Bit m is for the m-th member of rssringoccs_TauCSV *
+ *  which is column m of the current format. The other members are NULL.      */
+extern rssringoccs_TauCSV *
+rssringoccs_Get_Tau_Selected(const char *filename,
+                             tmpl_Bool use_deprecated,
+                             const double *range,
+                             unsigned long columns);
+
 extern void rssringoccs_Destroy_TauCSV_Members(rssringoccs_TauCSV *dlp);
 extern void rssringoccs_Destroy_TauCSV(rssringoccs_TauCSV **dlp);
 
@@ -170,6 +347,56 @@ rssringoccs_Extract_CSV_Data(const char *geo,
                              const char *tau,
                              tmpl_Bool use_deprecated);
 
+/*  As rssringoccs_Extract_CSV_Data, for the radii from rho_min to rho_max    *
+ *  only. Rows of the DLP and TAU files within halo of this range are kept as *
+ *  well, so halo should be at least half of the widest window that will be   *
+ *  used, and only those rows are parsed. The GEO and CAL files are sorted by *
+ *  time, not radius, and are small, and are read whole.                      */
+extern rssringoccs_CSVData *
+rssringoccs_Extract_CSV_Data_Range(const char *geo,
+                                   const char *cal,
+                                   const char *dlp,
+                                   const char *tau,
+                                   tmpl_Bool use_deprecated,
+                                   double rho_min,
+                                   double rho_max,
+                                   double halo);
+
+/*  As rssringoccs_Extract_CSV_Data, computing only the columns whose         *
+ *  RSSRINGOCCS_CSV_ bits are set in columns. The other members are NULL.     *
+ *  Columns of the input files that none of these depend on are not parsed,   *
+ *  and the GEO, CAL, and TAU files are not read at all if none of their      *
+ *  columns are needed. rho_km_vals is always computed. With range non-NULL,  *
+ *  only the DLP and TAU rows with radii between range[0] and range[1] are    *
+ *  read, as in rssringoccs_Extract_CSV_Data_Range with no halo.              */
+extern rssringoccs_CSVData *
+rssringoccs_Extract_CSV_Data_Selected(const char *geo,
+                                      const char *cal,
+                                      const char *dlp,
+                                      const char *tau,
+                                      tmpl_Bool use_deprecated,
+                                      const double *range,
+                                      unsigned long columns);
+
+/*  As rssringoccs_Extract_CSV_Data, keeping the result in the binary file    *
+ *  cache. If cache holds the data for the same inputs, whose sizes and       *
+ *  modification times, or failing that checksums, match, the columns are     *
+ *  mapped from it without parsing. Otherwise the files are parsed and cache  *
+ *  is written. Failing to write cache is not an error. A NULL cache is the   *
+ *  same as rssringoccs_Extract_CSV_Data.                                     */
+extern rssringoccs_CSVData *
+rssringoccs_Extract_CSV_Data_Cached(const char *geo,
+                                    const char *cal,
+                                    const char *dlp,
+                                    const char *tau,
+                                    tmpl_Bool use_deprecated,
+                                    const char *cache);
+
+/*  Copies columns mapped from a cache file into memory allocated with        *
+ *  malloc, so that they may be freed one at a time, and closes the cache.    *
+ *  Does nothing for columns that are already allocated.                      */
+extern void rssringoccs_Own_CSV_Members(rssringoccs_CSVData *csv);
+
 extern void rssringoccs_Destroy_CSV_Members(rssringoccs_CSVData *csv);
 
 extern void rssringoccs_Destroy_CSV(rssringoccs_CSVData **csv);
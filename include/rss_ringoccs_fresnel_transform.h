@@ -79,29 +79,225 @@ rssringoccs_Fresnel_Transform_Legendre_Odd_Norm(rssringoccs_TAUObj *tau,
                                                 size_t n_pts,
                                                 size_t center);
 
+/*  The Legendre phases are computed in blocks of this many samples.          */
+#define RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK (256U)
+
+/*  Computes the phases of the Legendre transforms for n_pts samples of       *
+ *  x_arr (at most RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK), using the same Horner *
+ *  scheme as the Even and Odd transforms. psi_left is used to the left of    *
+ *  the center, and psi_right to the right.                                   */
+extern void
+rssringoccs_Fresnel_Transform_Legendre_Psi(const rssringoccs_TAUObj *tau,
+                                           const double *x_arr,
+                                           const double *coeffs,
+                                           size_t n_pts,
+                                           size_t center,
+                                           tmpl_Bool is_even,
+                                           double *psi_left,
+                                           double *psi_right);
+
+/*  Vectorized versions of the quadratic and Legendre transforms. These have  *
+ *  the same arguments and results (up to round-off) as the above, and are    *
+ *  used by the reconstruction if tau->use_simd is set.                       */
+extern void
+rssringoccs_Fresnel_Transform_SIMD(rssringoccs_TAUObj *tau,
+                                   const double *x_arr,
+                                   const double *w_func,
+                                   size_t n_pts,
+                                   size_t center);
+
+extern void
+rssringoccs_Fresnel_Transform_Norm_SIMD(rssringoccs_TAUObj *tau,
+                                        const double *x_arr,
+                                        const double *w_func,
+                                        size_t n_pts,
+                                        size_t center);
+
+extern void
+rssringoccs_Fresnel_Transform_Legendre_Even_SIMD(rssringoccs_TAUObj *tau,
+                                                 const double *x_arr,
+                                                 const double *w_func,
+                                                 const double *coeffs,
+                                                 size_t n_pts,
+                                                 size_t center);
+
+extern void
+rssringoccs_Fresnel_Transform_Legendre_Even_Norm_SIMD(rssringoccs_TAUObj *tau,
+                                                      const double *x_arr,
+                                                      const double *w_func,
+                                                      const double *coeffs,
+                                                      size_t n_pts,
+                                                      size_t center);
+
+extern void
+rssringoccs_Fresnel_Transform_Legendre_Odd_SIMD(rssringoccs_TAUObj *tau,
+                                                const double *x_arr,
+                                                const double *w_func,
+                                                const double *coeffs,
+                                                size_t n_pts,
+                                                size_t center);
+
+extern void
+rssringoccs_Fresnel_Transform_Legendre_Odd_Norm_SIMD(rssringoccs_TAUObj *tau,
+                                                     const double *x_arr,
+                                                     const double *w_func,
+                                                     const double *coeffs,
+                                                     size_t n_pts,
+                                                     size_t center);
+
+/*  The Newton transforms solve for the stationary azimuth angles in blocks   *
+ *  of this many samples.                                                     */
+#define RSSRINGOCCS_FRESNEL_NEWTON_BLOCK (256U)
+
+/*  Batched versions of tmpl_Double_Stationary_Cyl_Fresnel_Psi_Newton and     *
+ *  tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton. phi holds the initial    *
+ *  guesses on entry and the stationary angles on exit, and psi is set to the *
+ *  Fresnel kernel at these angles. If use_simd is set, AVX2 or AVX-512 is    *
+ *  used when the CPU has it, with every lane iterating until it converges.   *
+ *  warm_start says the guesses come from a nearby center, which lets tiny    *
+ *  steps end the iteration early. The number of Newton steps taken is added  *
+ *  to *n_iter, if not NULL, except those taken by the libtmpl routines.      */
+extern void
+rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch(double k,
+                                                    double r,
+                                                    const double *r0,
+                                                    const double *phi0,
+                                                    double B,
+                                                    double D,
+                                                    double EPS,
+                                                    unsigned int toler,
+                                                    tmpl_Bool use_simd,
+                                                    tmpl_Bool warm_start,
+                                                    size_t n_pts,
+                                                    double *phi,
+                                                    double *psi,
+                                                    unsigned long *n_iter);
+
+extern void
+rssringoccs_Stationary_Cyl_Fresnel_Psi_D_Newton_Batch(double k,
+                                                      double r,
+                                                      const double *r0,
+                                                      const double *phi0,
+                                                      double B,
+                                                      double rx,
+                                                      double ry,
+                                                      double rz,
+                                                      double EPS,
+                                                      unsigned int toler,
+                                                      tmpl_Bool use_simd,
+                                                      tmpl_Bool warm_start,
+                                                      size_t n_pts,
+                                                      double *phi,
+                                                      double *psi,
+                                                      unsigned long *n_iter);
+
+/*  Per-thread state of the Newton transforms that use the batched solver.    *
+ *  If tau->use_warm_start is set, the stationary angles found for the        *
+ *  window about one center are kept in a ring buffer, indexed by sample,     *
+ *  and used as the initial guesses for the same samples about the next       *
+ *  center. The counters are updated whether or not warm starts are on.      */
+typedef struct rssringoccs_Newton_Warm_Start_Def {
+
+    /*  phi[j % capacity] is the last stationary angle for sample j, for      *
+     *  lo <= j < hi.                                                         */
+    double *phi;
+    size_t capacity;
+    size_t lo, hi;
+
+    /*  Newton steps taken, samples solved, and samples started warm.         */
+    unsigned long n_iterations;
+    unsigned long n_samples;
+    unsigned long n_warm;
+
+    /*  Scratch space for the adaptive transform, work_capacity samples.      */
+    double *work;
+    size_t *nodes;
+    unsigned char *done;
+    size_t work_capacity;
+} rssringoccs_Newton_Warm_Start;
+
+/*  Sets the buffer to NULL and the counters to zero.                         */
+extern void
+rssringoccs_Newton_Warm_Start_Init(rssringoccs_Newton_Warm_Start *warm);
+
+/*  Frees the ring buffer. The counters are left as is.                       */
+extern void
+rssringoccs_Newton_Warm_Start_Destroy(rssringoccs_Newton_Warm_Start *warm);
+
+/*  Called before solving the window of n_pts samples starting at offset.     *
+ *  Grows the ring buffer if needed. If malloc fails, warm starts are skipped *
+ *  and the transform proceeds with the usual initial guesses.                */
+extern void
+rssringoccs_Newton_Warm_Start_Begin(const rssringoccs_TAUObj *tau,
+                                    rssringoccs_Newton_Warm_Start *warm,
+                                    size_t offset,
+                                    size_t n_pts);
+
+/*  Initial guesses for samples offset through offset + n_pts - 1. These are  *
+ *  the stored angles where available, and phi_deg_vals elsewhere.            */
+extern void
+rssringoccs_Newton_Warm_Start_Guess(const rssringoccs_TAUObj *tau,
+                                    rssringoccs_Newton_Warm_Start *warm,
+                                    size_t offset,
+                                    size_t n_pts,
+                                    double *phi);
+
+/*  Stores the stationary angles of samples offset to offset + n_pts - 1.     */
+extern void
+rssringoccs_Newton_Warm_Start_Store(const rssringoccs_TAUObj *tau,
+                                    rssringoccs_Newton_Warm_Start *warm,
+                                    size_t offset,
+                                    size_t n_pts,
+                                    const double *phi);
+
+/*  Called once the whole window has been solved. The stored angles become    *
+ *  the guesses for the next window.                                          */
+extern void
+rssringoccs_Newton_Warm_Start_End(const rssringoccs_TAUObj *tau,
+                                  rssringoccs_Newton_Warm_Start *warm,
+                                  size_t offset,
+                                  size_t n_pts);
+
+/*  Makes room for a window of n_pts samples in the scratch space used by     *
+ *  the adaptive transform. Returns false if warm is NULL or malloc fails.    */
+extern tmpl_Bool
+rssringoccs_Newton_Warm_Start_Reserve(rssringoccs_Newton_Warm_Start *warm,
+                                      size_t n_pts);
+
+/*  Transforms that use the batched solver. warm may be NULL.                 */
+typedef void
+(*rssringoccs_Newton_FresT)(rssringoccs_TAUObj *, const double *, size_t,
+                            size_t, rssringoccs_Newton_Warm_Start *);
+
 extern void
 rssringoccs_Fresnel_Transform_Newton(rssringoccs_TAUObj *tau,
                                      const double *w_func,
                                      size_t n_pts,
-                                     size_t center);
+                                     size_t center,
+                                     rssringoccs_Newton_Warm_Start *warm);
 
 extern void
 rssringoccs_Fresnel_Transform_Newton_Norm(rssringoccs_TAUObj *tau,
                                           const double *w_func,
                                           size_t n_pts,
-                                          size_t center);
+                                          size_t center,
+                                          rssringoccs_Newton_Warm_Start *warm);
 
 extern void
 rssringoccs_Fresnel_Transform_Newton_D(rssringoccs_TAUObj *tau,
                                        const double *w_func,
                                        size_t n_pts,
-                                       size_t center);
+                                       size_t center,
+                                       rssringoccs_Newton_Warm_Start *warm);
 
 extern void
-rssringoccs_Fresnel_Transform_Newton_D_Norm(rssringoccs_TAUObj *tau,
-                                            const double *w_func,
-                                            size_t n_pts,
-                                            size_t center);
+rssringoccs_Fresnel_Transform_Newton_D_Norm(
+    rssringoccs_TAUObj *tau,
+    const double *w_func,
+    size_t n_pts,
+    size_t center,
+    rssringoccs_Newton_Warm_Start *warm
+);
 
 extern void
 rssringoccs_Fresnel_Transform_Newton_D_Old(rssringoccs_TAUObj *tau,
@@ -128,16 +324,138 @@ rssringoccs_Fresnel_Transform_Newton_dD_dphi_Norm(rssringoccs_TAUObj *tau,
                                                   size_t center);
 
 extern void
-rssringoccs_Fresnel_Transform_Perturbed_Newton(rssringoccs_TAUObj *tau,
-                                               const double *w_func,
-                                               size_t n_pts,
-                                               size_t center);
+rssringoccs_Fresnel_Transform_Perturbed_Newton(
+    rssringoccs_TAUObj *tau,
+    const double *w_func,
+    size_t n_pts,
+    size_t center,
+    rssringoccs_Newton_Warm_Start *warm
+);
 
 extern void
-rssringoccs_Fresnel_Transform_Perturbed_Newton_Norm(rssringoccs_TAUObj *tau,
-                                                    const double *w_func,
-                                                    size_t n_pts,
-                                                    size_t center);
+rssringoccs_Fresnel_Transform_Perturbed_Newton_Norm(
+    rssringoccs_TAUObj *tau,
+    const double *w_func,
+    size_t n_pts,
+    size_t center,
+    rssringoccs_Newton_Warm_Start *warm
+);
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Newton_Adaptive_Psi                                       *
+ *  Purpose:                                                                  *
+ *      Computes the stationary Fresnel kernel for every sample in the window *
+ *      about center, solving for it on a coarse grid and interpolating in    *
+ *      between. Intervals of the grid are bisected until the interpolation   *
+ *      error at their midpoints is below tau->interp_tol.                    *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object with the geometry.                                 *
+ *      warm (rssringoccs_Newton_Warm_Start *):                               *
+ *          Scratch space and counters for the calling thread.                *
+ *      center (size_t):                                                      *
+ *          The index of the point being reconstructed.                       *
+ *      n_pts (size_t):                                                       *
+ *          The number of points in the window.                               *
+ *  Outputs:                                                                  *
+ *      psi (const double *):                                                 *
+ *          The kernel at the n_pts samples, stored in warm. NULL if warm is  *
+ *          NULL or malloc fails.                                             *
+ ******************************************************************************/
+extern const double *
+rssringoccs_Newton_Adaptive_Psi(rssringoccs_TAUObj *tau,
+                                rssringoccs_Newton_Warm_Start *warm,
+                                size_t center,
+                                size_t n_pts);
+
+/*  Newton's method on an adaptively refined grid, with cubic Hermite         *
+ *  interpolation in between. Falls back to the Newton transforms if the      *
+ *  scratch space could not be allocated.                                     */
+extern void
+rssringoccs_Fresnel_Transform_Newton_Adaptive(
+    rssringoccs_TAUObj *tau,
+    const double *w_func,
+    size_t n_pts,
+    size_t center,
+    rssringoccs_Newton_Warm_Start *warm
+);
+
+extern void
+rssringoccs_Fresnel_Transform_Newton_Adaptive_Norm(
+    rssringoccs_TAUObj *tau,
+    const double *w_func,
+    size_t n_pts,
+    size_t center,
+    rssringoccs_Newton_Warm_Start *warm
+);
+
+/*  The largest number of nodes on each side of the center used by the        *
+ *  interpolated Newton transforms. The octic psitypes use all four.          */
+#define RSSRINGOCCS_NEWTON_INTERP_MAX_NODES (4U)
+
+/*  The stationary Fresnel kernel across a window, as a polynomial of degree  *
+ *  2 n_nodes in x = rho - rho0. even and odd hold the divided differences of *
+ *  the even and odd parts of psi, divided by x^2 and x, at the nodes u = x^2.*/
+typedef struct rssringoccs_Newton_Interp_Def {
+    unsigned int n_nodes;
+    double u[RSSRINGOCCS_NEWTON_INTERP_MAX_NODES];
+    double even[RSSRINGOCCS_NEWTON_INTERP_MAX_NODES];
+    double odd[RSSRINGOCCS_NEWTON_INTERP_MAX_NODES];
+} rssringoccs_Newton_Interp;
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Newton_Interp_Init                                        *
+ *  Purpose:                                                                  *
+ *      Solves for the stationary Fresnel kernel at symmetric nodes of the    *
+ *      window about center and computes the interpolating polynomial. The    *
+ *      family of Newton-Raphson method and the order are set by tau->psinum, *
+ *      which must be one of the quadratic, quartic, sextic, or octic values. *
+ *  Arguments:                                                                *
+ *      tau (const rssringoccs_TAUObj *):                                     *
+ *          The Tau object with the geometry.                                 *
+ *      center (size_t):                                                      *
+ *          The index of the point being reconstructed.                       *
+ *      n_pts (size_t):                                                       *
+ *          The number of points in the window.                               *
+ *      interp (rssringoccs_Newton_Interp *):                                 *
+ *          The polynomial, output.                                           *
+ *  Outputs:                                                                  *
+ *      None (void).                                                          *
+ ******************************************************************************/
+extern void
+rssringoccs_Newton_Interp_Init(const rssringoccs_TAUObj *tau,
+                               size_t center,
+                               size_t n_pts,
+                               rssringoccs_Newton_Interp *interp);
+
+/*  The stationary Fresnel kernel at sample j about center, computed as the   *
+ *  non-interpolated transform of the family of tau->psinum computes it. It   *
+ *  does not depend on the window, so it may be shared between windows.      */
+extern double
+rssringoccs_Newton_Interp_Psi(const rssringoccs_TAUObj *tau,
+                              size_t center,
+                              size_t j);
+
+/*  Evaluates the polynomial from rssringoccs_Newton_Interp_Init at x.        */
+extern double
+rssringoccs_Newton_Interp_Eval(const rssringoccs_Newton_Interp *interp,
+                               double x);
+
+/*  Fresnel transforms with the kernel from rssringoccs_Newton_Interp. These  *
+ *  handle every interpolated psitype of every Newton-Raphson method.         */
+extern void
+rssringoccs_Fresnel_Transform_Newton_Interp(rssringoccs_TAUObj *tau,
+                                            const double *w_func,
+                                            size_t n_pts,
+                                            size_t center);
+
+extern void
+rssringoccs_Fresnel_Transform_Newton_Interp_Norm(rssringoccs_TAUObj *tau,
+                                                 const double *w_func,
+                                                 size_t n_pts,
+                                                 size_t center);
 
 /******************************************************************************
  *  Function:                                                                 *
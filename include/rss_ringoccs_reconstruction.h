@@ -19,6 +19,94 @@ typedef void
 
 extern void rssringoccs_Reconstruction(rssringoccs_TAUObj *tau);
 
+/*  Runs the method selected by tau->psinum, writing to tau->T_out. The       *
+ *  Fresnel methods compute the points start to start + n_used inclusive,     *
+ *  the others the points start to start + n_used - 1. No checks are made.    */
+extern void rssringoccs_Reconstruction_Dispatch(rssringoccs_TAUObj *tau);
+
+/*  Reconstructs the data for every pair (res[i], wtypes[j]), sharing the     *
+ *  Fresnel kernel between them. Returns n_res * n_wtypes rows of n_used      *
+ *  points, row i * n_wtypes + j for (res[i], wtypes[j]), and sets tau->start *
+ *  and tau->n_used to the points they cover. NULL is returned on error. Only *
+ *  fresnel and the non-interpolated Newton psitypes are supported.           */
+extern tmpl_ComplexDouble *
+rssringoccs_Reconstruction_Batch(rssringoccs_TAUObj *tau,
+                                 const double *res,
+                                 size_t n_res,
+                                 const char * const *wtypes,
+                                 size_t n_wtypes);
+
+/*  Reconstructs several bands of one occultation, solving for the stationary *
+ *  azimuth angles once when they share a Newton psitype and their geometry   *
+ *  agrees to within RSSRINGOCCS_MULTI_BAND_TOLERANCE (relative). Otherwise   *
+ *  each band is passed to rssringoccs_Reconstruction.                        */
+extern void
+rssringoccs_Reconstruction_Multi_Band(rssringoccs_TAUObj **taus,
+                                      size_t n_bands);
+
+#define RSSRINGOCCS_MULTI_BAND_TOLERANCE (1.0E-10)
+
+/*  Runs the inverse transform and the forward model together, solving for    *
+ *  each kernel once. Returns false, doing nothing, if the psitype is not     *
+ *  fresnel or a Newton method handled by rssringoccs_Newton_Interp, or if a  *
+ *  task would need more than RSSRINGOCCS_FUSED_MAX_BYTES of kernels.         *
+ *  rssringoccs_Reconstruction only calls this if tau->use_fused is set.      */
+extern tmpl_Bool
+rssringoccs_Reconstruction_Fused(rssringoccs_TAUObj *tau, size_t nw_pts);
+
+/*  Upper bound on the kernels a task of rssringoccs_Reconstruction_Fused     *
+ *  keeps, in bytes. This may be overridden at compile time with -D.          */
+#ifndef RSSRINGOCCS_FUSED_MAX_BYTES
+#define RSSRINGOCCS_FUSED_MAX_BYTES (64UL*1024UL*1024UL)
+#endif
+
+/*  Reads the next points of an occultation, in increasing radius, into the   *
+ *  arrays of dlp, which have room for max_pts points. Returns the number of  *
+ *  points read, zero at the end of the data. Errors are reported by setting  *
+ *  dlp->error_occurred.                                                      */
+typedef size_t
+(*rssringoccs_DLP_Source)(void *, rssringoccs_DLPObj *, size_t);
+
+/*  Receives the reconstruction of the points first to first + n_pts - 1 of   *
+ *  tau. Returns false if the output could not be written.                    */
+typedef tmpl_Bool
+(*rssringoccs_Tau_Sink)(void *, const rssringoccs_TAUObj *, size_t, size_t);
+
+/*  Reconstructs an occultation read in chunks of chunk_size points from      *
+ *  source, passing the reconstructed points to sink as they are done. tau    *
+ *  holds the settings, as set for rssringoccs_Reconstruction, and no data.   *
+ *  Only the points that windows still need are kept, so the memory used is   *
+ *  set by chunk_size and the window width, not by the length of the data.    *
+ *  The forward model is not supported. tau->rng_list is the range to         *
+ *  reconstruct, and tau->progress_done counts the points sunk.               */
+extern void
+rssringoccs_Reconstruction_Stream(rssringoccs_TAUObj *tau,
+                                  rssringoccs_DLP_Source source,
+                                  void *source_data,
+                                  rssringoccs_Tau_Sink sink,
+                                  void *sink_data,
+                                  size_t chunk_size);
+
+/*  A source reading from a DLP object held in memory, from index next on.    */
+typedef struct rssringoccs_DLP_Array_Source_Def {
+    const rssringoccs_DLPObj *dlp;
+    size_t next;
+} rssringoccs_DLP_Array_Source;
+
+/*  rssringoccs_DLP_Source for a rssringoccs_DLP_Array_Source.                */
+extern size_t
+rssringoccs_DLP_Array_Source_Read(void *data,
+                                  rssringoccs_DLPObj *dlp,
+                                  size_t max_pts);
+
+/*  rssringoccs_Tau_Sink writing rows of rho_km_vals, the real part of T_out, *
+ *  and its imaginary part, to the FILE * data, in CSV format.                */
+extern tmpl_Bool
+rssringoccs_Tau_File_Sink_Write(void *data,
+                                const rssringoccs_TAUObj *tau,
+                                size_t first,
+                                size_t n_pts);
+
 extern void
 rssringoccs_Tau_Check_Data_Range(rssringoccs_TAUObj *dlp);
 
@@ -42,10 +130,129 @@ rssringoccs_Tau_Reset_Window(double *x_arr, double *w_func, double dx,
                              double width, size_t nw_pts,
                              rssringoccs_Window_Function fw);
 
+/*  Index of the point the window in use at center was built at, obtained by  *
+ *  replaying the 2*dx reset rule of the serial loops from tau->start.        */
+extern size_t
+rssringoccs_Tau_Window_Anchor(const rssringoccs_TAUObj *tau,
+                              size_t center, double two_dx);
+
+/*  The same, for the window widths w_km_vals of a run starting at start.     */
+extern size_t
+rssringoccs_Window_Anchor(const double *w_km_vals, size_t start,
+                          size_t center, double two_dx);
+
+/*  Number of threads a reconstruction loop should use. This is one when the  *
+ *  library is built without OpenMP, and tau->num_threads (or the size of the *
+ *  thread pool if num_threads is zero) otherwise, capped by tau->n_used.     */
+extern unsigned int
+rssringoccs_Tau_Thread_Count(const rssringoccs_TAUObj *tau);
+
+/*  Process-wide pool of reconstruction threads. Configure sets the number of *
+ *  threads (0 = OpenMP default) and whether workers are pinned to CPUs, and  *
+ *  starts the pool. Size returns the number of threads, starting the pool    *
+ *  with the current settings if needed. Info reports the number of threads   *
+ *  (0 if not started), pinning, and how many reconstructions used the pool.  *
+ *  The pool is the OpenMP team of the thread that started it. Runs started   *
+ *  from other threads use as many threads, in an unpinned team of their      *
+ *  own, and are not counted as uses.                                         */
+extern void
+rssringoccs_Thread_Pool_Configure(unsigned int n_threads, tmpl_Bool pin);
+
+extern unsigned int rssringoccs_Thread_Pool_Size(void);
+
+extern void
+rssringoccs_Thread_Pool_Info(unsigned int *n_threads,
+                             tmpl_Bool *pinned,
+                             unsigned long *uses);
+
+/*  Number of tasks per thread rssringoccs_Tau_Schedule aims for. More tasks  *
+ *  balance better, fewer rebuild the window less often. This may be          *
+ *  overridden at compile time with -D.                                       */
+#ifndef RSSRINGOCCS_TAU_TASKS_PER_THREAD
+#define RSSRINGOCCS_TAU_TASKS_PER_THREAD (16U)
+#endif
+
+/*  A contiguous range of points, first <= center < last. The window in use   *
+ *  at first was built at anchor, see rssringoccs_Tau_Window_Anchor.          */
+typedef struct rssringoccs_Tau_Task_Def {
+    size_t first;
+    size_t last;
+    size_t anchor;
+} rssringoccs_Tau_Task;
+
+/*  Reconstructs the points of a task. The arguments are the Tau object, the  *
+ *  data given to rssringoccs_Tau_Schedule, the index of the thread running   *
+ *  the task (less than the number of threads), and the task. Returns false   *
+ *  if malloc fails.                                                          */
+typedef tmpl_Bool
+(*rssringoccs_Tau_Task_Func)(rssringoccs_TAUObj *, void *, unsigned int,
+                             const rssringoccs_Tau_Task *);
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Schedule                                              *
+ *  Purpose:                                                                  *
+ *      Splits first <= center < last into tasks of about equal estimated     *
+ *      cost and runs them on n_threads threads that steal from each other.   *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object. The per-thread statistics of the run are stored   *
+ *          in tau->worker_stats.                                             *
+ *      first, last (size_t):                                                 *
+ *          The range of points to reconstruct.                               *
+ *      two_dx (double):                                                      *
+ *          Twice the sample spacing, used for the window reset rule.         *
+ *      point_cost (double):                                                  *
+ *          The cost of a point on top of its window, in window samples.      *
+ *      func (rssringoccs_Tau_Task_Func):                                     *
+ *          Reconstructs a task.                                              *
+ *      data (void *):                                                        *
+ *          Passed on to func.                                                *
+ *      n_threads (unsigned int):                                             *
+ *          The number of threads, see rssringoccs_Tau_Thread_Count.          *
+ *  Outputs:                                                                  *
+ *      success (tmpl_Bool):                                                  *
+ *          False if func or malloc failed, true otherwise.                   *
+ ******************************************************************************/
+extern tmpl_Bool
+rssringoccs_Tau_Schedule(rssringoccs_TAUObj *tau,
+                         size_t first,
+                         size_t last,
+                         double two_dx,
+                         double point_cost,
+                         rssringoccs_Tau_Task_Func func,
+                         void *data,
+                         unsigned int n_threads);
+
+/*  Upper bound on the memory used by the window function cache, in bytes.    *
+ *  This may be overridden at compile time with -D.                           */
+#ifndef RSSRINGOCCS_WINDOW_CACHE_MAX_BYTES
+#define RSSRINGOCCS_WINDOW_CACHE_MAX_BYTES (256UL*1024UL*1024UL)
+#endif
+
+/*  Process-wide cache of tabulated window functions, used by the             *
+ *  reconstruction loops if tau->use_window_cache is set. The table for a     *
+ *  half-width k has 2k+3 entries, table[n] = fw(n - (k+1), 2k+1). NULL is    *
+ *  returned if malloc fails or the cache is full.                            */
+extern const double *
+rssringoccs_Window_Cache_Get(rssringoccs_Window_Function fw, size_t half_width);
+
+/*  Number of cache hits and misses since the last clear, and bytes in use.   */
+extern void
+rssringoccs_Window_Cache_Stats(unsigned long *hits,
+                               unsigned long *misses,
+                               size_t *n_bytes);
+
+/*  Frees all cached tables. Must not be called during a reconstruction.      */
+extern void rssringoccs_Window_Cache_Clear(void);
+
 /*  Functions that compute the Fresnel Transform on a TAUObj instance.        */
 extern void
 rssringoccs_Diffraction_Correction_Fresnel(rssringoccs_TAUObj *tau);
 
+extern void
+rssringoccs_Diffraction_Correction_Fresnel_FFT(rssringoccs_TAUObj *tau);
+
 extern void
 rssringoccs_Diffraction_Correction_Legendre(rssringoccs_TAUObj *tau);
 
@@ -55,4 +262,7 @@ rssringoccs_Diffraction_Correction_Newton(rssringoccs_TAUObj *tau);
 extern void
 rssringoccs_Diffraction_Correction_SimpleFFT(rssringoccs_TAUObj *tau);
 
+extern void
+rssringoccs_Diffraction_Correction_Segmented_FFT(rssringoccs_TAUObj *tau);
+
 #endif
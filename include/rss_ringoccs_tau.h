@@ -89,10 +89,52 @@ typedef enum {
     rssringoccs_DR_NewtonEllipticalSextic = 27,
     rssringoccs_DR_NewtonEllipticalOctic = 28,
 
+    /*  Fresnel quadratic approximation, using blocked FFT convolutions.      */
+    rssringoccs_DR_FresnelFFT = 29,
+
+    /*  Newton-Raphson, using one FFT per segment of the data set.            */
+    rssringoccs_DR_NewtonSegmentedFFT = 30,
+
+    /*  Newton-Raphson on an adaptive grid, with spline interpolation.        */
+    rssringoccs_DR_NewtonAdaptive = 31,
+
     /*  Indicates an error.                                                   */
     rssringoccs_DR_None = 100
 } rssringoccs_Psitype_Enum;
 
+/*  The work done by one thread of a reconstruction. See                      *
+ *  rssringoccs_Tau_Schedule. busy_seconds / wall_seconds is the utilization. */
+typedef struct rssringoccs_Tau_Worker_Stats_Def {
+    unsigned long n_tasks;
+    unsigned long n_stolen;
+    unsigned long n_points;
+    double cost;
+    double busy_seconds;
+    double wall_seconds;
+} rssringoccs_Tau_Worker_Stats;
+
+/*  Arrays of a Tau object that are allocated during the reconstruction.      */
+typedef enum {
+    rssringoccs_Tau_Slot_T_Out = 0,
+    rssringoccs_Tau_Slot_T_Fwd = 1,
+    rssringoccs_Tau_Slot_W_Km = 2
+} rssringoccs_Tau_Slot_Enum;
+
+/*  Where the members copied from a DLP object are stored. These are all the  *
+ *  DLP members except rho_dot_kms_vals, which is always owned.               */
+typedef enum {
+
+    /*  Allocated one at a time and freed by rssringoccs_Tau_Destroy_Members. */
+    rssringoccs_Tau_DLP_Owned = 0,
+
+    /*  Placed in the arena, see rssringoccs_Tau_Malloc_Arena.                */
+    rssringoccs_Tau_DLP_In_Arena = 1,
+
+    /*  The arrays of the DLP object itself, which are never written to or    *
+     *  freed by the Tau object. See rssringoccs_Tau_Create_From_DLP_Borrowed.*/
+    rssringoccs_Tau_DLP_Borrowed = 2
+} rssringoccs_Tau_DLP_Storage_Enum;
+
 /*  Structure that contains all of the necessary data.                        */
 typedef struct rssringoccs_TAUObj_Def {
     tmpl_ComplexDouble *T_in;
@@ -126,6 +168,11 @@ typedef struct rssringoccs_TAUObj_Def {
     double rng_list[2];
     double rng_req[2];
     double EPS;
+    double fft_max_deviation;
+    double interp_tol;
+    unsigned long newton_iterations;
+    unsigned long newton_samples;
+    unsigned long newton_warm_samples;
     unsigned int toler;
     size_t start;
     size_t n_used;
@@ -136,9 +183,39 @@ typedef struct rssringoccs_TAUObj_Def {
     tmpl_Bool use_fwd;
     tmpl_Bool bfac;
     tmpl_Bool verbose;
+    tmpl_Bool use_window_cache;
+    tmpl_Bool use_simd;
+    tmpl_Bool use_warm_start;
+    tmpl_Bool use_fused;
     tmpl_Bool error_occurred;
     char *error_message;
     unsigned int order;
+    unsigned int num_threads;
+    rssringoccs_Tau_Worker_Stats *worker_stats;
+    unsigned int n_workers;
+
+    /*  If use_arena is set before the members are allocated, every array is  *
+     *  placed in one block, arena, of arena_bytes bytes. This is the peak    *
+     *  memory used by the arrays, as rssringoccs_Tau_Finish trims them       *
+     *  without copying. See rssringoccs_Tau_Malloc_Members.                  */
+    tmpl_Bool use_arena;
+    void *arena;
+    size_t arena_bytes;
+
+    /*  If borrow_dlp is set before the members are allocated, the DLP        *
+     *  members are referenced instead of copied. dlp_storage says where they *
+     *  are, and so which of them rssringoccs_Tau_Destroy_Members frees.      */
+    tmpl_Bool borrow_dlp;
+    rssringoccs_Tau_DLP_Storage_Enum dlp_storage;
+
+    /*  Points reconstructed so far out of progress_total, and a request to   *
+     *  stop. These may be read and set by another thread while               *
+     *  rssringoccs_Reconstruction runs, so once a Tau object is shared they  *
+     *  are only accessed with rssringoccs_Tau_Get_Progress and the related   *
+     *  functions below, which hold a mutex.                                  */
+    unsigned long progress_done;
+    unsigned long progress_total;
+    tmpl_Bool cancel_requested;
 } rssringoccs_TAUObj;
 
 /******************************************************************************
@@ -164,6 +241,37 @@ typedef struct rssringoccs_TAUObj_Def {
 extern rssringoccs_TAUObj *
 rssringoccs_Tau_Create_From_DLP(const rssringoccs_DLPObj *dlp, double res);
 
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Create_From_DLP_Borrowed                              *
+ *  Purpose:                                                                  *
+ *      Creates a Tau object that references the data in a DLP object         *
+ *      instead of copying it.                                                *
+ *  Arguments:                                                                *
+ *      dlp (const rssringoccs_DLPObj *):                                     *
+ *          The DLP object whose members are being referenced.                *
+ *      res (double):                                                         *
+ *          The requested resolution, in kilometers.                          *
+ *  Outputs:                                                                  *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The output Tau object.                                            *
+ *  Notes:                                                                    *
+ *      1.) The same as rssringoccs_Tau_Create_From_DLP, but the Tau object   *
+ *          only allocates T_in, F_km_vals, k_vals, rho_dot_kms_vals, and the *
+ *          outputs. The other members point to the arrays of the DLP object. *
+ *      2.) The arrays of dlp are read, never written to or freed. They must  *
+ *          outlive the Tau object, or rssringoccs_Tau_Own_DLP_Members must   *
+ *          be called before they are freed. The dlp struct itself may be     *
+ *          freed right away.                                                 *
+ *      3.) Nothing may write to the arrays of dlp while the Tau object is in *
+ *          use, by another thread or otherwise. The Python wrapper cannot    *
+ *          promise this for numpy arrays, so it uses                         *
+ *          rssringoccs_Tau_Create_From_DLP instead.                          *
+ ******************************************************************************/
+extern rssringoccs_TAUObj *
+rssringoccs_Tau_Create_From_DLP_Borrowed(const rssringoccs_DLPObj *dlp,
+                                         double res);
+
 /******************************************************************************
  *  Function:                                                                 *
  *      rssringoccs_Tau_Copy_DLP_Data                                         *
@@ -199,6 +307,23 @@ extern void
 rssringoccs_Tau_Copy_DLP_Members(rssringoccs_TAUObj *tau,
                                  const rssringoccs_DLPObj *dlp);
 
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Own_DLP_Members                                       *
+ *  Purpose:                                                                  *
+ *      Replaces the borrowed DLP members of a Tau object with copies that    *
+ *      the Tau object owns. Nothing is done if they are not borrowed.        *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object.                                                   *
+ *  Outputs:                                                                  *
+ *      None (void).                                                          *
+ *  Notes:                                                                    *
+ *      tau->arr_size points are copied from each array. On failure, the      *
+ *      members are left borrowed and error_occurred is set.                  *
+ ******************************************************************************/
+extern void rssringoccs_Tau_Own_DLP_Members(rssringoccs_TAUObj *tau);
+
 /******************************************************************************
  *  Function:                                                                 *
  *      rssringoccs_Tau_Compute_Data_From_DLP_Members                         *
@@ -272,10 +397,62 @@ extern void rssringoccs_Tau_Init(rssringoccs_TAUObj *tau);
  *  Outputs:                                                                  *
  *      None (void).                                                          *
  *  Notes:                                                                    *
- *      It is assumed tau->arr_size has been set and that tau is not NULL.    *
+ *      1.) It is assumed tau->arr_size has been set and that tau is not NULL.*
+ *      2.) If tau->use_arena is set, the arrays are placed in one block,     *
+ *          with slots for T_out, w_km_vals, and, if tau->use_fwd is set,     *
+ *          T_fwd, for rssringoccs_Tau_Calloc_Slot. Every slot starts on a    *
+ *          64 byte boundary. Set use_arena and use_fwd after                 *
+ *          rssringoccs_Tau_Init and before rssringoccs_Tau_Copy_DLP_Data.    *
+ *      3.) The arrays of an arena are freed together by                      *
+ *          rssringoccs_Tau_Destroy_Members and must not be freed on their    *
+ *          own. This includes the Python wrapper, which frees every array of *
+ *          the objects it converts, so it does not use arenas.               *
+ *      4.) If tau->borrow_dlp is set, the members referenced from the DLP    *
+ *          object are not allocated, see                                     *
+ *          rssringoccs_Tau_Create_From_DLP_Borrowed.                         *
  ******************************************************************************/
 extern void rssringoccs_Tau_Malloc_Members(rssringoccs_TAUObj *tau);
 
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Malloc_Arena                                          *
+ *  Purpose:                                                                  *
+ *      Allocates the Tau variables in one block. This is called by           *
+ *      rssringoccs_Tau_Malloc_Members if tau->use_arena is set.              *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object whose members are to be allocated memory.          *
+ *  Outputs:                                                                  *
+ *      None (void).                                                          *
+ ******************************************************************************/
+extern void rssringoccs_Tau_Malloc_Arena(rssringoccs_TAUObj *tau);
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Calloc_Slot                                           *
+ *  Purpose:                                                                  *
+ *      Allocates a zeroed array for T_out, T_fwd, or w_km_vals.              *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object the array is for.                                  *
+ *      slot (rssringoccs_Tau_Slot_Enum):                                     *
+ *          The array requested.                                              *
+ *  Outputs:                                                                  *
+ *      arr (void *):                                                         *
+ *          An array of tau->arr_size zeroes, or NULL on failure.             *
+ *  Notes:                                                                    *
+ *      1.) Without an arena this is calloc, and the array is freed by        *
+ *          rssringoccs_Tau_Destroy_Members like the rest.                    *
+ *      2.) With an arena, the slot reserved for the array is zeroed and      *
+ *          returned. There is one slot per array, so a second call for the   *
+ *          same slot returns the same memory. Never free it.                 *
+ *      3.) An arena only has a T_fwd slot if use_fwd was set when it was     *
+ *          allocated. NULL is returned otherwise.                            *
+ ******************************************************************************/
+extern void *
+rssringoccs_Tau_Calloc_Slot(rssringoccs_TAUObj *tau,
+                            rssringoccs_Tau_Slot_Enum slot);
+
 /******************************************************************************
  *  Function:                                                                 *
  *      rssringoccs_Tau_Has_Errors                                            *
@@ -320,6 +497,63 @@ extern void rssringoccs_Tau_Set_Default_Values(rssringoccs_TAUObj* tau);
 extern void
 rssringoccs_Tau_Set_Psi_Type(const char *psitype, rssringoccs_TAUObj* tau);
 
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Get_Progress                                          *
+ *  Purpose:                                                                  *
+ *      Reads the progress of a reconstruction, possibly from another thread. *
+ *  Arguments:                                                                *
+ *      tau (const rssringoccs_TAUObj *):                                     *
+ *          The Tau object.                                                   *
+ *      done (unsigned long *), total (unsigned long *):                      *
+ *          Pointers progress_done and progress_total are written to. Either  *
+ *          may be NULL.                                                      *
+ *  Outputs:                                                                  *
+ *      None (void).                                                          *
+ ******************************************************************************/
+extern void
+rssringoccs_Tau_Get_Progress(const rssringoccs_TAUObj *tau,
+                             unsigned long *done,
+                             unsigned long *total);
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Set_Progress                                          *
+ *  Purpose:                                                                  *
+ *      Sets progress_done and progress_total of a Tau object.                *
+ ******************************************************************************/
+extern void
+rssringoccs_Tau_Set_Progress(rssringoccs_TAUObj *tau,
+                             unsigned long done,
+                             unsigned long total);
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Add_Progress                                          *
+ *  Purpose:                                                                  *
+ *      Adds n_points to progress_done. Safe to call from several threads.    *
+ ******************************************************************************/
+extern void
+rssringoccs_Tau_Add_Progress(rssringoccs_TAUObj *tau, unsigned long n_points);
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Request_Cancel                                        *
+ *  Purpose:                                                                  *
+ *      Asks a running reconstruction to stop, possibly from another thread.  *
+ *      It stops before its next task and sets error_occurred.                *
+ ******************************************************************************/
+extern void rssringoccs_Tau_Request_Cancel(rssringoccs_TAUObj *tau);
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Cancel_Requested                                      *
+ *  Purpose:                                                                  *
+ *      Returns true if rssringoccs_Tau_Request_Cancel was called on tau.     *
+ ******************************************************************************/
+extern tmpl_Bool
+rssringoccs_Tau_Cancel_Requested(const rssringoccs_TAUObj *tau);
+
 /******************************************************************************
  *  Function:                                                                 *
  *      rssringoccs_Tau_Set_Range_From_String                                 *
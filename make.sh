@@ -131,12 +131,13 @@ CompilerArgs="$STDVER $ExtraArgs $CArgs1 $CArgs2 $CArgs3 $CArgs4 $CArgs5"
 # -I../ means include the parent directory so rss_ringoccs/ is in the path.
 # -flto is link time optimization.
 # -lm means link against the standard math library.
+# -lpthread provides the mutex guarding the window cache.
 # -o means create an output.
 # -shared means the output is a shared object, like a library file.
 if [ $USEOMP == 1 ]; then
-    LinkerArgs="-O3 -flto -fopenmp -shared -o $SONAME -lm"
+    LinkerArgs="-O3 -flto -fopenmp -shared -o $SONAME -lm -lpthread"
 else
-    LinkerArgs="-O3 -flto -shared -o $SONAME -lm"
+    LinkerArgs="-O3 -flto -shared -o $SONAME -lm -lpthread"
 fi
 
 # Location where the .h files will be stored.
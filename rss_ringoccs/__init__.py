@@ -90,6 +90,9 @@
 """
 
 from .crssringoccs import ExtractCSVData, DiffractionCorrection
+from .crssringoccs import set_thread_pool, get_thread_pool
+from .crssringoccs import reconstruct_async, DiffractionCorrectionFuture
+from .crssringoccs import reconstruct_batch, reconstruct_multi_band
 from . import tools
 from . import rsr_reader
 from . import occgeo
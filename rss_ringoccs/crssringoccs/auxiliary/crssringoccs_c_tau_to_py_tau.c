@@ -67,6 +67,14 @@ void crssringoccs_C_Tau_To_Py_Tau(PyDiffrecObj *py_tau, rssringoccs_TAUObj *tau)
         return;
     }
 
+    /*  The Python object frees every array it is given, so any members       *
+     *  borrowed from a DLP object are copied first. Tau objects made by      *
+     *  crssringoccs_Diffrec_Setup already own them, and this does nothing.   */
+    rssringoccs_Tau_Own_DLP_Members(tau);
+
+    if (tau->error_occurred)
+        return;
+
     /*  Set every variable in the Python object from the C Tau struct.        */
     SET_CVAR(T_in);
     SET_CVAR(T_out);
@@ -89,6 +97,14 @@ void crssringoccs_C_Tau_To_Py_Tau(PyDiffrecObj *py_tau, rssringoccs_TAUObj *tau)
     SET_VAR(ry_km_vals);
     SET_VAR(rz_km_vals);
 
+    /*  Measured error of the FFT method, zero for the other methods.         */
+    py_tau->fft_max_deviation = tau->fft_max_deviation;
+
+    /*  Newton solver counters, zero for the methods that do not use them.    */
+    py_tau->newton_iterations = tau->newton_iterations;
+    py_tau->newton_samples = tau->newton_samples;
+    py_tau->newton_warm_samples = tau->newton_warm_samples;
+
     /*  If forward modeling was not performed, set these as None objects.     */
     if (tau->T_fwd == NULL)
         MAKE_NONE(T_fwd);
@@ -57,4 +57,10 @@ crssringoccs_Get_Py_Vars_From_Tau_Self(rssringoccs_TAUObj *tau,
     tau->use_fwd  = self->use_fwd;
     tau->use_norm = self->use_norm;
     tau->verbose  = self->verbose;
+    tau->num_threads = self->num_threads;
+    tau->use_window_cache = self->use_window_cache;
+    tau->use_simd = self->use_simd;
+    tau->use_warm_start = self->use_warm_start;
+    tau->use_fused = self->use_fused;
+    tau->interp_tol = self->interp_tol;
 }
@@ -0,0 +1,74 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+
+/*  Booleans provided here.                                                   */
+#include <libtmpl/include/tmpl_bool.h>
+
+/*  Function prototype and typedefs for structs given here.                   */
+#include "../crssringoccs.h"
+
+/*  Python wrapper for rssringoccs_Thread_Pool_Configure. The keywords are    *
+ *  threads (int, 0 = OpenMP default) and pin (bool).                         */
+PyObject *
+crssringoccs_Set_Thread_Pool(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    unsigned int n_threads = 0U;
+    int pin = 0;
+    static char *kwlist[] = {"threads", "pin", NULL};
+    (void)self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Ip:set_thread_pool",
+                                     kwlist, &n_threads, &pin))
+    {
+        PyErr_Format(
+            PyExc_TypeError,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\tset_thread_pool\n\n"
+            "\rCould not parse input variables.\n\n"
+            "\rKeywords:\n"
+            "\r\tthreads   \tNumber of threads, 0 for the default (int).\n"
+            "\r\tpin       \tPin each worker to a CPU (bool).\n"
+        );
+        return NULL;
+    }
+
+    rssringoccs_Thread_Pool_Configure(n_threads, pin ? tmpl_True : tmpl_False);
+    Py_RETURN_NONE;
+}
+
+/*  Python wrapper for rssringoccs_Thread_Pool_Info. Returns a dictionary     *
+ *  with the keys threads (0 if the pool has not started yet), pinned, and    *
+ *  uses (the number of reconstructions run on the pool). Only runs started   *
+ *  from the thread that started the pool use it. Those of reconstruct_async  *
+ *  run on threads of their own and are not counted.                          */
+PyObject *crssringoccs_Get_Thread_Pool(PyObject *self, PyObject *args)
+{
+    unsigned int n_threads;
+    tmpl_Bool pinned;
+    unsigned long uses;
+    (void)self;
+    (void)args;
+
+    rssringoccs_Thread_Pool_Info(&n_threads, &pinned, &uses);
+
+    return Py_BuildValue("{s:I,s:O,s:k}",
+                         "threads", n_threads,
+                         "pinned", pinned ? Py_True : Py_False,
+                         "uses", uses);
+}
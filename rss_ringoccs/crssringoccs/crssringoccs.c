@@ -27,11 +27,67 @@
 #include <numpy/ndarraytypes.h>
 #include <numpy/ufuncobject.h>
 
+/*  Module level functions, for the shared thread pool and async runs.        */
+static PyMethodDef crssringoccs_methods[] = {
+    {
+        "set_thread_pool",
+        (PyCFunction)(void (*)(void))crssringoccs_Set_Thread_Pool,
+        METH_VARARGS | METH_KEYWORDS,
+        "set_thread_pool(threads=0, pin=False)\n\n"
+        "Set the number of threads of the pool all reconstructions with\n"
+        "num_threads=0 run on (0 is the OpenMP default), and whether each\n"
+        "worker is pinned to a CPU. The pool is started right away."
+    },
+    {
+        "get_thread_pool",
+        crssringoccs_Get_Thread_Pool,
+        METH_NOARGS,
+        "get_thread_pool()\n\n"
+        "Return a dictionary with the number of threads of the pool (0 if\n"
+        "it has not started), whether they are pinned, and the number of\n"
+        "reconstructions that used it."
+    },
+    {
+        "reconstruct_async",
+        (PyCFunction)(void (*)(void))crssringoccs_Reconstruct_Async,
+        METH_VARARGS | METH_KEYWORDS,
+        "reconstruct_async(dlp, res, **kwds)\n\n"
+        "Start a reconstruction on a thread of its own and return a\n"
+        "DiffractionCorrectionFuture. Takes the same arguments as the\n"
+        "DiffractionCorrection class. The future has the methods done(),\n"
+        "progress(), cancel(), and result(timeout=None)."
+    },
+    {
+        "reconstruct_batch",
+        (PyCFunction)(void (*)(void))crssringoccs_Reconstruct_Batch,
+        METH_VARARGS | METH_KEYWORDS,
+        "reconstruct_batch(dlp, res, wtypes, **kwds)\n\n"
+        "Reconstruct for every resolution in res and every window type in\n"
+        "wtypes, computing the Fresnel kernel once for all of them. Takes\n"
+        "the keywords of DiffractionCorrection. Returns a dictionary with\n"
+        "rho_km_vals and T_out, of shape (len(res), len(wtypes), len(rho)).\n"
+        "Only the fresnel and non-interpolated Newton psitypes are allowed."
+    },
+    {
+        "reconstruct_multi_band",
+        (PyCFunction)(void (*)(void))crssringoccs_Reconstruct_Multi_Band,
+        METH_VARARGS | METH_KEYWORDS,
+        "reconstruct_multi_band(dlps, res, **kwds)\n\n"
+        "Reconstruct the DLPs of the bands of one occultation, solving for\n"
+        "the stationary azimuth angles once for all of them when they share\n"
+        "a non-interpolated Newton psitype and their geometry. Takes the\n"
+        "arguments of DiffractionCorrection, which apply to every band.\n"
+        "Returns a list of DiffractionCorrection instances."
+    },
+    {NULL, NULL, 0, NULL}
+};
+
 static PyModuleDef moduledef = {
     PyModuleDef_HEAD_INIT,
     .m_name = "custom",
     .m_doc = "Module containing C Tools for rss_ringoccs.",
     .m_size = -1,
+    .m_methods = crssringoccs_methods,
 };
 
 PyMODINIT_FUNC PyInit_crssringoccs(void)
@@ -44,6 +100,9 @@ PyMODINIT_FUNC PyInit_crssringoccs(void)
     if (PyType_Ready(&ExtractCSVDataType) < 0)
         return NULL;
 
+    if (PyType_Ready(&DiffrecFutureType) < 0)
+        return NULL;
+
     m = PyModule_Create(&moduledef);
 
     if (m == NULL)
@@ -71,6 +130,17 @@ PyMODINIT_FUNC PyInit_crssringoccs(void)
         return NULL;
     }
 
+    Py_INCREF(&DiffrecFutureType);
+    pymod_addobj = PyModule_AddObject(m, "DiffractionCorrectionFuture",
+                                      (PyObject *) &DiffrecFutureType);
+
+    if (pymod_addobj < 0)
+    {
+        Py_DECREF(&DiffrecFutureType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
     import_array();
     return m;
 }
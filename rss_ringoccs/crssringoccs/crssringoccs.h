@@ -64,11 +64,21 @@ typedef struct PyDiffrecObj_Def {
     tmpl_Bool use_fwd;                /*  Boolean for forward modeling.       */
     tmpl_Bool use_norm;               /*  Boolean for window normalization.   */
     tmpl_Bool verbose;                /*  Boolean for printing messages.      */
+    tmpl_Bool use_window_cache;       /*  Boolean for cached window tables.   */
+    tmpl_Bool use_simd;               /*  Boolean for SIMD Fresnel kernels.   */
+    tmpl_Bool use_warm_start;         /*  Boolean for warm Newton starts.     */
+    tmpl_Bool use_fused;              /*  Boolean for one-pass forward model. */
     double ecc;                       /*  Eccentricity, elliptical rings only.*/
     double input_res;                 /*  Input resolution, in kilometers.    */
     double peri;                      /*  Periapse, elliptical rings only.    */
     double res_factor;                /*  Resolution scale factor, unitless.  */
     double sigma;                     /*  Allen deviation of spacecraft.      */
+    double fft_max_deviation;         /*  FFT vs. direct sum, "fresnelfft".   */
+    double interp_tol;                /*  Kernel error allowed, "adaptive".   */
+    unsigned long newton_iterations;  /*  Newton steps taken, Newton methods. */
+    unsigned long newton_samples;     /*  Samples the steps were taken for.   */
+    unsigned long newton_warm_samples;/*  Samples started from last center.   */
+    unsigned int num_threads;         /*  Reconstruction threads, 0 = auto.   */
     const char *outfiles;             /*  TAB files for this Tau object.      */
     const char *wtype;
     const char *psitype;
@@ -115,6 +125,11 @@ extern void crssringoccs_Set_CVar(PyObject **py_ptr,
 
 extern void crssringoccs_Capsule_Cleanup(PyObject *capsule);
 
+extern PyObject *
+crssringoccs_Set_Thread_Pool(PyObject *self, PyObject *args, PyObject *kwds);
+
+extern PyObject *crssringoccs_Get_Thread_Pool(PyObject *self, PyObject *args);
+
 extern double *
 crssringoccs_Extract_Data(rssringoccs_DLPObj *dlp,
                           PyObject *py_dlp,
@@ -141,6 +156,46 @@ extern int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds);
 
 extern PyTypeObject DiffrecType;
 
+extern rssringoccs_TAUObj *
+crssringoccs_Diffrec_Setup(PyDiffrecObj *self, PyObject *args, PyObject *kwds,
+                           PyObject **dlp_inst, PyObject **rng);
+
+extern int
+crssringoccs_Diffrec_Finish(PyDiffrecObj *self, rssringoccs_TAUObj *tau,
+                            PyObject *DLPInst, PyObject *rngreq);
+
+/*  Handle of a reconstruction running on a thread of its own.                */
+typedef struct PyDiffrecFutureObj_Def {
+    PyObject_HEAD
+    PyDiffrecObj *diffrec;            /*  The instance being reconstructed.   */
+    rssringoccs_TAUObj *tau;          /*  NULL once the result is collected.  */
+    PyThread_type_lock lock;          /*  Held while the thread is running.   */
+    PyObject *args;                   /*  Arguments of reconstruct_async.     */
+    PyObject *kwds;                   /*  Keywords of reconstruct_async.      */
+    PyObject *dlp_inst;               /*  DLP instance, borrowed from args.   */
+    PyObject *rngreq;                 /*  Requested range.                    */
+    PyObject *err_type;               /*  The exception if the run failed.    */
+    PyObject *err_value;
+    PyObject *err_traceback;
+} PyDiffrecFutureObj;
+
+extern PyObject *
+crssringoccs_Reconstruct_Async(PyObject *module,
+                               PyObject *args,
+                               PyObject *kwds);
+
+extern PyTypeObject DiffrecFutureType;
+
+extern PyObject *
+crssringoccs_Reconstruct_Batch(PyObject *module,
+                               PyObject *args,
+                               PyObject *kwds);
+
+extern PyObject *
+crssringoccs_Reconstruct_Multi_Band(PyObject *module,
+                                    PyObject *args,
+                                    PyObject *kwds);
+
 
 
 
@@ -131,6 +131,46 @@ static PyMemberDef diffrec_members[] = {
         "use_fwd", T_BOOL, offsetof(PyDiffrecObj, use_fwd), 0,
         "Forward modeling Boolean"
     },
+    {
+        "use_window_cache", T_BOOL, offsetof(PyDiffrecObj, use_window_cache), 0,
+        "Use of the cached window function tables"
+    },
+    {
+        "use_simd", T_BOOL, offsetof(PyDiffrecObj, use_simd), 0,
+        "Use of the SIMD Fresnel kernels"
+    },
+    {
+        "use_warm_start", T_BOOL, offsetof(PyDiffrecObj, use_warm_start), 0,
+        "Use of the previous center's stationary angles as Newton guesses"
+    },
+    {
+        "use_fused", T_BOOL, offsetof(PyDiffrecObj, use_fused), 0,
+        "Use of one pass for the reconstruction and the forward model"
+    },
+    {
+        "interp_tol", T_DOUBLE, offsetof(PyDiffrecObj, interp_tol), 0,
+        "Largest interpolation error of the kernel for the adaptive psitype"
+    },
+    {
+        "fft_max_deviation", T_DOUBLE,
+        offsetof(PyDiffrecObj, fft_max_deviation), 0,
+        "Largest difference between the FFT method and the direct sum"
+    },
+    {
+        "newton_iterations", T_ULONG,
+        offsetof(PyDiffrecObj, newton_iterations), 0,
+        "Newton steps taken finding the stationary azimuth angles, "
+        "not counted for cold starts with use_simd off"
+    },
+    {
+        "newton_samples", T_ULONG, offsetof(PyDiffrecObj, newton_samples), 0,
+        "Number of stationary azimuth angles found with Newton's method"
+    },
+    {
+        "newton_warm_samples", T_ULONG,
+        offsetof(PyDiffrecObj, newton_warm_samples), 0,
+        "Number of stationary azimuth angles started from the last center"
+    },
     {
         "ecc", T_DOUBLE, offsetof(PyDiffrecObj, ecc), 0,
         "Eccentricity of Rings"
@@ -160,6 +200,13 @@ static PyMemberDef diffrec_members[] = {
         0,
         "Allen deviation."
     },
+    {
+        "num_threads",
+        T_UINT,
+        offsetof(PyDiffrecObj, num_threads),
+        0,
+        "Number of reconstruction threads, zero for the OpenMP default."
+    },
     {
         NULL
     }  /* Sentinel */
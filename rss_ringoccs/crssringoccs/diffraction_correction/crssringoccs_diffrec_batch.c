@@ -0,0 +1,241 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                       Batch Diffraction Correction                         *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides reconstruct_batch, which reconstructs a DLP at several       *
+ *      resolutions and with several window types with one call to            *
+ *      rssringoccs_Reconstruction_Batch.                                     *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  reconstruct_batch(dlp, res, wtypes, **kwds) takes a sequence of           *
+ *  resolutions and a sequence of window types in place of res and wtype,     *
+ *  and otherwise the keywords of DiffractionCorrection. res_factor is        *
+ *  applied to every resolution. It returns a dictionary with                 *
+ *                                                                            *
+ *      rho_km_vals     The ring radii the reconstructions cover, the points  *
+ *                      every combination can reconstruct.                    *
+ *      T_out           Complex array of shape (len(res), len(wtypes),        *
+ *                      len(rho_km_vals)), T_out[i, j] being the              *
+ *                      reconstruction with res[i] and wtypes[j].             *
+ *                                                                            *
+ *  The GIL is released while the reconstructions run.                        *
+ ******************************************************************************/
+
+/*  free and malloc are found here.                                           */
+#include <stdlib.h>
+
+/*  Function prototype and typedefs for structs given here.                   */
+#include "../crssringoccs.h"
+
+/*  Converts a sequence of floats to a C array, scaled by factor. Returns     *
+ *  NULL, with a Python exception set, on error.                              */
+static double *
+crssringoccs_Batch_Res(PyObject *seq, Py_ssize_t n_res, double factor)
+{
+    Py_ssize_t n;
+    double *res = malloc(sizeof(*res) * (size_t)n_res);
+
+    if (res == NULL)
+        return (double *)PyErr_NoMemory();
+
+    for (n = 0; n < n_res; ++n)
+    {
+        res[n] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, n));
+
+        if (res[n] == -1.0 && PyErr_Occurred())
+        {
+            free(res);
+            return NULL;
+        }
+
+        res[n] *= factor;
+    }
+
+    return res;
+}
+
+/*  The strings of a sequence of str. They belong to the items, which seq     *
+ *  keeps alive. Returns NULL, with a Python exception set, on error.         */
+static const char **
+crssringoccs_Batch_WTypes(PyObject *seq, Py_ssize_t n_wtypes)
+{
+    Py_ssize_t n;
+    const char **wtypes = malloc(sizeof(*wtypes) * (size_t)n_wtypes);
+
+    if (wtypes == NULL)
+        return (const char **)PyErr_NoMemory();
+
+    for (n = 0; n < n_wtypes; ++n)
+    {
+        wtypes[n] = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(seq, n));
+
+        if (wtypes[n] == NULL)
+        {
+            free(wtypes);
+            return NULL;
+        }
+    }
+
+    return wtypes;
+}
+
+/*  Builds the output dictionary. The arrays take ownership of T_out.         */
+static PyObject *
+crssringoccs_Batch_Output(const rssringoccs_TAUObj *tau,
+                          tmpl_ComplexDouble *T_out,
+                          Py_ssize_t n_res,
+                          Py_ssize_t n_wtypes)
+{
+    PyObject *py_rho = NULL;
+    PyObject *py_T_out = NULL;
+    PyObject *shaped, *out;
+    size_t n;
+    const size_t n_pts = tau->n_used;
+    double *rho = malloc(sizeof(*rho) * n_pts);
+
+    if (rho == NULL)
+    {
+        free(T_out);
+        return PyErr_NoMemory();
+    }
+
+    for (n = 0; n < n_pts; ++n)
+        rho[n] = tau->rho_km_vals[tau->start + n];
+
+    crssringoccs_Set_Var(&py_rho, rho, n_pts);
+    crssringoccs_Set_CVar(&py_T_out, T_out, (size_t)(n_res*n_wtypes)*n_pts);
+
+    if (py_rho == NULL || py_T_out == NULL)
+    {
+        Py_XDECREF(py_rho);
+        Py_XDECREF(py_T_out);
+        return NULL;
+    }
+
+    shaped = PyObject_CallMethod(py_T_out, "reshape", "(nnn)",
+                                 n_res, n_wtypes, (Py_ssize_t)n_pts);
+    Py_DECREF(py_T_out);
+
+    if (shaped == NULL)
+    {
+        Py_DECREF(py_rho);
+        return NULL;
+    }
+
+    out = Py_BuildValue("{s:N,s:N}", "rho_km_vals", py_rho, "T_out", shaped);
+    return out;
+}
+
+/*  Module level function. Takes the arguments of DiffractionCorrection,      *
+ *  with sequences of resolutions and window types.                           */
+PyObject *
+crssringoccs_Reconstruct_Batch(PyObject *module,
+                               PyObject *args,
+                               PyObject *kwds)
+{
+    PyObject *py_dlp, *py_res, *py_wtypes;
+    PyObject *res_seq, *wtypes_seq, *setup_args;
+    PyObject *dlp_inst, *rngreq;
+    PyObject *out = NULL;
+    PyDiffrecObj *diffrec;
+    rssringoccs_TAUObj *tau;
+    tmpl_ComplexDouble *T_out;
+    double *res;
+    const char **wtypes;
+    Py_ssize_t n_res, n_wtypes;
+    (void)module;
+
+    if (!PyArg_UnpackTuple(args, "reconstruct_batch", 3, 3,
+                           &py_dlp, &py_res, &py_wtypes))
+        return NULL;
+
+    res_seq = PySequence_Fast(py_res, "res must be a sequence of floats.");
+
+    if (res_seq == NULL)
+        return NULL;
+
+    wtypes_seq = PySequence_Fast(py_wtypes,
+                                 "wtypes must be a sequence of strings.");
+
+    if (wtypes_seq == NULL)
+    {
+        Py_DECREF(res_seq);
+        return NULL;
+    }
+
+    n_res = PySequence_Fast_GET_SIZE(res_seq);
+    n_wtypes = PySequence_Fast_GET_SIZE(wtypes_seq);
+
+    if (n_res == 0 || n_wtypes == 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "res and wtypes must not be empty.");
+        Py_DECREF(res_seq);
+        Py_DECREF(wtypes_seq);
+        return NULL;
+    }
+
+    /*  The Tau object is built as DiffractionCorrection(dlp, res[0], ...)    *
+     *  would build it. The batch sets the resolution and window itself.      */
+    setup_args = PyTuple_Pack(2, py_dlp, PySequence_Fast_GET_ITEM(res_seq, 0));
+    diffrec = (PyDiffrecObj *)PyType_GenericNew(&DiffrecType, NULL, NULL);
+    tau = NULL;
+
+    if (setup_args != NULL && diffrec != NULL)
+        tau = crssringoccs_Diffrec_Setup(diffrec, setup_args, kwds,
+                                         &dlp_inst, &rngreq);
+
+    if (tau != NULL)
+    {
+        Py_DECREF(rngreq);
+        res = crssringoccs_Batch_Res(res_seq, n_res, diffrec->res_factor);
+        wtypes = NULL;
+
+        if (res != NULL)
+            wtypes = crssringoccs_Batch_WTypes(wtypes_seq, n_wtypes);
+
+        if (wtypes != NULL)
+        {
+            Py_BEGIN_ALLOW_THREADS
+            T_out = rssringoccs_Reconstruction_Batch(tau, res, (size_t)n_res,
+                                                     wtypes, (size_t)n_wtypes);
+            Py_END_ALLOW_THREADS
+
+            if (T_out != NULL)
+                out = crssringoccs_Batch_Output(tau, T_out, n_res, n_wtypes);
+            else if (tau->error_message == NULL)
+                PyErr_SetString(PyExc_RuntimeError,
+                                "rssringoccs_Reconstruction_Batch failed.");
+            else
+                PyErr_Format(PyExc_RuntimeError, "%s\n", tau->error_message);
+        }
+
+        free(res);
+        free(wtypes);
+        rssringoccs_Tau_Destroy(&tau);
+    }
+
+    Py_XDECREF(diffrec);
+    Py_XDECREF(setup_args);
+    Py_DECREF(wtypes_seq);
+    Py_DECREF(res_seq);
+    return out;
+}
+/*  End of crssringoccs_Reconstruct_Batch.                                    */
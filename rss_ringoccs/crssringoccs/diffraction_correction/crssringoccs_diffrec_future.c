@@ -0,0 +1,347 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                      Asynchronous Diffraction Correction                   *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides reconstruct_async, which takes the same arguments as the     *
+ *      DiffractionCorrection class, starts the reconstruction on a thread of *
+ *      its own, and returns a DiffractionCorrectionFuture right away.        *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The arguments are parsed and the C Tau object is built while the caller   *
+ *  waits, so bad arguments raise right away. rssringoccs_Reconstruction then *
+ *  runs on a new thread that never touches Python objects, and so never      *
+ *  needs the GIL. The future keeps args and kwds alive (wtype and psitype    *
+ *  point into them) until the result is collected.                           *
+ *                                                                            *
+ *  The future has the methods                                                *
+ *                                                                            *
+ *      done()          True once the reconstruction has stopped.             *
+ *      progress()      Fraction of the points reconstructed, 0 to 1.         *
+ *      cancel()        Asks the reconstruction to stop. True if it was still *
+ *                      running.                                              *
+ *      result(timeout) Waits, without the GIL, at most timeout seconds (for  *
+ *                      ever if None), and returns the DiffractionCorrection  *
+ *                      instance. Raises RuntimeError if the reconstruction   *
+ *                      failed or was cancelled, and TimeoutError if it is    *
+ *                      still running.                                        *
+ *                                                                            *
+ *  A future that is destroyed while its reconstruction runs cancels it and   *
+ *  waits for it to stop.                                                     *
+ *                                                                            *
+ *  The thread holds the lock of the future while it runs, so the future      *
+ *  knows the thread has stopped if it can take the lock. The progress and    *
+ *  cancel request are shared through rssringoccs_Tau_Get_Progress and        *
+ *  rssringoccs_Tau_Request_Cancel, which hold a mutex of their own.          *
+ ******************************************************************************/
+
+/*  free is found here.                                                       */
+#include <stdlib.h>
+
+/*  Booleans provided here.                                                   */
+#include <libtmpl/include/tmpl_bool.h>
+
+/*  Function prototype and typedefs for structs given here.                   */
+#include "../crssringoccs.h"
+
+/*  The reconstruction thread. The lock was acquired for it by its creator.   */
+static void crssringoccs_Diffrec_Future_Run(void *data)
+{
+    PyDiffrecFutureObj *self = data;
+    rssringoccs_Reconstruction(self->tau);
+    PyThread_release_lock(self->lock);
+}
+
+/*  Waits for the reconstruction thread without the GIL. timeout is in        *
+ *  microseconds, -1 for no limit. Returns 1 if the thread has finished.      */
+static int
+crssringoccs_Diffrec_Future_Wait(PyDiffrecFutureObj *self, PY_TIMEOUT_T timeout)
+{
+    PyLockStatus status;
+
+    Py_BEGIN_ALLOW_THREADS
+    status = PyThread_acquire_lock_timed(self->lock, timeout, 0);
+    Py_END_ALLOW_THREADS
+
+    if (status != PY_LOCK_ACQUIRED)
+        return 0;
+
+    /*  Leave the lock free so that later waits return at once.               */
+    PyThread_release_lock(self->lock);
+    return 1;
+}
+
+/*  Returns 1 if the reconstruction thread has stopped, without blocking.     */
+static int crssringoccs_Diffrec_Future_Finished(PyDiffrecFutureObj *self)
+{
+    /*  Without a lock no thread was started.                                 */
+    if (self->lock == NULL)
+        return 1;
+
+    if (!PyThread_acquire_lock(self->lock, NOWAIT_LOCK))
+        return 0;
+
+    PyThread_release_lock(self->lock);
+    return 1;
+}
+
+/*  Passes the Tau object to the DiffractionCorrection instance, once.        */
+static void crssringoccs_Diffrec_Future_Collect(PyDiffrecFutureObj *self)
+{
+    rssringoccs_TAUObj *tau = self->tau;
+    self->tau = NULL;
+
+    if (crssringoccs_Diffrec_Finish(self->diffrec, tau,
+                                    self->dlp_inst, self->rngreq) < 0)
+    {
+        PyErr_Fetch(&self->err_type, &self->err_value, &self->err_traceback);
+        Py_CLEAR(self->diffrec);
+    }
+
+    Py_CLEAR(self->rngreq);
+}
+
+static PyObject *
+crssringoccs_Diffrec_Future_Done(PyDiffrecFutureObj *self,
+                                 PyObject *Py_UNUSED(ignored))
+{
+    return PyBool_FromLong(crssringoccs_Diffrec_Future_Finished(self));
+}
+
+static PyObject *
+crssringoccs_Diffrec_Future_Progress(PyDiffrecFutureObj *self,
+                                     PyObject *Py_UNUSED(ignored))
+{
+    unsigned long done, total;
+
+    if (self->tau == NULL)
+        return PyFloat_FromDouble(1.0);
+
+    rssringoccs_Tau_Get_Progress(self->tau, &done, &total);
+
+    if (total == 0UL)
+        return PyFloat_FromDouble(0.0);
+
+    return PyFloat_FromDouble((double)done / (double)total);
+}
+
+static PyObject *
+crssringoccs_Diffrec_Future_Cancel(PyDiffrecFutureObj *self,
+                                   PyObject *Py_UNUSED(ignored))
+{
+    if (self->tau == NULL || crssringoccs_Diffrec_Future_Finished(self))
+        Py_RETURN_FALSE;
+
+    rssringoccs_Tau_Request_Cancel(self->tau);
+    Py_RETURN_TRUE;
+}
+
+static PyObject *
+crssringoccs_Diffrec_Future_Result(PyDiffrecFutureObj *self,
+                                   PyObject *args, PyObject *kwds)
+{
+    PyObject *py_timeout = Py_None;
+    PY_TIMEOUT_T timeout = -1;
+    double seconds;
+    static char *kwlist[] = {"timeout", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:result", kwlist,
+                                     &py_timeout))
+        return NULL;
+
+    if (py_timeout != Py_None)
+    {
+        seconds = PyFloat_AsDouble(py_timeout);
+
+        if (seconds == -1.0 && PyErr_Occurred())
+            return NULL;
+
+        if (seconds < 0.0)
+            seconds = 0.0;
+
+        if (seconds * 1.0E6 < (double)PY_TIMEOUT_MAX)
+            timeout = (PY_TIMEOUT_T)(seconds * 1.0E6);
+    }
+
+    if (!crssringoccs_Diffrec_Future_Wait(self, timeout))
+    {
+        PyErr_SetString(PyExc_TimeoutError,
+                        "The reconstruction is still running.");
+        return NULL;
+    }
+
+    if (self->tau != NULL)
+        crssringoccs_Diffrec_Future_Collect(self);
+
+    if (self->diffrec == NULL)
+    {
+        Py_XINCREF(self->err_type);
+        Py_XINCREF(self->err_value);
+        Py_XINCREF(self->err_traceback);
+        PyErr_Restore(self->err_type, self->err_value, self->err_traceback);
+        return NULL;
+    }
+
+    Py_INCREF(self->diffrec);
+    return (PyObject *)self->diffrec;
+}
+
+static void crssringoccs_Diffrec_Future_Dealloc(PyDiffrecFutureObj *self)
+{
+    /*  The reconstruction thread uses tau, so it must stop first. If there   *
+     *  is no lock, no thread was started.                                    */
+    if (self->tau != NULL)
+    {
+        if (self->lock != NULL)
+        {
+            rssringoccs_Tau_Request_Cancel(self->tau);
+            crssringoccs_Diffrec_Future_Wait(self, -1);
+        }
+
+        rssringoccs_Tau_Destroy(&self->tau);
+    }
+
+    if (self->lock != NULL)
+        PyThread_free_lock(self->lock);
+
+    Py_XDECREF(self->diffrec);
+    Py_XDECREF(self->args);
+    Py_XDECREF(self->kwds);
+    Py_XDECREF(self->rngreq);
+    Py_XDECREF(self->err_type);
+    Py_XDECREF(self->err_value);
+    Py_XDECREF(self->err_traceback);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyMethodDef crssringoccs_diffrec_future_methods[] = {
+    {
+        "done",
+        (PyCFunction)crssringoccs_Diffrec_Future_Done,
+        METH_NOARGS,
+        "True once the reconstruction has stopped."
+    },
+    {
+        "progress",
+        (PyCFunction)crssringoccs_Diffrec_Future_Progress,
+        METH_NOARGS,
+        "Fraction of the points reconstructed so far, from 0 to 1."
+    },
+    {
+        "cancel",
+        (PyCFunction)crssringoccs_Diffrec_Future_Cancel,
+        METH_NOARGS,
+        "Ask the reconstruction to stop. True if it was still running."
+    },
+    {
+        "result",
+        (PyCFunction)(void (*)(void))crssringoccs_Diffrec_Future_Result,
+        METH_VARARGS | METH_KEYWORDS,
+        "result(timeout=None)\n\n"
+        "Wait for the reconstruction and return the DiffractionCorrection\n"
+        "instance. Raises TimeoutError if it is still running after timeout\n"
+        "seconds, and RuntimeError if it failed or was cancelled."
+    },
+    {NULL, NULL, 0, NULL}
+};
+
+PyTypeObject DiffrecFutureType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "diffrec.DiffractionCorrectionFuture",
+    .tp_doc = "Handle of a reconstruction started by reconstruct_async.",
+    .tp_basicsize = sizeof(PyDiffrecFutureObj),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)crssringoccs_Diffrec_Future_Dealloc,
+    .tp_methods = crssringoccs_diffrec_future_methods,
+};
+
+/*  Module level function. Takes the arguments of DiffractionCorrection.      */
+PyObject *
+crssringoccs_Reconstruct_Async(PyObject *module,
+                               PyObject *args,
+                               PyObject *kwds)
+{
+    PyDiffrecFutureObj *future;
+    (void)module;
+
+    future = PyObject_New(PyDiffrecFutureObj, &DiffrecFutureType);
+
+    if (future == NULL)
+        return NULL;
+
+    future->diffrec = NULL;
+    future->tau = NULL;
+    future->lock = NULL;
+    future->dlp_inst = NULL;
+    future->rngreq = NULL;
+    future->err_type = NULL;
+    future->err_value = NULL;
+    future->err_traceback = NULL;
+
+    Py_XINCREF(args);
+    Py_XINCREF(kwds);
+    future->args = args;
+    future->kwds = kwds;
+
+    future->diffrec = (PyDiffrecObj *)PyType_GenericNew(&DiffrecType,
+                                                        NULL, NULL);
+
+    if (future->diffrec == NULL)
+    {
+        Py_DECREF(future);
+        return NULL;
+    }
+
+    future->tau = crssringoccs_Diffrec_Setup(future->diffrec, args, kwds,
+                                             &future->dlp_inst,
+                                             &future->rngreq);
+
+    if (future->tau == NULL)
+    {
+        Py_DECREF(future);
+        return NULL;
+    }
+
+    future->lock = PyThread_allocate_lock();
+
+    /*  No thread uses tau yet, so it is destroyed here, before dealloc.      */
+    if (future->lock == NULL)
+    {
+        rssringoccs_Tau_Destroy(&future->tau);
+        Py_DECREF(future);
+        return PyErr_NoMemory();
+    }
+
+    /*  Held until the reconstruction thread is done.                         */
+    PyThread_acquire_lock(future->lock, WAIT_LOCK);
+
+    if (PyThread_start_new_thread(crssringoccs_Diffrec_Future_Run, future) ==
+        PYTHREAD_INVALID_THREAD_ID)
+    {
+        PyThread_release_lock(future->lock);
+        Py_DECREF(future);
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Could not start the reconstruction thread.");
+        return NULL;
+    }
+
+    return (PyObject *)future;
+}
@@ -40,9 +40,13 @@
 
 #define DESTROY_VAR(var) if (var) {free(var); var = NULL;}
 
-/*  The init function for the dirrection correction class. This is the        *
- *  equivalent of the __init__ function defined in a normal python class.     */
-int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
+/*  Parses the arguments of the DiffractionCorrection class and builds the C  *
+ *  Tau object, ready for rssringoccs_Reconstruction. The DLP instance and    *
+ *  the range request are returned in dlp_inst (borrowed) and rng (a new      *
+ *  reference). NULL is returned, with a Python exception set, on error.      */
+rssringoccs_TAUObj *
+crssringoccs_Diffrec_Setup(PyDiffrecObj *self, PyObject *args, PyObject *kwds,
+                           PyObject **dlp_inst, PyObject **rng)
 {
     /*  Declare variables for a DLP and Tau object.                           */
     rssringoccs_DLPObj *dlp;
@@ -66,13 +70,20 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
         "ecc",
         "peri",
         "perturb",
+        "num_threads",
+        "use_window_cache",
+        "use_simd",
+        "use_warm_start",
+        "use_fused",
+        "interp_tol",
         NULL
     };
 
     /*  Python objects needed throughout the computation.                     */
     PyObject *DLPInst;
-    PyObject *tmp;
-    PyObject *dlp_tmp;
+
+    /*  Default range is "all", denoting [1.0, 400000.0]. We'll set later.    */
+    PyObject *rngreq = NULL;
 
     /*  Set the default keyword options.                                      */
 
@@ -96,9 +107,6 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
      *  accurate for all but the most extreme occultations (like Rev133).     */
     self->psitype = "fresnel4";
 
-    /*  Default range is "all", denoting [1.0, 400000.0]. We'll set later.    */
-    PyObject *rngreq = PyUnicode_FromString("all");
-
     /*  By default, forward computations are not run, FFTs are not used, and  *
      *  the run is silent (verbose is off).                                   */
     self->use_fwd = tmpl_False;
@@ -124,6 +132,38 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
     self->ecc = 0.0;
     self->peri = 0.0;
 
+    /*  Zero threads means use the shared thread pool, see set_thread_pool.   *
+     *  This has no effect if librssringoccs was built without OpenMP.        */
+    self->num_threads = 0U;
+
+    /*  Cached window tables use the nominal window width for a given number  *
+     *  of points, which changes the result slightly. Default is off.         */
+    self->use_window_cache = tmpl_False;
+
+    /*  The SIMD Fresnel kernels agree with the scalar ones to round-off, and *
+     *  fall back to the scalar code on CPUs without SSE2. Default is on.     */
+    self->use_simd = tmpl_True;
+
+    /*  Warm starts change the stationary angles by up to the Newton          *
+     *  tolerance, and hence the result slightly. Default is off.             */
+    self->use_warm_start = tmpl_False;
+
+    /*  The one-pass forward model uses the windows of the inverse transform, *
+     *  which changes T_fwd slightly where the width varies. Default is off.  */
+    self->use_fused = tmpl_False;
+
+    /*  Largest error, in radians, of the interpolated kernel for the         *
+     *  "adaptive" psitype.                                                   */
+    self->interp_tol = 1.0E-4;
+
+    /*  Only set by the "fresnelfft" method.                                  */
+    self->fft_max_deviation = 0.0;
+
+    /*  Only set by the Newton methods.                                       */
+    self->newton_iterations = 0UL;
+    self->newton_samples = 0UL;
+    self->newton_warm_samples = 0UL;
+
     /*  Extract the inputs and keywords supplied by the user. If the data     *
      *  cannot be extracted, raise a type error and return to caller. A short *
      *  explaination of PyArg_ParseTupleAndKeywords. The inputs args and kwds *
@@ -137,14 +177,21 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
      *  symbold means everything after is optional. s is a string, p is a     *
      *  Boolean (p for "predicate"). b is an integer, and the colon : denotes *
      *  that the input list has ended.                                        */
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Od$OsppppdsdddO:", kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds,
+                                     "|Od$OsppppdsdddOIppppd:", kwlist,
                                      &DLPInst,          &self->input_res,
                                      &rngreq,           &self->wtype,
                                      &self->use_fwd,    &self->use_norm,
                                      &self->verbose,    &self->bfac,
                                      &self->sigma,      &self->psitype,
                                      &self->res_factor, &self->ecc,
-                                     &self->peri,       &perturb))
+                                     &self->peri,       &perturb,
+                                     &self->num_threads,
+                                     &self->use_window_cache,
+                                     &self->use_simd,
+                                     &self->use_warm_start,
+                                     &self->use_fused,
+                                     &self->interp_tol))
     {
         PyErr_Format(
             PyExc_TypeError,
@@ -167,9 +214,26 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
             "\r\tecc       \tEccentricity of rings (bool).\n"
             "\r\tperi      \tPeriapse of rings (bool).\n"
             "\r\tperturb   \tRequested perturbation to Fresnel kernel (list).\n"
+            "\r\tnum_threads\tNumber of reconstruction threads (int).\n"
+            "\r\tuse_window_cache\tUse cached window tables (bool).\n"
+            "\r\tuse_simd  \tUse SIMD Fresnel kernels (bool).\n"
+            "\r\tuse_warm_start\tStart Newton from the last center (bool).\n"
+            "\r\tuse_fused \tForward model in the same pass (bool).\n"
+            "\r\tinterp_tol\tKernel error allowed by \"adaptive\" (float).\n"
         );
-        return -1;
+        return NULL;
+    }
+
+    /*  The range request is kept until the keywords dictionary is built.     */
+    if (rngreq == NULL)
+    {
+        rngreq = PyUnicode_FromString("all");
+
+        if (rngreq == NULL)
+            return NULL;
     }
+    else
+        Py_INCREF(rngreq);
 
     if (self->verbose)
     {
@@ -192,7 +256,8 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
             "\rFailed to pass variables to C. rssringoccs_Py_DLP_To_C_DLP\n"
             "\rreturned NULL. Returning.\n\n"
         );
-        return -1;
+        Py_DECREF(rngreq);
+        return NULL;
     }
 
     if (dlp->error_occurred)
@@ -214,15 +279,38 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
             free(dlp->error_message);
         }
         free(dlp);
-        return -1;
+        Py_DECREF(rngreq);
+        return NULL;
     }
 
     /*  If verbose was set, print a status update.                            */
     if (self->verbose)
         puts("\tDiffraction Correction: Creating C Tau object...");
 
+    /*  The reconstruction runs with the GIL released, possibly on another    *
+     *  thread, while other Python code may write to the numpy arrays of the  *
+     *  input DLP. The Tau object copies the data, rather than borrowing it   *
+     *  with rssringoccs_Tau_Create_From_DLP_Borrowed, so it never reads them *
+     *  after this call.                                                      */
     tau = rssringoccs_Tau_Create_From_DLP(dlp, self->input_res * self->res_factor);
 
+    /*  The Tau object has its own copy of the data. This does not free the   *
+     *  data from the input DLP PyObject, which is still available.           */
+    free(dlp);
+
+    if (tau == NULL)
+    {
+        PyErr_Format(
+            PyExc_RuntimeError,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\tdiffrec.DiffractionCorrection\n\n"
+            "\rrssringoccs_Create_TAUObj returned NULL for tau. Returning.\n\n"
+        );
+
+        Py_DECREF(rngreq);
+        return NULL;
+    }
+
     if (self->verbose)
         puts("\tDiffraction Correction: Passing Py variables to tau...");
 
@@ -233,28 +321,25 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
     rssringoccs_Tau_Set_Window_Type(self->wtype, tau);
     rssringoccs_Tau_Set_Psi_Type(self->psitype, tau);
 
-    if (self->verbose)
-        puts("\tDiffraction Correction: Running reconstruction...");
+    *dlp_inst = DLPInst;
+    *rng = rngreq;
+    return tau;
+}
 
-    rssringoccs_Reconstruction(tau);
+/*  Passes the result of rssringoccs_Reconstruction to self and frees tau.    *
+ *  Returns -1, with a Python exception set, if the reconstruction failed.    */
+int
+crssringoccs_Diffrec_Finish(PyDiffrecObj *self, rssringoccs_TAUObj *tau,
+                            PyObject *DLPInst, PyObject *rngreq)
+{
+    PyObject *tmp;
+    PyObject *dlp_tmp;
 
     if (self->verbose)
         puts("\tDiffraction Correction: Converting C tau to Py tau...");
 
     crssringoccs_C_Tau_To_Py_Tau(self, tau);
 
-    if (tau == NULL)
-    {
-        PyErr_Format(
-            PyExc_RuntimeError,
-            "\n\rError Encountered: rss_ringoccs\n"
-            "\r\tdiffrec.DiffractionCorrection\n\n"
-            "\rrssringoccs_Create_TAUObj returned NULL for tau. Returning.\n\n"
-        );
-
-        return -1;
-    }
-
     if (tau->error_occurred)
     {
         if (tau->error_message == NULL)
@@ -278,10 +363,6 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
      *  data is still available in self.                                      */
     free(tau);
 
-    /*  Similarly, we free the DLP. This does not free the data from the      *
-     *  input DLP PyObject. Those are also still available.                   */
-    free(dlp);
-
     if (self->verbose)
         puts("\tDiffraction Correction: Building arguments dictionary...");
 
@@ -322,3 +403,31 @@ int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
     return 1;
 }
 
+/*  The init function for the dirrection correction class. This is the        *
+ *  equivalent of the __init__ function defined in a normal python class.     */
+int Diffrec_init(PyDiffrecObj *self, PyObject *args, PyObject *kwds)
+{
+    rssringoccs_TAUObj *tau;
+    PyObject *DLPInst;
+    PyObject *rngreq;
+    int status;
+
+    tau = crssringoccs_Diffrec_Setup(self, args, kwds, &DLPInst, &rngreq);
+
+    if (tau == NULL)
+        return -1;
+
+    if (self->verbose)
+        puts("\tDiffraction Correction: Running reconstruction...");
+
+    /*  crssringoccs_Diffrec_Setup copied the DLP data into the Tau object,   *
+     *  which does not reference any Python object. The GIL is released and   *
+     *  other Python threads may run during the reconstruction.               */
+    Py_BEGIN_ALLOW_THREADS
+    rssringoccs_Reconstruction(tau);
+    Py_END_ALLOW_THREADS
+
+    status = crssringoccs_Diffrec_Finish(self, tau, DLPInst, rngreq);
+    Py_DECREF(rngreq);
+    return status;
+}
@@ -0,0 +1,186 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                     Multi-Band Diffraction Correction                      *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides reconstruct_multi_band, which reconstructs the DLPs of the   *
+ *      bands of one occultation with one call to                             *
+ *      rssringoccs_Reconstruction_Multi_Band.                                *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  reconstruct_multi_band(dlps, res, **kwds) takes a sequence of DLPs in     *
+ *  place of dlp, and otherwise the arguments of DiffractionCorrection, which *
+ *  apply to every band. It returns a list of DiffractionCorrection           *
+ *  instances, one per DLP, in the order given. The stationary azimuth angles *
+ *  are solved for once when the bands allow it, see                          *
+ *  rssringoccs_Reconstruction_Multi_Band. The GIL is released while the      *
+ *  reconstructions run.                                                      *
+ ******************************************************************************/
+
+/*  free and malloc are found here.                                           */
+#include <stdlib.h>
+
+/*  Function prototype and typedefs for structs given here.                   */
+#include "../crssringoccs.h"
+
+/*  A band between crssringoccs_Diffrec_Setup and Finish.                     */
+typedef struct crssringoccs_Band_Def {
+    PyDiffrecObj *diffrec;
+    PyObject *setup_args;
+    PyObject *dlp_inst;
+    PyObject *rngreq;
+} crssringoccs_Band;
+
+/*  Frees the bands that were set up but not finished.                        */
+static void
+crssringoccs_Multi_Band_Free(crssringoccs_Band *bands,
+                             rssringoccs_TAUObj **taus,
+                             Py_ssize_t n_bands)
+{
+    Py_ssize_t n;
+
+    for (n = 0; n < n_bands; ++n)
+    {
+        if (taus[n] != NULL)
+        {
+            rssringoccs_Tau_Destroy(&taus[n]);
+            Py_XDECREF(bands[n].rngreq);
+        }
+
+        Py_XDECREF(bands[n].diffrec);
+        Py_XDECREF(bands[n].setup_args);
+    }
+
+    free(bands);
+    free(taus);
+}
+
+/*  Module level function. Takes the arguments of DiffractionCorrection,      *
+ *  with a sequence of DLPs.                                                  */
+PyObject *
+crssringoccs_Reconstruct_Multi_Band(PyObject *module,
+                                    PyObject *args,
+                                    PyObject *kwds)
+{
+    PyObject *py_dlps, *py_res, *dlps_seq, *out;
+    crssringoccs_Band *bands;
+    rssringoccs_TAUObj **taus;
+    Py_ssize_t n, n_bands;
+    (void)module;
+
+    if (!PyArg_UnpackTuple(args, "reconstruct_multi_band", 2, 2,
+                           &py_dlps, &py_res))
+        return NULL;
+
+    dlps_seq = PySequence_Fast(py_dlps, "dlps must be a sequence of DLPs.");
+
+    if (dlps_seq == NULL)
+        return NULL;
+
+    n_bands = PySequence_Fast_GET_SIZE(dlps_seq);
+
+    if (n_bands == 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "dlps must not be empty.");
+        Py_DECREF(dlps_seq);
+        return NULL;
+    }
+
+    bands = malloc(sizeof(*bands) * (size_t)n_bands);
+    taus = malloc(sizeof(*taus) * (size_t)n_bands);
+
+    if (bands == NULL || taus == NULL)
+    {
+        free(bands);
+        free(taus);
+        Py_DECREF(dlps_seq);
+        return PyErr_NoMemory();
+    }
+
+    for (n = 0; n < n_bands; ++n)
+    {
+        bands[n].diffrec = NULL;
+        bands[n].setup_args = NULL;
+        bands[n].dlp_inst = NULL;
+        bands[n].rngreq = NULL;
+        taus[n] = NULL;
+    }
+
+    /*  Each Tau object is built as DiffractionCorrection(dlp, res, ...)      *
+     *  would build it. The argument tuples are kept until Finish, since the  *
+     *  instances refer to them.                                              */
+    for (n = 0; n < n_bands; ++n)
+    {
+        bands[n].setup_args = PyTuple_Pack(
+            2, PySequence_Fast_GET_ITEM(dlps_seq, n), py_res
+        );
+
+        bands[n].diffrec = (PyDiffrecObj *)PyType_GenericNew(&DiffrecType,
+                                                             NULL, NULL);
+
+        if (bands[n].setup_args == NULL || bands[n].diffrec == NULL)
+            break;
+
+        taus[n] = crssringoccs_Diffrec_Setup(bands[n].diffrec,
+                                             bands[n].setup_args, kwds,
+                                             &bands[n].dlp_inst,
+                                             &bands[n].rngreq);
+
+        if (taus[n] == NULL)
+            break;
+    }
+
+    if (n < n_bands)
+    {
+        crssringoccs_Multi_Band_Free(bands, taus, n_bands);
+        Py_DECREF(dlps_seq);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    rssringoccs_Reconstruction_Multi_Band(taus, (size_t)n_bands);
+    Py_END_ALLOW_THREADS
+
+    out = PyList_New(n_bands);
+
+    /*  Finish frees the Tau object whether or not it succeeds.               */
+    for (n = 0; out != NULL && n < n_bands; ++n)
+    {
+        rssringoccs_TAUObj *tau = taus[n];
+        taus[n] = NULL;
+
+        if (crssringoccs_Diffrec_Finish(bands[n].diffrec, tau,
+                                        bands[n].dlp_inst,
+                                        bands[n].rngreq) < 0)
+            Py_CLEAR(out);
+        else
+        {
+            PyList_SET_ITEM(out, n, (PyObject *)bands[n].diffrec);
+            bands[n].diffrec = NULL;
+        }
+
+        Py_DECREF(bands[n].rngreq);
+    }
+
+    crssringoccs_Multi_Band_Free(bands, taus, n_bands);
+    Py_DECREF(dlps_seq);
+    return out;
+}
+/*  End of crssringoccs_Reconstruct_Multi_Band.                               */
@@ -45,7 +45,9 @@ int ExtractCSVData_init(PyCSVObj *self, PyObject *args, PyObject *kwds)
     /*  The list of the keywords accepted by the DiffractionCorrection class. *
      *  dlp and res are REQUIRED inputs, the rest are optional. If the user   *
      *  does not provide these optional keywords, we must set them ourselves. */
-    static char *kwlist[] = {"geo", "cal", "dlp", "use_deprecate", "tau", NULL};
+    static char *kwlist[] = {
+        "geo", "cal", "dlp", "use_deprecate", "tau", "cache", NULL
+    };
 
     /*  Python objects needed throughout the computation.                     */
     PyObject *tmp, *csv_tmp;
@@ -53,6 +55,7 @@ int ExtractCSVData_init(PyCSVObj *self, PyObject *args, PyObject *kwds)
     const char *cal_str = NULL;
     const char *dlp_str = NULL;
     const char *tau_str = NULL;
+    const char *cache_str = NULL;
 
     /*  Extract the inputs and keywords supplied by the user. If the data     *
      *  cannot be extracted, raise a type error and return to caller. A short *
@@ -67,8 +70,9 @@ int ExtractCSVData_init(PyCSVObj *self, PyObject *args, PyObject *kwds)
      *  symbold means everything after is optional. s is a string, p is a     *
      *  Boolean (p for "predicate"). b is an integer, and the colon : denotes *
      *  that the input list has ended.                                        */
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sss$ps:", kwlist, &geo_str,
-                                     &cal_str, &dlp_str, &dpr, &tau_str))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sss$pss:", kwlist,
+                                     &geo_str, &cal_str, &dlp_str, &dpr,
+                                     &tau_str, &cache_str))
     {
         PyErr_Format(
             PyExc_TypeError,
@@ -82,11 +86,17 @@ int ExtractCSVData_init(PyCSVObj *self, PyObject *args, PyObject *kwds)
             "\rKeywords:\n"
             "\r\tuse_deprecate: Use the old CSV format.\n"
             "\r\ttau:           Location of a TAU.TAB file (str)\n"
+            "\r\tcache:         Location of a binary cache file (str)\n"
         );
         return -1;
     }
 
-    csv = rssringoccs_Extract_CSV_Data(geo_str, cal_str, dlp_str, tau_str, dpr);
+    csv = rssringoccs_Extract_CSV_Data_Cached(geo_str, cal_str, dlp_str,
+                                              tau_str, dpr, cache_str);
+
+    /*  The numpy arrays free their data when deleted. Columns mapped from    *
+     *  the cache are copied into memory that can be freed this way.          */
+    rssringoccs_Own_CSV_Members(csv);
 
     if (csv == NULL)
     {
@@ -2,6 +2,10 @@ import numpy
 import rss_ringoccs
 from rss_ringoccs.tools import error_check, history
 
+# Psitypes rss_ringoccs.reconstruct_batch can compute in one pass.
+BATCH_PSITYPES = ("fresnel", "newton", "newtond", "newtondold",
+                  "newtondphi", "ellipse")
+
 
 class CompareTau(object):
     def __init__(self, geo, cal, dlp, tau, res, rng='all', wtype="kbmd20",
@@ -128,31 +132,59 @@ class FindOptimalResolution(object):
         self.l2 = numpy.zeros((nres, nwins))
         self.ideal_res = numpy.zeros((nwins))
         eres = sres + (nres-1)*dres
-        res = sres
+        res_list = [sres + i*dres for i in range(nres)]
         data = rss_ringoccs.ExtractCSVData(
             geo, cal, dlp, tau=tau, verbose = verbose
         )
 
-        rec = rss_ringoccs.DiffractionCorrection(
-            data, res, rng = rng, wtype="kb35"
-        )
+        # The Fresnel kernel of these psitypes does not depend on the window,
+        # so every resolution and window type is reconstructed in one pass.
+        if psitype.replace(" ", "").lower() in BATCH_PSITYPES:
+            batch = rss_ringoccs.reconstruct_batch(
+                data, res_list, wlst, rng = rng, use_norm = norm,
+                bfac = bfac, sigma = sigma, psitype = psitype,
+                res_factor = res_factor, verbose = verbose
+            )
+
+            rho = batch["rho_km_vals"]
+            power = numpy.abs(batch["T_out"])**2
+            dx_km = rho[1] - rho[0]
+        else:
+            rho = None
 
-        start = int(numpy.min((data.tau_rho-numpy.min(rec.rho_km_vals)>=0).nonzero()))
-        fin = int(numpy.max((numpy.max(rec.rho_km_vals)-data.tau_rho>=0).nonzero()))
-        tau_power = data.power_vals[start:fin+1]
-        for i in numpy.arange(nres):
+        for i in range(nres):
             for j in range(nwins):
-                wtype = wlst[j]
-                recint = rss.DiffractionCorrection(data, res, rng=rng, wtype=wtype)
-                p_int = numpy.abs(recint.power_vals - tau_power)
+                if rho is None:
+                    recint = rss_ringoccs.DiffractionCorrection(
+                        data, res_list[i], rng = rng, wtype = wlst[j],
+                        use_norm = norm, bfac = bfac, sigma = sigma,
+                        psitype = psitype, res_factor = res_factor
+                    )
+
+                    rec_rho = recint.rho_km_vals
+                    rec_power = recint.power_vals
+                    dx_km = recint.dx_km
+                else:
+                    rec_rho = rho
+                    rec_power = power[i, j]
+
+                start = int(numpy.min(
+                    (data.tau_rho-numpy.min(rec_rho)>=0).nonzero()
+                ))
+
+                fin = int(numpy.max(
+                    (numpy.max(rec_rho)-data.tau_rho>=0).nonzero()
+                ))
+
+                tau_power = data.power_vals[start:fin+1]
+                p_int = numpy.abs(rec_power - tau_power)
                 self.linf[i,j] = numpy.max(p_int)
-                self.l2[i,j] = numpy.sqrt(numpy.sum(p_int*p_int)*recint.dx_km)
+                self.l2[i,j] = numpy.sqrt(numpy.sum(p_int*p_int)*dx_km)
 
                 if verbose:
                     print("%s %f %s %f %s %s"
-                          % ('Res:',res,'Max:',eres,"WTYPE:",wtype))
+                          % ('Res:',res_list[i],'Max:',eres,"WTYPE:",wlst[j]))
 
-            res += dres
         self.ideal_res = sres+dres*numpy.argmin(self.linf, axis=0)
 
 
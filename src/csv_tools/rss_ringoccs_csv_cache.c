@@ -0,0 +1,611 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Keeps the result of rssringoccs_Extract_CSV_Data in a binary file so  *
+ *      that later loads of the same TAB files need no parsing.               *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The cache file starts with a header giving the version, the number of     *
+ *  points, the name and offset of every column, and for each of the GEO,     *
+ *  CAL, DLP, and TAU files its size, modification time, and checksum. The    *
+ *  columns follow as arrays of doubles, each starting on a multiple of       *
+ *  RSSRINGOCCS_CSV_CACHE_ALIGN bytes. A missing column, such as the TAU data *
+ *  when no TAU file was given, has an offset of zero.                        *
+ *                                                                            *
+ *  The file is written in the byte order and type sizes of the machine, and  *
+ *  the header records these, so a cache made elsewhere is simply rebuilt.    *
+ *  It is written to a temporary file and renamed, so a reader never sees a   *
+ *  partial cache.                                                            *
+ *                                                                            *
+ *  On loading, the file is mapped and the columns of the CSV object point    *
+ *  into it. A source file whose size differs invalidates the cache. If only  *
+ *  the modification time differs, as after a copy, the source is checksummed *
+ *  and the cache is used if the checksum is unchanged. The new modification  *
+ *  time is then written to the header, so the next load need not checksum    *
+ *  the source again. Only these times are rewritten in place. A reader that  *
+ *  sees some of them updated simply checksums the others.                    *
+ ******************************************************************************/
+
+/*  stat is used on POSIX systems. Request the POSIX declarations before any  *
+ *  system header is included.                                                */
+#if defined(__unix__) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+/*  Booleans and tmpl_strdup are found here.                                  */
+#include <libtmpl/include/tmpl.h>
+
+/*  Typedefs for CSV structs and function prototypes given here.              */
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+
+/*  offsetof is found here.                                                   */
+#include <stddef.h>
+
+/*  malloc and free are found here.                                           */
+#include <stdlib.h>
+
+/*  fopen, fseek, fwrite, rename, and remove are found here.                  */
+#include <stdio.h>
+
+/*  memcmp, memcpy, memset, strcat, strcpy, and strlen are found here.        */
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#define RSSRINGOCCS_CSV_CACHE_HAS_STAT 1
+#else
+#define RSSRINGOCCS_CSV_CACHE_HAS_STAT 0
+#endif
+
+/*  Changed whenever the layout of the file changes.                          */
+#define RSSRINGOCCS_CSV_CACHE_VERSION (1UL)
+
+/*  Written as an unsigned long to tell the byte order of the machine.        */
+#define RSSRINGOCCS_CSV_CACHE_BYTE_ORDER (0x01020304UL)
+
+/*  The columns start on multiples of this many bytes.                        */
+#define RSSRINGOCCS_CSV_CACHE_ALIGN (64)
+
+/*  Number of columns of a rssringoccs_CSVData object.                        */
+#define RSSRINGOCCS_CSV_CACHE_COLUMNS (22)
+
+/*  Room for the name of a column, with the null terminator.                  */
+#define RSSRINGOCCS_CSV_CACHE_NAME_SIZE (32)
+
+/*  The GEO, CAL, DLP, and TAU files, in that order.                          */
+#define RSSRINGOCCS_CSV_CACHE_SOURCES (4)
+
+static const char
+rssringoccs_csv_cache_magic[8] = {'R', 'S', 'S', 'C', 'S', 'V', '\0', '\0'};
+
+/*  Names of the columns, in the order of rssringoccs_CSV_Cache_Members.      */
+static const char *const
+rssringoccs_csv_cache_names[RSSRINGOCCS_CSV_CACHE_COLUMNS] = {
+    "B_deg_vals", "D_km_vals", "f_sky_hz_vals", "p_norm_vals",
+    "raw_tau_vals", "phase_deg_vals", "phi_deg_vals", "phi_rl_deg_vals",
+    "raw_tau_threshold_vals", "rho_corr_pole_km_vals",
+    "rho_corr_timing_km_vals", "rho_dot_kms_vals", "rho_km_vals",
+    "rx_km_vals", "ry_km_vals", "rz_km_vals", "t_oet_spm_vals",
+    "t_ret_spm_vals", "t_set_spm_vals", "tau_phase", "tau_power", "tau_vals"
+};
+
+/*  What the cache knows about a source file. The checksum is only computed   *
+ *  when writing, or when the modification time does not match.               */
+typedef struct rssringoccs_CSV_Cache_Source_Def {
+    size_t size;
+    double mtime;
+    unsigned long checksum;
+    unsigned long is_present;
+} rssringoccs_CSV_Cache_Source;
+
+/*  The start of a cache file.                                                */
+typedef struct rssringoccs_CSV_Cache_Header_Def {
+    char magic[8];
+    unsigned long version;
+    unsigned long byte_order;
+    size_t header_size;
+    size_t double_size;
+    size_t n_elements;
+    size_t n_columns;
+    unsigned long use_deprecated;
+    rssringoccs_CSV_Cache_Source sources[RSSRINGOCCS_CSV_CACHE_SOURCES];
+    char names[RSSRINGOCCS_CSV_CACHE_COLUMNS][RSSRINGOCCS_CSV_CACHE_NAME_SIZE];
+    size_t offsets[RSSRINGOCCS_CSV_CACHE_COLUMNS];
+} rssringoccs_CSV_Cache_Header;
+
+/*  Pointers to the columns of csv, in the order of the names above.          */
+static void
+rssringoccs_CSV_Cache_Members(rssringoccs_CSVData *csv, double **members[])
+{
+    members[0] = &csv->B_deg_vals;
+    members[1] = &csv->D_km_vals;
+    members[2] = &csv->f_sky_hz_vals;
+    members[3] = &csv->p_norm_vals;
+    members[4] = &csv->raw_tau_vals;
+    members[5] = &csv->phase_deg_vals;
+    members[6] = &csv->phi_deg_vals;
+    members[7] = &csv->phi_rl_deg_vals;
+    members[8] = &csv->raw_tau_threshold_vals;
+    members[9] = &csv->rho_corr_pole_km_vals;
+    members[10] = &csv->rho_corr_timing_km_vals;
+    members[11] = &csv->rho_dot_kms_vals;
+    members[12] = &csv->rho_km_vals;
+    members[13] = &csv->rx_km_vals;
+    members[14] = &csv->ry_km_vals;
+    members[15] = &csv->rz_km_vals;
+    members[16] = &csv->t_oet_spm_vals;
+    members[17] = &csv->t_ret_spm_vals;
+    members[18] = &csv->t_set_spm_vals;
+    members[19] = &csv->tau_phase;
+    members[20] = &csv->tau_power;
+    members[21] = &csv->tau_vals;
+}
+/*  End of rssringoccs_CSV_Cache_Members.                                     */
+
+/*  Rounds n up to a multiple of RSSRINGOCCS_CSV_CACHE_ALIGN.                 */
+static size_t rssringoccs_CSV_Cache_Align(size_t n)
+{
+    const size_t align = RSSRINGOCCS_CSV_CACHE_ALIGN;
+    return ((n + align - 1) / align) * align;
+}
+/*  End of rssringoccs_CSV_Cache_Align.                                       */
+
+/*  Sets the size and modification time of a source file. A NULL filename,    *
+ *  the optional TAU file, gives a source that is not present. Returns false  *
+ *  if the file can not be examined.                                          */
+static tmpl_Bool
+rssringoccs_CSV_Cache_Stat(const char *filename,
+                           rssringoccs_CSV_Cache_Source *source)
+{
+    memset(source, 0, sizeof(*source));
+
+    if (filename == NULL)
+        return tmpl_True;
+
+    source->is_present = 1UL;
+
+#if RSSRINGOCCS_CSV_CACHE_HAS_STAT
+    {
+        struct stat info;
+
+        if (stat(filename, &info) != 0)
+            return tmpl_False;
+
+        source->size = (size_t)info.st_size;
+        source->mtime = (double)info.st_mtime;
+    }
+#else
+    {
+        long size;
+        FILE *fp = fopen(filename, "rb");
+
+        if (fp == NULL)
+            return tmpl_False;
+
+        if (fseek(fp, 0L, SEEK_END) != 0 || (size = ftell(fp)) < 0L)
+        {
+            fclose(fp);
+            return tmpl_False;
+        }
+
+        fclose(fp);
+
+        /*  With no modification time, the checksum decides every time.       */
+        source->size = (size_t)size;
+        source->mtime = -1.0;
+    }
+#endif
+
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_Cache_Stat.                                        */
+
+/*  Computes the 32-bit FNV-1a checksum of a file. Returns false on failure.  */
+static tmpl_Bool
+rssringoccs_CSV_Cache_Checksum(const char *filename, unsigned long *checksum)
+{
+    rssringoccs_CSV_File file;
+    size_t n;
+    unsigned long hash = 2166136261UL;
+
+    if (!rssringoccs_CSV_File_Open(&file, filename))
+        return tmpl_False;
+
+    for (n = 0; n < file.size; ++n)
+    {
+        hash ^= (unsigned long)(unsigned char)file.data[n];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    rssringoccs_CSV_File_Close(&file);
+    *checksum = hash;
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_Cache_Checksum.                                    */
+
+/*  Checks the header of a mapped cache file against the inputs. Returns      *
+ *  true if the columns in the file may be used. *is_stale is set if a source *
+ *  was only accepted by its checksum, its modification time having changed.  */
+static tmpl_Bool
+rssringoccs_CSV_Cache_Is_Valid(const rssringoccs_CSV_File *file,
+                               const char *const *filenames,
+                               const rssringoccs_CSV_Cache_Source *sources,
+                               tmpl_Bool use_deprecated,
+                               tmpl_Bool *is_stale)
+{
+    const rssringoccs_CSV_Cache_Header *header;
+    const rssringoccs_CSV_Cache_Source *cached;
+    unsigned long checksum;
+    size_t n, column_size;
+
+    *is_stale = tmpl_False;
+
+    if (file->size < sizeof(*header))
+        return tmpl_False;
+
+    header = (const rssringoccs_CSV_Cache_Header *)(const void *)file->data;
+
+    if (memcmp(header->magic, rssringoccs_csv_cache_magic, 8) != 0 ||
+        header->version != RSSRINGOCCS_CSV_CACHE_VERSION ||
+        header->byte_order != RSSRINGOCCS_CSV_CACHE_BYTE_ORDER ||
+        header->header_size != sizeof(*header) ||
+        header->double_size != sizeof(double) ||
+        header->n_columns != RSSRINGOCCS_CSV_CACHE_COLUMNS ||
+        header->use_deprecated != (use_deprecated ? 1UL : 0UL) ||
+        header->n_elements == 0)
+        return tmpl_False;
+
+    /*  Every column must lie inside the file and be aligned.                 */
+    column_size = sizeof(double) * header->n_elements;
+
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_COLUMNS; ++n)
+    {
+        if (header->offsets[n] == 0)
+            continue;
+
+        if (header->offsets[n] % RSSRINGOCCS_CSV_CACHE_ALIGN != 0 ||
+            header->offsets[n] > file->size ||
+            file->size - header->offsets[n] < column_size)
+            return tmpl_False;
+    }
+
+    /*  The sources must be the files the cache was made from.                */
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_SOURCES; ++n)
+    {
+        cached = &header->sources[n];
+
+        if (cached->is_present != sources[n].is_present)
+            return tmpl_False;
+
+        if (!sources[n].is_present)
+            continue;
+
+        if (cached->size != sources[n].size)
+            return tmpl_False;
+
+        /*  A time of -1 means there is none, and the checksum decides.       */
+        if (cached->mtime == sources[n].mtime && sources[n].mtime >= 0.0)
+            continue;
+
+        if (!rssringoccs_CSV_Cache_Checksum(filenames[n], &checksum) ||
+            checksum != cached->checksum)
+            return tmpl_False;
+
+        if (sources[n].mtime >= 0.0)
+            *is_stale = tmpl_True;
+    }
+
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_Cache_Is_Valid.                                    */
+
+/*  Writes the modification times of the sources into the header of the       *
+ *  cache file, keeping the sizes and checksums it has. Failing to do so only *
+ *  means the sources are checksummed again on the next load.                 */
+static void
+rssringoccs_CSV_Cache_Touch(const char *cache,
+                            const rssringoccs_CSV_Cache_Header *header,
+                            const rssringoccs_CSV_Cache_Source *sources)
+{
+    rssringoccs_CSV_Cache_Source updated[RSSRINGOCCS_CSV_CACHE_SOURCES];
+    const size_t offset = offsetof(rssringoccs_CSV_Cache_Header, sources);
+    FILE *fp;
+    size_t n;
+
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_SOURCES; ++n)
+    {
+        updated[n] = header->sources[n];
+        updated[n].mtime = sources[n].mtime;
+    }
+
+    fp = fopen(cache, "r+b");
+
+    if (fp == NULL)
+        return;
+
+    if (fseek(fp, (long)offset, SEEK_SET) == 0)
+        fwrite(updated, sizeof(updated), 1, fp);
+
+    fclose(fp);
+}
+/*  End of rssringoccs_CSV_Cache_Touch.                                       */
+
+/*  Maps the cache file and points the columns of a new CSV object into it.   *
+ *  Returns NULL if the cache is missing, out of date, or can not be used.    */
+static rssringoccs_CSVData *
+rssringoccs_CSV_Cache_Load(const char *cache,
+                           const char *const *filenames,
+                           const rssringoccs_CSV_Cache_Source *sources,
+                           tmpl_Bool use_deprecated)
+{
+    rssringoccs_CSV_File file;
+    const rssringoccs_CSV_Cache_Header *header;
+    rssringoccs_CSVData *csv;
+    double **members[RSSRINGOCCS_CSV_CACHE_COLUMNS];
+    tmpl_Bool is_stale;
+    size_t n;
+
+    if (!rssringoccs_CSV_File_Open(&file, cache))
+        return NULL;
+
+    if (!rssringoccs_CSV_Cache_Is_Valid(&file, filenames, sources,
+                                        use_deprecated, &is_stale))
+    {
+        rssringoccs_CSV_File_Close(&file);
+        return NULL;
+    }
+
+    header = (const rssringoccs_CSV_Cache_Header *)(const void *)file.data;
+
+    /*  Only the header changes, and the columns mapped below are the same.   */
+    if (is_stale)
+        rssringoccs_CSV_Cache_Touch(cache, header, sources);
+
+    csv = malloc(sizeof(*csv));
+
+    if (csv == NULL)
+    {
+        rssringoccs_CSV_File_Close(&file);
+        return NULL;
+    }
+
+    rssringoccs_CSV_Cache_Members(csv, members);
+
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_COLUMNS; ++n)
+    {
+        if (header->offsets[n] == 0)
+            *members[n] = NULL;
+        else
+            *members[n] = (double *)(void *)(file.data + header->offsets[n]);
+    }
+
+    csv->n_elements = header->n_elements;
+    csv->error_occurred = tmpl_False;
+    csv->error_message = NULL;
+    csv->cache = file;
+    return csv;
+}
+/*  End of rssringoccs_CSV_Cache_Load.                                        */
+
+/*  Writes size bytes of data to fp, followed by zeros up to a multiple of    *
+ *  RSSRINGOCCS_CSV_CACHE_ALIGN. Returns false on failure.                    */
+static tmpl_Bool
+rssringoccs_CSV_Cache_Write_Block(FILE *fp, const void *data, size_t size)
+{
+    static const char zeros[RSSRINGOCCS_CSV_CACHE_ALIGN] = {0};
+    const size_t padding = rssringoccs_CSV_Cache_Align(size) - size;
+
+    if (fwrite(data, 1, size, fp) != size)
+        return tmpl_False;
+
+    return (fwrite(zeros, 1, padding, fp) == padding);
+}
+/*  End of rssringoccs_CSV_Cache_Write_Block.                                 */
+
+/*  Writes the columns of csv to the cache file. Failures leave no cache.     */
+static void
+rssringoccs_CSV_Cache_Write(const char *cache,
+                            rssringoccs_CSVData *csv,
+                            const char *const *filenames,
+                            const rssringoccs_CSV_Cache_Source *sources,
+                            tmpl_Bool use_deprecated)
+{
+    rssringoccs_CSV_Cache_Header header;
+    double **members[RSSRINGOCCS_CSV_CACHE_COLUMNS];
+    char *temp_name;
+    FILE *fp;
+    size_t n, offset;
+    tmpl_Bool written;
+    const size_t column_size = sizeof(double) * csv->n_elements;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, rssringoccs_csv_cache_magic, 8);
+    header.version = RSSRINGOCCS_CSV_CACHE_VERSION;
+    header.byte_order = RSSRINGOCCS_CSV_CACHE_BYTE_ORDER;
+    header.header_size = sizeof(header);
+    header.double_size = sizeof(double);
+    header.n_elements = csv->n_elements;
+    header.n_columns = RSSRINGOCCS_CSV_CACHE_COLUMNS;
+    header.use_deprecated = (use_deprecated ? 1UL : 0UL);
+
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_SOURCES; ++n)
+    {
+        header.sources[n] = sources[n];
+
+        if (sources[n].is_present &&
+            !rssringoccs_CSV_Cache_Checksum(filenames[n],
+                                            &header.sources[n].checksum))
+            return;
+    }
+
+    rssringoccs_CSV_Cache_Members(csv, members);
+    offset = rssringoccs_CSV_Cache_Align(sizeof(header));
+
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_COLUMNS; ++n)
+    {
+        strcpy(header.names[n], rssringoccs_csv_cache_names[n]);
+
+        if (*members[n] != NULL)
+        {
+            header.offsets[n] = offset;
+            offset += rssringoccs_CSV_Cache_Align(column_size);
+        }
+    }
+
+    temp_name = malloc(strlen(cache) + 5);
+
+    if (temp_name == NULL)
+        return;
+
+    strcpy(temp_name, cache);
+    strcat(temp_name, ".tmp");
+    fp = fopen(temp_name, "wb");
+
+    if (fp == NULL)
+    {
+        free(temp_name);
+        return;
+    }
+
+    written = rssringoccs_CSV_Cache_Write_Block(fp, &header, sizeof(header));
+
+    for (n = 0; written && n < RSSRINGOCCS_CSV_CACHE_COLUMNS; ++n)
+    {
+        if (*members[n] != NULL)
+            written = rssringoccs_CSV_Cache_Write_Block(fp, *members[n],
+                                                        column_size);
+    }
+
+    if (fclose(fp) != 0)
+        written = tmpl_False;
+
+    /*  Some systems do not rename onto an existing file. Remove it first.    */
+    if (written && rename(temp_name, cache) != 0)
+    {
+        remove(cache);
+        written = (rename(temp_name, cache) == 0);
+    }
+
+    if (!written)
+        remove(temp_name);
+
+    free(temp_name);
+}
+/*  End of rssringoccs_CSV_Cache_Write.                                       */
+
+rssringoccs_CSVData *
+rssringoccs_Extract_CSV_Data_Cached(const char *geo,
+                                    const char *cal,
+                                    const char *dlp,
+                                    const char *tau,
+                                    tmpl_Bool use_deprecated,
+                                    const char *cache)
+{
+    rssringoccs_CSVData *csv;
+    rssringoccs_CSV_Cache_Source sources[RSSRINGOCCS_CSV_CACHE_SOURCES];
+    const char *filenames[RSSRINGOCCS_CSV_CACHE_SOURCES];
+    tmpl_Bool have_sources = tmpl_True;
+    size_t n;
+
+    if (cache == NULL)
+        return rssringoccs_Extract_CSV_Data(geo, cal, dlp, tau,
+                                            use_deprecated);
+
+    filenames[0] = geo;
+    filenames[1] = cal;
+    filenames[2] = dlp;
+    filenames[3] = tau;
+
+    /*  The optional TAU file is the only one that may be NULL.               */
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_SOURCES; ++n)
+    {
+        if ((filenames[n] == NULL && n < 3) ||
+            !rssringoccs_CSV_Cache_Stat(filenames[n], &sources[n]))
+            have_sources = tmpl_False;
+    }
+
+    /*  If a source can not be examined, parsing it will report why.          */
+    if (have_sources)
+    {
+        csv = rssringoccs_CSV_Cache_Load(cache, filenames,
+                                         sources, use_deprecated);
+
+        if (csv != NULL)
+            return csv;
+    }
+
+    csv = rssringoccs_Extract_CSV_Data(geo, cal, dlp, tau, use_deprecated);
+
+    if (have_sources && csv != NULL && !csv->error_occurred)
+        rssringoccs_CSV_Cache_Write(cache, csv, filenames,
+                                    sources, use_deprecated);
+
+    return csv;
+}
+/*  End of rssringoccs_Extract_CSV_Data_Cached.                               */
+
+void rssringoccs_Own_CSV_Members(rssringoccs_CSVData *csv)
+{
+    double **members[RSSRINGOCCS_CSV_CACHE_COLUMNS];
+    double *copies[RSSRINGOCCS_CSV_CACHE_COLUMNS];
+    size_t n, m, column_size;
+
+    if (csv == NULL || csv->cache.data == NULL)
+        return;
+
+    column_size = sizeof(double) * csv->n_elements;
+    rssringoccs_CSV_Cache_Members(csv, members);
+
+    /*  Copy every column before changing any, so a failure leaves csv as it  *
+     *  was.                                                                  */
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_COLUMNS; ++n)
+    {
+        copies[n] = NULL;
+
+        if (*members[n] == NULL)
+            continue;
+
+        copies[n] = malloc(column_size);
+
+        if (copies[n] == NULL)
+        {
+            for (m = 0; m < n; ++m)
+                free(copies[m]);
+
+            csv->error_occurred = tmpl_True;
+            csv->error_message = tmpl_strdup(
+                "Error Encountered: rss_ringoccs\n"
+                "\trssringoccs_Own_CSV_Members\n\n"
+                "Malloc returned NULL. Failed to allocate memory for\n"
+                "the columns. Aborting computation and returning.\n"
+            );
+            return;
+        }
+
+        memcpy(copies[n], *members[n], column_size);
+    }
+
+    for (n = 0; n < RSSRINGOCCS_CSV_CACHE_COLUMNS; ++n)
+        *members[n] = copies[n];
+
+    rssringoccs_CSV_File_Close(&csv->cache);
+}
+/*  End of rssringoccs_Own_CSV_Members.                                       */
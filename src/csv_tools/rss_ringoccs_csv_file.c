@@ -0,0 +1,148 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Maps a file into memory, or reads it whole where mmap is missing.     *
+ ******************************************************************************/
+
+/*  mmap is used on POSIX systems. Request the POSIX declarations before any  *
+ *  system header is included.                                                */
+#if defined(__unix__) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+/*  Booleans are found here.                                                  */
+#include <libtmpl/include/tmpl.h>
+
+/*  rssringoccs_CSV_File typedef here, and function prototypes given.         */
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+
+/*  malloc and free are found here.                                           */
+#include <stdlib.h>
+
+/*  fopen, fread, and ftell are found here.                                   */
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define RSSRINGOCCS_CSV_FILE_HAS_MMAP 1
+#else
+#define RSSRINGOCCS_CSV_FILE_HAS_MMAP 0
+#endif
+
+tmpl_Bool
+rssringoccs_CSV_File_Open(rssringoccs_CSV_File *file, const char *filename)
+{
+    FILE *fp;
+    long size;
+
+    file->data = NULL;
+    file->size = 0;
+    file->is_mapped = tmpl_False;
+
+#if RSSRINGOCCS_CSV_FILE_HAS_MMAP
+    {
+        struct stat info;
+        void *map;
+        int fd = open(filename, O_RDONLY);
+
+        if (fd < 0)
+            return tmpl_False;
+
+        if (fstat(fd, &info) != 0)
+        {
+            close(fd);
+            return tmpl_False;
+        }
+
+        /*  Empty files can not be mapped. They have no data anyway.          */
+        if (info.st_size == 0)
+        {
+            close(fd);
+            return tmpl_True;
+        }
+
+        /*  The mapping is private, so writes to it are never seen in the     *
+         *  file. They are allowed since callers may hand the data out.       */
+        map = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (map != MAP_FAILED)
+        {
+            file->data = map;
+            file->size = (size_t)info.st_size;
+            file->is_mapped = tmpl_True;
+            return tmpl_True;
+        }
+    }
+#endif
+
+    /*  Either mmap is not available or it failed. Read the whole file.       */
+    fp = fopen(filename, "rb");
+
+    if (fp == NULL)
+        return tmpl_False;
+
+    if (fseek(fp, 0L, SEEK_END) != 0 || (size = ftell(fp)) < 0L)
+    {
+        fclose(fp);
+        return tmpl_False;
+    }
+
+    rewind(fp);
+    file->size = (size_t)size;
+
+    if (file->size > 0)
+    {
+        file->data = malloc(file->size);
+
+        if (file->data == NULL ||
+            fread(file->data, 1, file->size, fp) != file->size)
+        {
+            free(file->data);
+            file->data = NULL;
+            fclose(fp);
+            return tmpl_False;
+        }
+    }
+
+    fclose(fp);
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_File_Open.                                         */
+
+void rssringoccs_CSV_File_Close(rssringoccs_CSV_File *file)
+{
+#if RSSRINGOCCS_CSV_FILE_HAS_MMAP
+    if (file->is_mapped)
+        munmap(file->data, file->size);
+    else
+        free(file->data);
+#else
+    free(file->data);
+#endif
+
+    file->data = NULL;
+    file->size = 0;
+}
+/*  End of rssringoccs_CSV_File_Close.                                        */
@@ -0,0 +1,387 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                        Multi-Column Interpolation                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Interpolates several columns sampled at the same points onto a new    *
+ *      set of points, finding each interval and its weights only once.       *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  Every method writes the value at a point x_out in the interval from x[j]  *
+ *  to x[j+1] as                                                              *
+ *                                                                            *
+ *      w0 y[j] + w1 y[j+1] + w2 s[j] + w3 s[j+1]                             *
+ *                                                                            *
+ *  where the weights depend only on x and x_out, and s is a second column    *
+ *  found from each y once, before any point is computed. For the natural     *
+ *  cubic spline s holds the second derivatives at the points, and for the    *
+ *  monotone method, the Fritsch-Carlson slopes used by PCHIP. The linear     *
+ *  method has no s.                                                          *
+ *                                                                            *
+ *  The output is done RSSRINGOCCS_CSV_INTERP_BLOCK points at a time. The     *
+ *  intervals and weights of a block are found and kept on the stack, and     *
+ *  are then used for every column in turn, so each column is written in one  *
+ *  sweep while the weights stay in cache. Intervals are searched for from    *
+ *  the last one found, so output sorted in either direction costs O(1) per   *
+ *  point, and any other order O(log n_pts). With OpenMP, blocks are done in  *
+ *  parallel once there are at least RSSRINGOCCS_CSV_INTERP_PARALLEL_MIN      *
+ *  values to compute.                                                        *
+ ******************************************************************************/
+
+/*  Booleans found here.                                                      */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototype and rssringoccs_Interp_Enum given here.                */
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+
+/*  malloc and free are found here.                                           */
+#include <stdlib.h>
+
+/*  Number of output points whose weights are found together.                 */
+#define RSSRINGOCCS_CSV_INTERP_BLOCK (256)
+
+/*  Fewer values than this, output points times columns, are done by one      *
+ *  thread.                                                                   */
+#ifndef RSSRINGOCCS_CSV_INTERP_PARALLEL_MIN
+#define RSSRINGOCCS_CSV_INTERP_PARALLEL_MIN (262144)
+#endif
+
+/*  Index j of the interval from x[j] to x[j+1] holding x0, searched for      *
+ *  from the interval last, which is checked first along with its two         *
+ *  neighbors. Points outside of x get the first or last interval.            */
+static size_t
+rssringoccs_CSV_Interp_Find(const double *x, size_t n_pts,
+                            double x0, size_t last)
+{
+    size_t low, high, mid;
+
+    if (x[last] <= x0 && x0 <= x[last + 1])
+        return last;
+
+    if (last + 2 < n_pts && x[last + 1] <= x0 && x0 <= x[last + 2])
+        return last + 1;
+
+    if (last > 0 && x[last - 1] <= x0 && x0 <= x[last])
+        return last - 1;
+
+    if (x0 >= x[n_pts - 1])
+        return n_pts - 2;
+
+    low = 0;
+    high = n_pts - 1;
+
+    while (high - low > 1)
+    {
+        mid = low + (high - low) / 2;
+
+        if (x[mid] <= x0)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+/*  End of rssringoccs_CSV_Interp_Find.                                       */
+
+/*  The second derivatives of the natural cubic spline through x and y, zero  *
+ *  at the ends, solve a tridiagonal system, done with the Thomas algorithm.  *
+ *  The factors c and inv of its elimination depend only on x, and are        *
+ *  shared by all columns.                                                    */
+static void
+rssringoccs_CSV_Spline_Factor(const double *x, size_t n_pts,
+                              double *c, double *inv)
+{
+    size_t n;
+    double h_left, h_right, denom;
+
+    for (n = 1; n + 1 < n_pts; ++n)
+    {
+        h_left = x[n] - x[n - 1];
+        h_right = x[n + 1] - x[n];
+        denom = 2.0*(h_left + h_right);
+
+        if (n > 1)
+            denom -= h_left*c[n - 1];
+
+        inv[n] = 1.0 / denom;
+        c[n] = h_right*inv[n];
+    }
+}
+/*  End of rssringoccs_CSV_Spline_Factor.                                     */
+
+/*  Eliminates and back substitutes the system for y, writing the second      *
+ *  derivatives to s.                                                         */
+static void
+rssringoccs_CSV_Spline_Solve(const double *x, const double *y, size_t n_pts,
+                             const double *c, const double *inv, double *s)
+{
+    size_t n;
+    double slope_left, slope_right;
+
+    s[0] = 0.0;
+    s[n_pts - 1] = 0.0;
+
+    for (n = 1; n + 1 < n_pts; ++n)
+    {
+        slope_left = (y[n] - y[n - 1]) / (x[n] - x[n - 1]);
+        slope_right = (y[n + 1] - y[n]) / (x[n + 1] - x[n]);
+        s[n] = 6.0*(slope_right - slope_left);
+
+        if (n > 1)
+            s[n] -= (x[n] - x[n - 1])*s[n - 1];
+
+        s[n] *= inv[n];
+    }
+
+    for (n = n_pts - 2; n > 1; --n)
+        s[n - 1] -= c[n - 1]*s[n];
+}
+/*  End of rssringoccs_CSV_Spline_Solve.                                      */
+
+/*  Slope at an end of the data from the three-point formula, limited so that *
+ *  the interpolant stays monotone, as in PCHIP.                              */
+static double
+rssringoccs_CSV_Pchip_End(double h0, double h1, double del0, double del1)
+{
+    double d = ((2.0*h0 + h1)*del0 - h0*del1) / (h0 + h1);
+
+    if (d*del0 <= 0.0)
+        return 0.0;
+
+    if (del0*del1 <= 0.0 && 9.0*del0*del0 < d*d)
+        return 3.0*del0;
+
+    return d;
+}
+/*  End of rssringoccs_CSV_Pchip_End.                                         */
+
+/*  Fritsch-Carlson slopes of y at x. The slope is zero at a local extremum   *
+ *  of the data, and a weighted harmonic mean of the slopes on either side    *
+ *  otherwise, so the interpolant never overshoots the data.                  */
+static void
+rssringoccs_CSV_Pchip_Slopes(const double *x, const double *y, size_t n_pts,
+                             double *s)
+{
+    size_t n;
+    double h_left, h_right, del_left, del_right, w_left, w_right;
+
+    h_right = x[1] - x[0];
+    del_right = (y[1] - y[0]) / h_right;
+
+    if (n_pts == 2)
+    {
+        s[0] = del_right;
+        s[1] = del_right;
+        return;
+    }
+
+    for (n = 1; n + 1 < n_pts; ++n)
+    {
+        h_left = h_right;
+        del_left = del_right;
+        h_right = x[n + 1] - x[n];
+        del_right = (y[n + 1] - y[n]) / h_right;
+
+        if (del_left*del_right <= 0.0)
+            s[n] = 0.0;
+        else
+        {
+            w_left = 2.0*h_right + h_left;
+            w_right = h_right + 2.0*h_left;
+            s[n] = (w_left + w_right) / (w_left/del_left + w_right/del_right);
+        }
+    }
+
+    s[0] = rssringoccs_CSV_Pchip_End(x[1] - x[0], x[2] - x[1],
+                                     (y[1] - y[0]) / (x[1] - x[0]),
+                                     (y[2] - y[1]) / (x[2] - x[1]));
+
+    n = n_pts - 1;
+    s[n] = rssringoccs_CSV_Pchip_End(x[n] - x[n - 1], x[n - 1] - x[n - 2],
+                                     (y[n] - y[n - 1]) / (x[n] - x[n - 1]),
+                                     (y[n - 1] - y[n - 2]) /
+                                     (x[n - 1] - x[n - 2]));
+}
+/*  End of rssringoccs_CSV_Pchip_Slopes.                                      */
+
+/*  Computes the output points from first to first + n_block, with n_block at *
+ *  most RSSRINGOCCS_CSV_INTERP_BLOCK, for every column.                      */
+static void
+rssringoccs_CSV_Interp_Block(const double *x,
+                             const double * const *y,
+                             const double *s,
+                             size_t n_pts,
+                             const double *x_out,
+                             double * const *y_out,
+                             size_t first,
+                             size_t n_block,
+                             size_t n_columns,
+                             rssringoccs_Interp_Enum method)
+{
+    size_t ind[RSSRINGOCCS_CSV_INTERP_BLOCK];
+    double w0[RSSRINGOCCS_CSV_INTERP_BLOCK];
+    double w1[RSSRINGOCCS_CSV_INTERP_BLOCK];
+    double w2[RSSRINGOCCS_CSV_INTERP_BLOCK];
+    double w3[RSSRINGOCCS_CSV_INTERP_BLOCK];
+    size_t n, k, j = 0;
+    double h, t, t2, t3;
+    const double *yk, *sk;
+    double *out;
+
+    for (n = 0; n < n_block; ++n)
+    {
+        j = rssringoccs_CSV_Interp_Find(x, n_pts, x_out[first + n], j);
+        h = x[j + 1] - x[j];
+        t = (h > 0.0 ? (x_out[first + n] - x[j]) / h : 0.0);
+
+        /*  Outside of x, the value at the nearest end is used.               */
+        if (t < 0.0)
+            t = 0.0;
+        else if (t > 1.0)
+            t = 1.0;
+
+        ind[n] = j;
+
+        if (method == rssringoccs_Interp_Cubic)
+        {
+            h = h*h / 6.0;
+            w0[n] = 1.0 - t;
+            w1[n] = t;
+            w2[n] = (w0[n]*w0[n] - 1.0)*w0[n]*h;
+            w3[n] = (t*t - 1.0)*t*h;
+        }
+        else if (method == rssringoccs_Interp_Monotone)
+        {
+            t2 = t*t;
+            t3 = t2*t;
+            w0[n] = 2.0*t3 - 3.0*t2 + 1.0;
+            w1[n] = 3.0*t2 - 2.0*t3;
+            w2[n] = (t3 - 2.0*t2 + t)*h;
+            w3[n] = (t3 - t2)*h;
+        }
+        else
+            w1[n] = t;
+    }
+
+    for (k = 0; k < n_columns; ++k)
+    {
+        yk = y[k];
+        out = y_out[k] + first;
+
+        if (method == rssringoccs_Interp_Linear)
+        {
+            for (n = 0; n < n_block; ++n)
+            {
+                j = ind[n];
+                out[n] = yk[j] + w1[n]*(yk[j + 1] - yk[j]);
+            }
+        }
+        else
+        {
+            sk = s + k*n_pts;
+
+            for (n = 0; n < n_block; ++n)
+            {
+                j = ind[n];
+                out[n] = w0[n]*yk[j] + w1[n]*yk[j + 1] +
+                         w2[n]*sk[j] + w3[n]*sk[j + 1];
+            }
+        }
+    }
+}
+/*  End of rssringoccs_CSV_Interp_Block.                                      */
+
+tmpl_Bool
+rssringoccs_CSV_Interp_Columns(const double *x,
+                               const double * const *y,
+                               size_t n_pts,
+                               const double *x_out,
+                               double * const *y_out,
+                               size_t n_out,
+                               size_t n_columns,
+                               rssringoccs_Interp_Enum method)
+{
+    double *s = NULL;
+    double *c, *inv;
+    size_t n, k, n_blocks;
+
+    if (n_pts == 0)
+        return tmpl_False;
+
+    /*  With one point every output is the value there.                       */
+    if (n_pts == 1)
+    {
+        for (k = 0; k < n_columns; ++k)
+            for (n = 0; n < n_out; ++n)
+                y_out[k][n] = y[k][0];
+
+        return tmpl_True;
+    }
+
+    if (method != rssringoccs_Interp_Linear)
+    {
+        /*  The second columns, and for the spline the shared factors.        */
+        s = malloc(sizeof(*s) * n_pts * (n_columns + 2));
+
+        if (s == NULL)
+            return tmpl_False;
+
+        c = s + n_pts*n_columns;
+        inv = c + n_pts;
+
+        if (method == rssringoccs_Interp_Cubic)
+        {
+            rssringoccs_CSV_Spline_Factor(x, n_pts, c, inv);
+
+            for (k = 0; k < n_columns; ++k)
+                rssringoccs_CSV_Spline_Solve(x, y[k], n_pts, c, inv,
+                                             s + k*n_pts);
+        }
+        else
+        {
+            for (k = 0; k < n_columns; ++k)
+                rssringoccs_CSV_Pchip_Slopes(x, y[k], n_pts, s + k*n_pts);
+        }
+    }
+
+    n_blocks = (n_out + RSSRINGOCCS_CSV_INTERP_BLOCK - 1) /
+               RSSRINGOCCS_CSV_INTERP_BLOCK;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) \
+    if (n_out*n_columns >= RSSRINGOCCS_CSV_INTERP_PARALLEL_MIN)
+#endif
+    for (n = 0; n < n_blocks; ++n)
+    {
+        const size_t first = n*RSSRINGOCCS_CSV_INTERP_BLOCK;
+        size_t n_block = n_out - first;
+
+        if (n_block > RSSRINGOCCS_CSV_INTERP_BLOCK)
+            n_block = RSSRINGOCCS_CSV_INTERP_BLOCK;
+
+        rssringoccs_CSV_Interp_Block(x, y, s, n_pts, x_out, y_out, first,
+                                     n_block, n_columns, method);
+    }
+
+    free(s);
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_Interp_Columns.                                    */
@@ -0,0 +1,898 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Reads the numeric columns of a CSV file in a single pass.             *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The file is mapped into memory where mmap is available, and read whole    *
+ *  with fread otherwise. It is then parsed once, front to back, with no      *
+ *  limit on the length of a line. The column arrays start with room for      *
+ *  RSSRINGOCCS_CSV_INITIAL_ROWS rows and double in size as needed, and are   *
+ *  trimmed to the number of rows at the end.                                 *
+ *                                                                            *
+ *  With OpenMP, a file with at least RSSRINGOCCS_CSV_PARALLEL_MIN_BYTES      *
+ *  bytes per thread is split at line breaks into one piece per thread. The   *
+ *  pieces are parsed at the same time and joined in order, giving the same   *
+ *  columns, and the same errors, as the serial parse.                        *
+ *                                                                            *
+ *  Numbers with at most 15 significant digits and a decimal exponent of at   *
+ *  most 22 in magnitude, which covers the PDS TAB files, are converted with  *
+ *  one multiplication or division by an exact power of ten. This is          *
+ *  correctly rounded, so the result is the one strtod gives. Other numbers,  *
+ *  and fields that are not numbers, are passed to strtod. As with atof, a    *
+ *  field is read up to the first character that cannot be part of a number,  *
+ *  and is zero if there is none.                                             *
+ *                                                                            *
+ *  Columns left out of the mask given to rssringoccs_CSV_Read_Selected are   *
+ *  neither allocated nor converted. Their fields are only scanned for the    *
+ *  comma that ends them.                                                     *
+ ******************************************************************************/
+
+/*  Booleans and tmpl_strdup are found here.                                  */
+#include <libtmpl/include/tmpl.h>
+
+/*  Typedefs for CSV structs and function prototype given here.               */
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+
+/*  malloc, realloc, free, and strtod are found here.                         */
+#include <stdlib.h>
+
+/*  CHAR_BIT is found here.                                                   */
+#include <limits.h>
+
+/*  sprintf is found here.                                                    */
+#include <stdio.h>
+
+/*  memchr, memcpy, and memmove are found here.                               */
+#include <string.h>
+
+/*  omp_get_max_threads and omp_get_active_level are declared here.           */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*  Number of rows the column arrays initially have room for.                 */
+#define RSSRINGOCCS_CSV_INITIAL_ROWS (4096)
+
+/*  Numbers with more significant digits than this are given to strtod.       */
+#define RSSRINGOCCS_CSV_MAX_FAST_DIGITS (15)
+
+/*  Whether column m of csv is read. Columns past the bits of an unsigned     *
+ *  long are always read.                                                     */
+#define RSSRINGOCCS_CSV_KEEPS(csv, m)                                          \
+    ((m) >= sizeof(unsigned long)*CHAR_BIT || (((csv)->columns >> (m)) & 1UL))
+
+/*  Powers of ten that are exactly representable as doubles.                  */
+static const double rssringoccs_csv_powers_of_ten[23] = {
+    1.0E0,  1.0E1,  1.0E2,  1.0E3,  1.0E4,  1.0E5,  1.0E6,  1.0E7,
+    1.0E8,  1.0E9,  1.0E10, 1.0E11, 1.0E12, 1.0E13, 1.0E14, 1.0E15,
+    1.0E16, 1.0E17, 1.0E18, 1.0E19, 1.0E20, 1.0E21, 1.0E22
+};
+
+/*  Sets the error of the CSV object.                                         */
+static void
+rssringoccs_CSV_Error(rssringoccs_CSV_Columns *csv, const char *message)
+{
+    csv->error_occurred = tmpl_True;
+    csv->error_message = tmpl_strdup(message);
+}
+/*  End of rssringoccs_CSV_Error.                                             */
+
+/*  Converts str, up to the first comma or line break, with strtod. The text  *
+ *  is copied first since the mapped file is not null terminated.             */
+static const char *
+rssringoccs_CSV_Parse_Slow(const char *str, const char *end, double *val)
+{
+    char buffer[128];
+    char *text = buffer;
+    char *stop;
+    size_t len = 0;
+
+    while (str + len < end && str[len] != ',' &&
+           str[len] != '\n' && str[len] != '\r')
+        ++len;
+
+    if (len >= sizeof(buffer))
+    {
+        text = malloc(len + 1);
+
+        /*  Without memory for the text, treat the field as not a number.     */
+        if (text == NULL)
+        {
+            *val = 0.0;
+            return str;
+        }
+    }
+
+    memcpy(text, str, len);
+    text[len] = '\0';
+    *val = strtod(text, &stop);
+    len = (size_t)(stop - text);
+
+    if (text != buffer)
+        free(text);
+
+    return str + len;
+}
+/*  End of rssringoccs_CSV_Parse_Slow.                                        */
+
+const char *
+rssringoccs_CSV_Parse_Double(const char *str, const char *end, double *val)
+{
+    const char *s;
+    double mantissa = 0.0;
+    long exponent = 0L;
+    long exp_part = 0L;
+    unsigned int digits = 0U;
+    unsigned int zeros = 0U;
+    tmpl_Bool negative = tmpl_False;
+    tmpl_Bool exp_negative = tmpl_False;
+    tmpl_Bool seen_digit = tmpl_False;
+    tmpl_Bool too_long = tmpl_False;
+    int digit;
+
+    while (str < end && (*str == ' ' || *str == '\t'))
+        ++str;
+
+    s = str;
+
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        negative = (*s == '-');
+        ++s;
+    }
+
+    /*  Zeros after the last non-zero digit are held back in zeros, so that   *
+     *  trailing zeros do not count against RSSRINGOCCS_CSV_MAX_FAST_DIGITS.  */
+    while (s < end && *s >= '0' && *s <= '9')
+    {
+        digit = *s - '0';
+        seen_digit = tmpl_True;
+
+        if (digit == 0)
+        {
+            if (digits > 0U)
+                ++zeros;
+        }
+        else if (digits + zeros + 1U > RSSRINGOCCS_CSV_MAX_FAST_DIGITS)
+            too_long = tmpl_True;
+        else
+        {
+            mantissa *= rssringoccs_csv_powers_of_ten[zeros + 1U];
+            mantissa += (double)digit;
+            digits += zeros + 1U;
+            zeros = 0U;
+        }
+
+        ++s;
+    }
+
+    if (s < end && *s == '.')
+    {
+        ++s;
+
+        while (s < end && *s >= '0' && *s <= '9')
+        {
+            digit = *s - '0';
+            seen_digit = tmpl_True;
+            --exponent;
+
+            if (digit == 0)
+            {
+                if (digits > 0U)
+                    ++zeros;
+            }
+            else if (digits + zeros + 1U > RSSRINGOCCS_CSV_MAX_FAST_DIGITS)
+                too_long = tmpl_True;
+            else
+            {
+                mantissa *= rssringoccs_csv_powers_of_ten[zeros + 1U];
+                mantissa += (double)digit;
+                digits += zeros + 1U;
+                zeros = 0U;
+            }
+
+            ++s;
+        }
+    }
+
+    /*  Not a number that this parser handles, such as inf or nan.            */
+    if (!seen_digit)
+        return rssringoccs_CSV_Parse_Slow(str, end, val);
+
+    exponent += (long)zeros;
+
+    if (s < end && (*s == 'e' || *s == 'E'))
+    {
+        const char *e = s + 1;
+
+        if (e < end && (*e == '-' || *e == '+'))
+        {
+            exp_negative = (*e == '-');
+            ++e;
+        }
+
+        /*  An e with no digits after it is not part of the number.           */
+        if (e < end && *e >= '0' && *e <= '9')
+        {
+            while (e < end && *e >= '0' && *e <= '9')
+            {
+                if (exp_part < 10000L)
+                    exp_part = 10L*exp_part + (long)(*e - '0');
+
+                ++e;
+            }
+
+            s = e;
+            exponent += (exp_negative ? -exp_part : exp_part);
+        }
+    }
+
+    if (too_long || exponent > 22L || exponent < -22L)
+        return rssringoccs_CSV_Parse_Slow(str, end, val);
+
+    if (exponent >= 0L)
+        mantissa *= rssringoccs_csv_powers_of_ten[exponent];
+    else
+        mantissa /= rssringoccs_csv_powers_of_ten[-exponent];
+
+    *val = (negative ? -mantissa : mantissa);
+    return s;
+}
+/*  End of rssringoccs_CSV_Parse_Double.                                      */
+
+/*  Grows the column arrays that are read to room for n_rows rows. Returns    *
+ *  false on error.                                                           */
+static tmpl_Bool
+rssringoccs_CSV_Grow(rssringoccs_CSV_Columns *csv, size_t n_rows)
+{
+    size_t m;
+    double *tmp;
+
+    for (m = 0; m < csv->n_columns; ++m)
+    {
+        if (!RSSRINGOCCS_CSV_KEEPS(csv, m))
+            continue;
+
+        tmp = realloc(csv->data[m], sizeof(*tmp) * n_rows);
+
+        if (tmp == NULL)
+            return tmpl_False;
+
+        csv->data[m] = tmp;
+    }
+
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_Grow.                                              */
+
+/*  Number of fields in the line starting at str.                             */
+static size_t rssringoccs_CSV_Count_Fields(const char *str, const char *end)
+{
+    size_t count = 1;
+
+    while (str < end && *str != '\n')
+    {
+        if (*str == ',')
+            ++count;
+
+        ++str;
+    }
+
+    return count;
+}
+/*  End of rssringoccs_CSV_Count_Fields.                                      */
+
+/*  Returns the start of the first line at or after s that is not blank, or   *
+ *  end if there is none. Leading blanks of that line are skipped.            */
+static const char *rssringoccs_CSV_Skip_Blank(const char *s, const char *end)
+{
+    while (s < end)
+    {
+        while (s < end && (*s == ' ' || *s == '\t' || *s == '\r'))
+            ++s;
+
+        if (s == end || *s != '\n')
+            return s;
+
+        ++s;
+    }
+
+    return s;
+}
+/*  End of rssringoccs_CSV_Skip_Blank.                                        */
+
+/*  Allocates n_columns empty columns. Returns false on error.                */
+static tmpl_Bool
+rssringoccs_CSV_Alloc_Columns(rssringoccs_CSV_Columns *csv, size_t n_columns)
+{
+    size_t m;
+
+    csv->data = malloc(sizeof(*csv->data) * n_columns);
+
+    if (csv->data == NULL)
+        return tmpl_False;
+
+    csv->n_columns = n_columns;
+
+    for (m = 0; m < n_columns; ++m)
+        csv->data[m] = NULL;
+
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_Alloc_Columns.                                     */
+
+/*  Sets the error of the CSV object for a failed allocation.                 */
+static void rssringoccs_CSV_Memory_Error(rssringoccs_CSV_Columns *csv)
+{
+    rssringoccs_CSV_Error(
+        csv,
+        "Error Encountered: rss_ringoccs\n"
+        "\trssringoccs_CSV_Read_Columns\n\n"
+        "Failed to allocate memory for the columns. Aborting\n"
+        "computation and returning.\n"
+    );
+}
+/*  End of rssringoccs_CSV_Memory_Error.                                      */
+
+/*  Sets the error of the CSV object for a row with the wrong number of       *
+ *  columns. Rows are counted from one.                                       */
+static void rssringoccs_CSV_Row_Error(rssringoccs_CSV_Columns *csv, size_t row)
+{
+    char message[256];
+
+    sprintf(
+        message,
+        "Error Encountered: rss_ringoccs\n"
+        "\trssringoccs_CSV_Read_Columns\n\n"
+        "Row %lu does not have the %lu columns of the first row.\n"
+        "Aborting computation and returning.\n",
+        (unsigned long)row,
+        (unsigned long)csv->n_columns
+    );
+
+    rssringoccs_CSV_Error(csv, message);
+}
+/*  End of rssringoccs_CSV_Row_Error.                                         */
+
+/*  Results of rssringoccs_CSV_Parse.                                         */
+#define RSSRINGOCCS_CSV_PARSED (0)
+#define RSSRINGOCCS_CSV_NO_MEMORY (1)
+#define RSSRINGOCCS_CSV_BAD_ROW (2)
+
+/*  Parses the rows from s to end into the columns of csv, which must have    *
+ *  been allocated. On a bad row, n_rows is the number of rows before it.     */
+static int
+rssringoccs_CSV_Parse(rssringoccs_CSV_Columns *csv,
+                      const char *s, const char *end)
+{
+    size_t m;
+    size_t capacity = 0;
+    double value;
+
+    s = rssringoccs_CSV_Skip_Blank(s, end);
+
+    while (s < end)
+    {
+        if (csv->n_rows == capacity)
+        {
+            capacity = (capacity == 0 ? RSSRINGOCCS_CSV_INITIAL_ROWS :
+                                        2*capacity);
+
+            if (!rssringoccs_CSV_Grow(csv, capacity))
+                return RSSRINGOCCS_CSV_NO_MEMORY;
+        }
+
+        for (m = 0; m < csv->n_columns; ++m)
+        {
+            if (RSSRINGOCCS_CSV_KEEPS(csv, m))
+            {
+                s = rssringoccs_CSV_Parse_Double(s, end, &value);
+                csv->data[m][csv->n_rows] = value;
+            }
+
+            /*  Skip anything after the number, as atof would, or the whole   *
+             *  field if the column is not read.                              */
+            while (s < end && *s != ',' && *s != '\n')
+                ++s;
+
+            if (m + 1 < csv->n_columns)
+            {
+                if (s == end || *s != ',')
+                    break;
+
+                ++s;
+            }
+        }
+
+        if (m < csv->n_columns || (s < end && *s != '\n'))
+            return RSSRINGOCCS_CSV_BAD_ROW;
+
+        ++csv->n_rows;
+        s = rssringoccs_CSV_Skip_Blank(s, end);
+    }
+
+    /*  Give back the memory the last doubling did not use.                   */
+    if (csv->n_rows > 0 && csv->n_rows < capacity)
+        rssringoccs_CSV_Grow(csv, csv->n_rows);
+
+    return RSSRINGOCCS_CSV_PARSED;
+}
+/*  End of rssringoccs_CSV_Parse.                                             */
+
+/*  Files smaller than this many bytes per thread are parsed by one thread.   */
+#ifndef RSSRINGOCCS_CSV_PARALLEL_MIN_BYTES
+#define RSSRINGOCCS_CSV_PARALLEL_MIN_BYTES (1048576)
+#endif
+
+#ifdef _OPENMP
+
+/*  Number of pieces a file of the given size is split into. This is one if   *
+ *  the caller is already in a parallel region that can not nest, as when     *
+ *  rssringoccs_Extract_CSV_Data reads several files at once.                 */
+static int rssringoccs_CSV_Number_Of_Pieces(size_t size)
+{
+    const size_t n_pieces = size / RSSRINGOCCS_CSV_PARALLEL_MIN_BYTES;
+    const int n_threads = omp_get_max_threads();
+
+    if (omp_get_active_level() >= omp_get_max_active_levels())
+        return 1;
+
+    if (n_pieces < (size_t)n_threads)
+        return (n_pieces == 0 ? 1 : (int)n_pieces);
+
+    return n_threads;
+}
+/*  End of rssringoccs_CSV_Number_Of_Pieces.                                  */
+
+/*  Joins the parsed pieces in order. The first piece was parsed into the     *
+ *  columns of csv, and the others are copied onto the end of them. The first *
+ *  piece that failed decides the error, so that a bad row is reported with   *
+ *  the number it has in the file.                                            */
+static void
+rssringoccs_CSV_Join(rssringoccs_CSV_Columns *csv,
+                     rssringoccs_CSV_Columns *pieces,
+                     const int *status, int n_pieces)
+{
+    size_t m;
+    size_t *first_row;
+    int k;
+
+    csv->n_rows = 0;
+
+    for (k = 0; k < n_pieces; ++k)
+    {
+        if (status[k] == RSSRINGOCCS_CSV_BAD_ROW)
+        {
+            rssringoccs_CSV_Row_Error(csv, csv->n_rows + pieces[k].n_rows + 1);
+            return;
+        }
+
+        if (status[k] == RSSRINGOCCS_CSV_NO_MEMORY)
+        {
+            rssringoccs_CSV_Memory_Error(csv);
+            return;
+        }
+
+        csv->n_rows += pieces[k].n_rows;
+    }
+
+    if (csv->n_rows == pieces[0].n_rows)
+        return;
+
+    first_row = malloc(sizeof(*first_row) * (size_t)n_pieces);
+
+    if (first_row == NULL || !rssringoccs_CSV_Grow(csv, csv->n_rows))
+    {
+        free(first_row);
+        rssringoccs_CSV_Memory_Error(csv);
+        return;
+    }
+
+    first_row[0] = 0;
+
+    for (k = 1; k < n_pieces; ++k)
+        first_row[k] = first_row[k - 1] + pieces[k - 1].n_rows;
+
+#pragma omp parallel for num_threads(n_pieces) private(m) schedule(static, 1)
+    for (k = 1; k < n_pieces; ++k)
+    {
+        if (pieces[k].n_rows == 0)
+            continue;
+
+        for (m = 0; m < csv->n_columns; ++m)
+        {
+            if (RSSRINGOCCS_CSV_KEEPS(csv, m))
+                memcpy(csv->data[m] + first_row[k], pieces[k].data[m],
+                       sizeof(double) * pieces[k].n_rows);
+        }
+    }
+
+    free(first_row);
+}
+/*  End of rssringoccs_CSV_Join.                                              */
+
+/*  Splits the text at line breaks into n_pieces pieces of about the same     *
+ *  size, and parses them at the same time.                                   */
+static void
+rssringoccs_CSV_Parse_Parallel(rssringoccs_CSV_Columns *csv,
+                               const char *s, const char *end,
+                               int n_pieces)
+{
+    rssringoccs_CSV_Columns *pieces;
+    const char **bounds;
+    const char *cut;
+    int *status;
+    int k;
+    const size_t step = (size_t)(end - s) / (size_t)n_pieces;
+
+    pieces = malloc(sizeof(*pieces) * (size_t)n_pieces);
+    bounds = malloc(sizeof(*bounds) * (size_t)(n_pieces + 1));
+    status = malloc(sizeof(*status) * (size_t)n_pieces);
+
+    if (pieces == NULL || bounds == NULL || status == NULL)
+    {
+        free(pieces);
+        free(bounds);
+        free(status);
+        rssringoccs_CSV_Memory_Error(csv);
+        return;
+    }
+
+    /*  Piece k starts after the first line break past k steps into the text. */
+    bounds[0] = s;
+    bounds[n_pieces] = end;
+
+    for (k = 1; k < n_pieces; ++k)
+    {
+        cut = s + (size_t)k*step;
+
+        if (cut < bounds[k - 1])
+            cut = bounds[k - 1];
+
+        cut = memchr(cut, '\n', (size_t)(end - cut));
+        bounds[k] = (cut == NULL ? end : cut + 1);
+    }
+
+    /*  The first piece is parsed into csv, the others into new columns.      */
+    pieces[0].data = csv->data;
+    pieces[0].n_columns = csv->n_columns;
+    pieces[0].n_rows = 0;
+    pieces[0].columns = csv->columns;
+
+    for (k = 1; k < n_pieces; ++k)
+    {
+        pieces[k].n_rows = 0;
+        pieces[k].columns = csv->columns;
+
+        if (!rssringoccs_CSV_Alloc_Columns(&pieces[k], csv->n_columns))
+            break;
+    }
+
+    if (k < n_pieces)
+    {
+        n_pieces = k;
+        rssringoccs_CSV_Memory_Error(csv);
+    }
+    else
+    {
+#pragma omp parallel for num_threads(n_pieces) schedule(static, 1)
+        for (k = 0; k < n_pieces; ++k)
+            status[k] = rssringoccs_CSV_Parse(&pieces[k], bounds[k],
+                                              bounds[k + 1]);
+
+        rssringoccs_CSV_Join(csv, pieces, status, n_pieces);
+    }
+
+    for (k = 1; k < n_pieces; ++k)
+        rssringoccs_Destroy_CSV_Columns_Members(&pieces[k]);
+
+    free(pieces);
+    free(bounds);
+    free(status);
+}
+/*  End of rssringoccs_CSV_Parse_Parallel.                                    */
+
+#endif
+/*  End of #ifdef _OPENMP.                                                    */
+
+/*  The text is split into blocks of this many bytes for the range search.    */
+#ifndef RSSRINGOCCS_CSV_INDEX_BLOCK_BYTES
+#define RSSRINGOCCS_CSV_INDEX_BLOCK_BYTES (65536)
+#endif
+
+/*  Finds the first row of block k of the text from s to end, which is the    *
+ *  first row starting at or after k blocks into the text, and the value in   *
+ *  its first column. Returns false if there is no such row.                  */
+static tmpl_Bool
+rssringoccs_CSV_Block_Entry(const char *s, const char *end, size_t k,
+                            const char **row, double *key)
+{
+    const char *cut = s;
+
+    if (k > 0)
+    {
+        cut = s + k*RSSRINGOCCS_CSV_INDEX_BLOCK_BYTES - 1;
+        cut = memchr(cut, '\n', (size_t)(end - cut));
+
+        if (cut == NULL)
+            return tmpl_False;
+
+        cut = rssringoccs_CSV_Skip_Blank(cut + 1, end);
+
+        if (cut == end)
+            return tmpl_False;
+    }
+
+    /*  A blank may be skipped past the start of the row. Step back to it.    */
+    while (cut > s && cut[-1] != '\n')
+        --cut;
+
+    rssringoccs_CSV_Parse_Double(cut, end, key);
+    *row = cut;
+    return tmpl_True;
+}
+/*  End of rssringoccs_CSV_Block_Entry.                                       */
+
+/*  Index of the first block whose first row is past x, in the direction of   *
+ *  sign, or n_blocks if there is none. Blocks with no row count as past.     *
+ *  With inclusive set, a row equal to x also counts as past.                 */
+static size_t
+rssringoccs_CSV_Block_Search(const char *s, const char *end, size_t n_blocks,
+                             double x, double sign, tmpl_Bool inclusive)
+{
+    size_t low = 0, high = n_blocks, mid;
+    const char *row;
+    double key;
+
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+
+        if (!rssringoccs_CSV_Block_Entry(s, end, mid, &row, &key) ||
+            sign*key > sign*x || (inclusive && key == x))
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    return low;
+}
+/*  End of rssringoccs_CSV_Block_Search.                                      */
+
+/*  Narrows the text from *start to *end, whose rows are sorted by their      *
+ *  first column in either direction, to whole blocks holding every row with  *
+ *  a first column between x_min and x_max. The blocks are found by binary    *
+ *  search, so only the first row of about log2 of the number of blocks is    *
+ *  ever parsed.                                                              */
+static void
+rssringoccs_CSV_Find_Range(const char **start, const char **end,
+                           double x_min, double x_max)
+{
+    const char *s = *start;
+    const char *e = *end;
+    const char *row, *last;
+    double first_key, last_key, sign, x_low, x_high;
+    size_t n_blocks, k;
+
+    n_blocks = ((size_t)(e - s) + RSSRINGOCCS_CSV_INDEX_BLOCK_BYTES - 1) /
+               RSSRINGOCCS_CSV_INDEX_BLOCK_BYTES;
+
+    if (n_blocks < 2)
+        return;
+
+    /*  The last row of the text tells whether the rows are increasing.       */
+    last = e;
+
+    while (last > s && (last[-1] == '\n' || last[-1] == '\r' ||
+                        last[-1] == ' ' || last[-1] == '\t'))
+        --last;
+
+    while (last > s && last[-1] != '\n')
+        --last;
+
+    rssringoccs_CSV_Block_Entry(s, e, 0, &row, &first_key);
+    rssringoccs_CSV_Parse_Double(last, e, &last_key);
+
+    if (last_key < first_key)
+    {
+        sign = -1.0;
+        x_low = x_max;
+        x_high = x_min;
+    }
+    else
+    {
+        sign = 1.0;
+        x_low = x_min;
+        x_high = x_max;
+    }
+
+    /*  The rows before the block before the first block reaching x_low are   *
+     *  all short of it. The rows from the first block past x_high on are all *
+     *  beyond it.                                                            */
+    k = rssringoccs_CSV_Block_Search(s, e, n_blocks, x_low, sign, tmpl_True);
+
+    if (k > 1 && rssringoccs_CSV_Block_Entry(s, e, k - 1, &row, &first_key))
+        *start = row;
+
+    k = rssringoccs_CSV_Block_Search(s, e, n_blocks, x_high, sign, tmpl_False);
+
+    if (k < n_blocks && rssringoccs_CSV_Block_Entry(s, e, k, &row, &last_key))
+        *end = row;
+}
+/*  End of rssringoccs_CSV_Find_Range.                                        */
+
+/*  Removes the rows whose first column is not between x_min and x_max. The   *
+ *  rows are sorted, so the rows kept are all in one run.                     */
+static void
+rssringoccs_CSV_Trim_Rows(rssringoccs_CSV_Columns *csv,
+                          double x_min, double x_max)
+{
+    size_t first = 0, last = csv->n_rows, m;
+    const double *x = csv->data[0];
+
+    while (first < last && (x[first] < x_min || x[first] > x_max))
+        ++first;
+
+    while (last > first && (x[last - 1] < x_min || x[last - 1] > x_max))
+        --last;
+
+    if (first > 0)
+    {
+        for (m = 0; m < csv->n_columns; ++m)
+        {
+            if (RSSRINGOCCS_CSV_KEEPS(csv, m))
+                memmove(csv->data[m], csv->data[m] + first,
+                        sizeof(double) * (last - first));
+        }
+    }
+
+    csv->n_rows = last - first;
+}
+/*  End of rssringoccs_CSV_Trim_Rows.                                         */
+
+void
+rssringoccs_CSV_Read_Selected(rssringoccs_CSV_Columns *csv,
+                              const char *filename,
+                              const double *range,
+                              unsigned long columns)
+{
+    rssringoccs_CSV_File file;
+    const char *start, *end;
+    int status;
+
+    if (csv == NULL)
+        return;
+
+    csv->data = NULL;
+    csv->n_columns = 0;
+    csv->n_rows = 0;
+    csv->columns = columns;
+    csv->error_occurred = tmpl_False;
+    csv->error_message = NULL;
+
+    /*  The range is found from the first column, so it is always read.       */
+    if (range != NULL)
+        csv->columns |= 1UL;
+
+    if (!rssringoccs_CSV_File_Open(&file, filename))
+    {
+        rssringoccs_CSV_Error(
+            csv,
+            "Error Encountered: rss_ringoccs\n"
+            "\trssringoccs_CSV_Read_Columns\n\n"
+            "Failed to open file for reading. It is likely the\n"
+            "filename is incorrect or does not exist.\n"
+        );
+        return;
+    }
+
+    /*  An empty file has no data pointer, so it is not parsed at all.        */
+    if (file.size > 0)
+    {
+        end = file.data + file.size;
+        start = rssringoccs_CSV_Skip_Blank(file.data, end);
+    }
+    else
+        start = end = file.data;
+
+    /*  The first row of the file sets the number of columns, even if it is   *
+     *  outside of the range.                                                 */
+    if (start < end)
+    {
+        const size_t n_columns = rssringoccs_CSV_Count_Fields(start, end);
+#ifdef _OPENMP
+        int n_pieces;
+#endif
+
+        if (range != NULL)
+            rssringoccs_CSV_Find_Range(&start, &end, range[0], range[1]);
+
+#ifdef _OPENMP
+        n_pieces = rssringoccs_CSV_Number_Of_Pieces((size_t)(end - start));
+#endif
+
+        if (!rssringoccs_CSV_Alloc_Columns(csv, n_columns))
+            rssringoccs_CSV_Memory_Error(csv);
+#ifdef _OPENMP
+        else if (n_pieces > 1)
+            rssringoccs_CSV_Parse_Parallel(csv, start, end, n_pieces);
+#endif
+        else
+        {
+            status = rssringoccs_CSV_Parse(csv, start, end);
+
+            if (status == RSSRINGOCCS_CSV_BAD_ROW)
+                rssringoccs_CSV_Row_Error(csv, csv->n_rows + 1);
+            else if (status == RSSRINGOCCS_CSV_NO_MEMORY)
+                rssringoccs_CSV_Memory_Error(csv);
+        }
+    }
+
+    rssringoccs_CSV_File_Close(&file);
+
+    if (range != NULL && csv->n_rows > 0 && !csv->error_occurred)
+    {
+        rssringoccs_CSV_Trim_Rows(csv, range[0], range[1]);
+
+        if (csv->n_rows == 0)
+            rssringoccs_CSV_Error(
+                csv,
+                "Error Encountered: rss_ringoccs\n"
+                "\trssringoccs_CSV_Read_Columns_Range\n\n"
+                "The file has no data in the requested range. Aborting\n"
+                "computation and returning.\n"
+            );
+    }
+
+    if (csv->n_rows == 0 && !csv->error_occurred)
+        rssringoccs_CSV_Error(
+            csv,
+            "Error Encountered: rss_ringoccs\n"
+            "\trssringoccs_CSV_Read_Columns\n\n"
+            "The file has no data. Aborting computation and returning.\n"
+        );
+
+    if (csv->error_occurred)
+        rssringoccs_Destroy_CSV_Columns_Members(csv);
+}
+/*  End of rssringoccs_CSV_Read_Selected.                                     */
+
+void
+rssringoccs_CSV_Read_Columns(rssringoccs_CSV_Columns *csv,
+                             const char *filename)
+{
+    rssringoccs_CSV_Read_Selected(csv, filename, NULL, ~0UL);
+}
+/*  End of rssringoccs_CSV_Read_Columns.                                      */
+
+void
+rssringoccs_CSV_Read_Columns_Range(rssringoccs_CSV_Columns *csv,
+                                   const char *filename,
+                                   double x_min,
+                                   double x_max)
+{
+    double range[2];
+
+    range[0] = x_min;
+    range[1] = x_max;
+    rssringoccs_CSV_Read_Selected(csv, filename, range, ~0UL);
+}
+/*  End of rssringoccs_CSV_Read_Columns_Range.                                */
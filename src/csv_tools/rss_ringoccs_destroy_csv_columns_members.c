@@ -0,0 +1,49 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Free all of the columns in a CSV_Columns object.                      *
+ ******************************************************************************/
+
+/*  free is found here, as is NULL.                                           */
+#include <stdlib.h>
+
+/*  rssringoccs_CSV_Columns typedef here, and function prototype given.       */
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+
+/*  Frees the columns of a rssringoccs_CSV_Columns pointer, and the array of  *
+ *  them, except the error_message. Columns that are NULL are skipped, so the *
+ *  caller may take ownership of a column by setting its pointer to NULL.     */
+void rssringoccs_Destroy_CSV_Columns_Members(rssringoccs_CSV_Columns *csv)
+{
+    size_t m;
+
+    /*  If the pointer is NULL, there's nothing to do. Simply return.         */
+    if (csv == NULL)
+        return;
+
+    if (csv->data == NULL)
+        return;
+
+    for (m = 0; m < csv->n_columns; ++m)
+        free(csv->data[m]);
+
+    free(csv->data);
+    csv->data = NULL;
+}
+/*  End of rssringoccs_Destroy_CSV_Columns_Members.                           */
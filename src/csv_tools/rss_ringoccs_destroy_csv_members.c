@@ -34,8 +34,16 @@
 #undef DESTROY_CSV_VAR
 #endif
 
-/*  Macro for freeing and nullifying the members of the CSV struct.           */
-#define DESTROY_CSV_VAR(var) if (var != NULL){free(var); var = NULL;}
+/*  Macro for freeing and nullifying the members of the CSV struct. Columns   *
+ *  mapped from a cache file are not freed, the file is closed instead.       */
+#define DESTROY_CSV_VAR(var)                                                   \
+    if (var != NULL)                                                           \
+    {                                                                          \
+        if (csv->cache.data == NULL)                                           \
+            free(var);                                                         \
+                                                                               \
+        var = NULL;                                                            \
+    }
 
 /*  Free's all members of a rssringoccs_CSVData pointer except the            *
  *  error_message. Members are set to NULL after freeing.                     */
@@ -68,6 +76,9 @@ void rssringoccs_Destroy_CSV_Members(rssringoccs_CSVData *csv)
     DESTROY_CSV_VAR(csv->tau_phase)
     DESTROY_CSV_VAR(csv->tau_power)
     DESTROY_CSV_VAR(csv->tau_vals)
+
+    /*  Unmap the cache file, if the columns came from one.                   */
+    rssringoccs_CSV_File_Close(&csv->cache);
 }
 /*  End of rssringoccs_Destroy_CSV_Members.                                   */
 
@@ -53,13 +53,96 @@
         return csv_data;                                                       \
     }
 
-/*  Extracts all data from CSV (.TAB) files and creates a DLP-like struct.    */
+/*  Allocates a column of the CSV object if its bit is requested.             */
+#define MALLOC_CSV_COLUMN(var, bit)                                            \
+    if (columns & (bit))                                                       \
+    {                                                                          \
+        MALLOC_CSV_VAR(var)                                                    \
+    }
+
+/*  Moves a column of the DLP object into the CSV object, if requested. The   *
+ *  DLP column is set to NULL so that rssringoccs_Destroy_DLPCSV skips it.    */
+#define TAKE_CSV_VAR(var, dlp_var, bit)                                        \
+    if (columns & (bit))                                                       \
+    {                                                                          \
+        csv_data->var = dlp_dat->dlp_var;                                      \
+        dlp_dat->dlp_var = NULL;                                               \
+    }
+
+/*  Adds a column of a file to those interpolated onto the CSV object, if it  *
+ *  is requested.                                                             */
+#define ADD_INTERP_VAR(y, var, bit)                                            \
+    if (columns & (bit))                                                       \
+    {                                                                          \
+        interp_in[n_interp] = y;                                               \
+        interp_out[n_interp] = csv_data->var;                                  \
+        ++n_interp;                                                            \
+    }
+
+/*  Columns of the CSV object found from the GEO, CAL, and TAU files.         */
+#define RSSRINGOCCS_CSV_GEO_COLUMNS                                            \
+    (RSSRINGOCCS_CSV_D_KM | RSSRINGOCCS_CSV_RHO_DOT_KMS |                      \
+     RSSRINGOCCS_CSV_RX_KM | RSSRINGOCCS_CSV_RY_KM | RSSRINGOCCS_CSV_RZ_KM)
+
+#define RSSRINGOCCS_CSV_CAL_COLUMNS (RSSRINGOCCS_CSV_F_SKY_HZ)
+
+#define RSSRINGOCCS_CSV_TAU_COLUMNS                                            \
+    (RSSRINGOCCS_CSV_TAU_PHASE | RSSRINGOCCS_CSV_TAU_POWER |                   \
+     RSSRINGOCCS_CSV_TAU_VALS)
+
+/*  The columns of the CSV object that depend on each member of the GEO, DLP, *
+ *  and TAU structs, in the order of the members, up to the last one used.    */
+static const unsigned long rssringoccs_csv_geo_bits[15] = {
+    0UL, 0UL, 0UL, RSSRINGOCCS_CSV_RHO_KM, 0UL, 0UL, 0UL,
+    RSSRINGOCCS_CSV_D_KM, RSSRINGOCCS_CSV_RHO_DOT_KMS, 0UL, 0UL, 0UL,
+    RSSRINGOCCS_CSV_RX_KM, RSSRINGOCCS_CSV_RY_KM, RSSRINGOCCS_CSV_RZ_KM
+};
+
+static const unsigned long rssringoccs_csv_dlp_bits[13] = {
+    RSSRINGOCCS_CSV_RHO_KM, RSSRINGOCCS_CSV_RHO_CORR_POLE_KM,
+    RSSRINGOCCS_CSV_RHO_CORR_TIMING_KM, RSSRINGOCCS_CSV_PHI_RL_DEG,
+    RSSRINGOCCS_CSV_PHI_DEG, RSSRINGOCCS_CSV_P_NORM, RSSRINGOCCS_CSV_RAW_TAU,
+    RSSRINGOCCS_CSV_PHASE_DEG, RSSRINGOCCS_CSV_RAW_TAU_THRESHOLD,
+    RSSRINGOCCS_CSV_T_OET_SPM | RSSRINGOCCS_CSV_F_SKY_HZ,
+    RSSRINGOCCS_CSV_T_RET_SPM, RSSRINGOCCS_CSV_T_SET_SPM, RSSRINGOCCS_CSV_B_DEG
+};
+
+static const unsigned long rssringoccs_csv_tau_bits[8] = {
+    RSSRINGOCCS_CSV_RHO_KM, 0UL, 0UL, 0UL, 0UL, RSSRINGOCCS_CSV_TAU_POWER,
+    RSSRINGOCCS_CSV_TAU_VALS, RSSRINGOCCS_CSV_TAU_PHASE
+};
+
+/*  The members of a struct that the requested columns depend on, as bits,    *
+ *  given the columns that depend on each member.                             */
+static unsigned long
+rssringoccs_CSV_File_Columns(unsigned long columns,
+                             const unsigned long *bits,
+                             unsigned int n_members)
+{
+    unsigned long file_columns = 0UL;
+    unsigned int m;
+
+    for (m = 0U; m < n_members; ++m)
+    {
+        if (columns & bits[m])
+            file_columns |= 1UL << m;
+    }
+
+    return file_columns;
+}
+/*  End of rssringoccs_CSV_File_Columns.                                      */
+
+/*  Extracts the requested columns from CSV (.TAB) files and creates a        *
+ *  DLP-like struct. With range non-NULL, only the radii from range[0] to     *
+ *  range[1] are read from the DLP and TAU files.                             */
 rssringoccs_CSVData *
-rssringoccs_Extract_CSV_Data(const char *geo,
-                             const char *cal,
-                             const char *dlp,
-                             const char *tau,
-                             tmpl_Bool use_deprecated)
+rssringoccs_Extract_CSV_Data_Selected(const char *geo,
+                                      const char *cal,
+                                      const char *dlp,
+                                      const char *tau,
+                                      tmpl_Bool use_deprecated,
+                                      const double *range,
+                                      unsigned long columns)
 {
     /*  Pointers for the Geo, Cal, DLP, and Tau CSV objects.                  */
     rssringoccs_GeoCSV *geo_dat;
@@ -83,6 +166,18 @@ rssringoccs_Extract_CSV_Data(const char *geo,
     double min_dr_dt, max_dr_dt, temp, mu, log_power;
     double *cal_f_sky_hz_vals;
 
+    /*  The columns to read from each file, as bits of the members of the     *
+     *  rssringoccs_GeoCSV, DLPCSV, and TauCSV structs, and which files are   *
+     *  read at all.                                                          */
+    unsigned long geo_columns, dlp_columns, tau_columns;
+    tmpl_Bool need_geo, need_cal, need_tau;
+
+    /*  The columns interpolated together, and whether this succeeded.        */
+    const double *interp_in[5];
+    double *interp_out[5];
+    size_t n_interp;
+    tmpl_Bool interp_ok;
+
     /*  Allocate memory for the CSV object.                                   */
     csv_data = malloc(sizeof(*csv_data));
 
@@ -116,12 +211,87 @@ rssringoccs_Extract_CSV_Data(const char *geo,
     csv_data->tau_vals = NULL;
     csv_data->error_message = NULL;
     csv_data->error_occurred = tmpl_False;
+    csv_data->cache.data = NULL;
+    csv_data->cache.size = 0;
+    csv_data->cache.is_mapped = tmpl_False;
+
+    /*  The radius is the variable everything else is a function of.          */
+    columns |= RSSRINGOCCS_CSV_RHO_KM;
+    need_geo = ((columns & RSSRINGOCCS_CSV_GEO_COLUMNS) != 0UL);
+    need_cal = ((columns & RSSRINGOCCS_CSV_CAL_COLUMNS) != 0UL);
+    need_tau = (tau != NULL && (columns & RSSRINGOCCS_CSV_TAU_COLUMNS) != 0UL);
+
+    /*  The columns of each file that the requested columns depend on.        */
+    geo_columns =
+        rssringoccs_CSV_File_Columns(columns, rssringoccs_csv_geo_bits, 15);
+    dlp_columns =
+        rssringoccs_CSV_File_Columns(columns, rssringoccs_csv_dlp_bits, 13);
+    tau_columns =
+        rssringoccs_CSV_File_Columns(columns, rssringoccs_csv_tau_bits, 8);
+
+    /*  t_set_spm_vals is always needed to check drho/dt below.               */
+    dlp_columns |= 1UL << 11;
+
+    /*  The deprecated formats have no power, which is computed from the      *
+     *  optical depth and B instead.                                          */
+    if (use_deprecated && (columns & RSSRINGOCCS_CSV_P_NORM))
+        dlp_columns |= (1UL << 6) | (1UL << 12);
+
+    if (use_deprecated && (columns & RSSRINGOCCS_CSV_TAU_POWER))
+    {
+        tau_columns |= 1UL << 6;
+        dlp_columns |= 1UL << 12;
+    }
 
-    /*  Extract the data from the GEO.TAB file.                               */
-    geo_dat = rssringoccs_Get_Geo(geo, use_deprecated);
+    /*  Files that are not needed are not read. Setting these to NULL avoids  *
+     *  free'ing non-malloced memory, since the "destroy" functions do not    *
+     *  attempt to free a NULL pointer.                                       */
+    geo_dat = NULL;
+    cal_dat = NULL;
+    tau_dat = NULL;
+
+    /*  The files are independent of each other. With OpenMP they are read at *
+     *  the same time, so this takes as long as the largest file, not the sum *
+     *  of all of them. They are checked below one at a time, and since all   *
+     *  of the objects exist by then, every one of them is freed on error.    */
+#ifdef _OPENMP
+#pragma omp parallel sections num_threads(tau ? 4 : 3)
+#endif
+    {
+        /*  Extract the data from the GEO.TAB file, if needed.                */
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        if (need_geo)
+            geo_dat = rssringoccs_Get_Geo_Selected(geo, use_deprecated,
+                                                   geo_columns);
+
+        /*  Extract the data from the DLP.TAB file.                           */
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        dlp_dat = rssringoccs_Get_DLP_Selected(dlp, use_deprecated,
+                                               range, dlp_columns);
+
+        /*  Extract the times and frequencies from the CAL.TAB file, if       *
+         *  needed. The last column, p_free_vals, is not used.                */
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        if (need_cal)
+            cal_dat = rssringoccs_Get_Cal_Selected(cal, 0x7UL);
+
+        /*  Extract the data from the TAU.TAB file, if requested.             */
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        if (need_tau)
+            tau_dat = rssringoccs_Get_Tau_Selected(tau, use_deprecated,
+                                                   range, tau_columns);
+    }
 
     /*  Check for errors.                                                     */
-    if (geo_dat == NULL)
+    if (need_geo && geo_dat == NULL)
     {
         csv_data->error_occurred = tmpl_True;
         csv_data->error_message = tmpl_strdup(
@@ -129,11 +299,14 @@ rssringoccs_Extract_CSV_Data(const char *geo,
             "\trssringoccs_Extract_CSV_Data\n\n"
             "rssringoccs_Get_Geo returned NULL for geo_dat. Aborting.\n"
         );
+        rssringoccs_Destroy_DLPCSV(&dlp_dat);
+        rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
         return csv_data;
     }
 
     /*  If the CSV is empty there is something wrong with the geo string.     */
-    else if (geo_dat->n_elements == zero)
+    else if (need_geo && geo_dat->n_elements == zero)
     {
         csv_data->error_occurred = tmpl_True;
 
@@ -156,14 +329,14 @@ rssringoccs_Extract_CSV_Data(const char *geo,
             );
         }
 
-        /*  The Geo object was allocated memory. Free before aborting.        */
+        /*  The Geo object was allocated memory. Free all before aborting.    */
         rssringoccs_Destroy_GeoCSV(&geo_dat);
+        rssringoccs_Destroy_DLPCSV(&dlp_dat);
+        rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
         return csv_data;
     }
 
-    /*  Extract the data from the DLP.TAB file.                               */
-    dlp_dat = rssringoccs_Get_DLP(dlp, use_deprecated);
-
     /*  Check for errors.                                                     */
     if (dlp_dat == NULL)
     {
@@ -174,9 +347,12 @@ rssringoccs_Extract_CSV_Data(const char *geo,
             "rssringoccs_Get_DLP returned NULL for dlp_dat. Aborting.\n"
         );
 
-        /*  The Geo object was successfully created. Destroy it to avoid      *
-         *  memory leaks and then abort the computation.                      */
+        /*  The other objects were successfully created. Destroy them to      *
+         *  avoid memory leaks and then abort the computation.                */
         rssringoccs_Destroy_GeoCSV(&geo_dat);
+        rssringoccs_Destroy_DLPCSV(&dlp_dat);
+        rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
         return csv_data;
     }
 
@@ -204,17 +380,16 @@ rssringoccs_Extract_CSV_Data(const char *geo,
             );
         }
 
-        /*  Both Geo and DLP have memory allocated to them. Free them.        */
+        /*  All of the objects have memory allocated to them. Free them.      */
         rssringoccs_Destroy_GeoCSV(&geo_dat);
         rssringoccs_Destroy_DLPCSV(&dlp_dat);
+        rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
         return csv_data;
     }
 
-    /*  Extract the data from the CAL.TAB file.                               */
-    cal_dat = rssringoccs_Get_Cal(cal);
-
     /*  Check for errors.                                                     */
-    if (cal_dat == NULL)
+    if (need_cal && cal_dat == NULL)
     {
         csv_data->error_occurred = tmpl_True;
         csv_data->error_message = tmpl_strdup(
@@ -223,15 +398,17 @@ rssringoccs_Extract_CSV_Data(const char *geo,
             "rssringoccs_Get_Cal returned NULL for cal_dat. Aborting.\n"
         );
 
-        /*  Geo and DLP were successfully created. They need to be freed to   *
-         *  avoid memory leaks. Destroy both objects and then abort.          */
+        /*  The other objects were successfully created. They need to be      *
+         *  freed to avoid memory leaks. Destroy them and then abort.         */
         rssringoccs_Destroy_GeoCSV(&geo_dat);
         rssringoccs_Destroy_DLPCSV(&dlp_dat);
+        rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
         return csv_data;
     }
 
     /*  Ensure the created object isn't empty.                                */
-    else if (cal_dat->n_elements == zero)
+    else if (need_cal && cal_dat->n_elements == zero)
     {
         csv_data->error_occurred = tmpl_True;
 
@@ -254,28 +431,17 @@ rssringoccs_Extract_CSV_Data(const char *geo,
             );
         }
 
-        /*  Free the three CSV objects before aborting.                       */
+        /*  Free the CSV objects before aborting.                             */
         rssringoccs_Destroy_GeoCSV(&geo_dat);
         rssringoccs_Destroy_DLPCSV(&dlp_dat);
         rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
         return csv_data;
     }
 
-    /*  Steal the pointer to avoid a call to malloc. It is destroyed in the   *
-     *  end anyways, so no harm done.                                         */
-    cal_f_sky_hz_vals = cal_dat->f_sky_pred_vals;
-
-    /*  The sky frequency is the difference of the predicted and residual     *
-     *  frequencies. Loop through the arrays and compute the difference.      */
-    for (n = zero; n < cal_dat->n_elements; ++n)
-        cal_f_sky_hz_vals[n] -= cal_dat->f_sky_resid_fit_vals[n];
-
-    /*  Extract the data from the TAU.TAB file.                               */
-    if (tau)
+    /*  Check the TAU.TAB data, if it was requested.                          */
+    if (need_tau)
     {
-        tau_dat = rssringoccs_Get_Tau(tau, use_deprecated);
-
-        /*  Check for errors.                                                 */
         if (tau_dat == NULL)
         {
             csv_data->error_occurred = tmpl_True;
@@ -328,49 +494,47 @@ rssringoccs_Extract_CSV_Data(const char *geo,
         }
     }
 
-    /*  If Tau data is not to be extracted, avoid free'ing non-malloced       *
-     *  memory by setting this to NULL. The "destroy" function will not       *
-     *  attempt to free a NULL pointer.                                       */
-    else
-        tau_dat = NULL;
+    /*  drho/dt is computed from neighbouring points below. A narrow range    *
+     *  may leave fewer than two.                                             */
+    if (dlp_dat->n_elements < 2)
+    {
+        csv_data->error_occurred = tmpl_True;
+        csv_data->error_message = tmpl_strdup(
+            "\nError Encountered: rss_ringoccs\n"
+            "\trssringoccs_Extract_CSV_Data\n\n"
+            "The DLP data has fewer than two points. Aborting.\n"
+        );
+        rssringoccs_Destroy_GeoCSV(&geo_dat);
+        rssringoccs_Destroy_DLPCSV(&dlp_dat);
+        rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
+        return csv_data;
+    }
 
     /*  Grab the number of elements from the DLP CSV. This will be the number *
      *  of elements in the output.                                            */
     csv_data->n_elements = dlp_dat->n_elements;
 
-    /*  The MALLOC_CSV_VAR macro contains an if-then statement with           *
+    /*  The MALLOC_CSV_COLUMN macro contains an if-then statement with        *
      *  braces {} hence there is no need for a semi-colon at the end.         */
-    MALLOC_CSV_VAR(D_km_vals)
-    MALLOC_CSV_VAR(f_sky_hz_vals)
-    MALLOC_CSV_VAR(rho_dot_kms_vals)
-    MALLOC_CSV_VAR(rx_km_vals)
-    MALLOC_CSV_VAR(ry_km_vals)
-    MALLOC_CSV_VAR(rz_km_vals)
+    MALLOC_CSV_COLUMN(D_km_vals, RSSRINGOCCS_CSV_D_KM)
+    MALLOC_CSV_COLUMN(f_sky_hz_vals, RSSRINGOCCS_CSV_F_SKY_HZ)
+    MALLOC_CSV_COLUMN(rho_dot_kms_vals, RSSRINGOCCS_CSV_RHO_DOT_KMS)
+    MALLOC_CSV_COLUMN(rx_km_vals, RSSRINGOCCS_CSV_RX_KM)
+    MALLOC_CSV_COLUMN(ry_km_vals, RSSRINGOCCS_CSV_RY_KM)
+    MALLOC_CSV_COLUMN(rz_km_vals, RSSRINGOCCS_CSV_RZ_KM)
 
     /*  If Tau data is to be extracted, reserve memory for the variables.     */
-    if (tau)
+    if (need_tau)
     {
-        MALLOC_CSV_VAR(tau_phase)
-        MALLOC_CSV_VAR(tau_power)
-        MALLOC_CSV_VAR(tau_vals)
+        MALLOC_CSV_COLUMN(tau_phase, RSSRINGOCCS_CSV_TAU_PHASE)
+        MALLOC_CSV_COLUMN(tau_power, RSSRINGOCCS_CSV_TAU_POWER)
+        MALLOC_CSV_COLUMN(tau_vals, RSSRINGOCCS_CSV_TAU_VALS)
     }
 
-    /*  The references to these variables can be stolen to avoid copying.     */
-    csv_data->rho_km_vals = dlp_dat->rho_km_vals;
-    csv_data->raw_tau_vals = dlp_dat->raw_tau_vals;
-    csv_data->t_ret_spm_vals = dlp_dat->t_ret_spm_vals;
-    csv_data->t_set_spm_vals = dlp_dat->t_set_spm_vals;
-    csv_data->t_oet_spm_vals = dlp_dat->t_oet_spm_vals;
-    csv_data->rho_corr_pole_km_vals = dlp_dat->rho_corr_pole_km_vals;
-    csv_data->rho_corr_timing_km_vals = dlp_dat->rho_corr_timing_km_vals;
-    csv_data->raw_tau_threshold_vals = dlp_dat->raw_tau_threshold_vals;
-
-    /*  The new TAB files have normalized power included.                     */
-    if (!use_deprecated)
-        csv_data->p_norm_vals = dlp_dat->p_norm_vals;
-
-    /*  Otherwise we need to compute the power from the optical depth.        */
-    else
+    /*  The old TAB files do not have normalized power, so we need to compute *
+     *  the power from the optical depth.                                     */
+    if (use_deprecated && (columns & RSSRINGOCCS_CSV_P_NORM))
     {
         /*  Need to allocate memory for p_norm_vals.                          */
         MALLOC_CSV_VAR(p_norm_vals)
@@ -381,21 +545,15 @@ rssringoccs_Extract_CSV_Data(const char *geo,
         {
             /*  tmpl_Double_Sind computes sine of an argument in degrees.     */
             mu = tmpl_Double_Sind(tmpl_Double_Abs(dlp_dat->B_deg_vals[n]));
-            log_power = -csv_data->raw_tau_vals[n] / mu;
+            log_power = -dlp_dat->raw_tau_vals[n] / mu;
 
             /*  Normalize diffracted power can be computed from optical depth.*/
             csv_data->p_norm_vals[n] = tmpl_Double_Exp(log_power);
         }
     }
 
-    /*  Various angles from the dlp file. Steal the reference.                */
-    csv_data->phase_deg_vals = dlp_dat->phase_deg_vals;
-    csv_data->phi_deg_vals = dlp_dat->phi_ora_deg_vals;
-    csv_data->B_deg_vals = dlp_dat->B_deg_vals;
-    csv_data->phi_rl_deg_vals = dlp_dat->phi_rl_deg_vals;
-
-    temp = (csv_data->rho_km_vals[1] - csv_data->rho_km_vals[0]) /
-           (csv_data->t_set_spm_vals[1] - csv_data->t_set_spm_vals[0]);
+    temp = (dlp_dat->rho_km_vals[1] - dlp_dat->rho_km_vals[0]) /
+           (dlp_dat->t_set_spm_vals[1] - dlp_dat->t_set_spm_vals[0]);
 
     min_dr_dt = temp;
     max_dr_dt = temp;
@@ -403,8 +561,8 @@ rssringoccs_Extract_CSV_Data(const char *geo,
     /*  Find the minimum and maximum of drho/dt.                              */
     for (n = 1U; n < csv_data->n_elements - 1U; ++n)
     {
-        temp = (csv_data->rho_km_vals[n+1U] - csv_data->rho_km_vals[n])   /
-               (csv_data->t_set_spm_vals[n+1U] - csv_data->t_set_spm_vals[n]);
+        temp = (dlp_dat->rho_km_vals[n+1U] - dlp_dat->rho_km_vals[n])   /
+               (dlp_dat->t_set_spm_vals[n+1U] - dlp_dat->t_set_spm_vals[n]);
 
         if (temp < min_dr_dt)
             min_dr_dt = temp;
@@ -429,6 +587,7 @@ rssringoccs_Extract_CSV_Data(const char *geo,
         rssringoccs_Destroy_CalCSV(&cal_dat);
         rssringoccs_Destroy_TauCSV(&tau_dat);
         rssringoccs_Destroy_CSV_Members(csv_data);
+        return csv_data;
     }
     else if ((min_dr_dt == 0.0) || (max_dr_dt == 0.0))
     {
@@ -445,109 +604,218 @@ rssringoccs_Extract_CSV_Data(const char *geo,
         rssringoccs_Destroy_CalCSV(&cal_dat);
         rssringoccs_Destroy_TauCSV(&tau_dat);
         rssringoccs_Destroy_CSV_Members(csv_data);
+        return csv_data;
     }
-    else if (max_dr_dt < 0.0)
+
+    /*  The GEO data is sorted by time. For an ingress occultation the radius *
+     *  decreases with time, so every column read is reversed to have the     *
+     *  radius increasing. The reverse of a NULL column is not needed.        */
+    else if (need_geo && max_dr_dt < 0.0)
     {
         tmpl_Double_Array_Reverse(geo_dat->rho_km_vals, geo_dat->n_elements);
-        tmpl_Double_Array_Reverse(geo_dat->rho_dot_kms_vals,
-                                  geo_dat->n_elements);
-        tmpl_Double_Array_Reverse(geo_dat->D_km_vals, geo_dat->n_elements);
+
+        if (geo_dat->rho_dot_kms_vals)
+            tmpl_Double_Array_Reverse(geo_dat->rho_dot_kms_vals,
+                                      geo_dat->n_elements);
+
+        if (geo_dat->D_km_vals)
+            tmpl_Double_Array_Reverse(geo_dat->D_km_vals, geo_dat->n_elements);
+
+        if (geo_dat->rx_km_vals)
+            tmpl_Double_Array_Reverse(geo_dat->rx_km_vals, geo_dat->n_elements);
+
+        if (geo_dat->ry_km_vals)
+            tmpl_Double_Array_Reverse(geo_dat->ry_km_vals, geo_dat->n_elements);
+
+        if (geo_dat->rz_km_vals)
+            tmpl_Double_Array_Reverse(geo_dat->rz_km_vals, geo_dat->n_elements);
     }
 
-    tmpl_Double_Sorted_Interp1d(geo_dat->rho_km_vals,
-                                geo_dat->D_km_vals,
-                                geo_dat->n_elements,
-                                csv_data->rho_km_vals,
-                                csv_data->D_km_vals,
-                                csv_data->n_elements);
-
-    tmpl_Double_Sorted_Interp1d(geo_dat->rho_km_vals,
-                                geo_dat->rho_dot_kms_vals,
-                                geo_dat->n_elements,
-                                csv_data->rho_km_vals,
-                                csv_data->rho_dot_kms_vals,
-                                csv_data->n_elements);
-
-    tmpl_Double_Sorted_Interp1d(geo_dat->rho_km_vals,
-                                geo_dat->rx_km_vals,
-                                geo_dat->n_elements,
-                                csv_data->rho_km_vals,
-                                csv_data->rx_km_vals,
-                                csv_data->n_elements);
-
-    tmpl_Double_Sorted_Interp1d(geo_dat->rho_km_vals,
-                                geo_dat->ry_km_vals,
-                                geo_dat->n_elements,
-                                csv_data->rho_km_vals,
-                                csv_data->ry_km_vals,
-                                csv_data->n_elements);
-
-    tmpl_Double_Sorted_Interp1d(geo_dat->rho_km_vals,
-                                geo_dat->rz_km_vals,
-                                geo_dat->n_elements,
-                                csv_data->rho_km_vals,
-                                csv_data->rz_km_vals,
-                                csv_data->n_elements);
-
-    tmpl_Double_Sorted_Interp1d(cal_dat->t_oet_spm_vals,
-                                cal_f_sky_hz_vals,
-                                cal_dat->n_elements,
-                                csv_data->t_oet_spm_vals,
-                                csv_data->f_sky_hz_vals,
-                                csv_data->n_elements);
-
-    /*  Interpolate the Tau data if requested.                                */
-    if (tau)
+    /*  The columns from each file are interpolated together, so that the     *
+     *  interval and weights of each point are found once per file. The       *
+     *  ADD_INTERP_VAR macro contains an if-then statement with braces {}     *
+     *  hence there is no need for a semi-colon at the end.                   */
+    interp_ok = tmpl_True;
+
+    if (need_geo)
     {
+        n_interp = zero;
+        ADD_INTERP_VAR(geo_dat->D_km_vals, D_km_vals, RSSRINGOCCS_CSV_D_KM)
+        ADD_INTERP_VAR(geo_dat->rho_dot_kms_vals, rho_dot_kms_vals,
+                       RSSRINGOCCS_CSV_RHO_DOT_KMS)
+        ADD_INTERP_VAR(geo_dat->rx_km_vals, rx_km_vals, RSSRINGOCCS_CSV_RX_KM)
+        ADD_INTERP_VAR(geo_dat->ry_km_vals, ry_km_vals, RSSRINGOCCS_CSV_RY_KM)
+        ADD_INTERP_VAR(geo_dat->rz_km_vals, rz_km_vals, RSSRINGOCCS_CSV_RZ_KM)
+
+        interp_ok = rssringoccs_CSV_Interp_Columns(geo_dat->rho_km_vals,
+                                                   interp_in,
+                                                   geo_dat->n_elements,
+                                                   dlp_dat->rho_km_vals,
+                                                   interp_out,
+                                                   csv_data->n_elements,
+                                                   n_interp,
+                                                   rssringoccs_Interp_Linear);
+    }
+
+    if (need_cal && interp_ok)
+    {
+        /*  Steal the pointer to avoid a call to malloc. It is destroyed in   *
+         *  the end anyways, so no harm done.                                 */
+        cal_f_sky_hz_vals = cal_dat->f_sky_pred_vals;
+
+        /*  The sky frequency is the difference of the predicted and residual *
+         *  frequencies. Loop through the arrays and compute the difference.  */
+        for (n = zero; n < cal_dat->n_elements; ++n)
+            cal_f_sky_hz_vals[n] -= cal_dat->f_sky_resid_fit_vals[n];
+
+        interp_in[0] = cal_f_sky_hz_vals;
+        interp_out[0] = csv_data->f_sky_hz_vals;
+
+        interp_ok = rssringoccs_CSV_Interp_Columns(cal_dat->t_oet_spm_vals,
+                                                   interp_in,
+                                                   cal_dat->n_elements,
+                                                   dlp_dat->t_oet_spm_vals,
+                                                   interp_out,
+                                                   csv_data->n_elements,
+                                                   1,
+                                                   rssringoccs_Interp_Linear);
+    }
+
+    /*  Interpolate the Tau data if requested. The deprecated format has no   *
+     *  power, and the optical depth is interpolated in its place.            */
+    if (need_tau && interp_ok)
+    {
+        n_interp = zero;
+
         if (use_deprecated)
         {
-            tmpl_Double_Sorted_Interp1d(tau_dat->rho_km_vals,
-                                        tau_dat->tau_vals,
-                                        tau_dat->n_elements,
-                                        csv_data->rho_km_vals,
-                                        csv_data->tau_power,
-                                        csv_data->n_elements);
-
-            for (n = zero; n < csv_data->n_elements; ++n)
-            {
-                mu = tmpl_Double_Sind(tmpl_Double_Abs(csv_data->B_deg_vals[n]));
-                log_power = -csv_data->tau_power[n] / mu;
-                csv_data->tau_power[n] = tmpl_Double_Exp(log_power);
-            }
+            ADD_INTERP_VAR(tau_dat->tau_vals, tau_power,
+                           RSSRINGOCCS_CSV_TAU_POWER)
         }
         else
-            tmpl_Double_Sorted_Interp1d(tau_dat->rho_km_vals,
-                                        tau_dat->power_vals,
-                                        tau_dat->n_elements,
-                                        csv_data->rho_km_vals,
-                                        csv_data->tau_power,
-                                        csv_data->n_elements);
-
-
-        tmpl_Double_Sorted_Interp1d(tau_dat->rho_km_vals,
-                                    tau_dat->phase_deg_vals,
-                                    tau_dat->n_elements,
-                                    csv_data->rho_km_vals,
-                                    csv_data->tau_phase,
-                                    csv_data->n_elements);
-
-        tmpl_Double_Sorted_Interp1d(tau_dat->rho_km_vals,
-                                    tau_dat->tau_vals,
-                                    tau_dat->n_elements,
-                                    csv_data->rho_km_vals,
-                                    csv_data->tau_vals,
-                                    csv_data->n_elements);
+        {
+            ADD_INTERP_VAR(tau_dat->power_vals, tau_power,
+                           RSSRINGOCCS_CSV_TAU_POWER)
+        }
+
+        ADD_INTERP_VAR(tau_dat->phase_deg_vals, tau_phase,
+                       RSSRINGOCCS_CSV_TAU_PHASE)
+        ADD_INTERP_VAR(tau_dat->tau_vals, tau_vals, RSSRINGOCCS_CSV_TAU_VALS)
+
+        interp_ok = rssringoccs_CSV_Interp_Columns(tau_dat->rho_km_vals,
+                                                   interp_in,
+                                                   tau_dat->n_elements,
+                                                   dlp_dat->rho_km_vals,
+                                                   interp_out,
+                                                   csv_data->n_elements,
+                                                   n_interp,
+                                                   rssringoccs_Interp_Linear);
+    }
+
+    if (!interp_ok)
+    {
+        csv_data->error_occurred = tmpl_True;
+        csv_data->error_message = tmpl_strdup(
+            "Error Encountered: rss_ringoccs\n"
+            "\trssringoccs_Extract_CSV_Data\n\n"
+            "rssringoccs_CSV_Interp_Columns failed. Aborting.\n"
+        );
+        rssringoccs_Destroy_GeoCSV(&geo_dat);
+        rssringoccs_Destroy_DLPCSV(&dlp_dat);
+        rssringoccs_Destroy_CalCSV(&cal_dat);
+        rssringoccs_Destroy_TauCSV(&tau_dat);
+        rssringoccs_Destroy_CSV_Members(csv_data);
+        return csv_data;
+    }
+
+    /*  Compute the power from the interpolated optical depth.                */
+    if (need_tau && use_deprecated && (columns & RSSRINGOCCS_CSV_TAU_POWER))
+    {
+        for (n = zero; n < csv_data->n_elements; ++n)
+        {
+            mu = tmpl_Double_Sind(tmpl_Double_Abs(dlp_dat->B_deg_vals[n]));
+            log_power = -csv_data->tau_power[n] / mu;
+            csv_data->tau_power[n] = tmpl_Double_Exp(log_power);
+        }
     }
 
-    /*  Free the Geo, Cal, and TAU structs. The CSV struct stole several      *
-     *  pointers from the DLP struct, so do not destroy this.                 */
+    /*  The references to the requested DLP variables can be stolen to avoid  *
+     *  copying. The TAKE_CSV_VAR macro contains an if-then statement with    *
+     *  braces {} hence there is no need for a semi-colon at the end.         */
+    TAKE_CSV_VAR(rho_km_vals, rho_km_vals, RSSRINGOCCS_CSV_RHO_KM)
+    TAKE_CSV_VAR(raw_tau_vals, raw_tau_vals, RSSRINGOCCS_CSV_RAW_TAU)
+    TAKE_CSV_VAR(t_ret_spm_vals, t_ret_spm_vals, RSSRINGOCCS_CSV_T_RET_SPM)
+    TAKE_CSV_VAR(t_set_spm_vals, t_set_spm_vals, RSSRINGOCCS_CSV_T_SET_SPM)
+    TAKE_CSV_VAR(t_oet_spm_vals, t_oet_spm_vals, RSSRINGOCCS_CSV_T_OET_SPM)
+    TAKE_CSV_VAR(rho_corr_pole_km_vals, rho_corr_pole_km_vals,
+                 RSSRINGOCCS_CSV_RHO_CORR_POLE_KM)
+    TAKE_CSV_VAR(rho_corr_timing_km_vals, rho_corr_timing_km_vals,
+                 RSSRINGOCCS_CSV_RHO_CORR_TIMING_KM)
+    TAKE_CSV_VAR(raw_tau_threshold_vals, raw_tau_threshold_vals,
+                 RSSRINGOCCS_CSV_RAW_TAU_THRESHOLD)
+
+    /*  The new TAB files have normalized power included.                     */
+    if (!use_deprecated)
+    {
+        TAKE_CSV_VAR(p_norm_vals, p_norm_vals, RSSRINGOCCS_CSV_P_NORM)
+    }
+
+    /*  Various angles from the dlp file. Steal the reference.                */
+    TAKE_CSV_VAR(phase_deg_vals, phase_deg_vals, RSSRINGOCCS_CSV_PHASE_DEG)
+    TAKE_CSV_VAR(phi_deg_vals, phi_ora_deg_vals, RSSRINGOCCS_CSV_PHI_DEG)
+    TAKE_CSV_VAR(B_deg_vals, B_deg_vals, RSSRINGOCCS_CSV_B_DEG)
+    TAKE_CSV_VAR(phi_rl_deg_vals, phi_rl_deg_vals, RSSRINGOCCS_CSV_PHI_RL_DEG)
+
+    /*  Free the Geo, Cal, and TAU structs, and what is left of the DLP       *
+     *  struct. The columns the CSV struct stole from it are NULL, and only   *
+     *  the ones that were read to compute others are freed.                  */
     rssringoccs_Destroy_GeoCSV(&geo_dat);
     rssringoccs_Destroy_CalCSV(&cal_dat);
     rssringoccs_Destroy_TauCSV(&tau_dat);
-
-    /*  The members of the DLP struct cannot be freed, the CSV struct has the *
-     *  same pointers. We can, however, free the pointer itself. We will not  *
-     *  lose references to its members since csv_data has these.              */
-    free(dlp_dat);
+    rssringoccs_Destroy_DLPCSV(&dlp_dat);
     return csv_data;
 }
+/*  End of rssringoccs_Extract_CSV_Data_Selected.                             */
+
+/*  Extracts all data from CSV (.TAB) files and creates a DLP-like struct.    */
+rssringoccs_CSVData *
+rssringoccs_Extract_CSV_Data(const char *geo,
+                             const char *cal,
+                             const char *dlp,
+                             const char *tau,
+                             tmpl_Bool use_deprecated)
+{
+    return rssringoccs_Extract_CSV_Data_Selected(geo, cal, dlp, tau,
+                                                 use_deprecated, NULL,
+                                                 RSSRINGOCCS_CSV_ALL_COLUMNS);
+}
+/*  End of rssringoccs_Extract_CSV_Data.                                      */
+
+rssringoccs_CSVData *
+rssringoccs_Extract_CSV_Data_Range(const char *geo,
+                                   const char *cal,
+                                   const char *dlp,
+                                   const char *tau,
+                                   tmpl_Bool use_deprecated,
+                                   double rho_min,
+                                   double rho_max,
+                                   double halo)
+{
+    double range[2];
+
+    range[0] = rho_min - halo;
+    range[1] = rho_max + halo;
+    return rssringoccs_Extract_CSV_Data_Selected(geo, cal, dlp, tau,
+                                                 use_deprecated, range,
+                                                 RSSRINGOCCS_CSV_ALL_COLUMNS);
+}
+/*  End of rssringoccs_Extract_CSV_Data_Range.                                */
+
+/*  Undefine the Macro functions.                                             */
+#undef MALLOC_CSV_VAR
+#undef MALLOC_CSV_COLUMN
+#undef TAKE_CSV_VAR
+#undef ADD_INTERP_VAR
+#undef RSSRINGOCCS_CSV_GEO_COLUMNS
+#undef RSSRINGOCCS_CSV_CAL_COLUMNS
+#undef RSSRINGOCCS_CSV_TAU_COLUMNS
@@ -23,7 +23,7 @@
  *  Date:       December 31, 2020                                             *
  ******************************************************************************/
 
-/*  Booleans, interpolation, math routines, and more.                         */
+/*  Booleans and tmpl_strdup are found here.                                  */
 #include <libtmpl/include/tmpl.h>
 
 /*  Typedefs for CSV structs and function prototype given here.               */
@@ -32,56 +32,26 @@
 /*  malloc and free are found here.                                           */
 #include <stdlib.h>
 
-/*  Functions for reading and writing files.                                  */
-#include <stdio.h>
-
-/*  strtok function provided here.                                            */
-#include <string.h>
-
 /*  Check if the macro name is available.                                     */
-#ifdef MALLOC_CAL_VAR
-#undef MALLOC_CAL_VAR
+#ifdef TAKE_CAL_VAR
+#undef TAKE_CAL_VAR
 #endif
 
-/*  Macro function for safely allocating memory for the variables. This       *
- *  checks if malloc fails, and does not simply assume it passed.             */
-#define MALLOC_CAL_VAR(var)                                                    \
-    cal->var = malloc(sizeof(*cal->var) * cal->n_elements);                    \
-    if (cal->var == NULL)                                                      \
-    {                                                                          \
-        cal->error_occurred = tmpl_True;                                       \
-        cal->error_message = tmpl_strdup(                                      \
-            "Error Encountered: rss_ringoccs\n"                                \
-            "\ttrssringoccs_Get_Cal\n\n"                                       \
-            "Malloc returned NULL. Failed to allocate memory for " #var ".\n"  \
-            "Aborting computation and returning.\n"                            \
-        );                                                                     \
-                                                                               \
-        /*  Free the variables that have been malloc'd so far.               */\
-        rssringoccs_Destroy_CalCSV_Members(cal);                               \
-        fclose(fp);                                                            \
-        return cal;                                                            \
-    }
+/*  Macro for moving a column of the CSV into the cal struct. The column is   *
+ *  set to NULL so that rssringoccs_Destroy_CSV_Columns_Members skips it.     */
+#define TAKE_CAL_VAR(var, m) cal->var = csv.data[m]; csv.data[m] = NULL;
 
-/*  Function for extracting the data from a CAL.TAB file.                     */
-rssringoccs_CalCSV *rssringoccs_Get_Cal(const char *filename)
+/*  Extracts the columns of a CAL.TAB file whose bits are set in columns.     */
+rssringoccs_CalCSV *
+rssringoccs_Get_Cal_Selected(const char *filename, unsigned long columns)
 {
-    /*  Pointer to a CalCSV struct.                                           */
+    /*  Pointer to the Cal struct.                                            */
     rssringoccs_CalCSV *cal;
 
-    /*  File object for the file we're reading.                               */
-    FILE *fp;
+    /*  The columns of the file.                                              */
+    rssringoccs_CSV_Columns csv;
 
-    /*  Buffer for reading a line of the CSV into.                            */
-    char buffer[1024];
-
-    /*  Variables used for parsing the contents of the CSV.                   */
-    char *record, *line;
-
-    unsigned int column_count = 0U;
-    size_t n = 0;
-
-    /*  Allocate memory for the CalCSV object.                                */
+    /*  Allocate memory for the cal data.                                     */
     cal = malloc(sizeof(*cal));
 
     /*  Check if malloc failed.                                               */
@@ -100,91 +70,48 @@ rssringoccs_CalCSV *rssringoccs_Get_Cal(const char *filename)
     cal->n_elements = 0UL;
     cal->error_occurred = tmpl_False;
 
-    /*  Try to open the input file.                                           */
-    fp = fopen(filename, "r");
+    /*  Read the requested columns of the file in one pass. The members of    *
+     *  the struct are in the order of the columns, so the bits are the same. */
+    rssringoccs_CSV_Read_Selected(&csv, filename, NULL, columns);
 
-    /*  If fopen returned NULL, the file likely does not exist. Return error. */
-    if (fp == NULL)
+    if (csv.error_occurred)
     {
         cal->error_occurred = tmpl_True;
-        cal->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\trssringoccs_Get_Cal\n\n"
-            "fopen returned NULL. Failed to open file for reading.\n"
-            "It is likely the filename is incorrect or does not exist.\n"
-        );
+        cal->error_message = csv.error_message;
         return cal;
     }
 
-    /*  Count the number of columns.                                          */
-    line = fgets(buffer, sizeof(buffer), fp);
-
-    /*  CAL.TAB files are comma separeted, so count the number of commas.     */
-    record = strtok(line, ",");
-
-    while (record != NULL)
-    {
-        record = strtok(NULL, ",");
-        column_count++;
-
-        /*  The CAL file should have exactly 4 columns.                       */
-        if (column_count > 4U)
-            break;
-    }
-
     /*  There should be 4 columns. Check this.                                */
-    if (column_count != 4U)
+    if (csv.n_columns != 4U)
     {
         cal->error_occurred = tmpl_True;
         cal->error_message = tmpl_strdup(
             "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Cal\n\n"
+            "\trssringoccs_Get_Cal\n\n"
             "Input CSV does not have 4 columns. Aborting computation.\n"
         );
-        fclose(fp);
+        rssringoccs_Destroy_CSV_Columns_Members(&csv);
         return cal;
     }
 
-    /*  Reset the file back to the start.                                     */
-    rewind(fp);
-
-    /*  Count the number of lines in the CSV.                                 */
-    cal->n_elements = tmpl_Line_Count(fp);
-
-    /*  Use the MALLOC_CAL_VAR macro function to allocate memory and check    *
-     *  for errors. This macro ends with an if-then statement, and ends in    *
-     *  curly braces {}, hence no need for a semi-colon here.                 */
-    MALLOC_CAL_VAR(t_oet_spm_vals)
-    MALLOC_CAL_VAR(f_sky_pred_vals)
-    MALLOC_CAL_VAR(f_sky_resid_fit_vals)
-    MALLOC_CAL_VAR(p_free_vals)
-
-    /*  Read in all of the data.                                              */
-    line = fgets(buffer, sizeof(buffer), fp);
-
-    while(line != NULL)
-    {
-        record = strtok(line, ",");
-        cal->t_oet_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        cal->f_sky_pred_vals[n] = atof(record);
+    cal->n_elements = csv.n_rows;
 
-        record = strtok(NULL, ",");
-        cal->f_sky_resid_fit_vals[n] = atof(record);
+    TAKE_CAL_VAR(t_oet_spm_vals, 0)
+    TAKE_CAL_VAR(f_sky_pred_vals, 1)
+    TAKE_CAL_VAR(f_sky_resid_fit_vals, 2)
+    TAKE_CAL_VAR(p_free_vals, 3)
 
-        record = strtok(NULL, ",");
-        cal->p_free_vals[n] = atof(record);
-
-        line = fgets(buffer, sizeof(buffer), fp);
-        ++n;
-    }
-
-    /*  Close the file.                                                       */
-    fclose(fp);
+    rssringoccs_Destroy_CSV_Columns_Members(&csv);
     return cal;
 }
+/*  End of rssringoccs_Get_Cal_Selected.                                      */
+
+/*  Function for extracting the data from a CAL.TAB file.                     */
+rssringoccs_CalCSV *rssringoccs_Get_Cal(const char *filename)
+{
+    return rssringoccs_Get_Cal_Selected(filename, ~0UL);
+}
 /*  End of rssringoccs_Get_Cal.                                               */
 
 /*  Undefine the Macro function.                                              */
-#undef MALLOC_CAL_VAR
+#undef TAKE_CAL_VAR
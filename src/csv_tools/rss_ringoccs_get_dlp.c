@@ -23,7 +23,7 @@
  *  Date:       December 31, 2020                                             *
  ******************************************************************************/
 
-/*  Booleans, interpolation, math routines, and more.                         */
+/*  Booleans and tmpl_strdup are found here.                                  */
 #include <libtmpl/include/tmpl.h>
 
 /*  Typedefs for CSV structs and function prototype given here.               */
@@ -32,55 +32,29 @@
 /*  malloc and free are found here.                                           */
 #include <stdlib.h>
 
-/*  Functions for reading and writing files.                                  */
-#include <stdio.h>
-
-/*  strtok function provided here.                                            */
-#include <string.h>
-
 /*  Check if the macro name is available.                                     */
-#ifdef MALLOC_DLP_VAR
-#undef MALLOC_DLP_VAR
+#ifdef TAKE_DLP_VAR
+#undef TAKE_DLP_VAR
 #endif
 
-/*  Macro function for safely allocating memory for the variables. This       *
- *  checks if malloc fails, and does not simply assume it passed.             */
-#define MALLOC_DLP_VAR(var)                                                    \
-    dlp->var = malloc(sizeof(*dlp->var) * dlp->n_elements);                    \
-    if (dlp->var == NULL)                                                      \
-    {                                                                          \
-        dlp->error_occurred = tmpl_True;                                       \
-        dlp->error_message = tmpl_strdup(                                      \
-            "Error Encountered: rss_ringoccs\n"                                \
-            "\ttrssringoccs_Get_DLP\n\n"                                       \
-            "Malloc returned NULL. Failed to allocate memory for " #var ".\n"  \
-            "Aborting computation and returning.\n"                            \
-        );                                                                     \
-                                                                               \
-        /*  Free the variables that have been malloc'd so far.               */\
-        rssringoccs_Destroy_DLPCSV_Members(dlp);                               \
-        fclose(fp);                                                            \
-        return dlp;                                                            \
-    }
+/*  Macro for moving a column of the CSV into the dlp struct. The column is   *
+ *  set to NULL so that rssringoccs_Destroy_CSV_Columns_Members skips it.     */
+#define TAKE_DLP_VAR(var, m) dlp->var = csv.data[m]; csv.data[m] = NULL;
 
-/*  Function for extracting the data from a DLP.TAB file.                     */
+/*  Extracts the columns of a DLP.TAB file whose bits are set in columns,     *
+ *  and with range non-NULL, only the rows with a radius between range[0]     *
+ *  and range[1].                                                             */
 rssringoccs_DLPCSV *
-rssringoccs_Get_DLP(const char *filename, tmpl_Bool use_deprecated)
+rssringoccs_Get_DLP_Selected(const char *filename,
+                             tmpl_Bool use_deprecated,
+                             const double *range,
+                             unsigned long columns)
 {
     /*  Pointer to the DLP struct.                                            */
     rssringoccs_DLPCSV *dlp;
 
-    /*  File pointer for the CSV file.                                        */
-    FILE *fp;
-
-    /*  Buffer for reading the file line by line.                             */
-    char buffer[1024];
-
-    /*  Variables for parsing the contents of the CSV file.                   */
-    char *record, *line;
-
-    unsigned int column_count = 0U;
-    size_t n = 0;
+    /*  The columns of the file.                                              */
+    rssringoccs_CSV_Columns csv;
 
     /*  Allocate memory for the dlp data.                                     */
     dlp = malloc(sizeof(*dlp));
@@ -98,7 +72,6 @@ rssringoccs_Get_DLP(const char *filename, tmpl_Bool use_deprecated)
     dlp->rho_corr_timing_km_vals = NULL;
     dlp->phi_rl_deg_vals = NULL;
     dlp->phi_ora_deg_vals = NULL;
-    dlp->p_norm_vals = NULL;
     dlp->raw_tau_vals = NULL;
     dlp->phase_deg_vals = NULL;
     dlp->raw_tau_threshold_vals = NULL;
@@ -106,44 +79,29 @@ rssringoccs_Get_DLP(const char *filename, tmpl_Bool use_deprecated)
     dlp->t_ret_spm_vals = NULL;
     dlp->t_set_spm_vals = NULL;
     dlp->B_deg_vals = NULL;
+    dlp->p_norm_vals = NULL;
     dlp->error_message = NULL;
     dlp->n_elements = 0UL;
     dlp->error_occurred = tmpl_False;
 
-    /*  Try to open the input file.                                           */
-    fp = fopen(filename, "r");
+    /*  The bits follow the members of the struct, which are in the order of  *
+     *  the columns of the current format. The deprecated format does not     *
+     *  have column 5, so the bits after it are shifted right by one.         */
+    if (use_deprecated)
+        columns = (columns & 0x1FUL) | ((columns >> 1) & ~0x1FUL);
 
-    /*  If fopen returned NULL, the file likely does not exist. Return error. */
-    if (fp == NULL)
+    /*  Read the requested columns of the file in one pass.                   */
+    rssringoccs_CSV_Read_Selected(&csv, filename, range, columns);
+
+    if (csv.error_occurred)
     {
         dlp->error_occurred = tmpl_True;
-        dlp->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\trssringoccs_Get_DLP\n\n"
-            "fopen returned NULL. Failed to open file for reading.\n"
-            "It is likely the filename is incorrect or does not exist.\n"
-        );
+        dlp->error_message = csv.error_message;
         return dlp;
     }
 
-    /*  Count the number of columns.                                          */
-    line = fgets(buffer, sizeof(buffer), fp);
-
-    /*  DLP.TAB files are comma separeted, so count the number of commas.     */
-    record = strtok(line, ",");
-
-    while (record != NULL)
-    {
-        record = strtok(NULL, ",");
-        column_count++;
-
-        /*  The DLP file should have 12 or 13 columns.                        */
-        if (column_count > 13U)
-            break;
-    }
-
-    /*  If use_deprecated was set to true, column_count must be 12. Check.    */
-    if ((column_count != 12) && (use_deprecated))
+    /*  If use_deprecated was set to true, there must be 12 columns. Check.   */
+    if ((csv.n_columns != 12U) && (use_deprecated))
     {
         dlp->error_occurred = tmpl_True;
         dlp->error_message = tmpl_strdup(
@@ -152,110 +110,83 @@ rssringoccs_Get_DLP(const char *filename, tmpl_Bool use_deprecated)
             "use_deprecated is set to true but the input CSV does not have\n"
             "12 columns. Aborting computation.\n"
         );
-        fclose(fp);
+        rssringoccs_Destroy_CSV_Columns_Members(&csv);
         return dlp;
     }
 
-    /*  And if use_deprecated is false, we need 13 column. Check this.        */
-    else if ((column_count != 13) && (!use_deprecated))
+    /*  And if use_deprecated is false, we need 13 columns. Check this.       */
+    else if ((csv.n_columns != 13U) && (!use_deprecated))
     {
         dlp->error_occurred = tmpl_True;
         dlp->error_message = tmpl_strdup(
             "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_DLP\n\n"
+            "\trssringoccs_Get_DLP\n\n"
             "use_deprecated is set to false but the input CSV does not have\n"
             "13 columns. Aborting computation.\n"
         );
-        fclose(fp);
+        rssringoccs_Destroy_CSV_Columns_Members(&csv);
         return dlp;
     }
 
-    /*  Reset the file back to the start.                                     */
-    rewind(fp);
+    dlp->n_elements = csv.n_rows;
 
-    /*  Count the number of lines in the CSV.                                 */
-    dlp->n_elements = tmpl_Line_Count(fp);
+    /*  The deprecated format does not have column 5. The columns after it    *
+     *  are shifted left by one.                                              */
+    TAKE_DLP_VAR(rho_km_vals, 0)
+    TAKE_DLP_VAR(rho_corr_pole_km_vals, 1)
+    TAKE_DLP_VAR(rho_corr_timing_km_vals, 2)
+    TAKE_DLP_VAR(phi_rl_deg_vals, 3)
+    TAKE_DLP_VAR(phi_ora_deg_vals, 4)
 
-    /*  Use the MALLOC_DLP_VAR macro function to allocate memory and check    *
-     *  for errors. This macro ends with an if-then statement, and ends in    *
-     *  curly braces {}, hence no need for a semi-colon here.                 */
-    MALLOC_DLP_VAR(t_oet_spm_vals)
-    MALLOC_DLP_VAR(t_ret_spm_vals)
-    MALLOC_DLP_VAR(t_set_spm_vals)
-    MALLOC_DLP_VAR(rho_km_vals)
-    MALLOC_DLP_VAR(rho_corr_pole_km_vals)
-    MALLOC_DLP_VAR(rho_corr_timing_km_vals)
-    MALLOC_DLP_VAR(phi_rl_deg_vals)
-    MALLOC_DLP_VAR(phi_ora_deg_vals)
-    MALLOC_DLP_VAR(B_deg_vals)
-    MALLOC_DLP_VAR(raw_tau_vals)
-    MALLOC_DLP_VAR(phase_deg_vals)
-    MALLOC_DLP_VAR(raw_tau_threshold_vals)
-
-
-    /*  If we're using the older deprecated format, there are 13 columns.     *
-     *  Allocate memory for p_norm_vals as well.                              */
-    if (!use_deprecated)
+    if (use_deprecated)
     {
-        MALLOC_DLP_VAR(p_norm_vals)
+        TAKE_DLP_VAR(raw_tau_vals, 5)
+        TAKE_DLP_VAR(phase_deg_vals, 6)
+        TAKE_DLP_VAR(raw_tau_threshold_vals, 7)
+        TAKE_DLP_VAR(t_oet_spm_vals, 8)
+        TAKE_DLP_VAR(t_ret_spm_vals, 9)
+        TAKE_DLP_VAR(t_set_spm_vals, 10)
+        TAKE_DLP_VAR(B_deg_vals, 11)
     }
-
-    /*  Read in all of the data.                                              */
-    line = fgets(buffer, sizeof(buffer), fp);
-
-    while(line != NULL)
+    else
     {
-        record = strtok(line, ",");
-        dlp->rho_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->rho_corr_pole_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->rho_corr_timing_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->phi_rl_deg_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->phi_ora_deg_vals[n] = atof(record);
-
-        if (!use_deprecated)
-        {
-            record = strtok(NULL, ",");
-            dlp->p_norm_vals[n] = atof(record);
-        }
-
-        record = strtok(NULL, ",");
-        dlp->raw_tau_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->phase_deg_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->raw_tau_threshold_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->t_oet_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->t_ret_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->t_set_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        dlp->B_deg_vals[n] = atof(record);
-
-        line = fgets(buffer, sizeof(buffer), fp);
-        ++n;
+        TAKE_DLP_VAR(p_norm_vals, 5)
+        TAKE_DLP_VAR(raw_tau_vals, 6)
+        TAKE_DLP_VAR(phase_deg_vals, 7)
+        TAKE_DLP_VAR(raw_tau_threshold_vals, 8)
+        TAKE_DLP_VAR(t_oet_spm_vals, 9)
+        TAKE_DLP_VAR(t_ret_spm_vals, 10)
+        TAKE_DLP_VAR(t_set_spm_vals, 11)
+        TAKE_DLP_VAR(B_deg_vals, 12)
     }
 
-    /*  Close the file.                                                       */
-    fclose(fp);
+    rssringoccs_Destroy_CSV_Columns_Members(&csv);
     return dlp;
 }
+/*  End of rssringoccs_Get_DLP_Selected.                                      */
+
+/*  Function for extracting the data from a DLP.TAB file.                     */
+rssringoccs_DLPCSV *
+rssringoccs_Get_DLP(const char *filename, tmpl_Bool use_deprecated)
+{
+    return rssringoccs_Get_DLP_Selected(filename, use_deprecated, NULL, ~0UL);
+}
 /*  End of rssringoccs_Get_DLP.                                               */
 
+rssringoccs_DLPCSV *
+rssringoccs_Get_DLP_Range(const char *filename,
+                          tmpl_Bool use_deprecated,
+                          double rho_min,
+                          double rho_max)
+{
+    double range[2];
+
+    range[0] = rho_min;
+    range[1] = rho_max;
+    return rssringoccs_Get_DLP_Selected(filename, use_deprecated,
+                                        range, ~0UL);
+}
+/*  End of rssringoccs_Get_DLP_Range.                                         */
+
 /*  Undefine the Macro function.                                              */
-#undef MALLOC_DLP_VAR
+#undef TAKE_DLP_VAR
@@ -23,7 +23,7 @@
  *  Date:       December 31, 2020                                             *
  ******************************************************************************/
 
-/*  Booleans, interpolation, math routines, and more.                         */
+/*  Booleans and tmpl_strdup are found here.                                  */
 #include <libtmpl/include/tmpl.h>
 
 /*  Typedefs for CSV structs and function prototype given here.               */
@@ -32,55 +32,26 @@
 /*  malloc and free are found here.                                           */
 #include <stdlib.h>
 
-/*  Functions for reading and writing files.                                  */
-#include <stdio.h>
-
-/*  strtok function provided here.                                            */
-#include <string.h>
-
 /*  Check if the macro name is available.                                     */
-#ifdef MALLOC_GEO_VAR
-#undef MALLOC_GEO_VAR
+#ifdef TAKE_GEO_VAR
+#undef TAKE_GEO_VAR
 #endif
 
-/*  Macro function for safely allocating memory for the variables. This       *
- *  checks if malloc fails, and does not simply assume it passed.             */
-#define MALLOC_GEO_VAR(var)                                                    \
-    geo->var = malloc(sizeof(*geo->var) * geo->n_elements);                    \
-    if (geo->var == NULL)                                                      \
-    {                                                                          \
-        geo->error_occurred = tmpl_True;                                       \
-        geo->error_message = tmpl_strdup(                                      \
-            "Error Encountered: rss_ringoccs\n"                                \
-            "\ttrssringoccs_Get_Cal\n\n"                                       \
-            "Malloc returned NULL. Failed to allocate memory for " #var ".\n"  \
-            "Aborting computation and returning.\n"                            \
-        );                                                                     \
-                                                                               \
-        /*  Free the variables that have been malloc'd so far.               */\
-        rssringoccs_Destroy_GeoCSV_Members(geo);                               \
-        fclose(fp);                                                            \
-        return geo;                                                            \
-    }
+/*  Macro for moving a column of the CSV into the geo struct. The column is   *
+ *  set to NULL so that rssringoccs_Destroy_CSV_Columns_Members skips it.     */
+#define TAKE_GEO_VAR(var, m) geo->var = csv.data[m]; csv.data[m] = NULL;
 
-/*  Function for extracting the data from a CAL.TAB file.                     */
+/*  Extracts the columns of a GEO.TAB file whose bits are set in columns.     */
 rssringoccs_GeoCSV *
-rssringoccs_Get_Geo(const char *filename, tmpl_Bool use_deprecated)
+rssringoccs_Get_Geo_Selected(const char *filename,
+                             tmpl_Bool use_deprecated,
+                             unsigned long columns)
 {
     /*  Pointer to the Geo struct.                                            */
     rssringoccs_GeoCSV *geo;
 
-    /*  File pointer for the CSV file.                                        */
-    FILE *fp;
-
-    /*  Buffer for reading the file line by line.                             */
-    char buffer[1024];
-
-    /*  Variables for parsing the contents of the CSV file.                   */
-    char *record, *line;
-
-    unsigned int column_count = 0U;
-    size_t n = 0;
+    /*  The columns of the file.                                              */
+    rssringoccs_CSV_Columns csv;
 
     /*  Allocate memory for the geo data.                                     */
     geo = malloc(sizeof(*geo));
@@ -116,40 +87,19 @@ rssringoccs_Get_Geo(const char *filename, tmpl_Bool use_deprecated)
     geo->n_elements = 0UL;
     geo->error_occurred = tmpl_False;
 
-    /*  Try to open the input file.                                           */
-    fp = fopen(filename, "r");
+    /*  Read the requested columns of the file in one pass. The members of    *
+     *  the struct are in the order of the columns, so the bits are the same. */
+    rssringoccs_CSV_Read_Selected(&csv, filename, NULL, columns);
 
-    /*  If fopen returned NULL, the file likely does not exist. Return error. */
-    if (fp == NULL)
+    if (csv.error_occurred)
     {
         geo->error_occurred = tmpl_True;
-        geo->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\trssringoccs_Get_Geo\n\n"
-            "fopen returned NULL. Failed to open file for reading.\n"
-            "It is likely the filename is incorrect or does not exist.\n"
-        );
+        geo->error_message = csv.error_message;
         return geo;
     }
 
-    /*  Count the number of columns.                                          */
-    line = fgets(buffer, sizeof(buffer), fp);
-
-    /*  GEO.TAB files are comma separeted, so count the number of commas.     */
-    record = strtok(line, ",");
-
-    while (record != NULL)
-    {
-        record = strtok(NULL, ",");
-        column_count++;
-
-        /*  The GEO file should have either 18 or 19 columns.                 */
-        if (column_count > 19U)
-            break;
-    }
-
-    /*  If use_deprecated was set to true, column_count must be 18. Check.    */
-    if ((column_count != 18U) && (use_deprecated))
+    /*  If use_deprecated was set to true, there must be 18 columns. Check.   */
+    if ((csv.n_columns != 18U) && (use_deprecated))
     {
         geo->error_occurred = tmpl_True;
         geo->error_message = tmpl_strdup(
@@ -158,12 +108,12 @@ rssringoccs_Get_Geo(const char *filename, tmpl_Bool use_deprecated)
             "use_deprecated is set to true but the input CSV does not have\n"
             "18 columns. Aborting computation.\n"
         );
-        fclose(fp);
+        rssringoccs_Destroy_CSV_Columns_Members(&csv);
         return geo;
     }
 
-    /*  And if use_deprecated is false, we need 19 column. Check this.        */
-    else if ((column_count != 19U) && (!use_deprecated))
+    /*  And if use_deprecated is false, we need 19 columns. Check this.       */
+    else if ((csv.n_columns != 19U) && (!use_deprecated))
     {
         geo->error_occurred = tmpl_True;
         geo->error_message = tmpl_strdup(
@@ -172,119 +122,49 @@ rssringoccs_Get_Geo(const char *filename, tmpl_Bool use_deprecated)
             "use_deprecated is set to false but the input CSV does not have\n"
             "19 columns. Aborting computation.\n"
         );
-        fclose(fp);
+        rssringoccs_Destroy_CSV_Columns_Members(&csv);
         return geo;
     }
 
-    /*  Reset the file back to the start.                                     */
-    rewind(fp);
-
-    /*  Count the number of lines in the CSV.                                 */
-    geo->n_elements = tmpl_Line_Count(fp);
-
-    /*  Use the MALLOC_GEO_VAR macro function to allocate memory and check    *
-     *  for errors. This macro ends with an if-then statement, and ends in    *
-     *  curly braces {}, hence no need for a semi-colon here.                 */
-    MALLOC_GEO_VAR(t_oet_spm_vals)
-    MALLOC_GEO_VAR(t_ret_spm_vals)
-    MALLOC_GEO_VAR(t_set_spm_vals)
-    MALLOC_GEO_VAR(rho_km_vals)
-    MALLOC_GEO_VAR(phi_rl_deg_vals)
-    MALLOC_GEO_VAR(phi_ora_deg_vals)
-    MALLOC_GEO_VAR(B_deg_vals)
-    MALLOC_GEO_VAR(D_km_vals)
-    MALLOC_GEO_VAR(rho_dot_kms_vals)
-    MALLOC_GEO_VAR(phi_rl_dot_kms_vals)
-    MALLOC_GEO_VAR(F_km_vals)
-    MALLOC_GEO_VAR(R_imp_km_vals)
-    MALLOC_GEO_VAR(rx_km_vals)
-    MALLOC_GEO_VAR(ry_km_vals)
-    MALLOC_GEO_VAR(rz_km_vals)
-    MALLOC_GEO_VAR(vx_kms_vals)
-    MALLOC_GEO_VAR(vy_kms_vals)
-    MALLOC_GEO_VAR(vz_kms_vals)
-
-    /*  If we're using the older deprecated format, there are 19 columns.     *
-     *  Allocate memory for obs_spacecract_lat_deg_vals.                      */
+    geo->n_elements = csv.n_rows;
+
+    TAKE_GEO_VAR(t_oet_spm_vals, 0)
+    TAKE_GEO_VAR(t_ret_spm_vals, 1)
+    TAKE_GEO_VAR(t_set_spm_vals, 2)
+    TAKE_GEO_VAR(rho_km_vals, 3)
+    TAKE_GEO_VAR(phi_rl_deg_vals, 4)
+    TAKE_GEO_VAR(phi_ora_deg_vals, 5)
+    TAKE_GEO_VAR(B_deg_vals, 6)
+    TAKE_GEO_VAR(D_km_vals, 7)
+    TAKE_GEO_VAR(rho_dot_kms_vals, 8)
+    TAKE_GEO_VAR(phi_rl_dot_kms_vals, 9)
+    TAKE_GEO_VAR(F_km_vals, 10)
+    TAKE_GEO_VAR(R_imp_km_vals, 11)
+    TAKE_GEO_VAR(rx_km_vals, 12)
+    TAKE_GEO_VAR(ry_km_vals, 13)
+    TAKE_GEO_VAR(rz_km_vals, 14)
+    TAKE_GEO_VAR(vx_kms_vals, 15)
+    TAKE_GEO_VAR(vy_kms_vals, 16)
+    TAKE_GEO_VAR(vz_kms_vals, 17)
+
+    /*  The deprecated format does not have obs_spacecract_lat_deg_vals.      */
     if (!use_deprecated)
     {
-        MALLOC_GEO_VAR(obs_spacecract_lat_deg_vals)
-    }
-
-    /*  Read in all of the data.                                              */
-    line = fgets(buffer, sizeof(buffer), fp);
-
-    while (line != NULL)
-    {
-        record = strtok(line, ",");
-        geo->t_oet_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->t_ret_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->t_set_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->rho_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->phi_rl_deg_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->phi_ora_deg_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->B_deg_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->D_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->rho_dot_kms_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->phi_rl_dot_kms_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->F_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->R_imp_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->rx_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->ry_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->rz_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->vx_kms_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->vy_kms_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        geo->vz_kms_vals[n] = atof(record);
-
-        if (!use_deprecated)
-        {
-            record = strtok(NULL, ",");
-            geo->obs_spacecract_lat_deg_vals[n] = atof(record);
-        }
-
-        line = fgets(buffer, sizeof(buffer), fp);
-        ++n;
+        TAKE_GEO_VAR(obs_spacecract_lat_deg_vals, 18)
     }
 
-    /*  Close the file.                                                       */
-    fclose(fp);
+    rssringoccs_Destroy_CSV_Columns_Members(&csv);
     return geo;
 }
-/*  End of rssringoccs_Get_GEO.                                               */
+/*  End of rssringoccs_Get_Geo_Selected.                                      */
+
+/*  Function for extracting the data from a GEO.TAB file.                     */
+rssringoccs_GeoCSV *
+rssringoccs_Get_Geo(const char *filename, tmpl_Bool use_deprecated)
+{
+    return rssringoccs_Get_Geo_Selected(filename, use_deprecated, ~0UL);
+}
+/*  End of rssringoccs_Get_Geo.                                               */
 
 /*  Undefine the Macro function.                                              */
-#undef MALLOC_GEO_VAR
+#undef TAKE_GEO_VAR
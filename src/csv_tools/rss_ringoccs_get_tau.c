@@ -20,7 +20,7 @@
  *  Date:       December 31, 2020                                             *
  ******************************************************************************/
 
-/*  Booleans, interpolation, math routines, and more.                         */
+/*  Booleans and tmpl_strdup are found here.                                  */
 #include <libtmpl/include/tmpl.h>
 
 /*  Typedefs for CSV structs and function prototype given here.               */
@@ -29,21 +29,31 @@
 /*  malloc and free are found here.                                           */
 #include <stdlib.h>
 
-/*  Functions for reading and writing files.                                  */
-#include <stdio.h>
-
-/*  strtok function provided here.                                            */
-#include <string.h>
-
-rssringoccs_TauCSV *rssringoccs_Get_Tau(const char *filename,
-                                        tmpl_Bool use_deprecated)
+/*  Check if the macro name is available.                                     */
+#ifdef TAKE_TAU_VAR
+#undef TAKE_TAU_VAR
+#endif
+
+/*  Macro for moving a column of the CSV into the tau struct. The column is   *
+ *  set to NULL so that rssringoccs_Destroy_CSV_Columns_Members skips it.     */
+#define TAKE_TAU_VAR(var, m) tau->var = csv.data[m]; csv.data[m] = NULL;
+
+/*  Extracts the columns of a TAU.TAB file whose bits are set in columns,     *
+ *  and with range non-NULL, only the rows with a radius between range[0]     *
+ *  and range[1].                                                             */
+rssringoccs_TauCSV *
+rssringoccs_Get_Tau_Selected(const char *filename,
+                             tmpl_Bool use_deprecated,
+                             const double *range,
+                             unsigned long columns)
 {
+    /*  Pointer to the Tau struct.                                            */
     rssringoccs_TauCSV *tau;
-    FILE *fp;
-    char buffer[1024];
-    char *record, *line;
-    size_t column_count, n;
 
+    /*  The columns of the file.                                              */
+    rssringoccs_CSV_Columns csv;
+
+    /*  Allocate memory for the tau data.                                     */
     tau = malloc(sizeof(*tau));
 
     /*  Check if malloc failed.                                               */
@@ -59,7 +69,6 @@ rssringoccs_TauCSV *rssringoccs_Get_Tau(const char *filename,
     tau->rho_corr_timing_km_vals = NULL;
     tau->phi_rl_deg_vals = NULL;
     tau->phi_ora_deg_vals = NULL;
-    tau->power_vals = NULL;
     tau->tau_vals = NULL;
     tau->phase_deg_vals = NULL;
     tau->tau_threshold_vals = NULL;
@@ -67,38 +76,29 @@ rssringoccs_TauCSV *rssringoccs_Get_Tau(const char *filename,
     tau->t_ret_spm_vals = NULL;
     tau->t_set_spm_vals = NULL;
     tau->B_deg_vals = NULL;
+    tau->power_vals = NULL;
     tau->error_message = NULL;
+    tau->n_elements = 0UL;
     tau->error_occurred = tmpl_False;
-    tau->n_elements = (size_t)0;
 
-    /*  Try to open the input file.                                           */
-    fp = fopen(filename, "r");
+    /*  The bits follow the members of the struct, which are in the order of  *
+     *  the columns of the current format. The deprecated format does not     *
+     *  have column 5, so the bits after it are shifted right by one.         */
+    if (use_deprecated)
+        columns = (columns & 0x1FUL) | ((columns >> 1) & ~0x1FUL);
+
+    /*  Read the requested columns of the file in one pass.                   */
+    rssringoccs_CSV_Read_Selected(&csv, filename, range, columns);
 
-    /*  If fopen returned NULL, the file likely does not exist. Return error. */
-    if (fp == NULL)
+    if (csv.error_occurred)
     {
         tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\trssringoccs_Get_Tau\n\n"
-            "fopen returned NULL. Failed to open file for reading.\n"
-            "It is likely the filename is incorrect or does not exist.\n"
-        );
+        tau->error_message = csv.error_message;
         return tau;
     }
 
-    /*  And count the number of columns.                                      */
-    column_count = 0;
-    line = fgets(buffer,sizeof(buffer), fp);
-    record = strtok(line, ",");
-    while (record != NULL)
-    {
-        record = strtok(NULL, ",");
-        column_count++;
-    }
-
-    /*  If use_deprecated was set to true, column_count must be 12. Check.    */
-    if ((column_count != 12) && (use_deprecated))
+    /*  If use_deprecated was set to true, there must be 12 columns. Check.   */
+    if ((csv.n_columns != 12U) && (use_deprecated))
     {
         tau->error_occurred = tmpl_True;
         tau->error_message = tmpl_strdup(
@@ -107,310 +107,83 @@ rssringoccs_TauCSV *rssringoccs_Get_Tau(const char *filename,
             "use_deprecated is set to true but the input CSV does not have\n"
             "12 columns. Aborting computation.\n"
         );
-        fclose(fp);
+        rssringoccs_Destroy_CSV_Columns_Members(&csv);
         return tau;
     }
 
-    /*  And if use_deprecated is false, we need 13 column. Check this.        */
-    else if ((column_count != 13) && (!use_deprecated))
+    /*  And if use_deprecated is false, we need 13 columns. Check this.       */
+    else if ((csv.n_columns != 13U) && (!use_deprecated))
     {
         tau->error_occurred = tmpl_True;
         tau->error_message = tmpl_strdup(
             "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
+            "\trssringoccs_Get_Tau\n\n"
             "use_deprecated is set to false but the input CSV does not have\n"
             "13 columns. Aborting computation.\n"
         );
-        fclose(fp);
-        return tau;
-    }
-
-    /*  Count the number of lines in the CSV.                                 */
-    rewind(fp);
-
-    tau->n_elements = tmpl_Line_Count(fp);
-
-    /*  Allocate memory for t_oet_spm_vals and check for error.               */
-    tau->t_oet_spm_vals = malloc(sizeof(*tau->t_oet_spm_vals)*tau->n_elements);
-    if (tau->t_oet_spm_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "t_oet_spm_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for t_ret_spm_vals and check for error.               */
-    tau->t_ret_spm_vals = malloc(sizeof(*tau->t_ret_spm_vals)*tau->n_elements);
-    if (tau->t_ret_spm_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "t_ret_spm_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for t_set_spm_vals and check for error.               */
-    tau->t_set_spm_vals = malloc(sizeof(*tau->t_set_spm_vals)*tau->n_elements);
-    if (tau->t_set_spm_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "t_set_spm_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for rho_km_vals and check for error.                  */
-    tau->rho_km_vals = malloc(sizeof(*tau->rho_km_vals)*tau->n_elements);
-    if (tau->rho_km_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "rho_km_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for rho_corr_pole_km_vals and check for error.        */
-    tau->rho_corr_pole_km_vals
-        = malloc(sizeof(*tau->rho_corr_pole_km_vals)*tau->n_elements);
-    if (tau->rho_corr_pole_km_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "rho_corr_pole_km_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for rho_corr_timing_km_vals and check for error.      */
-    tau->rho_corr_timing_km_vals
-        = malloc(sizeof(*tau->rho_corr_timing_km_vals)*tau->n_elements);
-    if (tau->rho_corr_timing_km_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "rho_corr_timing_km_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for phi_rl_deg_vals and check for error.              */
-    tau->phi_rl_deg_vals = malloc(sizeof(*tau->phi_rl_deg_vals)*tau->n_elements);
-    if (tau->phi_rl_deg_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "phi_rl_deg_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for phi_ora_deg_vals and check for error.             */
-    tau->phi_ora_deg_vals = malloc(sizeof(*tau->phi_ora_deg_vals) * tau->n_elements);
-    if (tau->phi_ora_deg_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "phi_ora_deg_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for B_deg_vals and check for error.                   */
-    tau->B_deg_vals = malloc(sizeof(*tau->B_deg_vals) * tau->n_elements);
-    if (tau->B_deg_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "B_deg_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
-
-    /*  Allocate memory for tau_vals and check for error.                     */
-    tau->tau_vals = malloc(sizeof(*tau->tau_vals) * tau->n_elements);
-    if (tau->tau_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "tau_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
+        rssringoccs_Destroy_CSV_Columns_Members(&csv);
         return tau;
     }
 
-    /*  Allocate memory for phase_deg_vals and check for error.               */
-    tau->phase_deg_vals = malloc(sizeof(*tau->phase_deg_vals) * tau->n_elements);
-    if (tau->phase_deg_vals == NULL)
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "phase_deg_vals. Aborting computation and returning.\n"
-        );
+    tau->n_elements = csv.n_rows;
 
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
-    }
+    /*  The deprecated format does not have column 5. The columns after it    *
+     *  are shifted left by one.                                              */
+    TAKE_TAU_VAR(rho_km_vals, 0)
+    TAKE_TAU_VAR(rho_corr_pole_km_vals, 1)
+    TAKE_TAU_VAR(rho_corr_timing_km_vals, 2)
+    TAKE_TAU_VAR(phi_rl_deg_vals, 3)
+    TAKE_TAU_VAR(phi_ora_deg_vals, 4)
 
-    /*  Allocate memory for tau_threshold_vals and check for error.       */
-    tau->tau_threshold_vals
-        = malloc(sizeof(*tau->tau_threshold_vals) * tau->n_elements);
-    if (tau->tau_threshold_vals == NULL)
+    if (use_deprecated)
     {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "Error Encountered: rss_ringoccs\n"
-            "\ttrssringoccs_Get_Tau\n\n"
-            "Malloc returned NULL. Failed to allocate memory for.\n"
-            "tau_threshold_vals. Aborting computation and returning.\n"
-        );
-
-        /*  Free the variables that have been malloc'd so far.                */
-        rssringoccs_Destroy_TauCSV_Members(tau);
-        return tau;
+        TAKE_TAU_VAR(tau_vals, 5)
+        TAKE_TAU_VAR(phase_deg_vals, 6)
+        TAKE_TAU_VAR(tau_threshold_vals, 7)
+        TAKE_TAU_VAR(t_oet_spm_vals, 8)
+        TAKE_TAU_VAR(t_ret_spm_vals, 9)
+        TAKE_TAU_VAR(t_set_spm_vals, 10)
+        TAKE_TAU_VAR(B_deg_vals, 11)
     }
-
-    /*  If we're using the older deprecated format, there are 18 columns. Set *
-     *  the power_vals to NULL.                                               */
-    if (use_deprecated)
-        tau->power_vals = NULL;
     else
     {
-        /*  Allocate memory for power_vals.                                   */
-        tau->power_vals =
-            malloc(sizeof(*tau->power_vals) * tau->n_elements);
-        if (tau->power_vals == NULL)
-        {
-            tau->error_occurred = tmpl_True;
-            tau->error_message = tmpl_strdup(
-                "Error Encountered: rss_ringoccs\n"
-                "\trssringoccs_Get_Tau\n\n"
-                "Malloc returned NULL. Failed to allocate memory for.\n"
-                "power_vals. Aborting computation and returning.\n"
-            );
-
-            /*  Free the variables that have been malloc'd so far.            */
-            rssringoccs_Destroy_TauCSV_Members(tau);
-            return tau;
-        }
+        TAKE_TAU_VAR(power_vals, 5)
+        TAKE_TAU_VAR(tau_vals, 6)
+        TAKE_TAU_VAR(phase_deg_vals, 7)
+        TAKE_TAU_VAR(tau_threshold_vals, 8)
+        TAKE_TAU_VAR(t_oet_spm_vals, 9)
+        TAKE_TAU_VAR(t_ret_spm_vals, 10)
+        TAKE_TAU_VAR(t_set_spm_vals, 11)
+        TAKE_TAU_VAR(B_deg_vals, 12)
     }
 
-    line = fgets(buffer, sizeof(buffer), fp);
-    n = 0;
-    while(line != NULL)
-    {
-        record = strtok(line, ",");
-        tau->rho_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->rho_corr_pole_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->rho_corr_timing_km_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->phi_rl_deg_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->phi_ora_deg_vals[n] = atof(record);
-
-        if (!use_deprecated)
-        {
-            record = strtok(NULL, ",");
-            tau->power_vals[n] = atof(record);
-        }
-
-        record = strtok(NULL, ",");
-        tau->tau_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->phase_deg_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->tau_threshold_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->t_oet_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->t_ret_spm_vals[n] = atof(record);
-
-        record = strtok(NULL, ",");
-        tau->t_set_spm_vals[n] = atof(record);
+    rssringoccs_Destroy_CSV_Columns_Members(&csv);
+    return tau;
+}
+/*  End of rssringoccs_Get_Tau_Selected.                                      */
 
-        record = strtok(NULL, ",");
-        tau->B_deg_vals[n] = atof(record);
+/*  Function for extracting the data from a TAU.TAB file.                     */
+rssringoccs_TauCSV *
+rssringoccs_Get_Tau(const char *filename, tmpl_Bool use_deprecated)
+{
+    return rssringoccs_Get_Tau_Selected(filename, use_deprecated, NULL, ~0UL);
+}
+/*  End of rssringoccs_Get_Tau.                                               */
 
-        line = fgets(buffer, sizeof(buffer), fp);
-        ++n;
-    }
+rssringoccs_TauCSV *
+rssringoccs_Get_Tau_Range(const char *filename,
+                          tmpl_Bool use_deprecated,
+                          double rho_min,
+                          double rho_max)
+{
+    double range[2];
 
-    return tau;
+    range[0] = rho_min;
+    range[1] = rho_max;
+    return rssringoccs_Get_Tau_Selected(filename, use_deprecated,
+                                        range, ~0UL);
 }
+/*  End of rssringoccs_Get_Tau_Range.                                         */
+
+/*  Undefine the Macro function.                                              */
+#undef TAKE_TAU_VAR
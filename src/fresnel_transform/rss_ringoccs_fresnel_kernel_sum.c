@@ -0,0 +1,489 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                            Fresnel Kernel Sum                              *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Computes the window sums of the quadratic Fresnel and Legendre        *
+ *      transforms with SSE2, AVX2, or AVX-512 instructions, selected at run  *
+ *      time from what the CPU supports.                                      *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  Given the window w, the phases psi_L and psi_R, and the data to the left  *
+ *  and right of the center, the kernel sum is                                *
+ *                                                                            *
+ *              n-1                                                           *
+ *             -----                                                          *
+ *      sums = \      w[m] exp(-i s psi_L[m]) T_L[m]                          *
+ *             /        + w[m] exp(-i s psi_R[m]) T_R[-m],                    *
+ *             -----                                                          *
+ *             m = 0                                                          *
+ *                                                                            *
+ *  where s is a scale factor, along with the sum of the kernel itself, which *
+ *  is needed for the normalization. T_L runs forward from the left edge of   *
+ *  the window, and T_R runs backward from the right edge.                    *
+ *                                                                            *
+ *  The vector versions keep the real and imaginary parts in separate         *
+ *  registers, loading the interleaved complex data and shuffling it apart.   *
+ *  sin and cos are computed together by rssringoccs_Fresnel_Sincos_SSE2 and  *
+ *  friends. Their error is a few ULP, the same as the C library, but the     *
+ *  sums are accumulated in a different order so results differ from the     *
+ *  scalar code by round-off.                                                 *
+ *  Phases larger than RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG fall back to the    *
+ *  scalar code.                                                              *
+ *                                                                            *
+ *  The vector code is only compiled for x86 with GCC compatible compilers,   *
+ *  and can be disabled by defining RSSRINGOCCS_NO_SIMD.                      *
+ ******************************************************************************/
+
+/*  tmpl_CDouble_Polar and friends found here.                                */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototypes and the kernel sum typedef are here.                  */
+#include "rss_ringoccs_fresnel_simd.h"
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Fresnel_Kernel_Sum_Scalar                                 *
+ *  Purpose:                                                                  *
+ *      Reference implementation of the kernel sum, one sample at a time.     *
+ *  Arguments:                                                                *
+ *      w_func (const double *):                                              *
+ *          The window function, n_pts elements.                              *
+ *      psi_left (const double *), psi_right (const double *):                *
+ *          The phases for the left and right halves of the window. If these  *
+ *          are the same pointer the kernel is symmetric and is only computed *
+ *          once per sample.                                                  *
+ *      scale (double):                                                       *
+ *          The phases are multiplied by this.                                *
+ *      T_left (const tmpl_ComplexDouble *):                                  *
+ *          The data at the left edge of the window, read forward.            *
+ *      T_right (const tmpl_ComplexDouble *):                                 *
+ *          The data at the right edge of the window, read backward.          *
+ *      n_pts (size_t):                                                       *
+ *          The number of samples on either side of the center.               *
+ *      sums (double *):                                                      *
+ *          Four elements. The real and imaginary parts of the sum of the     *
+ *          integrand are added to sums[0] and sums[1], and those of the sum  *
+ *          of the kernel to sums[2] and sums[3].                             *
+ ******************************************************************************/
+void
+rssringoccs_Fresnel_Kernel_Sum_Scalar(const double *w_func,
+                                      const double *psi_left,
+                                      const double *psi_right,
+                                      double scale,
+                                      const tmpl_ComplexDouble *T_left,
+                                      const tmpl_ComplexDouble *T_right,
+                                      size_t n_pts, double *sums)
+{
+    size_t m;
+    tmpl_ComplexDouble ker, data, integrand;
+    tmpl_ComplexDouble sum = tmpl_CDouble_Zero;
+    tmpl_ComplexDouble norm = tmpl_CDouble_Zero;
+
+    for (m = 0U; m < n_pts; ++m)
+    {
+        ker = tmpl_CDouble_Polar(w_func[m], -scale*psi_left[m]);
+
+        /*  Symmetric kernel, add the data first as the Fresnel transform.    */
+        if (psi_left == psi_right)
+        {
+            data = tmpl_CDouble_Add(T_left[m], *(T_right - m));
+            integrand = tmpl_CDouble_Multiply(ker, data);
+            tmpl_CDouble_AddTo(&sum, &integrand);
+            tmpl_CDouble_AddTo(&norm, &ker);
+            tmpl_CDouble_AddTo(&norm, &ker);
+        }
+        else
+        {
+            integrand = tmpl_CDouble_Multiply(ker, T_left[m]);
+            tmpl_CDouble_AddTo(&sum, &integrand);
+            tmpl_CDouble_AddTo(&norm, &ker);
+
+            ker = tmpl_CDouble_Polar(w_func[m], -scale*psi_right[m]);
+            integrand = tmpl_CDouble_Multiply(ker, *(T_right - m));
+            tmpl_CDouble_AddTo(&sum, &integrand);
+            tmpl_CDouble_AddTo(&norm, &ker);
+        }
+    }
+
+    sums[0] += sum.dat[0];
+    sums[1] += sum.dat[1];
+    sums[2] += norm.dat[0];
+    sums[3] += norm.dat[1];
+}
+/*  End of rssringoccs_Fresnel_Kernel_Sum_Scalar.                             */
+
+#ifdef RSSRINGOCCS_FRESNEL_X86
+
+/******************************************************************************
+ *                                   SSE2                                     *
+ ******************************************************************************/
+
+/*  Kernel sum, two samples at a time.                                        */
+__attribute__((target("sse2")))
+static void
+rssringoccs_Fresnel_Kernel_Sum_SSE2(const double *w_func,
+                                    const double *psi_left,
+                                    const double *psi_right,
+                                    double scale,
+                                    const tmpl_ComplexDouble *T_left,
+                                    const tmpl_ComplexDouble *T_right,
+                                    size_t n_pts, double *sums)
+{
+    size_t m;
+    double out[2];
+    __m128d w, x, s, c, ws, wc, a, b, re, im, right_re, right_im;
+    __m128d sum_re = _mm_setzero_pd(), sum_im = _mm_setzero_pd();
+    __m128d norm_re = _mm_setzero_pd(), norm_im = _mm_setzero_pd();
+    const __m128d vscale = _mm_set1_pd(scale);
+    const __m128d limit = _mm_set1_pd(RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const tmpl_Bool symmetric = (psi_left == psi_right);
+
+    for (m = 0U; m + 2U <= n_pts; m += 2U)
+    {
+        x = _mm_mul_pd(_mm_loadu_pd(psi_left + m), vscale);
+        a = _mm_mul_pd(_mm_loadu_pd(psi_right + m), vscale);
+        b = _mm_max_pd(_mm_andnot_pd(sign, x), _mm_andnot_pd(sign, a));
+
+        /*  Huge phases are handled by the C library.                         */
+        if (_mm_movemask_pd(_mm_cmpgt_pd(b, limit)))
+        {
+            rssringoccs_Fresnel_Kernel_Sum_Scalar(
+                w_func + m, psi_left + m, psi_right + m,
+                scale, T_left + m, T_right - m, 2U, sums
+            );
+            continue;
+        }
+
+        /*  Deinterleave the data to the left of the center.                  */
+        a = _mm_loadu_pd((const double *)(T_left + m));
+        b = _mm_loadu_pd((const double *)(T_left + m + 1));
+        re = _mm_unpacklo_pd(a, b);
+        im = _mm_unpackhi_pd(a, b);
+
+        /*  And to the right, which is read backwards.                        */
+        a = _mm_loadu_pd((const double *)(T_right - m));
+        b = _mm_loadu_pd((const double *)(T_right - m - 1));
+        right_re = _mm_unpacklo_pd(a, b);
+        right_im = _mm_unpackhi_pd(a, b);
+
+        w = _mm_loadu_pd(w_func + m);
+        rssringoccs_Fresnel_Sincos_SSE2(x, &s, &c);
+        wc = _mm_mul_pd(w, c);
+        ws = _mm_mul_pd(w, s);
+
+        if (symmetric)
+        {
+            re = _mm_add_pd(re, right_re);
+            im = _mm_add_pd(im, right_im);
+            norm_re = _mm_add_pd(norm_re, _mm_add_pd(wc, wc));
+            norm_im = _mm_sub_pd(norm_im, _mm_add_pd(ws, ws));
+        }
+        else
+        {
+            norm_re = _mm_add_pd(norm_re, wc);
+            norm_im = _mm_sub_pd(norm_im, ws);
+        }
+
+        /*  (wc - i ws)(re + i im) = wc re + ws im + i (wc im - ws re).       */
+        sum_re = _mm_add_pd(sum_re, _mm_add_pd(_mm_mul_pd(wc, re),
+                                               _mm_mul_pd(ws, im)));
+        sum_im = _mm_add_pd(sum_im, _mm_sub_pd(_mm_mul_pd(wc, im),
+                                               _mm_mul_pd(ws, re)));
+
+        if (!symmetric)
+        {
+            x = _mm_mul_pd(_mm_loadu_pd(psi_right + m), vscale);
+            rssringoccs_Fresnel_Sincos_SSE2(x, &s, &c);
+            wc = _mm_mul_pd(w, c);
+            ws = _mm_mul_pd(w, s);
+            norm_re = _mm_add_pd(norm_re, wc);
+            norm_im = _mm_sub_pd(norm_im, ws);
+            sum_re = _mm_add_pd(sum_re, _mm_add_pd(_mm_mul_pd(wc, right_re),
+                                                   _mm_mul_pd(ws, right_im)));
+            sum_im = _mm_add_pd(sum_im, _mm_sub_pd(_mm_mul_pd(wc, right_im),
+                                                   _mm_mul_pd(ws, right_re)));
+        }
+    }
+
+    _mm_storeu_pd(out, sum_re);
+    sums[0] += out[0] + out[1];
+    _mm_storeu_pd(out, sum_im);
+    sums[1] += out[0] + out[1];
+    _mm_storeu_pd(out, norm_re);
+    sums[2] += out[0] + out[1];
+    _mm_storeu_pd(out, norm_im);
+    sums[3] += out[0] + out[1];
+
+    /*  The remaining odd sample, if any.                                     */
+    rssringoccs_Fresnel_Kernel_Sum_Scalar(
+        w_func + m, psi_left + m, psi_right + m,
+        scale, T_left + m, T_right - m, n_pts - m, sums
+    );
+}
+
+/******************************************************************************
+ *                                   AVX2                                     *
+ ******************************************************************************/
+
+/*  Kernel sum, four samples at a time.                                       */
+__attribute__((target("avx2,fma")))
+static void
+rssringoccs_Fresnel_Kernel_Sum_AVX2(const double *w_func,
+                                    const double *psi_left,
+                                    const double *psi_right,
+                                    double scale,
+                                    const tmpl_ComplexDouble *T_left,
+                                    const tmpl_ComplexDouble *T_right,
+                                    size_t n_pts, double *sums)
+{
+    size_t m;
+    double out[4];
+    __m256d w, x, s, c, ws, wc, a, b, re, im, right_re, right_im;
+    __m256d sum_re = _mm256_setzero_pd(), sum_im = _mm256_setzero_pd();
+    __m256d norm_re = _mm256_setzero_pd(), norm_im = _mm256_setzero_pd();
+    const __m256d vscale = _mm256_set1_pd(scale);
+    const __m256d limit = _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const tmpl_Bool symmetric = (psi_left == psi_right);
+
+    for (m = 0U; m + 4U <= n_pts; m += 4U)
+    {
+        x = _mm256_mul_pd(_mm256_loadu_pd(psi_left + m), vscale);
+        a = _mm256_mul_pd(_mm256_loadu_pd(psi_right + m), vscale);
+        b = _mm256_max_pd(_mm256_andnot_pd(sign, x),
+                          _mm256_andnot_pd(sign, a));
+
+        if (_mm256_movemask_pd(_mm256_cmp_pd(b, limit, _CMP_GT_OQ)))
+        {
+            rssringoccs_Fresnel_Kernel_Sum_Scalar(
+                w_func + m, psi_left + m, psi_right + m,
+                scale, T_left + m, T_right - m, 4U, sums
+            );
+            continue;
+        }
+
+        /*  unpack gives the samples in the order 0, 2, 1, 3. Permute back.   */
+        a = _mm256_loadu_pd((const double *)(T_left + m));
+        b = _mm256_loadu_pd((const double *)(T_left + m + 2));
+        re = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), 0xD8);
+        im = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0xD8);
+
+        /*  The right side is loaded in reverse, giving the order 3, 1, 2, 0. */
+        a = _mm256_loadu_pd((const double *)(T_right - m - 3));
+        b = _mm256_loadu_pd((const double *)(T_right - m - 1));
+        right_re = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), 0x27);
+        right_im = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0x27);
+
+        w = _mm256_loadu_pd(w_func + m);
+        rssringoccs_Fresnel_Sincos_AVX2(x, &s, &c);
+        wc = _mm256_mul_pd(w, c);
+        ws = _mm256_mul_pd(w, s);
+
+        if (symmetric)
+        {
+            re = _mm256_add_pd(re, right_re);
+            im = _mm256_add_pd(im, right_im);
+            norm_re = _mm256_add_pd(norm_re, _mm256_add_pd(wc, wc));
+            norm_im = _mm256_sub_pd(norm_im, _mm256_add_pd(ws, ws));
+        }
+        else
+        {
+            norm_re = _mm256_add_pd(norm_re, wc);
+            norm_im = _mm256_sub_pd(norm_im, ws);
+        }
+
+        sum_re = _mm256_fmadd_pd(wc, re, sum_re);
+        sum_re = _mm256_fmadd_pd(ws, im, sum_re);
+        sum_im = _mm256_fmadd_pd(wc, im, sum_im);
+        sum_im = _mm256_fnmadd_pd(ws, re, sum_im);
+
+        if (!symmetric)
+        {
+            x = _mm256_mul_pd(_mm256_loadu_pd(psi_right + m), vscale);
+            rssringoccs_Fresnel_Sincos_AVX2(x, &s, &c);
+            wc = _mm256_mul_pd(w, c);
+            ws = _mm256_mul_pd(w, s);
+            norm_re = _mm256_add_pd(norm_re, wc);
+            norm_im = _mm256_sub_pd(norm_im, ws);
+            sum_re = _mm256_fmadd_pd(wc, right_re, sum_re);
+            sum_re = _mm256_fmadd_pd(ws, right_im, sum_re);
+            sum_im = _mm256_fmadd_pd(wc, right_im, sum_im);
+            sum_im = _mm256_fnmadd_pd(ws, right_re, sum_im);
+        }
+    }
+
+    _mm256_storeu_pd(out, sum_re);
+    sums[0] += (out[0] + out[1]) + (out[2] + out[3]);
+    _mm256_storeu_pd(out, sum_im);
+    sums[1] += (out[0] + out[1]) + (out[2] + out[3]);
+    _mm256_storeu_pd(out, norm_re);
+    sums[2] += (out[0] + out[1]) + (out[2] + out[3]);
+    _mm256_storeu_pd(out, norm_im);
+    sums[3] += (out[0] + out[1]) + (out[2] + out[3]);
+
+    rssringoccs_Fresnel_Kernel_Sum_Scalar(
+        w_func + m, psi_left + m, psi_right + m,
+        scale, T_left + m, T_right - m, n_pts - m, sums
+    );
+}
+
+/******************************************************************************
+ *                                  AVX-512                                   *
+ ******************************************************************************/
+
+/*  Kernel sum, eight samples at a time.                                      */
+__attribute__((target("avx512f")))
+static void
+rssringoccs_Fresnel_Kernel_Sum_AVX512(const double *w_func,
+                                      const double *psi_left,
+                                      const double *psi_right,
+                                      double scale,
+                                      const tmpl_ComplexDouble *T_left,
+                                      const tmpl_ComplexDouble *T_right,
+                                      size_t n_pts, double *sums)
+{
+    size_t m;
+    __m512d w, x, s, c, ws, wc, a, b, re, im, right_re, right_im;
+    __m512i x_abs, a_abs;
+    __m512d sum_re = _mm512_setzero_pd(), sum_im = _mm512_setzero_pd();
+    __m512d norm_re = _mm512_setzero_pd(), norm_im = _mm512_setzero_pd();
+    const __m512d vscale = _mm512_set1_pd(scale);
+    const __m512d limit = _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG);
+    const __m512i sign = _mm512_castpd_si512(_mm512_set1_pd(-0.0));
+
+    /*  Indices of the real and imaginary parts of eight interleaved complex  *
+     *  numbers spread over two registers, forward and in reverse.            */
+    const __m512i even = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i odd = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+    const __m512i even_rev = _mm512_set_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m512i odd_rev = _mm512_set_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+    const tmpl_Bool symmetric = (psi_left == psi_right);
+
+    for (m = 0U; m + 8U <= n_pts; m += 8U)
+    {
+        x = _mm512_mul_pd(_mm512_loadu_pd(psi_left + m), vscale);
+        a = _mm512_mul_pd(_mm512_loadu_pd(psi_right + m), vscale);
+        x_abs = _mm512_andnot_epi64(sign, _mm512_castpd_si512(x));
+        a_abs = _mm512_andnot_epi64(sign, _mm512_castpd_si512(a));
+        b = _mm512_max_pd(_mm512_castsi512_pd(x_abs),
+                          _mm512_castsi512_pd(a_abs));
+
+        if (_mm512_cmp_pd_mask(b, limit, _CMP_GT_OQ))
+        {
+            rssringoccs_Fresnel_Kernel_Sum_Scalar(
+                w_func + m, psi_left + m, psi_right + m,
+                scale, T_left + m, T_right - m, 8U, sums
+            );
+            continue;
+        }
+
+        a = _mm512_loadu_pd((const double *)(T_left + m));
+        b = _mm512_loadu_pd((const double *)(T_left + m + 4));
+        re = _mm512_permutex2var_pd(a, even, b);
+        im = _mm512_permutex2var_pd(a, odd, b);
+
+        a = _mm512_loadu_pd((const double *)(T_right - m - 7));
+        b = _mm512_loadu_pd((const double *)(T_right - m - 3));
+        right_re = _mm512_permutex2var_pd(a, even_rev, b);
+        right_im = _mm512_permutex2var_pd(a, odd_rev, b);
+
+        w = _mm512_loadu_pd(w_func + m);
+        rssringoccs_Fresnel_Sincos_AVX512(x, &s, &c);
+        wc = _mm512_mul_pd(w, c);
+        ws = _mm512_mul_pd(w, s);
+
+        if (symmetric)
+        {
+            re = _mm512_add_pd(re, right_re);
+            im = _mm512_add_pd(im, right_im);
+            norm_re = _mm512_add_pd(norm_re, _mm512_add_pd(wc, wc));
+            norm_im = _mm512_sub_pd(norm_im, _mm512_add_pd(ws, ws));
+        }
+        else
+        {
+            norm_re = _mm512_add_pd(norm_re, wc);
+            norm_im = _mm512_sub_pd(norm_im, ws);
+        }
+
+        sum_re = _mm512_fmadd_pd(wc, re, sum_re);
+        sum_re = _mm512_fmadd_pd(ws, im, sum_re);
+        sum_im = _mm512_fmadd_pd(wc, im, sum_im);
+        sum_im = _mm512_fnmadd_pd(ws, re, sum_im);
+
+        if (!symmetric)
+        {
+            x = _mm512_mul_pd(_mm512_loadu_pd(psi_right + m), vscale);
+            rssringoccs_Fresnel_Sincos_AVX512(x, &s, &c);
+            wc = _mm512_mul_pd(w, c);
+            ws = _mm512_mul_pd(w, s);
+            norm_re = _mm512_add_pd(norm_re, wc);
+            norm_im = _mm512_sub_pd(norm_im, ws);
+            sum_re = _mm512_fmadd_pd(wc, right_re, sum_re);
+            sum_re = _mm512_fmadd_pd(ws, right_im, sum_re);
+            sum_im = _mm512_fmadd_pd(wc, right_im, sum_im);
+            sum_im = _mm512_fnmadd_pd(ws, right_re, sum_im);
+        }
+    }
+
+    sums[0] += _mm512_reduce_add_pd(sum_re);
+    sums[1] += _mm512_reduce_add_pd(sum_im);
+    sums[2] += _mm512_reduce_add_pd(norm_re);
+    sums[3] += _mm512_reduce_add_pd(norm_im);
+
+    rssringoccs_Fresnel_Kernel_Sum_Scalar(
+        w_func + m, psi_left + m, psi_right + m,
+        scale, T_left + m, T_right - m, n_pts - m, sums
+    );
+}
+
+#endif
+/*  End of #ifdef RSSRINGOCCS_FRESNEL_X86.                                    */
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Fresnel_Kernel_Sum_Select                                 *
+ *  Purpose:                                                                  *
+ *      Returns the fastest kernel sum the CPU supports.                      *
+ *  Output:                                                                   *
+ *      sum (rssringoccs_Fresnel_Kernel_Sum_Func):                            *
+ *          The AVX-512, AVX2 (with FMA), or SSE2 kernel sum, in that order   *
+ *          of preference, or rssringoccs_Fresnel_Kernel_Sum_Scalar.          *
+ *  Notes:                                                                    *
+ *      __builtin_cpu_supports only reads a few bits set when the program is  *
+ *      loaded, so this is cheap enough to call once per point.               *
+ ******************************************************************************/
+rssringoccs_Fresnel_Kernel_Sum_Func rssringoccs_Fresnel_Kernel_Sum_Select(void)
+{
+#ifdef RSSRINGOCCS_FRESNEL_X86
+    if (__builtin_cpu_supports("avx512f"))
+        return rssringoccs_Fresnel_Kernel_Sum_AVX512;
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return rssringoccs_Fresnel_Kernel_Sum_AVX2;
+
+    if (__builtin_cpu_supports("sse2"))
+        return rssringoccs_Fresnel_Kernel_Sum_SSE2;
+#endif
+
+    return rssringoccs_Fresnel_Kernel_Sum_Scalar;
+}
+/*  End of rssringoccs_Fresnel_Kernel_Sum_Select.                             */
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Internal to src/fresnel_transform. Declares the vector sin and cos    *
+ *      and the window sums of the vectorized transforms. This header is not  *
+ *      installed, so that programs using rss_ringoccs do not get             *
+ *      <immintrin.h> or functions built for instruction sets the CPU may not *
+ *      have.                                                                 *
+ ******************************************************************************/
+
+/*  Include guard to avoid including this file twice.                         */
+#ifndef RSS_RINGOCCS_FRESNEL_SIMD_H
+#define RSS_RINGOCCS_FRESNEL_SIMD_H
+
+/*  tmpl_ComplexDouble typedef provided here.                                 */
+#include <libtmpl/include/tmpl_complex.h>
+
+/*  size_t typedef given here.                                                */
+#include <stddef.h>
+
+/*  The vector kernels need the target attribute and __builtin_cpu_supports. */
+#if !defined(RSSRINGOCCS_NO_SIMD) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define RSSRINGOCCS_FRESNEL_X86
+#include <immintrin.h>
+#endif
+
+/*  Largest argument the vector sin and cos handle, in radians.               */
+#define RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG (1.0E8)
+
+#ifdef RSSRINGOCCS_FRESNEL_X86
+
+/*  sin and cos of 2, 4, and 8 doubles, accurate to a few ULP. Only call      *
+ *  these if the CPU supports the instruction set in the target attribute.    */
+__attribute__((target("sse2")))
+extern void
+rssringoccs_Fresnel_Sincos_SSE2(__m128d x, __m128d *sin_x, __m128d *cos_x);
+
+__attribute__((target("avx2,fma")))
+extern void
+rssringoccs_Fresnel_Sincos_AVX2(__m256d x, __m256d *sin_x, __m256d *cos_x);
+
+__attribute__((target("avx512f")))
+extern void
+rssringoccs_Fresnel_Sincos_AVX512(__m512d x, __m512d *sin_x, __m512d *cos_x);
+
+#endif
+/*  End of #ifdef RSSRINGOCCS_FRESNEL_X86.                                    */
+
+/*  Window sum shared by the vectorized quadratic and Legendre transforms.    *
+ *  Adds the sum of w[m] exp(-i scale psi_left[m]) T_left[m] and              *
+ *  w[m] exp(-i scale psi_right[m]) T_right[-m] over 0 <= m < n_pts to        *
+ *  sums[0] and sums[1] (real and imaginary parts), and the sum of the kernel *
+ *  to sums[2] and sums[3]. If psi_left == psi_right the kernel is computed   *
+ *  once per sample.                                                          */
+typedef void
+(*rssringoccs_Fresnel_Kernel_Sum_Func)(const double *w_func,
+                                       const double *psi_left,
+                                       const double *psi_right,
+                                       double scale,
+                                       const tmpl_ComplexDouble *T_left,
+                                       const tmpl_ComplexDouble *T_right,
+                                       size_t n_pts, double *sums);
+
+/*  Reference version of the kernel sum, one sample at a time.                */
+extern void
+rssringoccs_Fresnel_Kernel_Sum_Scalar(const double *w_func,
+                                      const double *psi_left,
+                                      const double *psi_right,
+                                      double scale,
+                                      const tmpl_ComplexDouble *T_left,
+                                      const tmpl_ComplexDouble *T_right,
+                                      size_t n_pts, double *sums);
+
+/*  The fastest kernel sum available on this CPU (AVX-512, AVX2, SSE2, or     *
+ *  the scalar version), chosen at run time.                                  */
+extern rssringoccs_Fresnel_Kernel_Sum_Func
+rssringoccs_Fresnel_Kernel_Sum_Select(void);
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,246 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                             Fresnel Sincos                                 *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Computes sin and cos of a vector of doubles with SSE2, AVX2, or       *
+ *      AVX-512 instructions. Used by the vectorized Fresnel kernels.         *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The argument is reduced to r = x - q pi/2, |r| <= pi/4, with the          *
+ *  Cody-Waite method, pi/2 being split into three parts so that q pi/2 is    *
+ *  exact for |q| < 2^27. sin(r) and cos(r) are then computed with the        *
+ *  minimax polynomials from Cephes, and swapped and negated according to q   *
+ *  mod 4. The error is a few ULP for |x| up to                               *
+ *  RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG. Larger arguments must be handled by   *
+ *  the caller.                                                               *
+ ******************************************************************************/
+
+/*  Function prototypes and RSSRINGOCCS_FRESNEL_X86 are here.                 */
+#include "rss_ringoccs_fresnel_simd.h"
+
+/*  Only compiled for x86 with GCC compatible compilers.                      */
+#ifdef RSSRINGOCCS_FRESNEL_X86
+
+/*  2 / pi, and pi / 2 split into three parts for the Cody-Waite reduction.   */
+#define RSSRINGOCCS_FRESNEL_TWO_BY_PI (6.36619772367581343076E-01)
+#define RSSRINGOCCS_FRESNEL_PI_BY_TWO_A (1.57079625129699707031E+00)
+#define RSSRINGOCCS_FRESNEL_PI_BY_TWO_B (7.54978941586159635335E-08)
+#define RSSRINGOCCS_FRESNEL_PI_BY_TWO_C (5.39030285815811905290E-15)
+
+/*  Adding 1.5 * 2^52 rounds to the nearest integer, which then sits in the   *
+ *  low bits of the mantissa.                                                 */
+#define RSSRINGOCCS_FRESNEL_ROUND_MAGIC (6755399441055744.0)
+
+/*  Coefficients for sin and cos on [-pi/4, pi/4], from Cephes.               */
+#define RSSRINGOCCS_FRESNEL_SIN_0 (1.58962301576546568060E-10)
+#define RSSRINGOCCS_FRESNEL_SIN_1 (-2.50507477628578072866E-8)
+#define RSSRINGOCCS_FRESNEL_SIN_2 (2.75573136213857245213E-6)
+#define RSSRINGOCCS_FRESNEL_SIN_3 (-1.98412698295895385996E-4)
+#define RSSRINGOCCS_FRESNEL_SIN_4 (8.33333333332211858878E-3)
+#define RSSRINGOCCS_FRESNEL_SIN_5 (-1.66666666666666307295E-1)
+#define RSSRINGOCCS_FRESNEL_COS_0 (-1.13585365213876817300E-11)
+#define RSSRINGOCCS_FRESNEL_COS_1 (2.08757008419747316778E-9)
+#define RSSRINGOCCS_FRESNEL_COS_2 (-2.75573141792967388112E-7)
+#define RSSRINGOCCS_FRESNEL_COS_3 (2.48015872888517045348E-5)
+#define RSSRINGOCCS_FRESNEL_COS_4 (-1.38888888888730564116E-3)
+#define RSSRINGOCCS_FRESNEL_COS_5 (4.16666666666665929218E-2)
+
+/******************************************************************************
+ *                                   SSE2                                     *
+ ******************************************************************************/
+
+/*  sin and cos of two doubles. The quadrant q mod 4 selects which of the     *
+ *  two polynomials gives sin(x) and which gives cos(x), and their signs.     */
+__attribute__((target("sse2")))
+void
+rssringoccs_Fresnel_Sincos_SSE2(__m128d x, __m128d *sin_x, __m128d *cos_x)
+{
+    const __m128d magic = _mm_set1_pd(RSSRINGOCCS_FRESNEL_ROUND_MAGIC);
+    const __m128i sign = _mm_castpd_si128(_mm_set1_pd(-0.0));
+    const __m128i one = _mm_set_epi32(0, 1, 0, 1);
+    __m128d q, r, z, s, c, t, swap;
+    __m128i k, mask;
+
+    /*  q is the nearest integer to 2x/pi, and k holds q in its low bits.     */
+    q = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(RSSRINGOCCS_FRESNEL_TWO_BY_PI)),
+                   magic);
+    k = _mm_castpd_si128(q);
+    q = _mm_sub_pd(q, magic);
+
+    /*  r = x - q pi/2, computed in three steps to avoid cancellation.        */
+    t = _mm_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_A);
+    r = _mm_sub_pd(x, _mm_mul_pd(q, t));
+    t = _mm_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_B);
+    r = _mm_sub_pd(r, _mm_mul_pd(q, t));
+    t = _mm_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_C);
+    r = _mm_sub_pd(r, _mm_mul_pd(q, t));
+    z = _mm_mul_pd(r, r);
+
+    s = _mm_set1_pd(RSSRINGOCCS_FRESNEL_SIN_0);
+    s = _mm_add_pd(_mm_mul_pd(s, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_SIN_1));
+    s = _mm_add_pd(_mm_mul_pd(s, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_SIN_2));
+    s = _mm_add_pd(_mm_mul_pd(s, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_SIN_3));
+    s = _mm_add_pd(_mm_mul_pd(s, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_SIN_4));
+    s = _mm_add_pd(_mm_mul_pd(s, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_SIN_5));
+    s = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, z), s));
+
+    c = _mm_set1_pd(RSSRINGOCCS_FRESNEL_COS_0);
+    c = _mm_add_pd(_mm_mul_pd(c, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_COS_1));
+    c = _mm_add_pd(_mm_mul_pd(c, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_COS_2));
+    c = _mm_add_pd(_mm_mul_pd(c, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_COS_3));
+    c = _mm_add_pd(_mm_mul_pd(c, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_COS_4));
+    c = _mm_add_pd(_mm_mul_pd(c, z), _mm_set1_pd(RSSRINGOCCS_FRESNEL_COS_5));
+    t = _mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(_mm_set1_pd(0.5), z));
+    c = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(z, z), c), t);
+
+    /*  Swap sin and cos in odd quadrants. SSE2 has no 64-bit compare, so     *
+     *  compare the low 32 bits and copy the result to the high 32 bits.      */
+    mask = _mm_cmpeq_epi32(_mm_and_si128(k, one), one);
+    swap = _mm_castsi128_pd(_mm_shuffle_epi32(mask, 0xA0));
+    *sin_x = _mm_or_pd(_mm_and_pd(swap, c), _mm_andnot_pd(swap, s));
+    *cos_x = _mm_or_pd(_mm_and_pd(swap, s), _mm_andnot_pd(swap, c));
+
+    /*  sin is negative in quadrants 2 and 3, cos in quadrants 1 and 2.       */
+    mask = _mm_and_si128(_mm_slli_epi64(k, 62), sign);
+    *sin_x = _mm_xor_pd(*sin_x, _mm_castsi128_pd(mask));
+    mask = _mm_and_si128(_mm_slli_epi64(_mm_add_epi64(k, one), 62), sign);
+    *cos_x = _mm_xor_pd(*cos_x, _mm_castsi128_pd(mask));
+}
+
+/******************************************************************************
+ *                                   AVX2                                     *
+ ******************************************************************************/
+
+/*  sin and cos of four doubles. See the SSE2 version for details.            */
+__attribute__((target("avx2,fma")))
+void
+rssringoccs_Fresnel_Sincos_AVX2(__m256d x, __m256d *sin_x, __m256d *cos_x)
+{
+    const __m256d magic = _mm256_set1_pd(RSSRINGOCCS_FRESNEL_ROUND_MAGIC);
+    const __m256i sign = _mm256_castpd_si256(_mm256_set1_pd(-0.0));
+    const __m256i one = _mm256_set_epi32(0, 1, 0, 1, 0, 1, 0, 1);
+    __m256d q, r, z, s, c, swap;
+    __m256i k, mask;
+
+    q = _mm256_fmadd_pd(x, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_TWO_BY_PI),
+                        magic);
+    k = _mm256_castpd_si256(q);
+    q = _mm256_sub_pd(q, magic);
+
+    r = _mm256_fnmadd_pd(q, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_A), x);
+    r = _mm256_fnmadd_pd(q, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_B), r);
+    r = _mm256_fnmadd_pd(q, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_C), r);
+    z = _mm256_mul_pd(r, r);
+
+    s = _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SIN_0);
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SIN_1));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SIN_2));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SIN_3));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SIN_4));
+    s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SIN_5));
+    s = _mm256_fmadd_pd(_mm256_mul_pd(r, z), s, r);
+
+    c = _mm256_set1_pd(RSSRINGOCCS_FRESNEL_COS_0);
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_COS_1));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_COS_2));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_COS_3));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_COS_4));
+    c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(RSSRINGOCCS_FRESNEL_COS_5));
+    c = _mm256_fmadd_pd(_mm256_mul_pd(z, z), c,
+                        _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z,
+                                         _mm256_set1_pd(1.0)));
+
+    /*  blendv only looks at the sign bit, so shift the parity bit there.     */
+    swap = _mm256_castsi256_pd(_mm256_slli_epi64(k, 63));
+    *sin_x = _mm256_blendv_pd(s, c, swap);
+    *cos_x = _mm256_blendv_pd(c, s, swap);
+
+    mask = _mm256_and_si256(_mm256_slli_epi64(k, 62), sign);
+    *sin_x = _mm256_xor_pd(*sin_x, _mm256_castsi256_pd(mask));
+    mask = _mm256_and_si256(
+        _mm256_slli_epi64(_mm256_add_epi64(k, one), 62), sign
+    );
+    *cos_x = _mm256_xor_pd(*cos_x, _mm256_castsi256_pd(mask));
+}
+
+/******************************************************************************
+ *                                  AVX-512                                   *
+ ******************************************************************************/
+
+/*  sin and cos of eight doubles. See the SSE2 version for details. AVX-512F  *
+ *  has no floating point and / xor, so the integer versions are used.        */
+__attribute__((target("avx512f")))
+void
+rssringoccs_Fresnel_Sincos_AVX512(__m512d x, __m512d *sin_x, __m512d *cos_x)
+{
+    const __m512d magic = _mm512_set1_pd(RSSRINGOCCS_FRESNEL_ROUND_MAGIC);
+    const __m512i sign = _mm512_castpd_si512(_mm512_set1_pd(-0.0));
+    const __m512i one = _mm512_set1_epi64(1);
+    __m512d q, r, z, s, c;
+    __m512i k, mask;
+    __mmask8 swap;
+
+    q = _mm512_fmadd_pd(x, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_TWO_BY_PI),
+                        magic);
+    k = _mm512_castpd_si512(q);
+    q = _mm512_sub_pd(q, magic);
+
+    r = _mm512_fnmadd_pd(q, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_A), x);
+    r = _mm512_fnmadd_pd(q, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_B), r);
+    r = _mm512_fnmadd_pd(q, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_PI_BY_TWO_C), r);
+    z = _mm512_mul_pd(r, r);
+
+    s = _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SIN_0);
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SIN_1));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SIN_2));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SIN_3));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SIN_4));
+    s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SIN_5));
+    s = _mm512_fmadd_pd(_mm512_mul_pd(r, z), s, r);
+
+    c = _mm512_set1_pd(RSSRINGOCCS_FRESNEL_COS_0);
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_COS_1));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_COS_2));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_COS_3));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_COS_4));
+    c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(RSSRINGOCCS_FRESNEL_COS_5));
+    c = _mm512_fmadd_pd(_mm512_mul_pd(z, z), c,
+                        _mm512_fnmadd_pd(_mm512_set1_pd(0.5), z,
+                                         _mm512_set1_pd(1.0)));
+
+    swap = _mm512_test_epi64_mask(k, one);
+    *sin_x = _mm512_mask_blend_pd(swap, s, c);
+    *cos_x = _mm512_mask_blend_pd(swap, c, s);
+
+    mask = _mm512_and_epi64(_mm512_slli_epi64(k, 62), sign);
+    *sin_x = _mm512_castsi512_pd(
+        _mm512_xor_epi64(_mm512_castpd_si512(*sin_x), mask)
+    );
+    mask = _mm512_and_epi64(
+        _mm512_slli_epi64(_mm512_add_epi64(k, one), 62), sign
+    );
+    *cos_x = _mm512_castsi512_pd(
+        _mm512_xor_epi64(_mm512_castpd_si512(*cos_x), mask)
+    );
+}
+
+#endif
+/*  End of #ifdef RSSRINGOCCS_FRESNEL_X86.                                    */
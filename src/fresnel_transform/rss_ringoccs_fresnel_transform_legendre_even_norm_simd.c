@@ -0,0 +1,94 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+#include "rss_ringoccs_fresnel_simd.h"
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Fresnel_Transform_Legendre_Even_Norm_SIMD                 *
+ *  Purpose:                                                                  *
+ *      Vectorized version of                                                 *
+ *      rssringoccs_Fresnel_Transform_Legendre_Even_Norm.                     *
+ *  Arguments:                                                                *
+ *      Same as rssringoccs_Fresnel_Transform_Legendre_Even_Norm.             *
+ *  Notes:                                                                    *
+ *      psi is computed in blocks of RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK       *
+ *      samples with the same arithmetic as the scalar transform, and each    *
+ *      block is summed by rssringoccs_Fresnel_Kernel_Sum_Select, which picks *
+ *      the widest vector instructions the CPU supports.                      *
+ ******************************************************************************/
+void
+rssringoccs_Fresnel_Transform_Legendre_Even_Norm_SIMD(rssringoccs_TAUObj *tau,
+                                                      const double *x_arr,
+                                                      const double *w_func,
+                                                      const double *coeffs,
+                                                      size_t n_pts,
+                                                      size_t center)
+{
+    /*  Sum of the integrand and of the kernel, real and imaginary parts.     */
+    double sums[4];
+    double psi_left[RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK];
+    double psi_right[RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK];
+    double factor;
+                                                      size_t n, block;
+    tmpl_ComplexDouble sum, scale_factor;
+    tmpl_ComplexDouble norm;
+
+    /*  The kernel sum for the widest instruction set available.              */
+    const rssringoccs_Fresnel_Kernel_Sum_Func kernel_sum
+        = rssringoccs_Fresnel_Kernel_Sum_Select();
+
+    sums[0] = 0.0;
+    sums[1] = 0.0;
+    sums[2] = 0.0;
+    sums[3] = 0.0;
+
+    for (n = 0U; n < n_pts; n += block)
+    {
+        block = n_pts - n;
+
+        if (block > RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK)
+            block = RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK;
+
+        rssringoccs_Fresnel_Transform_Legendre_Psi(tau, x_arr + n, coeffs,
+                                                   block, center, tmpl_True,
+                                                   psi_left, psi_right);
+
+        /*  Sample n is center - n_pts + n on the left, center + n_pts - n on *
+         *  the right.                                                        */
+        kernel_sum(w_func + n, psi_left, psi_right, 1.0,
+                   tau->T_in + (center - n_pts + n),
+                   tau->T_in + (center + n_pts - n), block, sums);
+    }
+
+    /*  Add the central point, where the window function is one.              */
+    sum = tmpl_CDouble_Rect(sums[0], sums[1]);
+    tmpl_CDouble_AddTo(&sum, &tau->T_in[center]);
+
+    /*  The integral in the numerator of norm evaluates to F sqrt(2), which   *
+     *  cancels the 1/F in the Fresnel inverse.                               */
+    norm = tmpl_CDouble_Rect(sums[2], sums[3]);
+    tmpl_CDouble_AddTo_Real(&norm, 1.0);
+    factor = 0.5*tmpl_Sqrt_Two / tmpl_CDouble_Abs(norm);
+
+    scale_factor = tmpl_CDouble_Rect(factor, factor);
+    tau->T_out[center] = tmpl_CDouble_Multiply(scale_factor, sum);
+}
+/*  End of rssringoccs_Fresnel_Transform_Legendre_Even_Norm_SIMD.             */
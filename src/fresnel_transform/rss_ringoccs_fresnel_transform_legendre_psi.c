@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Fresnel_Transform_Legendre_Psi                            *
+ *  Purpose:                                                                  *
+ *      Computes the Legendre approximation of psi for a block of samples,    *
+ *      for use with rssringoccs_Fresnel_Kernel_Sum_Func.                     *
+ *  Arguments:                                                                *
+ *      tau (const rssringoccs_TAUObj *):                                     *
+ *          The Tau object. order, k_vals, and D_km_vals are used.            *
+ *      x_arr (const double *):                                               *
+ *          rho - rho0 for the samples to the left of the center.             *
+ *      coeffs (const double *):                                              *
+ *          The coefficients of the polynomial approximation of psi.          *
+ *      n_pts (size_t):                                                       *
+ *          The number of samples, at most RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK.*
+ *      center (size_t):                                                      *
+ *          The index of the point being reconstructed.                       *
+ *      is_even (tmpl_Bool):                                                  *
+ *          Selects the Horner scheme of the Even or the Odd transform.       *
+ *      psi_left (double *), psi_right (double *):                            *
+ *          Output, psi_even - psi_odd and psi_even + psi_odd.                *
+ *  Notes:                                                                    *
+ *      The loops run over the samples innermost so the compiler can          *
+ *      vectorize them. The arithmetic is the same, operation for operation,  *
+ *      as in rssringoccs_Fresnel_Transform_Legendre_Even and _Odd.           *
+ ******************************************************************************/
+void
+rssringoccs_Fresnel_Transform_Legendre_Psi(const rssringoccs_TAUObj *tau,
+                                           const double *x_arr,
+                                           const double *coeffs,
+                                           size_t n_pts,
+                                           size_t center,
+                                           tmpl_Bool is_even,
+                                           double *psi_left,
+                                           double *psi_right)
+{
+    size_t i;
+    unsigned int k;
+    double x[RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK];
+    double x2[RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK];
+    double psi_even[RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK];
+    double psi_odd[RSSRINGOCCS_FRESNEL_LEGENDRE_BLOCK];
+
+    const double rcpr_D = 1.0 / tau->D_km_vals[center];
+    const double kD = tau->k_vals[center]*tau->D_km_vals[center];
+    const unsigned int order = tau->order;
+
+    for (i = 0U; i < n_pts; ++i)
+    {
+        x[i] = x_arr[i]*rcpr_D;
+        x2[i] = x[i]*x[i];
+    }
+
+    if (is_even)
+    {
+        for (i = 0U; i < n_pts; ++i)
+        {
+            psi_even[i] = coeffs[order-1];
+            psi_odd[i] = coeffs[order-2];
+        }
+
+        for (k = 3U; k < order-1; k += 2U)
+        {
+            for (i = 0U; i < n_pts; ++i)
+            {
+                psi_even[i] = psi_even[i]*x2[i] + coeffs[order-k];
+                psi_odd[i] = psi_odd[i]*x2[i] + coeffs[order-k-1];
+            }
+        }
+
+        for (i = 0U; i < n_pts; ++i)
+            psi_even[i] = psi_even[i]*x2[i] + coeffs[0];
+    }
+    else
+    {
+        for (i = 0U; i < n_pts; ++i)
+        {
+            psi_odd[i] = coeffs[order-1];
+            psi_even[i] = coeffs[order-2];
+        }
+
+        for (k = 2U; k < order-1; k += 2U)
+        {
+            for (i = 0U; i < n_pts; ++i)
+            {
+                psi_odd[i] = psi_odd[i]*x2[i] + coeffs[order-k-1];
+                psi_even[i] = psi_even[i]*x2[i] + coeffs[order-k-2];
+            }
+        }
+    }
+
+    /*  The leading term is x^2, so multiply by this and kD.                  */
+    for (i = 0U; i < n_pts; ++i)
+    {
+        psi_even[i] *= kD*x2[i];
+        psi_odd[i] *= kD*x2[i]*x[i];
+        psi_left[i] = psi_even[i] - psi_odd[i];
+        psi_right[i] = psi_even[i] + psi_odd[i];
+    }
+}
+/*  End of rssringoccs_Fresnel_Transform_Legendre_Psi.                        */
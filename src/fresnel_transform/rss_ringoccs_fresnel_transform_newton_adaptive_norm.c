@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  Normalized Newton-Raphson transform with psi solved for on an adaptive    *
+ *  grid and interpolated in between, see rssringoccs_Newton_Adaptive_Psi.    */
+void
+rssringoccs_Fresnel_Transform_Newton_Adaptive_Norm(
+    rssringoccs_TAUObj *tau,
+    const double *w_func,
+    size_t n_pts,
+    size_t center,
+    rssringoccs_Newton_Warm_Start *warm
+)
+{
+    /*  Declare all necessary variables. n is used for indexing.              */
+    size_t n, offset;
+
+    /*  The Fresnel kernel across the window, and the normalization.          */
+    const double *psi;
+    double real_norm, abs_norm;
+    tmpl_ComplexDouble exp_psi, norm, integrand;
+
+    psi = rssringoccs_Newton_Adaptive_Psi(tau, warm, center, n_pts);
+
+    /*  Without the scratch space, solve for psi at every sample.             */
+    if (!psi)
+    {
+        rssringoccs_Fresnel_Transform_Newton_Norm(
+            tau, w_func, n_pts, center, warm
+        );
+
+        return;
+    }
+
+    /*  Initialize T_out and norm to zero so we can loop over later.          */
+    tau->T_out[center] = tmpl_CDouble_Zero;
+    norm = tmpl_CDouble_Zero;
+    offset = center - (n_pts - 1UL)/2UL;
+
+    /*  Use a Riemann Sum to approximate the Fresnel Inverse Integral.        */
+    for (n = 0U; n < n_pts; ++n)
+    {
+        exp_psi = tmpl_CDouble_Polar(w_func[n], -psi[n]);
+
+        /*  Compute the norm using a Riemann sum as well.                     */
+        tmpl_CDouble_AddTo(&norm, &exp_psi);
+
+        integrand = tmpl_CDouble_Multiply(exp_psi, tau->T_in[offset + n]);
+        tmpl_CDouble_AddTo(&tau->T_out[center], &integrand);
+    }
+
+    /*  The integral in the numerator of norm evaluates to F sqrt(2). Use     *
+     *  this in the calculation of the normalization.                         */
+    abs_norm = tmpl_CDouble_Abs(norm);
+    real_norm = tmpl_Sqrt_Two / abs_norm;
+
+    /*  Multiply result by the coefficient found in the Fresnel inverse.      *
+     *  The 1/F term is omitted, since the F in the norm cancels this.        */
+    integrand = tmpl_CDouble_Rect(0.5*real_norm, 0.5*real_norm);
+    tau->T_out[center] = tmpl_CDouble_Multiply(integrand, tau->T_out[center]);
+}
@@ -54,8 +54,7 @@ rssringoccs_Fresnel_Transform_Newton_D_Quartic(rssringoccs_TAUObj *tau,
      /*  Use a Riemann Sum to approximate the Fresnel Inverse Integral.        */
     for (i = 0; i < 4; ++i)
     {
-
-        phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_dD_dPhi_Newton(
+        phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton(
             tau->k_vals[center],
             tau->rho_km_vals[center],
             tau->rho_km_vals[offset + ind[i]],
@@ -70,11 +69,11 @@ rssringoccs_Fresnel_Transform_Newton_D_Quartic(rssringoccs_TAUObj *tau,
         );
 
         D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
-            tau->rx_km_vals[center],    /* Ring radius. */
-            phi,                        /* Stationary azimuth angle. */
-            tau->rx_km_vals[center],    /* Cassini x coordinate. */
-            tau->ry_km_vals[center],    /* Cassini y coordinate. */
-            tau->rz_km_vals[center]     /* Cassini z coordinate. */
+            tau->rho_km_vals[offset + ind[i]],  /* Ring radius. */
+            phi,                                /* Stationary azimuth angle. */
+            tau->rx_km_vals[center],            /* Cassini x coordinate. */
+            tau->ry_km_vals[center],            /* Cassini y coordinate. */
+            tau->rz_km_vals[center]             /* Cassini z coordinate. */
         );
 
         psi_n[i] = tmpl_Double_Cyl_Fresnel_Psi(
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *                                  LICENSE                                   *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify      *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+void
+rssringoccs_Fresnel_Transform_Newton_Interp_Norm(rssringoccs_TAUObj *tau,
+                                                 const double *w_func,
+                                                 size_t n_pts,
+                                                 size_t center)
+{
+    /*  Declare all necessary variables. i is used for indexing.              */
+    size_t i, offset;
+
+    /*  The Fresnel kernel and its interpolating polynomial.                  */
+    double psi, x, abs_norm, real_norm;
+    rssringoccs_Newton_Interp interp;
+    tmpl_ComplexDouble exp_psi, norm, integrand;
+
+    /*  Solve for psi at the nodes, with the method and order set by psinum.  */
+    rssringoccs_Newton_Interp_Init(tau, center, n_pts, &interp);
+
+    /*  Initialize T_out and norm to zero so we can loop over later.          */
+    tau->T_out[center] = tmpl_CDouble_Zero;
+    norm = tmpl_CDouble_Zero;
+
+    /*  Symmetry is lost without the Legendre polynomials, or Fresnel         *
+     *  quadratic. Must compute everything from -W/2 to W/2.                  */
+    offset = center - (n_pts - 1UL) / 2UL;
+
+    /*  Use a Riemann Sum to approximate the Fresnel Inverse Integral.        */
+    for (i = 0; i < n_pts; ++i)
+    {
+        x = tau->rho_km_vals[offset] - tau->rho_km_vals[center];
+        psi = rssringoccs_Newton_Interp_Eval(&interp, x);
+
+        exp_psi = tmpl_CDouble_Polar(w_func[i], -psi);
+
+        /*  Compute the norm using a Riemann sum as well.                     */
+        norm = tmpl_CDouble_Add(norm, exp_psi);
+
+        integrand = tmpl_CDouble_Multiply(exp_psi, tau->T_in[offset]);
+        tmpl_CDouble_AddTo(&tau->T_out[center], &integrand);
+        offset += 1;
+    }
+
+    /*  The integral in the numerator of norm evaluates to F sqrt(2). Use     *
+     *  this in the calculation of the normalization.                         */
+    abs_norm = tmpl_CDouble_Abs(norm);
+    real_norm = tmpl_Sqrt_Two / abs_norm;
+
+    /*  Multiply result by the coefficient found in the Fresnel inverse.      *
+     *  The 1/F term is omitted, since the F in the norm cancels this.        */
+    integrand = tmpl_CDouble_Rect(0.5*real_norm, 0.5*real_norm);
+    tau->T_out[center] = tmpl_CDouble_Multiply(integrand, tau->T_out[center]);
+}
@@ -73,16 +73,21 @@
  *          The diffraction corrected profile.                                *
  ******************************************************************************/
 void
-rssringoccs_Fresnel_Transform_Perturbed_Newton(rssringoccs_TAUObj *tau,
-                                               const double *w_func,
-                                               size_t n_pts,
-                                               size_t center)
+rssringoccs_Fresnel_Transform_Perturbed_Newton(
+    rssringoccs_TAUObj *tau,
+    const double *w_func,
+    size_t n_pts,
+    size_t center,
+    rssringoccs_Newton_Warm_Start *warm
+)
 {
     /*  Declare all necessary variables. i and j are used for indexing.       */
-    size_t m, offset;
+    size_t m, n, n_block, offset;
 
     /*  The Fresnel kernel and ring azimuth angle.                            */
-    double psi, phi, x, poly, factor;
+    double x, poly, factor;
+    double phi[RSSRINGOCCS_FRESNEL_NEWTON_BLOCK];
+    double psi[RSSRINGOCCS_FRESNEL_NEWTON_BLOCK];
     tmpl_ComplexDouble exp_psi, integrand;
 
     /*  Initialize T_out and norm to zero so we can loop over later.          */
@@ -93,56 +98,69 @@ rssringoccs_Fresnel_Transform_Perturbed_Newton(rssringoccs_TAUObj *tau,
      *  quadratic. Must compute everything from -W/2 to W/2.                  */
     offset = center - (n_pts - 1UL) / 2UL;
 
-    /*  Use a Riemann Sum to approximate the Fresnel Inverse Integral.        */
-    for (m = 0; m < n_pts; ++m)
+    rssringoccs_Newton_Warm_Start_Begin(tau, warm, offset, n_pts);
+
+    /*  Use a Riemann Sum to approximate the Fresnel Inverse Integral. The    *
+     *  stationary azimuth angles are found a block at a time.                */
+    for (m = 0U; m < n_pts; m += n_block)
     {
-        /*  Factor for the polynomial perturbation.                           */
-        x = (tau->rho_km_vals[center]-tau->rho_km_vals[offset]) /
-            tau->D_km_vals[center];
+        n_block = n_pts - m;
+
+        if (n_block > RSSRINGOCCS_FRESNEL_NEWTON_BLOCK)
+            n_block = RSSRINGOCCS_FRESNEL_NEWTON_BLOCK;
+
+        /*  The ring azimuth angles, or the last solutions, are the guesses.  */
+        rssringoccs_Newton_Warm_Start_Guess(tau, warm, offset, n_block, phi);
 
-        /*  Calculate the stationary value of psi with respect to phi.        */
-        phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_Newton(
+        /*  Calculate the stationary values of phi, and psi at these.         */
+        rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch(
             tau->k_vals[center],        /* Wavenumber. */
             tau->rho_km_vals[center],   /* Dummy radius. */
-            tau->rho_km_vals[offset],   /* Ring radius. */
-            tau->phi_deg_vals[offset],  /* Dummy azimuthal angle. */
-            tau->phi_deg_vals[offset],  /* Ring azimuth angle. */
+            tau->rho_km_vals + offset,  /* Ring radii. */
+            tau->phi_deg_vals + offset, /* Ring azimuth angles. */
             tau->B_deg_vals[center],    /* Ring opening angle. */
             tau->D_km_vals[center],     /* Observer distance. */
             tau->EPS,                   /* Allowed error. */
-            tau->toler                  /* Max number of iterations. */
+            tau->toler,                 /* Max number of iterations. */
+            tau->use_simd,              /* Use AVX2 or AVX-512 if possible. */
+            tau->use_warm_start,        /* Guesses may be from last center. */
+            n_block,                    /* Number of samples. */
+            phi,                        /* Initial guesses, then solutions. */
+            psi,                        /* Fresnel kernel, output. */
+            warm ? &warm->n_iterations : NULL
         );
 
-        /*  Compute the left side of exp(-ipsi) using Euler's Formula.        */
-        psi = tmpl_Double_Cyl_Fresnel_Psi(
-            tau->k_vals[center],        /* Wavenumber. */
-            tau->rho_km_vals[center],   /* Dummy radius. */
-            tau->rho_km_vals[offset],   /* Ring radius. */
-            phi,                        /* Stationary azimuth angle. */
-            tau->phi_deg_vals[offset],  /* Ring azimuth angle. */
-            tau->B_deg_vals[center],    /* Ring opening angle. */
-            tau->D_km_vals[center]      /* Observer distance. */
-        );
+        rssringoccs_Newton_Warm_Start_Store(tau, warm, offset, n_block, phi);
+
+        for (n = 0U; n < n_block; ++n)
+        {
+            /*  Factor for the polynomial perturbation.                       */
+            x = (tau->rho_km_vals[center]-tau->rho_km_vals[offset]) /
+                tau->D_km_vals[center];
+
+            /*  Use Horner's method to compute the polynomial.                */
+            poly  = x*tau->perturb[4] + tau->perturb[3];
+            poly  = poly*x + tau->perturb[2];
+            poly  = poly*x + tau->perturb[1];
+            poly  = poly*x + tau->perturb[0];
+            poly *= tau->k_vals[center] * tau->D_km_vals[center];
+            psi[n] += poly;
 
-        /*  Use Horner's method to compute the polynomial.                    */
-        poly  = x*tau->perturb[4] + tau->perturb[3];
-        poly  = poly*x + tau->perturb[2];
-        poly  = poly*x + tau->perturb[1];
-        poly  = poly*x + tau->perturb[0];
-        poly *= tau->k_vals[center] * tau->D_km_vals[center];
-        psi  += poly;
-
-        /*  Compute the left side of exp(-ipsi) using Euler's Formula.        */
-        exp_psi = tmpl_CDouble_Polar(w_func[m], -psi);
-
-        /*  Compute the transform with a Riemann sum. If the T_in pointer     *
-         *  does not contain at least 2*n_pts+1 points, n_pts to the left and *
-         *  right of the center, then this will create a segmentation fault.  */
-        integrand = tmpl_CDouble_Multiply(exp_psi, tau->T_in[offset]);
-        tau->T_out[center] = tmpl_CDouble_Add(tau->T_out[center], integrand);
-        offset += 1;
+            /*  Compute the left side of exp(-ipsi) using Euler's Formula.    */
+            exp_psi = tmpl_CDouble_Polar(w_func[m + n], -psi[n]);
+
+            /*  Compute the transform with a Riemann sum. If the T_in         *
+             *  pointer does not contain at least 2*n_pts+1 points, n_pts to  *
+             *  the left and right of the center, then this will create a     *
+             *  segmentation fault.                                           */
+            integrand = tmpl_CDouble_Multiply(exp_psi, tau->T_in[offset]);
+            tmpl_CDouble_AddTo(&tau->T_out[center], &integrand);
+            offset += 1;
+        }
     }
 
+    rssringoccs_Newton_Warm_Start_End(tau, warm, offset - n_pts, n_pts);
+
     /*  Multiply result by the coefficient found in the Fresnel inverse.      */
     integrand = tmpl_CDouble_Rect(factor, factor);
     tau->T_out[center] = tmpl_CDouble_Multiply(integrand, tau->T_out[center]);
@@ -0,0 +1,358 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                          Newton Adaptive Psi                               *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Computes the stationary Fresnel kernel across a window by solving     *
+ *      for it on an adaptively refined grid and interpolating in between.    *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The Newton_Quadratic and Newton_Quartic transforms fit psi through 2 or 4 *
+ *  solved samples. Here the order is not fixed. The window is first split    *
+ *  into RSSRINGOCCS_NEWTON_ADAPTIVE_INTERVALS intervals and psi is solved    *
+ *  for at their ends. Between these nodes psi is a cubic Hermite spline      *
+ *  whose slopes are those of the parabola through each node and its two      *
+ *  neighbors, so quadratic kernels are reproduced exactly.                   *
+ *                                                                            *
+ *  To estimate the error of the spline on an interval, psi is solved for at  *
+ *  its midpoint and compared with the spline. Unless the difference is       *
+ *  smaller than tau->interp_tol the interval is bisected, and the two halves *
+ *  are checked the same way on the next pass with the midpoint as a new      *
+ *  node. Otherwise the interval is done. A new node changes the slopes at    *
+ *  the ends of the bisected interval, and with them the spline on the two    *
+ *  intervals next to it, so these are checked again on the next pass, with   *
+ *  the midpoints already solved for. The refinement stops on a pass that     *
+ *  adds no nodes, so every interval has passed its check with the slopes it  *
+ *  is interpolated with. Intervals one sample wide need no check. With       *
+ *  interp_tol = 0 every sample is solved for, and the result agrees with the *
+ *  Newton transform up to round-off.                                         *
+ *                                                                            *
+ *  psi itself is only accurate to about 10^-16 k D (the formula for it loses *
+ *  digits to cancellation), so tolerances much below that just solve for     *
+ *  more samples.                                                             *
+ *                                                                            *
+ *  All of the nodes of a pass are solved for together with                   *
+ *  rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch, and the steps and    *
+ *  the number of samples solved for are added to warm.                       *
+ ******************************************************************************/
+
+/*  tmpl_Double_Abs found here.                                               */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototype and the rssringoccs_Newton_Warm_Start typedef.         */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  The number of intervals the window is split into before any refinement.   */
+#define RSSRINGOCCS_NEWTON_ADAPTIVE_INTERVALS (8U)
+
+/*  Solves for psi at the n_ind samples offset + ind[n], a block at a time.   */
+static void
+rssringoccs_Newton_Adaptive_Solve(rssringoccs_TAUObj *tau,
+                                  rssringoccs_Newton_Warm_Start *warm,
+                                  size_t center,
+                                  size_t offset,
+                                  const size_t *ind,
+                                  size_t n_ind,
+                                  double *psi)
+{
+    size_t m, n, n_block;
+    double r0[RSSRINGOCCS_FRESNEL_NEWTON_BLOCK];
+    double phi0[RSSRINGOCCS_FRESNEL_NEWTON_BLOCK];
+    double phi[RSSRINGOCCS_FRESNEL_NEWTON_BLOCK];
+    double out[RSSRINGOCCS_FRESNEL_NEWTON_BLOCK];
+
+    for (m = 0U; m < n_ind; m += n_block)
+    {
+        n_block = n_ind - m;
+
+        if (n_block > RSSRINGOCCS_FRESNEL_NEWTON_BLOCK)
+            n_block = RSSRINGOCCS_FRESNEL_NEWTON_BLOCK;
+
+        /*  Gather the samples. The ring azimuth angles are the guesses.      */
+        for (n = 0U; n < n_block; ++n)
+        {
+            r0[n] = tau->rho_km_vals[offset + ind[m + n]];
+            phi0[n] = tau->phi_deg_vals[offset + ind[m + n]];
+            phi[n] = phi0[n];
+        }
+
+        rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch(
+            tau->k_vals[center],        /* Wavenumber. */
+            tau->rho_km_vals[center],   /* Dummy radius. */
+            r0,                         /* Ring radii. */
+            phi0,                       /* Ring azimuth angles. */
+            tau->B_deg_vals[center],    /* Ring opening angle. */
+            tau->D_km_vals[center],     /* Observer distance. */
+            tau->EPS,                   /* Allowed error. */
+            tau->toler,                 /* Max number of iterations. */
+            tau->use_simd,              /* Use AVX2 or AVX-512 if possible. */
+            tmpl_False,                 /* Guesses are the azimuth angles. */
+            n_block,                    /* Number of samples. */
+            phi,                        /* Initial guesses, then solutions. */
+            out,                        /* Fresnel kernel, output. */
+            &warm->n_iterations
+        );
+
+        for (n = 0U; n < n_block; ++n)
+            psi[ind[m + n]] = out[n];
+    }
+
+    warm->n_samples += n_ind;
+}
+
+/*  Slopes, per sample, of the parabolas through consecutive nodes.           */
+static void
+rssringoccs_Newton_Adaptive_Slopes(const size_t *node,
+                                   size_t n_nodes,
+                                   const double *psi,
+                                   double *slope)
+{
+    size_t n;
+    double h0, h1, d0, d1;
+
+    /*  With two nodes the spline is the line through them.                   */
+    if (n_nodes == 2U)
+    {
+        d0 = (psi[node[1]] - psi[node[0]]) / (double)(node[1] - node[0]);
+        slope[node[0]] = slope[node[1]] = d0;
+        return;
+    }
+
+    for (n = 1U; n + 1U < n_nodes; ++n)
+    {
+        h0 = (double)(node[n] - node[n - 1U]);
+        h1 = (double)(node[n + 1U] - node[n]);
+        d0 = (psi[node[n]] - psi[node[n - 1U]]) / h0;
+        d1 = (psi[node[n + 1U]] - psi[node[n]]) / h1;
+        slope[node[n]] = (h1*d0 + h0*d1) / (h0 + h1);
+
+        /*  The end points use the parabola through the two nearest nodes.    */
+        if (n == 1U)
+            slope[node[0]] = d0 - h0*(d1 - d0) / (h0 + h1);
+
+        if (n + 2U == n_nodes)
+            slope[node[n + 1U]] = d1 + h1*(d1 - d0) / (h0 + h1);
+    }
+}
+
+/*  The cubic Hermite spline between nodes a < b, evaluated at sample x.      */
+static double
+rssringoccs_Newton_Adaptive_Hermite(size_t a,
+                                    size_t b,
+                                    size_t x,
+                                    const double *psi,
+                                    const double *slope)
+{
+    const double h = (double)(b - a);
+    const double t = (double)(x - a) / h;
+    const double s = 1.0 - t;
+
+    return s*s*((1.0 + 2.0*t)*psi[a] + t*h*slope[a]) +
+           t*t*((3.0 - 2.0*t)*psi[b] - s*h*slope[b]);
+}
+
+const double *
+rssringoccs_Newton_Adaptive_Psi(rssringoccs_TAUObj *tau,
+                                rssringoccs_Newton_Warm_Start *warm,
+                                size_t center,
+                                size_t n_pts)
+{
+    size_t n, j, k, a, b, x, stride, n_nodes, n_mid, n_new;
+    size_t *node, *mid, *new_mid;
+    double *psi, *slope;
+    double err;
+    unsigned char *done;
+    unsigned char converged;
+    tmpl_Bool refine;
+
+    /*  The window runs from center - (n_pts - 1) / 2 to the right.           */
+    const size_t offset = center - (n_pts - 1U) / 2U;
+
+    if (!rssringoccs_Newton_Warm_Start_Reserve(warm, n_pts))
+        return NULL;
+
+    psi = warm->work;
+    slope = warm->work + n_pts;
+    node = warm->nodes;
+    mid = warm->nodes + n_pts;
+    done = warm->done;
+
+    /*  Windows this small are solved for at every sample.                    */
+    if (n_pts <= 2U*RSSRINGOCCS_NEWTON_ADAPTIVE_INTERVALS)
+    {
+        for (n = 0U; n < n_pts; ++n)
+            node[n] = n;
+
+        rssringoccs_Newton_Adaptive_Solve(
+            tau, warm, center, offset, node, n_pts, psi
+        );
+
+        return psi;
+    }
+
+    /*  The coarse grid. The last interval may be shorter than the rest.      */
+    stride = (n_pts - 1U) / RSSRINGOCCS_NEWTON_ADAPTIVE_INTERVALS;
+    n_nodes = 0U;
+
+    for (a = 0U; a + stride < n_pts; a += stride)
+    {
+        node[n_nodes] = a;
+        done[a] = 0U;
+        ++n_nodes;
+    }
+
+    if (node[n_nodes - 1U] != n_pts - 1U)
+    {
+        node[n_nodes] = n_pts - 1U;
+        ++n_nodes;
+    }
+
+    done[n_pts - 1U] = 1U;
+    rssringoccs_Newton_Adaptive_Solve(
+        tau, warm, center, offset, node, n_nodes, psi
+    );
+
+    /*  Bisect until every interval passes its midpoint check.                */
+    do {
+        rssringoccs_Newton_Adaptive_Slopes(node, n_nodes, psi, slope);
+
+        /*  done[a] refers to the interval whose left node is a. It is 0 for  *
+         *  an unchecked interval, 1 for a done one, 2 for one that has just  *
+         *  failed its check, and 3 for one to check again. The midpoints     *
+         *  are distinct samples that are not nodes, so the ones to solve for *
+         *  fit in the unused end of the node array.                          */
+        n_mid = 0U;
+        n_new = 0U;
+        new_mid = node + n_nodes;
+
+        for (n = 0U; n + 1U < n_nodes; ++n)
+        {
+            a = node[n];
+            b = node[n + 1U];
+
+            if (b - a < 2U)
+                done[a] = 1U;
+
+            if (done[a] == 1U)
+                continue;
+
+            mid[n_mid] = a + (b - a) / 2U;
+
+            if (done[a] == 0U)
+            {
+                new_mid[n_new] = mid[n_mid];
+                ++n_new;
+            }
+
+            ++n_mid;
+        }
+
+        if (n_mid == 0U)
+            break;
+
+        rssringoccs_Newton_Adaptive_Solve(
+            tau, warm, center, offset, new_mid, n_new, psi
+        );
+
+        /*  Compare the spline with the solution at each midpoint, and keep   *
+         *  the midpoints of the intervals that fail as the new nodes.        */
+        refine = tmpl_False;
+
+        for (n = 0U, j = 0U, k = 0U; n + 1U < n_nodes; ++n)
+        {
+            a = node[n];
+
+            if (done[a] == 1U)
+                continue;
+
+            b = node[n + 1U];
+            x = mid[k];
+            ++k;
+
+            err = psi[x] - rssringoccs_Newton_Adaptive_Hermite(a, b, x,
+                                                               psi, slope);
+            converged = (tmpl_Double_Abs(err) < tau->interp_tol ? 1U : 0U);
+
+            if (converged)
+                done[a] = 1U;
+            else
+            {
+                done[a] = 2U;
+                done[x] = 0U;
+                mid[j] = x;
+                ++j;
+                refine = tmpl_True;
+            }
+        }
+
+        n_mid = j;
+
+        /*  The neighbors of a bisected interval are checked again.           */
+        for (n = 0U; n + 1U < n_nodes; ++n)
+        {
+            if (done[node[n]] != 2U)
+                continue;
+
+            done[node[n]] = 0U;
+
+            if (n > 0U && done[node[n - 1U]] == 1U)
+                done[node[n - 1U]] = 3U;
+
+            if (n + 2U < n_nodes && done[node[n + 1U]] == 1U)
+                done[node[n + 1U]] = 3U;
+        }
+
+        /*  Merge the new nodes into the sorted list of nodes, from the back. */
+        j = n_nodes + n_mid;
+        k = n_mid;
+        n = n_nodes;
+
+        while (k > 0U)
+        {
+            --j;
+
+            if (node[n - 1U] > mid[k - 1U])
+            {
+                node[j] = node[n - 1U];
+                --n;
+            }
+            else
+            {
+                node[j] = mid[k - 1U];
+                --k;
+            }
+        }
+
+        n_nodes += n_mid;
+    } while (refine);
+
+    /*  Interpolate between the nodes. No node was added on the last pass,    *
+     *  so the slopes are still the ones every interval was checked with.     */
+    for (n = 0U; n + 1U < n_nodes; ++n)
+    {
+        a = node[n];
+        b = node[n + 1U];
+
+        for (x = a + 1U; x < b; ++x)
+            psi[x] = rssringoccs_Newton_Adaptive_Hermite(a, b, x, psi, slope);
+    }
+
+    return psi;
+}
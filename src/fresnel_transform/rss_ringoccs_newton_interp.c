@@ -0,0 +1,360 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                          Newton Interpolation                              *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Polynomial interpolation of the stationary Fresnel kernel across a    *
+ *      window, for the quadratic, quartic, sextic, and octic psitypes of     *
+ *      every Newton-Raphson variant.                                         *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The kernel vanishes at the center of the window. With x = rho - rho0 and  *
+ *  degree 2K it is approximated by                                           *
+ *                                                                            *
+ *      psi(x) = x^2 E(x^2) + x O(x^2),                                       *
+ *                                                                            *
+ *  where E and O have degree K - 1. psi is solved for at the K samples       *
+ *  m_i = i H / K to either side of the center, H = (n_pts - 1) / 2, so that  *
+ *  E and O interpolate the even and odd parts of psi at u_i = x_i^2. These   *
+ *  are kept in Newton's divided difference form, which is evaluated with     *
+ *  Horner's method. For K = 1 and K = 2 the nodes are those of the existing  *
+ *  Newton_Quadratic and Newton_Quartic transforms.                           *
+ *                                                                            *
+ *  The kernel at a node is computed exactly as the non-interpolated          *
+ *  transform of the same family computes it at that sample, so for large K   *
+ *  the result tends to that of the full transform.                           *
+ ******************************************************************************/
+
+/*  Newton-Raphson routines and the Fresnel kernel found here.                */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototypes and the rssringoccs_Newton_Interp typedef.            */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  The families of Newton-Raphson methods with interpolated versions.       */
+typedef enum {
+    rssringoccs_Newton_Interp_Cyl,
+    rssringoccs_Newton_Interp_D,
+    rssringoccs_Newton_Interp_D_Old,
+    rssringoccs_Newton_Interp_dD_dPhi,
+    rssringoccs_Newton_Interp_Elliptical
+} rssringoccs_Newton_Interp_Family;
+
+/*  The stationary Fresnel kernel at sample j about center, as computed by    *
+ *  the non-interpolated transform of the given family.                       */
+static double
+rssringoccs_Newton_Interp_Node(const rssringoccs_TAUObj *tau,
+                               rssringoccs_Newton_Interp_Family family,
+                               size_t center,
+                               size_t j)
+{
+    double phi, D, rho, ecc_factor, semi_major;
+
+    switch (family)
+    {
+        case rssringoccs_Newton_Interp_Cyl:
+            phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_Newton(
+                tau->k_vals[center], tau->rho_km_vals[center],
+                tau->rho_km_vals[j], tau->phi_deg_vals[j],
+                tau->phi_deg_vals[j], tau->B_deg_vals[center],
+                tau->D_km_vals[center], tau->EPS, tau->toler
+            );
+
+            return tmpl_Double_Cyl_Fresnel_Psi(
+                tau->k_vals[center], tau->rho_km_vals[center],
+                tau->rho_km_vals[j], phi, tau->phi_deg_vals[j],
+                tau->B_deg_vals[center], tau->D_km_vals[center]
+            );
+
+        case rssringoccs_Newton_Interp_D:
+            phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton(
+                tau->k_vals[center], tau->rho_km_vals[center],
+                tau->rho_km_vals[j], tau->phi_deg_vals[j],
+                tau->phi_deg_vals[j], tau->B_deg_vals[center],
+                tau->rx_km_vals[center], tau->ry_km_vals[center],
+                tau->rz_km_vals[center], tau->EPS, tau->toler
+            );
+
+            D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                tau->rho_km_vals[j], phi, tau->rx_km_vals[center],
+                tau->ry_km_vals[center], tau->rz_km_vals[center]
+            );
+
+            return tmpl_Double_Cyl_Fresnel_Psi(
+                tau->k_vals[center], tau->rho_km_vals[center],
+                tau->rho_km_vals[j], phi, tau->phi_deg_vals[j],
+                tau->B_deg_vals[center], D
+            );
+
+        case rssringoccs_Newton_Interp_D_Old:
+            phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton_Old(
+                tau->k_vals[center]*tau->D_km_vals[center],
+                tau->rho_km_vals[center], tau->rho_km_vals[j],
+                tau->phi_deg_vals[j], tau->phi_deg_vals[j],
+                tau->B_deg_vals[center], tau->rx_km_vals[center],
+                tau->ry_km_vals[center], tau->rz_km_vals[center],
+                tau->EPS, tau->toler
+            );
+
+            D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                tau->rho_km_vals[j], phi, tau->rx_km_vals[center],
+                tau->ry_km_vals[center], tau->rz_km_vals[center]
+            );
+
+            return tmpl_Double_Cyl_Fresnel_Psi_Alt(
+                tau->k_vals[center]*tau->D_km_vals[center],
+                tau->rho_km_vals[center], tau->rho_km_vals[j], phi,
+                tau->phi_deg_vals[j], tau->B_deg_vals[center], D
+            );
+
+        case rssringoccs_Newton_Interp_dD_dPhi:
+            phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_dD_dPhi_Newton(
+                tau->k_vals[j], tau->rho_km_vals[center],
+                tau->rho_km_vals[j], tau->phi_deg_vals[j],
+                tau->phi_deg_vals[j], tau->B_deg_vals[j],
+                tau->rx_km_vals[center], tau->ry_km_vals[center],
+                tau->rz_km_vals[center], tau->EPS, tau->toler
+            );
+
+            D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                tau->rho_km_vals[j], phi, tau->rx_km_vals[center],
+                tau->ry_km_vals[center], tau->rz_km_vals[center]
+            );
+
+            return tmpl_Double_Cyl_Fresnel_Psi(
+                tau->k_vals[center], tau->rho_km_vals[center],
+                tau->rho_km_vals[j], phi, tau->phi_deg_vals[j],
+                tau->B_deg_vals[center], D
+            );
+
+        default:
+            ecc_factor = 1.0 - tau->ecc*tau->ecc;
+            semi_major = tau->rho_km_vals[center] * (1.0 + tau->ecc *
+                tmpl_Double_Cosd(tau->phi_deg_vals[center] - tau->peri)
+            ) / ecc_factor;
+
+            phi = tmpl_Double_Stationary_Elliptical_Fresnel_Psi_Newton(
+                tau->k_vals[center], tau->rho_km_vals[center],
+                tau->rho_km_vals[j], tau->phi_deg_vals[j],
+                tau->phi_deg_vals[j], tau->B_deg_vals[center], tau->ecc,
+                tau->peri, tau->rx_km_vals[center], tau->ry_km_vals[center],
+                tau->rz_km_vals[center], tau->EPS, tau->toler
+            );
+
+            D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                tau->rho_km_vals[j], phi, tau->rx_km_vals[center],
+                tau->ry_km_vals[center], tau->rz_km_vals[center]
+            );
+
+            rho = semi_major * ecc_factor /
+                  (1.0 + tau->ecc * tmpl_Double_Cos(phi - tau->peri));
+
+            return tmpl_Double_Cyl_Fresnel_Psi(
+                tau->k_vals[center], rho, tau->rho_km_vals[j], phi,
+                tau->phi_deg_vals[j], tau->B_deg_vals[center], D
+            );
+    }
+}
+
+/*  Replaces y with the divided difference coefficients of the polynomial     *
+ *  through (u[i], y[i]), 0 <= i < n.                                         */
+static void
+rssringoccs_Newton_Interp_Divided_Differences(const double *u,
+                                              double *y,
+                                              unsigned int n)
+{
+    unsigned int i, j;
+
+    for (j = 1U; j < n; ++j)
+        for (i = n - 1U; i >= j; --i)
+            y[i] = (y[i] - y[i - 1U]) / (u[i] - u[i - j]);
+}
+
+/*  The family of a Newton-Raphson psitype, and the number of nodes on each   *
+ *  side of the center (zero for the non-interpolated method).                */
+typedef struct rssringoccs_Newton_Interp_Type_Def {
+    rssringoccs_Psitype_Enum psinum;
+    rssringoccs_Newton_Interp_Family family;
+    unsigned int n_nodes;
+} rssringoccs_Newton_Interp_Type;
+
+/*  Every psitype handled here, keyed by its own value so that the order of   *
+ *  rssringoccs_Psitype_Enum does not matter.                                 */
+static const rssringoccs_Newton_Interp_Type rssringoccs_interp_types[] = {
+    {rssringoccs_DR_Newton,
+     rssringoccs_Newton_Interp_Cyl, 0U},
+    {rssringoccs_DR_NewtonQuadratic,
+     rssringoccs_Newton_Interp_Cyl, 1U},
+    {rssringoccs_DR_NewtonQuartic,
+     rssringoccs_Newton_Interp_Cyl, 2U},
+    {rssringoccs_DR_NewtonSextic,
+     rssringoccs_Newton_Interp_Cyl, 3U},
+    {rssringoccs_DR_NewtonOctic,
+     rssringoccs_Newton_Interp_Cyl, 4U},
+    {rssringoccs_DR_NewtonD,
+     rssringoccs_Newton_Interp_D, 0U},
+    {rssringoccs_DR_NewtonDQuadratic,
+     rssringoccs_Newton_Interp_D, 1U},
+    {rssringoccs_DR_NewtonDQuartic,
+     rssringoccs_Newton_Interp_D, 2U},
+    {rssringoccs_DR_NewtonDSextic,
+     rssringoccs_Newton_Interp_D, 3U},
+    {rssringoccs_DR_NewtonDOctic,
+     rssringoccs_Newton_Interp_D, 4U},
+    {rssringoccs_DR_NewtonDOld,
+     rssringoccs_Newton_Interp_D_Old, 0U},
+    {rssringoccs_DR_NewtonDOldQuadratic,
+     rssringoccs_Newton_Interp_D_Old, 1U},
+    {rssringoccs_DR_NewtonDOldQuartic,
+     rssringoccs_Newton_Interp_D_Old, 2U},
+    {rssringoccs_DR_NewtonDOldSextic,
+     rssringoccs_Newton_Interp_D_Old, 3U},
+    {rssringoccs_DR_NewtonDOldOctic,
+     rssringoccs_Newton_Interp_D_Old, 4U},
+    {rssringoccs_DR_NewtonDPhi,
+     rssringoccs_Newton_Interp_dD_dPhi, 0U},
+    {rssringoccs_DR_NewtonDPhiQuadratic,
+     rssringoccs_Newton_Interp_dD_dPhi, 1U},
+    {rssringoccs_DR_NewtonDPhiQuartic,
+     rssringoccs_Newton_Interp_dD_dPhi, 2U},
+    {rssringoccs_DR_NewtonDPhiSextic,
+     rssringoccs_Newton_Interp_dD_dPhi, 3U},
+    {rssringoccs_DR_NewtonDPhiOctic,
+     rssringoccs_Newton_Interp_dD_dPhi, 4U},
+    {rssringoccs_DR_NewtonElliptical,
+     rssringoccs_Newton_Interp_Elliptical, 0U},
+    {rssringoccs_DR_NewtonEllipticalQuadratic,
+     rssringoccs_Newton_Interp_Elliptical, 1U},
+    {rssringoccs_DR_NewtonEllipticalQuartic,
+     rssringoccs_Newton_Interp_Elliptical, 2U},
+    {rssringoccs_DR_NewtonEllipticalSextic,
+     rssringoccs_Newton_Interp_Elliptical, 3U},
+    {rssringoccs_DR_NewtonEllipticalOctic,
+     rssringoccs_Newton_Interp_Elliptical, 4U}
+};
+
+#define RSSRINGOCCS_NEWTON_INTERP_TYPES \
+    (sizeof(rssringoccs_interp_types)/sizeof(rssringoccs_interp_types[0]))
+
+/*  The family of tau->psinum, and the number of nodes on each side of the    *
+ *  center. Psitypes missing from the table are treated as newton.            */
+static rssringoccs_Newton_Interp_Family
+rssringoccs_Newton_Interp_Get_Family(const rssringoccs_TAUObj *tau,
+                                     unsigned int *K)
+{
+    size_t n;
+
+    for (n = 0; n < RSSRINGOCCS_NEWTON_INTERP_TYPES; ++n)
+    {
+        if (rssringoccs_interp_types[n].psinum == tau->psinum)
+        {
+            *K = rssringoccs_interp_types[n].n_nodes;
+            return rssringoccs_interp_types[n].family;
+        }
+    }
+
+    *K = 0U;
+    return rssringoccs_Newton_Interp_Cyl;
+}
+
+/*  The stationary Fresnel kernel at sample j about center, for the family    *
+ *  of tau->psinum. This does not depend on the window.                       */
+double
+rssringoccs_Newton_Interp_Psi(const rssringoccs_TAUObj *tau,
+                              size_t center,
+                              size_t j)
+{
+    unsigned int K;
+    const rssringoccs_Newton_Interp_Family family =
+        rssringoccs_Newton_Interp_Get_Family(tau, &K);
+
+    return rssringoccs_Newton_Interp_Node(tau, family, center, j);
+}
+
+/*  Solves for psi at the nodes and computes the interpolating polynomial.    */
+void
+rssringoccs_Newton_Interp_Init(const rssringoccs_TAUObj *tau,
+                               size_t center,
+                               size_t n_pts,
+                               rssringoccs_Newton_Interp *interp)
+{
+    unsigned int n, K;
+    size_t m;
+    double x, left, right;
+    rssringoccs_Newton_Interp_Family family;
+
+    /*  Half the window, in samples.                                          */
+    const size_t half = (n_pts - 1U) / 2U;
+
+    family = rssringoccs_Newton_Interp_Get_Family(tau, &K);
+
+    /*  Small windows do not have room for K distinct nodes on each side.     */
+    if (K > RSSRINGOCCS_NEWTON_INTERP_MAX_NODES)
+        K = RSSRINGOCCS_NEWTON_INTERP_MAX_NODES;
+
+    if ((size_t)K > half)
+        K = (unsigned int)half;
+
+    interp->n_nodes = K;
+
+    for (n = 0U; n < K; ++n)
+    {
+        m = ((size_t)(n + 1U) * half) / (size_t)K;
+        x = tau->rho_km_vals[center + m] - tau->rho_km_vals[center];
+
+        right = rssringoccs_Newton_Interp_Node(tau, family, center, center + m);
+        left = rssringoccs_Newton_Interp_Node(tau, family, center, center - m);
+
+        /*  The even and odd parts of psi, divided by x^2 and x.              */
+        interp->u[n] = x*x;
+        interp->even[n] = 0.5*(right + left) / interp->u[n];
+        interp->odd[n] = 0.5*(right - left) / x;
+    }
+
+    rssringoccs_Newton_Interp_Divided_Differences(interp->u, interp->even, K);
+    rssringoccs_Newton_Interp_Divided_Differences(interp->u, interp->odd, K);
+}
+
+/*  Evaluates the interpolating polynomial at x = rho - rho0.                 */
+double
+rssringoccs_Newton_Interp_Eval(const rssringoccs_Newton_Interp *interp,
+                               double x)
+{
+    unsigned int n;
+    double even, odd;
+    const double u = x*x;
+
+    /*  A window of a single point, where psi is zero.                        */
+    if (interp->n_nodes == 0U)
+        return 0.0;
+
+    n = interp->n_nodes - 1U;
+    even = interp->even[n];
+    odd = interp->odd[n];
+
+    while (n > 0U)
+    {
+        --n;
+        even = even*(u - interp->u[n]) + interp->even[n];
+        odd = odd*(u - interp->u[n]) + interp->odd[n];
+    }
+
+    return x*(x*even + odd);
+}
@@ -0,0 +1,212 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                            Newton Warm Start                               *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Keeps the stationary azimuth angles found about one center so they    *
+ *      can be used as the initial guesses about the next.                    *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  Consecutive centers share all but one sample of their windows, and the    *
+ *  stationary angle of a sample barely changes when the center moves by dx.  *
+ *  Starting Newton's method from the previous solution instead of from       *
+ *  phi_deg_vals typically saves a few steps per sample. The solutions are    *
+ *  kept in a ring buffer indexed by the sample, phi[j % capacity]. The       *
+ *  buffer holds twice the window, so that the samples written while solving  *
+ *  one window never overwrite those still to be read from the last.          *
+ *                                                                            *
+ *  The convergence test is unchanged, so the results differ from a cold      *
+ *  start by no more than the tolerance of the solver allows.                 *
+ ******************************************************************************/
+
+/*  realloc and free found here.                                              */
+#include <stdlib.h>
+
+/*  The rssringoccs_Newton_Warm_Start typedef is here.                        */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  Sets the buffer to NULL and the counters to zero.                         */
+void rssringoccs_Newton_Warm_Start_Init(rssringoccs_Newton_Warm_Start *warm)
+{
+    warm->phi = NULL;
+    warm->capacity = 0U;
+    warm->lo = warm->hi = 0U;
+    warm->n_iterations = 0UL;
+    warm->n_samples = 0UL;
+    warm->n_warm = 0UL;
+    warm->work = NULL;
+    warm->nodes = NULL;
+    warm->done = NULL;
+    warm->work_capacity = 0U;
+}
+
+/*  Frees the buffers, leaving the counters as is.                            */
+void rssringoccs_Newton_Warm_Start_Destroy(rssringoccs_Newton_Warm_Start *warm)
+{
+    free(warm->phi);
+    warm->phi = NULL;
+    warm->capacity = 0U;
+    warm->lo = warm->hi = 0U;
+
+    free(warm->work);
+    free(warm->nodes);
+    free(warm->done);
+    warm->work = NULL;
+    warm->nodes = NULL;
+    warm->done = NULL;
+    warm->work_capacity = 0U;
+}
+
+/*  Grows the scratch space of the adaptive transform.                        */
+tmpl_Bool
+rssringoccs_Newton_Warm_Start_Reserve(rssringoccs_Newton_Warm_Start *warm,
+                                      size_t n_pts)
+{
+    double *work;
+    size_t *nodes;
+    unsigned char *done;
+
+    if (!warm)
+        return tmpl_False;
+
+    if (warm->work_capacity >= n_pts)
+        return tmpl_True;
+
+    /*  psi and its slope for each sample, and two lists of sample indices.   */
+    work = realloc(warm->work, sizeof(*work) * 2U * n_pts);
+
+    if (!work)
+        return tmpl_False;
+
+    warm->work = work;
+    nodes = realloc(warm->nodes, sizeof(*nodes) * 2U * n_pts);
+
+    if (!nodes)
+        return tmpl_False;
+
+    warm->nodes = nodes;
+    done = realloc(warm->done, sizeof(*done) * n_pts);
+
+    if (!done)
+        return tmpl_False;
+
+    warm->done = done;
+    warm->work_capacity = n_pts;
+    return tmpl_True;
+}
+
+/*  Makes room for the window [offset, offset + n_pts).                       */
+void
+rssringoccs_Newton_Warm_Start_Begin(const rssringoccs_TAUObj *tau,
+                                    rssringoccs_Newton_Warm_Start *warm,
+                                    size_t offset,
+                                    size_t n_pts)
+{
+    size_t first, last;
+    double *tmp;
+
+    if (!warm)
+        return;
+
+    warm->n_samples += n_pts;
+
+    if (!tau->use_warm_start)
+        return;
+
+    /*  The indices change meaning with the capacity, so start over.          */
+    if (warm->capacity < 2U*n_pts)
+    {
+        tmp = realloc(warm->phi, sizeof(*tmp) * 2U * n_pts);
+
+        /*  Without the buffer this window is solved from the usual guesses.  */
+        if (!tmp)
+        {
+            rssringoccs_Newton_Warm_Start_Destroy(warm);
+            return;
+        }
+
+        warm->phi = tmp;
+        warm->capacity = 2U*n_pts;
+        warm->lo = warm->hi = 0U;
+        return;
+    }
+
+    /*  The old and new windows must fit in the buffer together.              */
+    first = (warm->lo < offset ? warm->lo : offset);
+    last = (warm->hi > offset + n_pts ? warm->hi : offset + n_pts);
+
+    if (last - first > warm->capacity)
+        warm->lo = warm->hi = 0U;
+}
+
+/*  Stored angles where available, the ring azimuth angles elsewhere.        */
+void
+rssringoccs_Newton_Warm_Start_Guess(const rssringoccs_TAUObj *tau,
+                                    rssringoccs_Newton_Warm_Start *warm,
+                                    size_t offset,
+                                    size_t n_pts,
+                                    double *phi)
+{
+    size_t n, j;
+
+    for (n = 0U; n < n_pts; ++n)
+    {
+        j = offset + n;
+
+        if (warm && warm->lo <= j && j < warm->hi)
+        {
+            phi[n] = warm->phi[j % warm->capacity];
+            ++warm->n_warm;
+        }
+        else
+            phi[n] = tau->phi_deg_vals[j];
+    }
+}
+
+/*  Saves the solutions for the next window.                                  */
+void
+rssringoccs_Newton_Warm_Start_Store(const rssringoccs_TAUObj *tau,
+                                    rssringoccs_Newton_Warm_Start *warm,
+                                    size_t offset,
+                                    size_t n_pts,
+                                    const double *phi)
+{
+    size_t n;
+
+    if (!warm || !tau->use_warm_start || warm->capacity == 0U)
+        return;
+
+    for (n = 0U; n < n_pts; ++n)
+        warm->phi[(offset + n) % warm->capacity] = phi[n];
+}
+
+/*  The window just solved is what the next one reads from.                   */
+void
+rssringoccs_Newton_Warm_Start_End(const rssringoccs_TAUObj *tau,
+                                  rssringoccs_Newton_Warm_Start *warm,
+                                  size_t offset,
+                                  size_t n_pts)
+{
+    if (!warm || !tau->use_warm_start || warm->capacity == 0U)
+        return;
+
+    warm->lo = offset;
+    warm->hi = offset + n_pts;
+}
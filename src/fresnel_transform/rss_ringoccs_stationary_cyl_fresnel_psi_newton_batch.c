@@ -0,0 +1,673 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                 Batched Stationary Cylindrical Fresnel Psi                 *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Computes the stationary azimuth angles, and the Fresnel kernel at     *
+ *      these angles, for every sample in a window at once.                   *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  With xi = cos(B) (r cos(phi) - r0 cos(phi0)) / D and                      *
+ *  eta = (r^2 + r0^2 - 2 r r0 cos(phi - phi0)) / D^2, the cylindrical        *
+ *  Fresnel kernel is                                                         *
+ *                                                                            *
+ *      psi = k D (sqrt(1 + eta - 2 xi) + xi - 1).                            *
+ *                                                                            *
+ *  The stationary azimuth angle is the root of dpsi / dphi, found with       *
+ *  Newton's method as in tmpl_Double_Stationary_Cyl_Fresnel_Psi_Newton:      *
+ *  iterate while |dpsi / dphi| > EPS, at most toler + 1 times. The _D_       *
+ *  version recomputes D at every step from the position of the observer and  *
+ *  the point (r0, phi) in the ring plane, as                                 *
+ *  tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton does. The scalar version  *
+ *  calls these two routines, and so does not count its steps.                *
+ *                                                                            *
+ *  dpsi / dphi carries the factor k D, about 10^10, so near the root its     *
+ *  rounding error is comparable to the usual EPS of 10^-6 and the test above *
+ *  passes or fails more or less at random. Iterating further only moves phi  *
+ *  by an ulp or two, so for warm starts, see                                 *
+ *  rssringoccs_Newton_Warm_Start_Guess, a sample is also considered          *
+ *  converged once a step is smaller than RSSRINGOCCS_NEWTON_BATCH_MIN_STEP.  *
+ *  The scalar version then runs the loop itself with                         *
+ *  tmpl_Double_Cyl_Fresnel_dPsi_dPhi and _d2Psi_dPhi2, counting the steps.   *
+ *  Cold starts keep the libtmpl stopping rule, so their results do not       *
+ *  depend on whether warm starts are available.                              *
+ *                                                                            *
+ *  The vector versions solve 4 (AVX2) or 8 (AVX-512) samples per register.   *
+ *  Each lane stops updating once it has converged, and the register is done  *
+ *  when every lane has, so the iterates agree with the scalar routine. The   *
+ *  psi of the last iterate is computed alongside the derivatives, saving the *
+ *  separate call to tmpl_Double_Cyl_Fresnel_Psi. sin and cos are those of    *
+ *  rssringoccs_Fresnel_Sincos_AVX2, so results differ from the scalar code   *
+ *  by round-off. Registers that see an angle larger than                     *
+ *  RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG are redone with the scalar code.       *
+ ******************************************************************************/
+
+/*  tmpl_Double_Cyl_Fresnel_dPsi_dPhi and friends found here.                 */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototypes are here.                                             */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  The vector sin and cos, and RSSRINGOCCS_FRESNEL_X86, are here.            */
+#include "rss_ringoccs_fresnel_simd.h"
+
+/*  With warm starts, steps smaller than this, in radians, end the iteration. *
+ *  The error after such a step is of order its square, far below the         *
+ *  resolution of phi.                                                        */
+#define RSSRINGOCCS_NEWTON_BATCH_MIN_STEP (1.0E-12)
+
+/*  The parameters that are the same for every sample in the window.          */
+typedef struct rssringoccs_Newton_Batch_Args_Def {
+    double k, r, B, cos_B, D, rx, ry, rz, EPS;
+    unsigned int toler;
+    tmpl_Bool vary_D;
+
+    /*  RSSRINGOCCS_NEWTON_BATCH_MIN_STEP for warm starts, zero otherwise.    */
+    double min_step;
+
+    /*  The total number of Newton steps taken, over all samples.             */
+    unsigned long n_iterations;
+} rssringoccs_Newton_Batch_Args;
+
+/*  One sample at a time with the libtmpl Newton routines.                    */
+static void
+rssringoccs_Newton_Batch_Cold(const rssringoccs_Newton_Batch_Args *args,
+                              const double *r0,
+                              const double *phi0,
+                              size_t n_pts,
+                              double *phi,
+                              double *psi)
+{
+    size_t m;
+    double D;
+
+    for (m = 0U; m < n_pts; ++m)
+    {
+        if (args->vary_D)
+        {
+            phi[m] = tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton(
+                args->k, args->r, r0[m], phi[m], phi0[m], args->B,
+                args->rx, args->ry, args->rz, args->EPS, args->toler
+            );
+
+            D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                r0[m], phi[m], args->rx, args->ry, args->rz
+            );
+        }
+        else
+        {
+            phi[m] = tmpl_Double_Stationary_Cyl_Fresnel_Psi_Newton(
+                args->k, args->r, r0[m], phi[m], phi0[m], args->B,
+                args->D, args->EPS, args->toler
+            );
+
+            D = args->D;
+        }
+
+        psi[m] = tmpl_Double_Cyl_Fresnel_Psi(
+            args->k, args->r, r0[m], phi[m], phi0[m], args->B, D
+        );
+    }
+}
+
+/*  One sample at a time with the libtmpl derivatives of psi, for warm        *
+ *  starts. Cold starts are passed on to rssringoccs_Newton_Batch_Cold.       */
+static void
+rssringoccs_Newton_Batch_Scalar(rssringoccs_Newton_Batch_Args *args,
+                                const double *r0,
+                                const double *phi0,
+                                size_t n_pts,
+                                double *phi,
+                                double *psi)
+{
+    size_t m;
+    unsigned int n;
+    double D, dpsi, d2psi, step;
+
+    if (args->min_step == 0.0)
+    {
+        rssringoccs_Newton_Batch_Cold(args, r0, phi0, n_pts, phi, psi);
+        return;
+    }
+
+    for (m = 0U; m < n_pts; ++m)
+    {
+        if (args->vary_D)
+            D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                r0[m], phi[m], args->rx, args->ry, args->rz
+            );
+        else
+            D = args->D;
+
+        dpsi = tmpl_Double_Cyl_Fresnel_dPsi_dPhi(
+            args->k, args->r, r0[m], phi[m], phi0[m], args->B, D
+        );
+
+        n = 0U;
+
+        while (tmpl_Double_Abs(dpsi) > args->EPS)
+        {
+            d2psi = tmpl_Double_Cyl_Fresnel_d2Psi_dPhi2(
+                args->k, args->r, r0[m], phi[m], phi0[m], args->B, D
+            );
+
+            step = dpsi / d2psi;
+            phi[m] -= step;
+            ++n;
+
+            if (n > args->toler)
+                break;
+
+            if (tmpl_Double_Abs(step) < args->min_step)
+                break;
+
+            if (args->vary_D)
+                D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                    r0[m], phi[m], args->rx, args->ry, args->rz
+                );
+
+            dpsi = tmpl_Double_Cyl_Fresnel_dPsi_dPhi(
+                args->k, args->r, r0[m], phi[m], phi0[m], args->B, D
+            );
+        }
+
+        /*  The _D_ kernel uses the distance at the stationary angle.         */
+        if (args->vary_D)
+            D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+                r0[m], phi[m], args->rx, args->ry, args->rz
+            );
+
+        psi[m] = tmpl_Double_Cyl_Fresnel_Psi(
+            args->k, args->r, r0[m], phi[m], phi0[m], args->B, D
+        );
+
+        args->n_iterations += n;
+    }
+}
+
+#ifdef RSSRINGOCCS_FRESNEL_X86
+
+/******************************************************************************
+ *                                   AVX2                                     *
+ ******************************************************************************/
+
+/*  psi and its first two derivatives with respect to phi, four at a time.    */
+__attribute__((target("avx2,fma")))
+static void
+rssringoccs_Newton_Batch_Eval_AVX2(const rssringoccs_Newton_Batch_Args *args,
+                                   __m256d r0, __m256d phi, __m256d phi0,
+                                   __m256d cos_phi0, __m256d *psi,
+                                   __m256d *dpsi, __m256d *d2psi)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d r = _mm256_set1_pd(args->r);
+    __m256d s, c, sd, cd, x, y, D, rcpr_D, rcpr_D2, scale, rr0;
+    __m256d xi, eta, psi0, rcpr_psi0, dxi, deta, dxi2, deta2, num, kD;
+
+    rssringoccs_Fresnel_Sincos_AVX2(phi, &s, &c);
+    rssringoccs_Fresnel_Sincos_AVX2(_mm256_sub_pd(phi, phi0), &sd, &cd);
+
+    /*  Distance from the observer to (r0 cos(phi), r0 sin(phi), 0).          */
+    if (args->vary_D)
+    {
+        x = _mm256_fnmadd_pd(r0, c, _mm256_set1_pd(args->rx));
+        y = _mm256_fnmadd_pd(r0, s, _mm256_set1_pd(args->ry));
+        D = _mm256_fmadd_pd(y, y, _mm256_set1_pd(args->rz*args->rz));
+        D = _mm256_sqrt_pd(_mm256_fmadd_pd(x, x, D));
+    }
+    else
+        D = _mm256_set1_pd(args->D);
+
+    rcpr_D = _mm256_div_pd(one, D);
+    rcpr_D2 = _mm256_mul_pd(rcpr_D, rcpr_D);
+    scale = _mm256_mul_pd(_mm256_set1_pd(args->cos_B), rcpr_D);
+    rr0 = _mm256_mul_pd(_mm256_mul_pd(two, r), _mm256_mul_pd(r0, rcpr_D2));
+
+    xi = _mm256_fmsub_pd(r, c, _mm256_mul_pd(r0, cos_phi0));
+    xi = _mm256_mul_pd(scale, xi);
+    eta = _mm256_mul_pd(_mm256_fmadd_pd(r0, r0, _mm256_mul_pd(r, r)), rcpr_D2);
+    eta = _mm256_fnmadd_pd(rr0, cd, eta);
+    psi0 = _mm256_sqrt_pd(_mm256_fnmadd_pd(two, xi, _mm256_add_pd(one, eta)));
+    rcpr_psi0 = _mm256_div_pd(one, psi0);
+
+    scale = _mm256_mul_pd(scale, r);
+    dxi = _mm256_sub_pd(_mm256_setzero_pd(), _mm256_mul_pd(scale, s));
+    dxi2 = _mm256_sub_pd(_mm256_setzero_pd(), _mm256_mul_pd(scale, c));
+    deta = _mm256_mul_pd(rr0, sd);
+    deta2 = _mm256_mul_pd(rr0, cd);
+    kD = _mm256_mul_pd(_mm256_set1_pd(args->k), D);
+
+    *psi = _mm256_mul_pd(kD, _mm256_sub_pd(_mm256_add_pd(psi0, xi), one));
+
+    /*  dpsi = kD ((deta - 2 dxi) / (2 psi0) + dxi).                          */
+    num = _mm256_fnmadd_pd(two, dxi, deta);
+    *dpsi = _mm256_mul_pd(half, _mm256_mul_pd(num, rcpr_psi0));
+    *dpsi = _mm256_mul_pd(kD, _mm256_add_pd(*dpsi, dxi));
+
+    /*  d2psi = kD ((deta2 - 2 dxi2) / (2 psi0)                               *
+     *              - (deta - 2 dxi)^2 / (4 psi0^3) + dxi2).                  */
+    x = _mm256_mul_pd(_mm256_mul_pd(half, num), rcpr_psi0);
+    y = _mm256_mul_pd(half, _mm256_fnmadd_pd(two, dxi2, deta2));
+    *d2psi = _mm256_fnmadd_pd(x, x, y);
+    *d2psi = _mm256_fmadd_pd(*d2psi, rcpr_psi0, dxi2);
+    *d2psi = _mm256_mul_pd(kD, *d2psi);
+}
+
+/*  Solves four samples at a time and returns how many were solved.           */
+__attribute__((target("avx2,fma")))
+static size_t
+rssringoccs_Newton_Batch_AVX2(rssringoccs_Newton_Batch_Args *args,
+                              const double *r0,
+                              const double *phi0,
+                              size_t n_pts,
+                              double *phi,
+                              double *psi)
+{
+    size_t m;
+    unsigned int n, n_steps;
+    int overflow;
+    __m256d vr0, vphi, vphi0, vpsi, dpsi, d2psi, s0, c0, active, step, done;
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d eps = _mm256_set1_pd(args->EPS);
+    const __m256d min_step = _mm256_set1_pd(args->min_step);
+    const __m256d limit = _mm256_set1_pd(RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG);
+
+    for (m = 0U; m + 4U <= n_pts; m += 4U)
+    {
+        vr0 = _mm256_loadu_pd(r0 + m);
+        vphi0 = _mm256_loadu_pd(phi0 + m);
+        vphi = _mm256_loadu_pd(phi + m);
+
+        step = _mm256_max_pd(_mm256_andnot_pd(sign, vphi),
+                             _mm256_andnot_pd(sign, vphi0));
+        overflow = _mm256_movemask_pd(_mm256_cmp_pd(step, limit, _CMP_GT_OQ));
+
+        if (!overflow)
+        {
+            rssringoccs_Fresnel_Sincos_AVX2(vphi0, &s0, &c0);
+            rssringoccs_Newton_Batch_Eval_AVX2(args, vr0, vphi, vphi0, c0,
+                                               &vpsi, &dpsi, &d2psi);
+            active = _mm256_cmp_pd(_mm256_andnot_pd(sign, dpsi), eps,
+                                   _CMP_GT_OQ);
+            n = n_steps = 0U;
+
+            /*  Lanes that have converged keep their value of phi, and psi.   */
+            while (_mm256_movemask_pd(active))
+            {
+                n_steps += (unsigned int)__builtin_popcount(
+                    (unsigned int)_mm256_movemask_pd(active)
+                );
+
+                step = _mm256_div_pd(dpsi, d2psi);
+                done = _mm256_cmp_pd(_mm256_andnot_pd(sign, step), min_step,
+                                     _CMP_LT_OQ);
+                step = _mm256_sub_pd(vphi, step);
+                vphi = _mm256_blendv_pd(vphi, step, active);
+                ++n;
+
+                overflow = _mm256_movemask_pd(
+                    _mm256_cmp_pd(_mm256_andnot_pd(sign, vphi), limit,
+                                  _CMP_GT_OQ)
+                );
+
+                if (overflow)
+                    break;
+
+                /*  psi must still be computed for the last iterate.          */
+                step = vpsi;
+                rssringoccs_Newton_Batch_Eval_AVX2(args, vr0, vphi, vphi0, c0,
+                                                   &vpsi, &dpsi, &d2psi);
+                vpsi = _mm256_blendv_pd(step, vpsi, active);
+
+                if (n > args->toler)
+                    break;
+
+                active = _mm256_and_pd(
+                    _mm256_andnot_pd(done, active),
+                    _mm256_cmp_pd(_mm256_andnot_pd(sign, dpsi), eps,
+                                  _CMP_GT_OQ)
+                );
+            }
+        }
+
+        /*  Start over with the C library if an angle got too big.            */
+        if (overflow)
+        {
+            rssringoccs_Newton_Batch_Scalar(args, r0 + m, phi0 + m, 4U,
+                                            phi + m, psi + m);
+            continue;
+        }
+
+        _mm256_storeu_pd(phi + m, vphi);
+        _mm256_storeu_pd(psi + m, vpsi);
+        args->n_iterations += n_steps;
+    }
+
+    return m;
+}
+
+/******************************************************************************
+ *                                  AVX-512                                   *
+ ******************************************************************************/
+
+/*  psi and its first two derivatives with respect to phi, eight at a time.   */
+__attribute__((target("avx512f")))
+static void
+rssringoccs_Newton_Batch_Eval_AVX512(const rssringoccs_Newton_Batch_Args *args,
+                                     __m512d r0, __m512d phi, __m512d phi0,
+                                     __m512d cos_phi0, __m512d *psi,
+                                     __m512d *dpsi, __m512d *d2psi)
+{
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d r = _mm512_set1_pd(args->r);
+    __m512d s, c, sd, cd, x, y, D, rcpr_D, rcpr_D2, scale, rr0;
+    __m512d xi, eta, psi0, rcpr_psi0, dxi, deta, dxi2, deta2, num, kD;
+
+    rssringoccs_Fresnel_Sincos_AVX512(phi, &s, &c);
+    rssringoccs_Fresnel_Sincos_AVX512(_mm512_sub_pd(phi, phi0), &sd, &cd);
+
+    if (args->vary_D)
+    {
+        x = _mm512_fnmadd_pd(r0, c, _mm512_set1_pd(args->rx));
+        y = _mm512_fnmadd_pd(r0, s, _mm512_set1_pd(args->ry));
+        D = _mm512_fmadd_pd(y, y, _mm512_set1_pd(args->rz*args->rz));
+        D = _mm512_sqrt_pd(_mm512_fmadd_pd(x, x, D));
+    }
+    else
+        D = _mm512_set1_pd(args->D);
+
+    rcpr_D = _mm512_div_pd(one, D);
+    rcpr_D2 = _mm512_mul_pd(rcpr_D, rcpr_D);
+    scale = _mm512_mul_pd(_mm512_set1_pd(args->cos_B), rcpr_D);
+    rr0 = _mm512_mul_pd(_mm512_mul_pd(two, r), _mm512_mul_pd(r0, rcpr_D2));
+
+    xi = _mm512_fmsub_pd(r, c, _mm512_mul_pd(r0, cos_phi0));
+    xi = _mm512_mul_pd(scale, xi);
+    eta = _mm512_mul_pd(_mm512_fmadd_pd(r0, r0, _mm512_mul_pd(r, r)), rcpr_D2);
+    eta = _mm512_fnmadd_pd(rr0, cd, eta);
+    psi0 = _mm512_sqrt_pd(_mm512_fnmadd_pd(two, xi, _mm512_add_pd(one, eta)));
+    rcpr_psi0 = _mm512_div_pd(one, psi0);
+
+    scale = _mm512_mul_pd(scale, r);
+    dxi = _mm512_sub_pd(_mm512_setzero_pd(), _mm512_mul_pd(scale, s));
+    dxi2 = _mm512_sub_pd(_mm512_setzero_pd(), _mm512_mul_pd(scale, c));
+    deta = _mm512_mul_pd(rr0, sd);
+    deta2 = _mm512_mul_pd(rr0, cd);
+    kD = _mm512_mul_pd(_mm512_set1_pd(args->k), D);
+
+    *psi = _mm512_mul_pd(kD, _mm512_sub_pd(_mm512_add_pd(psi0, xi), one));
+
+    num = _mm512_fnmadd_pd(two, dxi, deta);
+    *dpsi = _mm512_mul_pd(half, _mm512_mul_pd(num, rcpr_psi0));
+    *dpsi = _mm512_mul_pd(kD, _mm512_add_pd(*dpsi, dxi));
+
+    x = _mm512_mul_pd(_mm512_mul_pd(half, num), rcpr_psi0);
+    y = _mm512_mul_pd(half, _mm512_fnmadd_pd(two, dxi2, deta2));
+    *d2psi = _mm512_fnmadd_pd(x, x, y);
+    *d2psi = _mm512_fmadd_pd(*d2psi, rcpr_psi0, dxi2);
+    *d2psi = _mm512_mul_pd(kD, *d2psi);
+}
+
+/*  Solves eight samples at a time and returns how many were solved.          */
+__attribute__((target("avx512f")))
+static size_t
+rssringoccs_Newton_Batch_AVX512(rssringoccs_Newton_Batch_Args *args,
+                                const double *r0,
+                                const double *phi0,
+                                size_t n_pts,
+                                double *phi,
+                                double *psi)
+{
+    size_t m;
+    unsigned int n, n_steps;
+    __mmask8 active, overflow, done;
+    __m512d vr0, vphi, vphi0, vpsi, dpsi, d2psi, s0, c0, step;
+    const __m512d eps = _mm512_set1_pd(args->EPS);
+    const __m512d min_step = _mm512_set1_pd(args->min_step);
+    const __m512d limit = _mm512_set1_pd(RSSRINGOCCS_FRESNEL_SINCOS_MAX_ARG);
+
+    for (m = 0U; m + 8U <= n_pts; m += 8U)
+    {
+        vr0 = _mm512_loadu_pd(r0 + m);
+        vphi0 = _mm512_loadu_pd(phi0 + m);
+        vphi = _mm512_loadu_pd(phi + m);
+
+        step = _mm512_max_pd(_mm512_abs_pd(vphi), _mm512_abs_pd(vphi0));
+        overflow = _mm512_cmp_pd_mask(step, limit, _CMP_GT_OQ);
+
+        if (!overflow)
+        {
+            rssringoccs_Fresnel_Sincos_AVX512(vphi0, &s0, &c0);
+            rssringoccs_Newton_Batch_Eval_AVX512(args, vr0, vphi, vphi0, c0,
+                                                 &vpsi, &dpsi, &d2psi);
+            active = _mm512_cmp_pd_mask(_mm512_abs_pd(dpsi), eps, _CMP_GT_OQ);
+            n = n_steps = 0U;
+
+            while (active)
+            {
+                n_steps += (unsigned int)__builtin_popcount(active);
+
+                step = _mm512_div_pd(dpsi, d2psi);
+                done = _mm512_cmp_pd_mask(_mm512_abs_pd(step), min_step,
+                                          _CMP_LT_OQ);
+                vphi = _mm512_mask_sub_pd(vphi, active, vphi, step);
+                ++n;
+
+                overflow = _mm512_cmp_pd_mask(_mm512_abs_pd(vphi), limit,
+                                              _CMP_GT_OQ);
+
+                if (overflow)
+                    break;
+
+                step = vpsi;
+                rssringoccs_Newton_Batch_Eval_AVX512(args, vr0, vphi, vphi0, c0,
+                                                     &vpsi, &dpsi, &d2psi);
+                vpsi = _mm512_mask_blend_pd(active, step, vpsi);
+
+                if (n > args->toler)
+                    break;
+
+                active &= (__mmask8)~done;
+                active &= _mm512_cmp_pd_mask(_mm512_abs_pd(dpsi), eps,
+                                             _CMP_GT_OQ);
+            }
+        }
+
+        if (overflow)
+        {
+            rssringoccs_Newton_Batch_Scalar(args, r0 + m, phi0 + m, 8U,
+                                            phi + m, psi + m);
+            continue;
+        }
+
+        _mm512_storeu_pd(phi + m, vphi);
+        _mm512_storeu_pd(psi + m, vpsi);
+        args->n_iterations += n_steps;
+    }
+
+    return m;
+}
+
+#endif
+/*  End of #ifdef RSSRINGOCCS_FRESNEL_X86.                                    */
+
+/*  Picks the widest vector version the CPU supports, scalar for the rest.    */
+static void
+rssringoccs_Newton_Batch(rssringoccs_Newton_Batch_Args *args,
+                         const double *r0,
+                         const double *phi0,
+                         tmpl_Bool use_simd,
+                         size_t n_pts,
+                         double *phi,
+                         double *psi)
+{
+    size_t m = 0U;
+
+#ifdef RSSRINGOCCS_FRESNEL_X86
+    if (use_simd && __builtin_cpu_supports("avx512f"))
+        m = rssringoccs_Newton_Batch_AVX512(args, r0, phi0, n_pts, phi, psi);
+
+    else if (use_simd && __builtin_cpu_supports("avx2") &&
+             __builtin_cpu_supports("fma"))
+        m = rssringoccs_Newton_Batch_AVX2(args, r0, phi0, n_pts, phi, psi);
+#else
+    (void)use_simd;
+#endif
+
+    rssringoccs_Newton_Batch_Scalar(args, r0 + m, phi0 + m, n_pts - m,
+                                    phi + m, psi + m);
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch                   *
+ *  Purpose:                                                                  *
+ *      Batched tmpl_Double_Stationary_Cyl_Fresnel_Psi_Newton, followed by    *
+ *      tmpl_Double_Cyl_Fresnel_Psi at the stationary angle.                  *
+ *  Arguments:                                                                *
+ *      k (double):                                                           *
+ *          The wavenumber.                                                   *
+ *      r (double):                                                           *
+ *          The radius of the point being reconstructed.                      *
+ *      r0 (const double *):                                                  *
+ *          The ring radii of the samples, n_pts elements.                    *
+ *      phi0 (const double *):                                                *
+ *          The ring azimuth angles of the samples, n_pts elements.           *
+ *      B (double):                                                           *
+ *          The ring opening angle.                                           *
+ *      D (double):                                                           *
+ *          The distance from the observer to the ring intercept point.       *
+ *      EPS (double):                                                         *
+ *          The allowed error in dpsi / dphi.                                 *
+ *      toler (unsigned int):                                                 *
+ *          The maximum number of iterations.                                 *
+ *      use_simd (tmpl_Bool):                                                 *
+ *          Use AVX2 or AVX-512 if the CPU has it. Otherwise the libtmpl      *
+ *          routines are called for each sample.                              *
+ *      warm_start (tmpl_Bool):                                               *
+ *          Whether the guesses in phi are the angles found about a nearby    *
+ *          center. If so, a step smaller than                                *
+ *          RSSRINGOCCS_NEWTON_BATCH_MIN_STEP also ends the iteration.        *
+ *      n_pts (size_t):                                                       *
+ *          The number of samples.                                            *
+ *      phi (double *):                                                       *
+ *          On entry the initial guesses, on exit the stationary angles.      *
+ *      psi (double *):                                                       *
+ *          Output, the Fresnel kernel at the stationary angles.              *
+ *      n_iter (unsigned long *):                                             *
+ *          The number of Newton steps taken, summed over the samples, is     *
+ *          added to this. May be NULL. Steps taken inside the libtmpl        *
+ *          routines, for cold starts without use_simd, are not counted.      *
+ ******************************************************************************/
+void
+rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch(double k,
+                                                    double r,
+                                                    const double *r0,
+                                                    const double *phi0,
+                                                    double B,
+                                                    double D,
+                                                    double EPS,
+                                                    unsigned int toler,
+                                                    tmpl_Bool use_simd,
+                                                    tmpl_Bool warm_start,
+                                                    size_t n_pts,
+                                                    double *phi,
+                                                    double *psi,
+                                                    unsigned long *n_iter)
+{
+    rssringoccs_Newton_Batch_Args args;
+
+    args.k = k;
+    args.r = r;
+    args.B = B;
+    args.cos_B = tmpl_Double_Cos(B);
+    args.D = D;
+    args.rx = args.ry = args.rz = 0.0;
+    args.EPS = EPS;
+    args.toler = toler;
+    args.vary_D = tmpl_False;
+    args.n_iterations = 0UL;
+    args.min_step = (warm_start ? RSSRINGOCCS_NEWTON_BATCH_MIN_STEP : 0.0);
+
+    rssringoccs_Newton_Batch(&args, r0, phi0, use_simd, n_pts, phi, psi);
+
+    if (n_iter)
+        *n_iter += args.n_iterations;
+}
+/*  End of rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch.               */
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Stationary_Cyl_Fresnel_Psi_D_Newton_Batch                 *
+ *  Purpose:                                                                  *
+ *      Batched tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton, followed by  *
+ *      tmpl_Double_Cyl_Fresnel_Psi with the observer distance at the         *
+ *      stationary angle.                                                     *
+ *  Arguments:                                                                *
+ *      rx (double), ry (double), rz (double):                                *
+ *          The position of the observer.                                     *
+ *      The rest are as in rssringoccs_Stationary_Cyl_Fresnel_Psi_Newton_Batch.*
+ ******************************************************************************/
+void
+rssringoccs_Stationary_Cyl_Fresnel_Psi_D_Newton_Batch(double k,
+                                                      double r,
+                                                      const double *r0,
+                                                      const double *phi0,
+                                                      double B,
+                                                      double rx,
+                                                      double ry,
+                                                      double rz,
+                                                      double EPS,
+                                                      unsigned int toler,
+                                                      tmpl_Bool use_simd,
+                                                      tmpl_Bool warm_start,
+                                                      size_t n_pts,
+                                                      double *phi,
+                                                      double *psi,
+                                                      unsigned long *n_iter)
+{
+    rssringoccs_Newton_Batch_Args args;
+
+    args.k = k;
+    args.r = r;
+    args.B = B;
+    args.cos_B = tmpl_Double_Cos(B);
+    args.D = 0.0;
+    args.rx = rx;
+    args.ry = ry;
+    args.rz = rz;
+    args.EPS = EPS;
+    args.toler = toler;
+    args.vary_D = tmpl_True;
+    args.n_iterations = 0UL;
+    args.min_step = (warm_start ? RSSRINGOCCS_NEWTON_BATCH_MIN_STEP : 0.0);
+
+    rssringoccs_Newton_Batch(&args, r0, phi0, use_simd, n_pts, phi, psi);
+
+    if (n_iter)
+        *n_iter += args.n_iterations;
+}
+/*  End of rssringoccs_Stationary_Cyl_Fresnel_Psi_D_Newton_Batch.             */
+
+#undef RSSRINGOCCS_NEWTON_BATCH_MIN_STEP
@@ -206,36 +206,202 @@
  *      2.) While this may be inaccurate for certain occultations, it is      *
  *          immensely fast, capable of processing the entire Rev007 E         *
  *          occultation accurately in less than a second at 1km resolution.   *
+ *      3.) If the library is built with OpenMP the points are split into     *
+ *          tasks of about equal cost, run by rssringoccs_Tau_Schedule. Each  *
+ *          task has its own x_arr and w_func, and starts with the window     *
+ *          width the serial loop would be using at its first point (see      *
+ *          rssringoccs_Tau_Window_Anchor), so the output is identical to the *
+ *          serial computation.                                               *
+ *      4.) If tau->use_window_cache is set the window functions are taken    *
+ *          from the process-wide cache (see rssringoccs_Window_Cache_Get).   *
  ******************************************************************************/
-void rssringoccs_Diffraction_Correction_Fresnel(rssringoccs_TAUObj *tau)
+/*  Function pointer type for the two quadratic Fresnel transforms.          */
+typedef void (*rssringoccs_Fresnel_FresT)(
+    rssringoccs_TAUObj *, const double *, const double *, size_t, size_t
+);
+
+/*  Computes pi/2 * x^2 (negated for forward modeling) and the window         *
+ *  function for a window of width w_init. The window is written to w_func,   *
+ *  or taken from the window cache if tau->use_window_cache is set. The       *
+ *  pointer to the window that is to be used is returned.                     */
+static const double *
+rssringoccs_Diffraction_Correction_Fresnel_Window(const rssringoccs_TAUObj *tau,
+                                                  double *x_arr, double *w_func,
+                                                  double dx, double w_init,
+                                                  size_t nw_pts,
+                                                  double fwd_factor)
 {
-    /*  m and n used for indexing, nw_pts is number of points in window.      */
-    size_t m, n, nw_pts, center;
+    size_t n;
+    const double *window = NULL;
+
+    /*  The left half-window is the first nw_pts entries of the cached table. */
+    if (tau->use_window_cache)
+        window = rssringoccs_Window_Cache_Get(tau->window_func, nw_pts - 1UL);
+
+    /*  Reset the x_arr array to range between -W/2 and zero.                 */
+    if (window)
+    {
+        for (n = 0; n < nw_pts; ++n)
+            x_arr[n] = ((double)n - (double)nw_pts)*dx;
+    }
+    else
+    {
+        rssringoccs_Tau_Reset_Window(x_arr, w_func, dx, w_init,
+                                     nw_pts, tau->window_func);
+        window = w_func;
+    }
+
+    /* Compute Window Functions, and compute pi/2 * x^2.                      */
+    for (n = 0; n < nw_pts; ++n)
+    {
+        /*  The independent variable is pi/2 * ((rho-rho0)/F)^2. Compute      *
+         *  part of this. The 1/F^2 part is introduced later.                 */
+        x_arr[n] *= tmpl_Pi_By_Two*x_arr[n];
+
+        /*  Use the fwd_factor to computer forward or inverse transform.      */
+        x_arr[n] *= fwd_factor;
+    }
+
+    return window;
+}
+
+/*  The arguments of rssringoccs_Diffraction_Correction_Fresnel_Block that    *
+ *  are the same for every task.                                              */
+typedef struct rssringoccs_Fresnel_Task_Data_Def {
+    rssringoccs_Fresnel_FresT FresT;
+    double fwd_factor;
+} rssringoccs_Fresnel_Task_Data;
+
+/*  Reconstructs the points of a task. Returns false if malloc fails. The     *
+ *  window starts from the width it was built with at task->anchor.           */
+static tmpl_Bool
+rssringoccs_Diffraction_Correction_Fresnel_Block(
+    rssringoccs_TAUObj *tau,
+    void *data,
+    unsigned int worker,
+    const rssringoccs_Tau_Task *task
+)
+{
+    /*  center is the point being reconstructed, nw_pts is the window size.   */
+    size_t nw_pts, center;
 
     /*  w_init is window width (km), dx and two_dx are sample spacing (km).   */
-    double w_init, dx, two_dx;
+    const double dx = tau->dx_km;
+    const double two_dx = 2.0*dx;
+    double w_init;
 
     /*  Pointers for the independent variable and the window function.        */
-    double *x_arr;
-    double *w_func;
-    double fwd_factor;
+    double *x_arr, *w_func, *tmp;
+
+    /*  The window in use. This is either w_func or a cached table.           */
+    const double *window;
 
-    /*  Declare the window function pointer and allocate memory for it. The   *
-     *  type rssringoccs_window_func was declared at the start of this file.  *
-     *  Be sure to free this at the end!                                      */
-    rssringoccs_Window_Function fw = tau->window_func;
+    /*  The transform, and the sign of the transform.                         */
+    const rssringoccs_Fresnel_Task_Data *args = data;
+    const rssringoccs_Fresnel_FresT FresT = args->FresT;
+    const double fwd_factor = args->fwd_factor;
 
-    void (*FresT)(
-        rssringoccs_TAUObj *, const double *, const double *, size_t, size_t
+    /*  Every thread has its own buffers, so the thread does not matter.      */
+    (void)worker;
+
+    /*  The width of the window in effect at the first point of this task.    */
+    w_init = tau->w_km_vals[task->anchor];
+    nw_pts = (size_t)(w_init / two_dx) + 1UL;
+
+    /*  Reserve some memory for two arrays, the ring radius and the window    *
+     *  function. This will need to be reallocated later if the window width  *
+     *  changes by more than two_dx.                                          */
+    x_arr  = malloc(sizeof(*x_arr)  * nw_pts);
+    w_func = malloc(sizeof(*w_func) * nw_pts);
+
+    if (!x_arr || !w_func)
+    {
+        free(x_arr);
+        free(w_func);
+        return tmpl_False;
+    }
+
+    window = rssringoccs_Diffraction_Correction_Fresnel_Window(
+        tau, x_arr, w_func, dx, w_init, nw_pts, fwd_factor
     );
 
+    /*  Compute the Fresnel transform across the task.                        */
+    for (center = task->first; center < task->last; ++center)
+    {
+        /*  If the window width has deviated more the 2*dx, reset values.     */
+        if (tmpl_Double_Abs(w_init - tau->w_km_vals[center]) >= two_dx)
+        {
+            /* Reset w_init and recompute window function.                    */
+            w_init = tau->w_km_vals[center];
+            nw_pts = ((size_t)(w_init / two_dx)) + 1UL;
+
+            /*  Reallocate memory, since the sizes of the arrays changed.     */
+            tmp = realloc(w_func, sizeof(*w_func)*nw_pts);
+
+            if (!tmp)
+            {
+                free(x_arr);
+                free(w_func);
+                return tmpl_False;
+            }
+
+            w_func = tmp;
+            tmp = realloc(x_arr, sizeof(*x_arr)*nw_pts);
+
+            if (!tmp)
+            {
+                free(x_arr);
+                free(w_func);
+                return tmpl_False;
+            }
+
+            x_arr = tmp;
+            window = rssringoccs_Diffraction_Correction_Fresnel_Window(
+                tau, x_arr, w_func, dx, w_init, nw_pts, fwd_factor
+            );
+        }
+
+        /*  Compute the Fresnel Transform about the current point.            */
+        FresT(tau, x_arr, window, nw_pts, center);
+    }
+
+    /*  Free the variables allocated by malloc.                               */
+    free(x_arr);
+    free(w_func);
+    return tmpl_True;
+}
+
+void rssringoccs_Diffraction_Correction_Fresnel(rssringoccs_TAUObj *tau)
+{
+    /*  Factor for the forward or inverse transform.                          */
+    double fwd_factor;
+
+    /*  Number of threads used, and a flag for malloc failures.               */
+    unsigned int n_threads;
+    int failed = 0;
+
+    /*  The quadratic Fresnel transform, with or without normalization.       */
+    rssringoccs_Fresnel_FresT FresT;
+    rssringoccs_Fresnel_Task_Data data;
+
     /*  This should remain at false.                                          */
     tau->error_occurred = tmpl_False;
 
-    if (tau->use_norm)
-        FresT = rssringoccs_Fresnel_Transform_Norm;
+    /*  The vectorized transforms compute the same sums with SIMD registers.  */
+    if (tau->use_simd)
+    {
+        if (tau->use_norm)
+            FresT = rssringoccs_Fresnel_Transform_Norm_SIMD;
+        else
+            FresT = rssringoccs_Fresnel_Transform_SIMD;
+    }
     else
-        FresT = rssringoccs_Fresnel_Transform;
+    {
+        if (tau->use_norm)
+            FresT = rssringoccs_Fresnel_Transform_Norm;
+        else
+            FresT = rssringoccs_Fresnel_Transform;
+    }
 
     if (tau->use_fwd)
         fwd_factor = -1.0;
@@ -248,30 +414,15 @@ void rssringoccs_Diffraction_Correction_Fresnel(rssringoccs_TAUObj *tau)
     if (tau->error_occurred)
         return;
 
-    /*  Retrieve the starting point from the TAUObj instance.                 */
-    center = tau->start;
-
-    /*  Compute some extra necessary variables. At this point it is assumed   *
-     *  that tau->w_km_vals, tau->rho_km_vals, and others are pointers, most  *
-     *  likely created with malloc or calloc, that point to a memory block    *
-     *  that is tau->arr_size in size, that tau->start >= 0, and that         *
+    /*  At this point it is assumed that tau->w_km_vals, tau->rho_km_vals,    *
+     *  and others are pointers, most likely created with malloc or calloc,   *
+     *  that point to a memory block that is tau->arr_size in size, and that  *
      *  tau->start+tau->n_used <= tau->arr_size. No error checks for this     *
      *  are performed here, but rather the caller of this function has that   *
      *  responsibility. Such checks are performed in the                      *
      *  DiffractionCorrection Python class, so if you're only using that then *
      *  there's no problem. If not, this next step may cause a segmentation   *
      *  fault.                                                                */
-    w_init = tau->w_km_vals[center];
-
-    /*  It is also assumed these pointers have at least two elements of       *
-     *  doubles being pointed to. Again, DiffractionCorrection checks this.   *
-     *  Hence dlp->rho_km_vals[center] and dlp->rho_km_vals[center+1] should  *
-     *  be initialized. If not, you will get a segmentation fault.            */
-    dx = tau->dx_km;
-
-    /*  And now, some more variables we'll be using.                          */
-    two_dx = 2.0*dx;
-    nw_pts = (size_t)(w_init / two_dx) + 1UL;
 
     /* Check to ensure you have enough data to the left.                      */
     rssringoccs_Tau_Check_Data_Range(tau);
@@ -279,86 +430,26 @@ void rssringoccs_Diffraction_Correction_Fresnel(rssringoccs_TAUObj *tau)
     if (tau->error_occurred)
         return;
 
-    /*  Reserve some memory for two arrays, the ring radius and the window    *
-     *  function. This will need to be reallocated later if the window width  *
-     *  changes by more than two_dx. Per C99 recommendations, we do not cast  *
-     *  malloc since void will safely be promoted to a double pointer.        */
-    x_arr  = malloc(sizeof(*x_arr)  * nw_pts);
-    w_func = malloc(sizeof(*w_func) * nw_pts);
+    n_threads = rssringoccs_Tau_Thread_Count(tau);
+    data.FresT = FresT;
+    data.fwd_factor = fwd_factor;
 
-    /*  Check that malloc was successfull then pass the x_arr array           *
-     *  (ring radius) to the void function reset_window. This alters x_arr so *
-     *  that it's values range from -W/2 to zero, W begin the window width.   */
-    if (!(x_arr))
-    {
-        tau->error_occurred = tmpl_True;
-        tau->error_message = tmpl_strdup(
-            "\n\rError Encountered: rss_ringoccs\n\n"
-            "\r\tDiffractionCorrectionFresnel\n\n"
-            "\rMalloc failed and returned NULL for x_arr. Returning.\n\n"
-        );
-        return;
-    }
+    /*  The loop runs over start <= center <= start + n_used, inclusive. The  *
+     *  windows are summed over in full, there is no extra cost per point.    */
+    if (!rssringoccs_Tau_Schedule(
+            tau, tau->start, tau->start + tau->n_used + 1UL, 2.0*tau->dx_km,
+            0.0, rssringoccs_Diffraction_Correction_Fresnel_Block, &data,
+            n_threads))
+        failed = 1;
 
-    if (!(w_func))
+    /*  A cancelled run has set its own error message.                        */
+    if (failed && !tau->error_occurred)
     {
         tau->error_occurred = tmpl_True;
         tau->error_message = tmpl_strdup(
             "\n\rError Encountered: rss_ringoccs\n\n"
             "\r\tDiffractionCorrectionFresnel\n\n"
-            "\rMalloc failed and returned NULL for w_func. Returning.\n\n"
+            "\rMalloc failed and returned NULL for x_arr or w_func.\n\n"
         );
-        return;
-    }
-
-    rssringoccs_Tau_Reset_Window(x_arr, w_func, dx, w_init, nw_pts, fw);
-
-    /* Compute Window Functions, and compute pi/2 * x^2                       */
-    for (m = 0; m < nw_pts; ++m)
-    {
-        /*  The independent variable is pi/2 * ((rho-rho0)/F)^2. Compute      *
-         *  part of this. The 1/F^2 part is introduced later.                 */
-        x_arr[m] *= tmpl_Pi_By_Two*x_arr[m];
-
-        /*  Use the fwd_factor to computer forward or inverse transform.      */
-        x_arr[m] *= fwd_factor;
-    }
-
-    /*  Compute the Fresnel transform across the input data.                  */
-    for (m=0; m<=tau->n_used; ++m)
-    {
-        /*  If the window width has deviated more the 2*dx, reset values.     */
-        if (tmpl_Double_Abs(w_init - tau->w_km_vals[center]) >= two_dx)
-        {
-            /* Reset w_init and recompute window function.                    */
-            w_init = tau->w_km_vals[center];
-            nw_pts = ((size_t)(w_init / two_dx)) + 1UL;
-
-            /*  Reallocate memory, since the sizes of the arrays changed.     */
-            w_func = realloc(w_func, sizeof(double)*nw_pts);
-            x_arr  = realloc(x_arr, sizeof(double)*nw_pts);
-
-            /*  Reset the x_arr array to range between -W/2 and zero.         */
-            rssringoccs_Tau_Reset_Window(x_arr, w_func, dx, w_init, nw_pts, fw);
-
-            /* Compute Window Functions, and compute pi/2 * x^2.              */
-            for(n=0; n<nw_pts; ++n)
-            {
-                x_arr[n] *= tmpl_Pi_By_Two*x_arr[n];
-
-                /*  Again, if forward calculation is set, negate x_arr.       */
-                x_arr[n] *= fwd_factor;
-            }
-        }
-
-        /*  Compute the Fresnel Transform about the current point.            */
-        FresT(tau, x_arr, w_func, nw_pts, center);
-
-        /*  Move the pointers to the next point.                              */
-        center += 1;
     }
-
-    /*  Free the variables allocated by malloc.                               */
-    free(x_arr);
-    free(w_func);
 }
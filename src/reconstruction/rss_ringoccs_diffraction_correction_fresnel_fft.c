@@ -0,0 +1,540 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                      Diffraction Correction: Fresnel FFT                   *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Computes the quadratic Fresnel reconstruction with blocked FFT        *
+ *      convolutions instead of a direct O(W) sum per point.                  *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  With x_d = d*dx, the quadratic Fresnel transform about a point c is       *
+ *                                                                            *
+ *                     K                                                      *
+ *                   -----                                                    *
+ *      T_out[c] = f \      w(d) exp(-i a_c d^2) T_in[c - d]                  *
+ *                   /                                                        *
+ *                   -----                                                    *
+ *                   d = -K                                                   *
+ *                                                                            *
+ *  where a_c = (pi/2) (dx / F_c)^2 and f = (1+i) dx / 2F_c. The window w and *
+ *  half-width K only change when the window width drifts by 2*dx, so         *
+ *  between such resets only a_c depends on c. Fix a reference value a_b      *
+ *  for a block of points and write a_c d^2 = a_b d^2 + beta_c (d/K)^2,       *
+ *  where beta_c = (a_c - a_b) K^2. Expanding exp(-i beta_c u) in a Taylor    *
+ *  series in u = (d/K)^2 gives                                               *
+ *                                                                            *
+ *                  P-1                                                       *
+ *                 -----                                                      *
+ *      T_out[c] = \      (-i beta_c)^p / p!  (g_p * T_in)[c],                *
+ *                 /                                                          *
+ *                 -----                                                      *
+ *                 p = 0                                                      *
+ *                                                                            *
+ *  with g_p(d) = w(d) exp(-i a_b d^2) (d/K)^(2p). Each term is a true        *
+ *  convolution, computed for the entire block with FFTs (overlap-save). The  *
+ *  truncation error is bounded by beta^P / P!, where beta = max |beta_c|.    *
+ *  Blocks are grown until either the window resets, beta exceeds             *
+ *  RSSRINGOCCS_FRESNEL_FFT_MAX_BETA, or the block fills the FFT. The number  *
+ *  of terms is then chosen so that beta^P / P! is below                      *
+ *  RSSRINGOCCS_FRESNEL_FFT_TOLERANCE. For nearly constant F a single term    *
+ *  (one convolution) is enough.                                              *
+ *                                                                            *
+ *  If a block is too short for the FFT to pay off, it is computed with the   *
+ *  direct sum. For blocks computed with FFTs the direct sum is evaluated at  *
+ *  the first, middle, and last point, and the largest difference is stored   *
+ *  in tau->fft_max_deviation.                                                *
+ ******************************************************************************/
+
+/*  malloc, realloc, and free are found here.                                 */
+#include <stdlib.h>
+
+/*  tmpl_CDouble_FFT and tmpl_CDouble_IFFT are declared here.                 */
+#include <libtmpl/include/tmpl.h>
+
+/*  Fresnel transforms and prototypes for the reconstruction functions.       */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  The largest allowed |beta_c| within a block, in radians.                  */
+#ifndef RSSRINGOCCS_FRESNEL_FFT_MAX_BETA
+#define RSSRINGOCCS_FRESNEL_FFT_MAX_BETA (2.0)
+#endif
+
+/*  Bound on the truncation error of the Taylor series of exp(-i beta u).     */
+#ifndef RSSRINGOCCS_FRESNEL_FFT_TOLERANCE
+#define RSSRINGOCCS_FRESNEL_FFT_TOLERANCE (1.0E-13)
+#endif
+
+/*  Maximum number of terms in the expansion.                                 */
+#define RSSRINGOCCS_FRESNEL_FFT_MAX_TERMS (48U)
+
+/*  Function pointer type for the two quadratic Fresnel transforms.           */
+typedef void (*rssringoccs_Fresnel_FFT_FresT)(
+    rssringoccs_TAUObj *, const double *, const double *, size_t, size_t
+);
+
+/*  A contiguous set of points sharing a window and a reference 1/F^2.        */
+typedef struct rssringoccs_Fresnel_FFT_Block_Def {
+    size_t first;
+    size_t last;
+    double w_init;
+    double rcpr_F2;
+    double beta;
+    double deviation;
+} rssringoccs_Fresnel_FFT_Block;
+
+/*  Smallest power of two that is not smaller than n.                         */
+static size_t rssringoccs_Fresnel_FFT_Size(size_t n)
+{
+    size_t size = 1U;
+
+    while (size < n)
+        size <<= 1;
+
+    return size;
+}
+
+/*  The FFT length used for a window of K points on either side of center.    *
+ *  The block length is then at most three quarters of the FFT length.        */
+static size_t rssringoccs_Fresnel_FFT_Length(size_t K)
+{
+    return rssringoccs_Fresnel_FFT_Size(4U*(2U*K + 1U));
+}
+
+/*  Splits start to start + n_used, inclusive, into blocks. This is the range *
+ *  of rssringoccs_Diffraction_Correction_Fresnel, and the window width       *
+ *  follows the same 2*dx reset rule. The blocks are returned in *blocks_ptr, *
+ *  which must be freed by the caller, and their number in *n_blocks_ptr.     *
+ *  Returns false if realloc fails.                                           */
+static tmpl_Bool
+rssringoccs_Fresnel_FFT_Plan(const rssringoccs_TAUObj *tau,
+                             rssringoccs_Fresnel_FFT_Block **blocks_ptr,
+                             size_t *n_blocks_ptr)
+{
+    size_t center, next, K, max_length, n_blocks, capacity;
+    double w_init, rcpr_F2, r_min, r_max, scale, beta;
+    const double dx = tau->dx_km;
+    const double two_dx = 2.0*dx;
+    const size_t end = tau->start + tau->n_used + 1U;
+    rssringoccs_Fresnel_FFT_Block *blocks = NULL;
+    rssringoccs_Fresnel_FFT_Block *tmp;
+
+    *blocks_ptr = NULL;
+    *n_blocks_ptr = 0U;
+    n_blocks = 0U;
+    capacity = 0U;
+    center = tau->start;
+    w_init = tau->w_km_vals[center];
+
+    while (center < end)
+    {
+        /*  Reset the window if it has drifted by 2*dx, as the serial loop.   */
+        if (tmpl_Double_Abs(w_init - tau->w_km_vals[center]) >= two_dx)
+            w_init = tau->w_km_vals[center];
+
+        K = (size_t)(w_init / two_dx) + 1U;
+        max_length = rssringoccs_Fresnel_FFT_Length(K) - 2U*K;
+
+        /*  beta_c = (pi/2) (K dx)^2 (1/F_c^2 - 1/F_b^2).                     */
+        scale = tmpl_Pi_By_Two*(double)K*dx*(double)K*dx;
+        r_min = 1.0 / (tau->F_km_vals[center]*tau->F_km_vals[center]);
+        r_max = r_min;
+
+        /*  Grow the block until the window resets, the block fills the FFT,  *
+         *  or the spread in 1/F^2 makes the expansion too long.              */
+        for (next = center + 1U; next < end; ++next)
+        {
+            if (next - center >= max_length)
+                break;
+
+            if (tmpl_Double_Abs(w_init - tau->w_km_vals[next]) >= two_dx)
+                break;
+
+            rcpr_F2 = 1.0 / (tau->F_km_vals[next]*tau->F_km_vals[next]);
+
+            if (rcpr_F2 < r_min)
+            {
+                beta = 0.5*(r_max - rcpr_F2)*scale;
+
+                if (beta > RSSRINGOCCS_FRESNEL_FFT_MAX_BETA)
+                    break;
+
+                r_min = rcpr_F2;
+            }
+            else if (rcpr_F2 > r_max)
+            {
+                beta = 0.5*(rcpr_F2 - r_min)*scale;
+
+                if (beta > RSSRINGOCCS_FRESNEL_FFT_MAX_BETA)
+                    break;
+
+                r_max = rcpr_F2;
+            }
+        }
+
+        if (n_blocks == capacity)
+        {
+            capacity = (capacity == 0U ? 64U : 2U*capacity);
+            tmp = realloc(blocks, sizeof(*blocks)*capacity);
+
+            if (!tmp)
+            {
+                free(blocks);
+                return tmpl_False;
+            }
+
+            blocks = tmp;
+        }
+
+        blocks[n_blocks].first = center;
+        blocks[n_blocks].last = next;
+        blocks[n_blocks].w_init = w_init;
+        blocks[n_blocks].rcpr_F2 = 0.5*(r_min + r_max);
+        blocks[n_blocks].beta = 0.5*(r_max - r_min)*scale;
+        blocks[n_blocks].deviation = 0.0;
+        ++n_blocks;
+
+        center = next;
+    }
+
+    *blocks_ptr = blocks;
+    *n_blocks_ptr = n_blocks;
+    return tmpl_True;
+}
+
+/*  Reconstructs the points in a block. Returns false if malloc fails.        */
+static tmpl_Bool
+rssringoccs_Fresnel_FFT_Compute_Block(rssringoccs_TAUObj *tau,
+                                      rssringoccs_Fresnel_FFT_Block *block,
+                                      rssringoccs_Fresnel_FFT_FresT FresT,
+                                      double fwd_factor)
+{
+    size_t n, m, d, p, N, K, log2_N, n_terms;
+    double term_bound, rcpr_F, factor, deviation, scale;
+    tmpl_ComplexDouble value, arg, norm_term;
+
+    /*  Window variables, and the arrays used for the FFT.                    */
+    double *x_arr, *w_func, *u_pow, *beta;
+    tmpl_ComplexDouble *kernel, *fft_in, *fft_ker, *out, *coeff, *norm;
+
+    /*  The points that are compared with the direct sum.                     */
+    size_t probes[3];
+
+    const double dx = tau->dx_km;
+    const size_t L = block->last - block->first;
+    tmpl_Bool success = tmpl_True;
+
+    K = (size_t)(block->w_init / (2.0*dx)) + 1U;
+    N = rssringoccs_Fresnel_FFT_Length(K);
+
+    /*  Number of terms needed so that beta^P / P! is below the tolerance.    */
+    n_terms = 1U;
+    term_bound = block->beta;
+
+    while ((term_bound > RSSRINGOCCS_FRESNEL_FFT_TOLERANCE) &&
+           (n_terms < RSSRINGOCCS_FRESNEL_FFT_MAX_TERMS))
+    {
+        ++n_terms;
+        term_bound *= block->beta / (double)n_terms;
+    }
+
+    /*  Compute the window and the quadratic phase, as in the direct method.  */
+    x_arr = malloc(sizeof(*x_arr)*K);
+    w_func = malloc(sizeof(*w_func)*K);
+
+    if (!x_arr || !w_func)
+    {
+        free(x_arr);
+        free(w_func);
+        return tmpl_False;
+    }
+
+    rssringoccs_Tau_Reset_Window(x_arr, w_func, dx, block->w_init,
+                                 K, tau->window_func);
+
+    for (n = 0U; n < K; ++n)
+        x_arr[n] *= tmpl_Pi_By_Two*x_arr[n]*fwd_factor;
+
+    /*  Rough operation counts of the two methods. Short blocks are computed  *
+     *  directly since the FFTs would cost more than the sums.                */
+    log2_N = 0U;
+
+    for (n = N; n > 1U; n >>= 1)
+        ++log2_N;
+
+    if ((double)L*(double)K <= (double)(n_terms+1U)*(double)N*(double)log2_N)
+    {
+        for (n = block->first; n < block->last; ++n)
+            FresT(tau, x_arr, w_func, K, n);
+
+        free(x_arr);
+        free(w_func);
+        return tmpl_True;
+    }
+
+    kernel  = malloc(sizeof(*kernel)*(K+1U));
+    u_pow   = malloc(sizeof(*u_pow)*(K+1U));
+    fft_in  = malloc(sizeof(*fft_in)*N);
+    fft_ker = malloc(sizeof(*fft_ker)*N);
+    out     = malloc(sizeof(*out)*L);
+    coeff   = malloc(sizeof(*coeff)*L);
+    norm    = malloc(sizeof(*norm)*L);
+    beta    = malloc(sizeof(*beta)*L);
+
+    if (!kernel || !u_pow || !fft_in || !fft_ker ||
+        !out || !coeff || !norm || !beta)
+    {
+        success = tmpl_False;
+        n_terms = 0U;
+    }
+    else
+    {
+        /*  The data needed by the block, zero padded to the FFT length.      */
+        for (n = 0U; n < L + 2U*K; ++n)
+            fft_in[n] = tau->T_in[block->first - K + n];
+
+        for (n = L + 2U*K; n < N; ++n)
+            fft_in[n] = tmpl_CDouble_Zero;
+
+        tmpl_CDouble_FFT(fft_in, fft_in, N);
+
+        /*  Kernel at the reference 1/F^2: w(d) exp(-i a_b d^2), d = 1 to K.  */
+        for (d = 1U; d <= K; ++d)
+        {
+            kernel[d] = tmpl_CDouble_Polar(w_func[K-d],
+                                           -x_arr[K-d]*block->rcpr_F2);
+            u_pow[d] = 1.0;
+        }
+
+        /*  beta_c for every point in the block.                              */
+        scale = fwd_factor*tmpl_Pi_By_Two*(double)K*dx*(double)K*dx;
+
+        for (n = 0U; n < L; ++n)
+        {
+            rcpr_F = 1.0 / tau->F_km_vals[block->first + n];
+            beta[n] = scale*(rcpr_F*rcpr_F - block->rcpr_F2);
+            coeff[n] = tmpl_CDouble_One;
+            out[n] = tmpl_CDouble_Zero;
+            norm[n] = tmpl_CDouble_Zero;
+        }
+    }
+
+    /*  Sum the terms of the expansion, one convolution per term.             */
+    for (p = 0U; p < n_terms; ++p)
+    {
+        /*  g_p(d) = w(d) exp(-i a_b d^2) (d/K)^(2p), stored circularly.      */
+        norm_term = tmpl_CDouble_Zero;
+
+        for (n = 0U; n < N; ++n)
+            fft_ker[n] = tmpl_CDouble_Zero;
+
+        if (p == 0U)
+            fft_ker[0] = tmpl_CDouble_One;
+
+        for (d = 1U; d <= K; ++d)
+        {
+            value = tmpl_CDouble_Multiply_Real(u_pow[d], kernel[d]);
+            fft_ker[d] = value;
+            fft_ker[N-d] = value;
+            tmpl_CDouble_AddTo(&norm_term, &value);
+            u_pow[d] *= ((double)d/(double)K)*((double)d/(double)K);
+        }
+
+        /*  The normalization uses the same expansion, 1 + 2 sum g_p(d).      */
+        norm_term = tmpl_CDouble_Multiply_Real(2.0, norm_term);
+
+        if (p == 0U)
+            tmpl_CDouble_AddTo_Real(&norm_term, 1.0);
+
+        tmpl_CDouble_FFT(fft_ker, fft_ker, N);
+
+        for (n = 0U; n < N; ++n)
+            fft_ker[n] = tmpl_CDouble_Multiply(fft_ker[n], fft_in[n]);
+
+        tmpl_CDouble_IFFT(fft_ker, fft_ker, N);
+
+        /*  Accumulate (-i beta_c)^p / p! times the convolution.              */
+        for (n = 0U; n < L; ++n)
+        {
+            value = tmpl_CDouble_Multiply(coeff[n], fft_ker[n + K]);
+            tmpl_CDouble_AddTo(&out[n], &value);
+
+            value = tmpl_CDouble_Multiply(coeff[n], norm_term);
+            tmpl_CDouble_AddTo(&norm[n], &value);
+
+            arg = tmpl_CDouble_Rect(0.0, -beta[n] / (double)(p + 1U));
+            coeff[n] = tmpl_CDouble_Multiply(coeff[n], arg);
+        }
+    }
+
+    if (success)
+    {
+        for (n = 0U; n < L; ++n)
+        {
+            m = block->first + n;
+
+            /*  Same scale factors as the direct transforms.                  */
+            if (tau->use_norm)
+                factor = 0.5*tmpl_Sqrt_Two / tmpl_CDouble_Abs(norm[n]);
+            else
+                factor = 0.5*dx / tau->F_km_vals[m];
+
+            arg = tmpl_CDouble_Rect(factor, factor);
+            tau->T_out[m] = tmpl_CDouble_Multiply(arg, out[n]);
+        }
+
+        /*  Compare with the direct sum at the ends and the middle.           */
+        probes[0] = block->first;
+        probes[1] = block->first + L/2U;
+        probes[2] = block->last - 1U;
+
+        for (n = 0U; n < 3U; ++n)
+        {
+            m = probes[n];
+            value = tau->T_out[m];
+            FresT(tau, x_arr, w_func, K, m);
+            arg = tmpl_CDouble_Subtract(value, tau->T_out[m]);
+            deviation = tmpl_CDouble_Abs(arg);
+            tau->T_out[m] = value;
+
+            if (deviation > block->deviation)
+                block->deviation = deviation;
+        }
+    }
+
+    free(x_arr);
+    free(w_func);
+    free(kernel);
+    free(u_pow);
+    free(fft_in);
+    free(fft_ker);
+    free(out);
+    free(coeff);
+    free(norm);
+    free(beta);
+    return success;
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Diffraction_Correction_Fresnel_FFT                        *
+ *  Purpose:                                                                  *
+ *      Compute the quadratic Fresnel reconstruction using blocked FFTs.      *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object with the diffracted data and geometry.             *
+ *  Output:                                                                   *
+ *      None (void).                                                          *
+ *  Notes:                                                                    *
+ *      1.) The result agrees with rssringoccs_Diffraction_Correction_Fresnel *
+ *          up to round-off and the truncation bound of the expansion. The    *
+ *          largest difference at the probe points is stored in               *
+ *          tau->fft_max_deviation, if larger than its current value, so it   *
+ *          may be checked by the caller.                                     *
+ *      2.) Blocks are independent and are distributed over tau->num_threads  *
+ *          threads if the library is built with OpenMP.                      *
+ ******************************************************************************/
+void rssringoccs_Diffraction_Correction_Fresnel_FFT(rssringoccs_TAUObj *tau)
+{
+    size_t n, n_blocks;
+    double fwd_factor;
+    unsigned int n_threads;
+    int failed = 0;
+    rssringoccs_Fresnel_FFT_Block *blocks;
+    rssringoccs_Fresnel_FFT_FresT FresT;
+
+    /*  Check that the pointers to the data are not NULL.                     */
+    rssringoccs_Tau_Check_Data(tau);
+
+    if (tau->error_occurred)
+        return;
+
+    /* Check to ensure you have enough data to the left and right.            */
+    rssringoccs_Tau_Check_Data_Range(tau);
+
+    if (tau->error_occurred)
+        return;
+
+    /*  Used for short blocks and for the comparison with the direct sum.     */
+    if (tau->use_simd)
+    {
+        if (tau->use_norm)
+            FresT = rssringoccs_Fresnel_Transform_Norm_SIMD;
+        else
+            FresT = rssringoccs_Fresnel_Transform_SIMD;
+    }
+    else
+    {
+        if (tau->use_norm)
+            FresT = rssringoccs_Fresnel_Transform_Norm;
+        else
+            FresT = rssringoccs_Fresnel_Transform;
+    }
+
+    /*  The forward model is computed by conjugating the kernel.              */
+    if (tau->use_fwd)
+        fwd_factor = -1.0;
+    else
+        fwd_factor = 1.0;
+
+    if (!rssringoccs_Fresnel_FFT_Plan(tau, &blocks, &n_blocks))
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Diffraction_Correction_Fresnel_FFT\n\n"
+            "\rrealloc failed and returned NULL for blocks. Returning.\n\n"
+        );
+        return;
+    }
+
+    n_threads = rssringoccs_Tau_Thread_Count(tau);
+    (void)n_threads;
+
+    /*  Blocks vary in cost, so they are handed out dynamically.              */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(n_threads) schedule(dynamic, 1) \
+    reduction(|:failed)
+#endif
+    for (n = 0U; n < n_blocks; ++n)
+    {
+        if (!rssringoccs_Fresnel_FFT_Compute_Block(tau, &blocks[n],
+                                                   FresT, fwd_factor))
+            failed = 1;
+    }
+
+    /*  The deviation is the maximum over the inverse and forward passes.     */
+    for (n = 0U; n < n_blocks; ++n)
+        if (blocks[n].deviation > tau->fft_max_deviation)
+            tau->fft_max_deviation = blocks[n].deviation;
+
+    free(blocks);
+
+    if (failed)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Diffraction_Correction_Fresnel_FFT\n\n"
+            "\rmalloc failed and returned NULL. Returning.\n\n"
+        );
+    }
+}
+/*  End of rssringoccs_Diffraction_Correction_Fresnel_FFT.                    */
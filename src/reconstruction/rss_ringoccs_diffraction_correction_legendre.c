@@ -2,6 +2,7 @@
 #include <math.h>
 #include <libtmpl/include/tmpl_math.h>
 #include <libtmpl/include/tmpl_special_functions_real.h>
+#include <libtmpl/include/tmpl_string.h>
 #include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
 #include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
 
@@ -34,93 +35,94 @@
  *          Legendre approximation assumes the first iteration of the Newton  *
  *          Raphson method is good enough, whereas in reality 3-4 iterations  *
  *          may be needed, like in Rev133.                                    *
+ *      3.) If the library is built with OpenMP the points are split into     *
+ *          tasks of about equal cost, run by rssringoccs_Tau_Schedule. Each  *
+ *          task has its own window and Legendre buffers, and starts with the *
+ *          window width the serial loop would be using at its first point,   *
+ *          so the output is identical to the serial computation.             *
+ *      4.) If tau->use_window_cache is set the window functions are taken    *
+ *          from the process-wide cache (see rssringoccs_Window_Cache_Get).   *
  ******************************************************************************/
-void rssringoccs_Diffraction_Correction_Legendre(rssringoccs_TAUObj *tau)
-{
-    /*  i is used for indexing, nw_pts is the number of points in the window. */
-    size_t i, nw_pts, center;
-
-    /*  Variable for the number of Legendre coefficients to be computed.      */
-    unsigned int poly_order;
+/*  Function pointer type for the even and odd Legendre transforms.          */
+typedef void (*rssringoccs_Legendre_FresT)(
+    rssringoccs_TAUObj *, const double *, const double *, const double *,
+    size_t, size_t
+);
 
-    /*  IsEven is a boolean for determining the parity of the polynomial.     */
-    tmpl_Bool IsEven;
+/*  Computes x_arr, ranging from -W/2 to zero, and the window function for a  *
+ *  window of width w_init. The window is written to w_func, or taken from    *
+ *  the window cache if tau->use_window_cache is set. The pointer to the      *
+ *  window that is to be used is returned.                                    */
+static const double *
+rssringoccs_Diffraction_Correction_Legendre_Window(
+    const rssringoccs_TAUObj *tau, double *x_arr, double *w_func,
+    double dx, double w_init, size_t nw_pts
+)
+{
+    size_t n;
+    const double *window = NULL;
 
-    /*  Various other variables needed throughout.                            */
-    double w_init, dx, two_dx, cosb, sinp, cosp, Legendre_Coeff;
-    double *x_arr, *w_func, *legendre_p, *alt_legendre_p, *fresnel_ker_coeffs;
+    /*  The left half-window is the first nw_pts entries of the cached table. */
+    if (tau->use_window_cache)
+        window = rssringoccs_Window_Cache_Get(tau->window_func, nw_pts - 1UL);
 
-    /*  Create function pointers for window function and Fresnel transform.   */
-    rssringoccs_Window_Function fw = tau->window_func;
+    if (!window)
+    {
+        rssringoccs_Tau_Reset_Window(x_arr, w_func, dx, w_init,
+                                     nw_pts, tau->window_func);
+        return w_func;
+    }
 
-    void (*FresT)(
-        rssringoccs_TAUObj *, const double *, const double *, const double *,
-        size_t, size_t
-    );
+    for (n = 0; n < nw_pts; ++n)
+        x_arr[n] = ((double)n - (double)nw_pts)*dx;
 
-    /*  This should remain at false.                                          */
-    tau->error_occurred = tmpl_False;
+    return window;
+}
 
-    /*  Check that the pointers to the data are not NULL.                     */
-    rssringoccs_Tau_Check_Data(tau);
-    if (tau->error_occurred)
-        return;
+/*  The arguments of rssringoccs_Diffraction_Correction_Legendre_Block that   *
+ *  are the same for every task.                                              */
+typedef struct rssringoccs_Legendre_Task_Data_Def {
+    rssringoccs_Legendre_FresT FresT;
+    unsigned int poly_order;
+    double dx;
+} rssringoccs_Legendre_Task_Data;
 
-    /*  Set the IsEven boolean to the appropriate value. Since the linear and *
-     *  constant term are zero, even polynomials will have an odd number of   *
-     *  terms. For example, the quartic expansion has the quadratic, cubic,   *
-     *  quartic terms, and hence needs three coefficients. Thus, if the       *
-     *  tau->order variable is an odd number, this corresponds to an even     *
-     *  polynomial and vice versa. Set IsEven accordingly.                    */
-    if (tau->order & 1)
-        IsEven = tmpl_True;
-    else
-        IsEven = tmpl_False;
+/*  Reconstructs the points of a task. Returns false if malloc fails. The     *
+ *  window starts from the width it was built with at task->anchor.           */
+static tmpl_Bool
+rssringoccs_Diffraction_Correction_Legendre_Block(
+    rssringoccs_TAUObj *tau,
+    void *data,
+    unsigned int worker,
+    const rssringoccs_Tau_Task *task
+)
+{
+    /*  nw_pts is the number of points in the window.                         */
+    size_t nw_pts, center;
 
-    /*  Select the appropriate Fresnel transform and set poly_order.          */
-    if (IsEven)
-        poly_order = tau->order;
-    else
-        poly_order = tau->order + 1;
+    /*  The transform, the number of coefficients, and the sample spacing.    */
+    const rssringoccs_Legendre_Task_Data *args = data;
+    const rssringoccs_Legendre_FresT FresT = args->FresT;
+    const unsigned int poly_order = args->poly_order;
+    const double dx = args->dx;
 
-    if (tau->use_norm)
-    {
-        if (IsEven)
-            FresT = rssringoccs_Fresnel_Transform_Legendre_Even_Norm;
-        else
-            FresT = rssringoccs_Fresnel_Transform_Legendre_Odd_Norm;
-    }
-    else
-    {
-        if (IsEven)
-            FresT = rssringoccs_Fresnel_Transform_Legendre_Even;
-        else
-            FresT = rssringoccs_Fresnel_Transform_Legendre_Odd;
-    }
+    /*  Various other variables needed throughout.                            */
+    const double two_dx = 2.0*dx;
+    double w_init, cosb, sinp, cosp, Legendre_Coeff;
+    double *x_arr, *w_func, *legendre_p, *alt_legendre_p, *fresnel_ker_coeffs;
+    double *tmp;
+    tmpl_Bool success = tmpl_True;
 
-    /* Compute first window width and window function. */
-    center = tau->start;
+    /*  The window in use. This is either w_func or a cached table.           */
+    const double *window = NULL;
 
-    /*  If forward tranform is set, negate the k_vals variable. This has      *
-     *  the equivalent effect of computing the forward calculation later.     */
-    if (tau->use_fwd)
-    {
-        /*  Loop over all of k_vals and negate the value.                     */
-        for (i=0; i <= tau->n_used; ++i)
-            tau->k_vals[i] *= -1.0;
-    }
+    /*  Every thread has its own buffers, so the thread does not matter.      */
+    (void)worker;
 
-    /*  Compute more necessary data.                                          */
-    w_init = tau->w_km_vals[center];
-    dx     = tau->rho_km_vals[center+1] - tau->rho_km_vals[center];
-    two_dx = 2.0*dx;
+    /*  The width of the window in effect at the first point of this task.    */
+    w_init = tau->w_km_vals[task->anchor];
     nw_pts = (size_t)(w_init / two_dx) + 1UL;
 
-    /* Check to ensure you have enough data to the left.                      */
-    rssringoccs_Tau_Check_Data_Range(tau);
-    if (tau->error_occurred)
-        return;
-
     /*  Allocate memory for the independent variable and window function.     */
     x_arr  = malloc(sizeof(*x_arr)*nw_pts);
     w_func = malloc(sizeof(*w_func)*nw_pts);
@@ -137,16 +139,14 @@ void rssringoccs_Diffraction_Correction_Legendre(rssringoccs_TAUObj *tau)
      *  that it's values range from -W/2 to zero, W being the window width.   */
     if (!(x_arr)    ||    !(w_func)            ||    !(legendre_p)
                     ||    !(alt_legendre_p)    ||    !(fresnel_ker_coeffs))
-    {
-        /*  Malloc failed, return to calling function.                        */
-        tau->error_occurred = tmpl_True;
-        return;
-    }
+        success = tmpl_False;
     else
-        rssringoccs_Tau_Reset_Window(x_arr, w_func, dx, w_init, nw_pts, fw);
+        window = rssringoccs_Diffraction_Correction_Legendre_Window(
+            tau, x_arr, w_func, dx, w_init, nw_pts
+        );
 
     /* Loop through each point and begin the reconstruction.                  */
-    for (i = 0; i < tau->n_used; ++i)
+    for (center = task->first; success && center < task->last; ++center)
     {
         /*  Compute some geometric information, and the scaling coefficient   *
          *  for the Legendre polynomial expansion.                            */
@@ -174,18 +174,33 @@ void rssringoccs_Diffraction_Correction_Legendre(rssringoccs_TAUObj *tau)
             nw_pts = (size_t)(w_init / two_dx) + 1UL;
 
             /*  Reallocate x_arr and w_func since the sizes changed.          */
-            x_arr  = realloc(x_arr, sizeof(double)*nw_pts);
-            w_func = realloc(w_func, sizeof(double)*nw_pts);
+            tmp = realloc(x_arr, sizeof(*x_arr)*nw_pts);
+
+            if (!tmp)
+            {
+                success = tmpl_False;
+                break;
+            }
+
+            x_arr = tmp;
+            tmp = realloc(w_func, sizeof(*w_func)*nw_pts);
+
+            if (!tmp)
+            {
+                success = tmpl_False;
+                break;
+            }
+
+            w_func = tmp;
 
             /*  Recompute x_arr and w_func for the new sizes.                 */
-            rssringoccs_Tau_Reset_Window(x_arr, w_func, dx, w_init, nw_pts, fw);
+            window = rssringoccs_Diffraction_Correction_Legendre_Window(
+                tau, x_arr, w_func, dx, w_init, nw_pts
+            );
         }
 
         /*  Compute the fresnel tranform about the current point.             */
-        FresT(tau, x_arr, w_func, fresnel_ker_coeffs, nw_pts, center);
-
-        /*  Increment T_in pointer using pointer arithmetic.                  */
-        center += 1;
+        FresT(tau, x_arr, window, fresnel_ker_coeffs, nw_pts, center);
     }
 
     /*  Free all variables allocated by malloc.                               */
@@ -194,4 +209,131 @@ void rssringoccs_Diffraction_Correction_Legendre(rssringoccs_TAUObj *tau)
     free(legendre_p);
     free(alt_legendre_p);
     free(fresnel_ker_coeffs);
+    return success;
+}
+
+void rssringoccs_Diffraction_Correction_Legendre(rssringoccs_TAUObj *tau)
+{
+    /*  i is used for indexing.                                               */
+    size_t i;
+
+    /*  Variable for the number of Legendre coefficients to be computed.      */
+    unsigned int poly_order;
+
+    /*  IsEven is a boolean for determining the parity of the polynomial.     */
+    tmpl_Bool IsEven;
+
+    /*  The sample spacing.                                                   */
+    double dx;
+
+    /*  Number of threads used, and a flag for malloc failures.               */
+    unsigned int n_threads;
+    int failed = 0;
+
+    /*  Function pointer for the Fresnel transform.                           */
+    rssringoccs_Legendre_FresT FresT;
+    rssringoccs_Legendre_Task_Data data;
+
+    /*  This should remain at false.                                          */
+    tau->error_occurred = tmpl_False;
+
+    /*  Check that the pointers to the data are not NULL.                     */
+    rssringoccs_Tau_Check_Data(tau);
+    if (tau->error_occurred)
+        return;
+
+    /*  Set the IsEven boolean to the appropriate value. Since the linear and *
+     *  constant term are zero, even polynomials will have an odd number of   *
+     *  terms. For example, the quartic expansion has the quadratic, cubic,   *
+     *  quartic terms, and hence needs three coefficients. Thus, if the       *
+     *  tau->order variable is an odd number, this corresponds to an even     *
+     *  polynomial and vice versa. Set IsEven accordingly.                    */
+    if (tau->order & 1)
+        IsEven = tmpl_True;
+    else
+        IsEven = tmpl_False;
+
+    /*  Select the appropriate Fresnel transform and set poly_order.          */
+    if (IsEven)
+        poly_order = tau->order;
+    else
+        poly_order = tau->order + 1;
+
+    if (tau->use_simd)
+    {
+        if (tau->use_norm)
+        {
+            if (IsEven)
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Even_Norm_SIMD;
+            else
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Odd_Norm_SIMD;
+        }
+        else
+        {
+            if (IsEven)
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Even_SIMD;
+            else
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Odd_SIMD;
+        }
+    }
+    else
+    {
+        if (tau->use_norm)
+        {
+            if (IsEven)
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Even_Norm;
+            else
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Odd_Norm;
+        }
+        else
+        {
+            if (IsEven)
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Even;
+            else
+                FresT = rssringoccs_Fresnel_Transform_Legendre_Odd;
+        }
+    }
+
+    /*  If forward tranform is set, negate the k_vals variable. This has      *
+     *  the equivalent effect of computing the forward calculation later.     *
+     *  This is done before any threads are started since it modifies tau.    */
+    if (tau->use_fwd)
+    {
+        /*  Loop over all of k_vals and negate the value.                     */
+        for (i=0; i <= tau->n_used; ++i)
+            tau->k_vals[i] *= -1.0;
+    }
+
+    /*  Compute more necessary data.                                          */
+    dx = tau->rho_km_vals[tau->start+1] - tau->rho_km_vals[tau->start];
+
+    /* Check to ensure you have enough data to the left.                      */
+    rssringoccs_Tau_Check_Data_Range(tau);
+    if (tau->error_occurred)
+        return;
+
+    n_threads = rssringoccs_Tau_Thread_Count(tau);
+    data.FresT = FresT;
+    data.poly_order = poly_order;
+    data.dx = dx;
+
+    /*  The coefficients of a point take about as long as poly_order samples. */
+    if (!rssringoccs_Tau_Schedule(
+            tau, tau->start, tau->start + tau->n_used, 2.0*dx,
+            (double)poly_order,
+            rssringoccs_Diffraction_Correction_Legendre_Block, &data,
+            n_threads))
+        failed = 1;
+
+    /*  Malloc failed, return to calling function. A cancelled run has set    *
+     *  its own error message.                                                */
+    if (failed && !tau->error_occurred)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n\n"
+            "\r\trssringoccs_Diffraction_Correction_Legendre\n\n"
+            "\rMalloc failed and returned NULL. Returning.\n\n"
+        );
+    }
 }
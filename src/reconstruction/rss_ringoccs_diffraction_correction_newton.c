@@ -35,18 +35,328 @@
  *          polynomials increase the number of computations needed. The real  *
  *          use of them arises if one uses FFT methods. This routine does NOT *
  *          use FFTs, but rather ordinary integration.                        *
+ *      3.) If the library is built with OpenMP the points start to           *
+ *          start + n_used - 1 are split into tasks of about equal cost,      *
+ *          which the threads run and steal from each other (see              *
+ *          rssringoccs_Tau_Schedule). Each task builds its first window at   *
+ *          the point the serial loop would have built it (see                *
+ *          rssringoccs_Tau_Window_Anchor), so the output does not depend on  *
+ *          the number of threads. The number of threads is set by            *
+ *          tau->num_threads.                                                 *
+ *      4.) If tau->use_window_cache is set the window functions are taken    *
+ *          from the process-wide cache (see rssringoccs_Window_Cache_Get).   *
+ *      5.) The Newton, NewtonD, NewtonPerturb, and NewtonAdaptive transforms *
+ *          are given a rssringoccs_Newton_Warm_Start object per thread. If   *
+ *          tau->use_warm_start is set, Newton's method about each center is  *
+ *          started from the angles found about the previous center (except   *
+ *          for NewtonAdaptive, which uses the object for scratch space). The *
+ *          Newton steps and samples are added to tau->newton_iterations,     *
+ *          tau->newton_samples, and tau->newton_warm_samples either way,     *
+ *          except that cold starts without tau->use_simd run in libtmpl and  *
+ *          their steps are not counted.                                      *
+ *      6.) The transform is looked up in rssringoccs_newton_dispatch. Every  *
+ *          quadratic, quartic, sextic, and octic psitype without a transform *
+ *          of its own uses rssringoccs_Fresnel_Transform_Newton_Interp. A    *
+ *          psitype missing from the table is an error.                       *
  ******************************************************************************/
+/*  The transforms for a Newton-Raphson psitype, without and with the norm.   *
+ *  Exactly one of fres and newton_fres is set.                               */
+typedef struct rssringoccs_Newton_Dispatch_Def {
+    rssringoccs_Psitype_Enum psinum;
+    rssringoccs_FresT fres, fres_norm;
+    rssringoccs_Newton_FresT newton_fres, newton_fres_norm;
+} rssringoccs_Newton_Dispatch;
+
+/*  Every psitype handled by rssringoccs_Diffraction_Correction_Newton. The   *
+ *  quadratic through octic interpolations use rssringoccs_Newton_Interp,     *
+ *  except for the ones with a dedicated transform.                           */
+static const rssringoccs_Newton_Dispatch rssringoccs_newton_dispatch[] = {
+    {
+        rssringoccs_DR_Newton, NULL, NULL,
+        rssringoccs_Fresnel_Transform_Newton,
+        rssringoccs_Fresnel_Transform_Newton_Norm
+    },
+    {
+        rssringoccs_DR_NewtonQuadratic,
+        rssringoccs_Fresnel_Transform_Newton_Quadratic,
+        rssringoccs_Fresnel_Transform_Newton_Quadratic_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonQuartic,
+        rssringoccs_Fresnel_Transform_Newton_Quartic,
+        rssringoccs_Fresnel_Transform_Newton_Quartic_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonSextic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonOctic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonD, NULL, NULL,
+        rssringoccs_Fresnel_Transform_Newton_D,
+        rssringoccs_Fresnel_Transform_Newton_D_Norm
+    },
+    {
+        rssringoccs_DR_NewtonDQuadratic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDQuartic,
+        rssringoccs_Fresnel_Transform_Newton_D_Quartic,
+        rssringoccs_Fresnel_Transform_Newton_D_Quartic_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDSextic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDOctic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDOld,
+        rssringoccs_Fresnel_Transform_Newton_D_Old,
+        rssringoccs_Fresnel_Transform_Newton_D_Old_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDOldQuadratic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDOldQuartic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDOldSextic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDOldOctic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDPhi,
+        rssringoccs_Fresnel_Transform_Newton_dD_dphi,
+        rssringoccs_Fresnel_Transform_Newton_dD_dphi_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDPhiQuadratic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDPhiQuartic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDPhiSextic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonDPhiOctic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonPerturb, NULL, NULL,
+        rssringoccs_Fresnel_Transform_Perturbed_Newton,
+        rssringoccs_Fresnel_Transform_Perturbed_Newton_Norm
+    },
+    {
+        rssringoccs_DR_NewtonElliptical,
+        rssringoccs_Fresnel_Transform_Newton_Elliptical,
+        rssringoccs_Fresnel_Transform_Newton_Elliptical_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonEllipticalQuadratic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonEllipticalQuartic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonEllipticalSextic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonEllipticalOctic,
+        rssringoccs_Fresnel_Transform_Newton_Interp,
+        rssringoccs_Fresnel_Transform_Newton_Interp_Norm, NULL, NULL
+    },
+    {
+        rssringoccs_DR_NewtonAdaptive, NULL, NULL,
+        rssringoccs_Fresnel_Transform_Newton_Adaptive,
+        rssringoccs_Fresnel_Transform_Newton_Adaptive_Norm
+    }
+};
+
+#define RSSRINGOCCS_NEWTON_DISPATCH_SIZE \
+    (sizeof(rssringoccs_newton_dispatch)/sizeof(rssringoccs_newton_dispatch[0]))
+
+/*  Returns the window function about center for a window of width w_init     *
+ *  and nw_pts points. If the window cache is enabled the cached table is     *
+ *  returned, otherwise the window is computed in *buffer, which is grown if  *
+ *  needed. Returns NULL if malloc fails.                                     */
+static const double *
+rssringoccs_Diffraction_Correction_Newton_Window(rssringoccs_TAUObj *tau,
+                                                 double **buffer,
+                                                 size_t *capacity,
+                                                 size_t center,
+                                                 double w_init,
+                                                 size_t nw_pts)
+{
+    size_t j;
+    const size_t offset = center - (nw_pts - 1UL) / 2UL;
+    const double *table;
+    double *tmp;
+
+    /*  The symmetric window is entries 1 through nw_pts of the cached table. */
+    if (tau->use_window_cache)
+    {
+        table = rssringoccs_Window_Cache_Get(tau->window_func,
+                                             (nw_pts - 1UL) / 2UL);
+
+        if (table)
+            return table + 1;
+    }
+
+    /*  Reallocate memory if the window grew.                                 */
+    if (*capacity < nw_pts)
+    {
+        tmp = realloc(*buffer, sizeof(*tmp) * nw_pts);
+
+        if (!tmp)
+            return NULL;
+
+        *buffer = tmp;
+        *capacity = nw_pts;
+    }
+
+    /*  Compute the window function about the given center.                   */
+    for (j = 0; j < nw_pts; ++j)
+        (*buffer)[j] = tau->window_func(
+            tau->rho_km_vals[offset+j] - tau->rho_km_vals[center], w_init
+        );
+
+    return *buffer;
+}
+
+/*  The arguments of rssringoccs_Diffraction_Correction_Newton_Block that     *
+ *  are the same for every task. warm has one entry per thread.               */
+typedef struct rssringoccs_Newton_Task_Data_Def {
+    rssringoccs_FresT FresT;
+    rssringoccs_Newton_FresT NewtonFresT;
+    rssringoccs_Newton_Warm_Start *warm;
+    double two_dx;
+} rssringoccs_Newton_Task_Data;
+
+/*  Reconstructs the points of a task. Returns false if malloc fails, true    *
+ *  otherwise. The window is recomputed exactly as the serial loop does,      *
+ *  starting from task->anchor. If NewtonFresT is not NULL it is used, with   *
+ *  the warm start object of the thread, in place of FresT.                   */
+static tmpl_Bool
+rssringoccs_Diffraction_Correction_Newton_Block(
+    rssringoccs_TAUObj *tau,
+    void *data,
+    unsigned int worker,
+    const rssringoccs_Tau_Task *task
+)
+{
+    /*  nw_pts is the number of points in the window.                         */
+    size_t nw_pts, center;
+
+    /*  The width the current window was built with, and the window itself.   */
+    double w_init;
+    const double *w_func;
+
+    /*  Buffer the window is computed in if it is not taken from the cache.   */
+    double *buffer = NULL;
+    size_t capacity = 0;
+
+    /*  The transforms, and the warm start object of this thread.             */
+    const rssringoccs_Newton_Task_Data *args = data;
+    const rssringoccs_FresT FresT = args->FresT;
+    const rssringoccs_Newton_FresT NewtonFresT = args->NewtonFresT;
+    rssringoccs_Newton_Warm_Start *warm = args->warm + worker;
+    const double two_dx = args->two_dx;
+
+    /*  The point the window in effect at the first center was computed at.   */
+    const size_t anchor = task->anchor;
+
+    /*  Compute the window function about the anchor point.                   */
+    w_init = tau->w_km_vals[anchor];
+    nw_pts = 2UL*((size_t)(w_init / two_dx)) + 1UL;
+    w_func = rssringoccs_Diffraction_Correction_Newton_Window(
+        tau, &buffer, &capacity, anchor, w_init, nw_pts
+    );
+
+    if (!w_func)
+        return tmpl_False;
+
+    /*  Run diffraction correction point by point.                            */
+    for (center = task->first; center < task->last; ++center)
+    {
+        /*  If the window width changes significantly, recompute w_func.      */
+        if (fabs(w_init - tau->w_km_vals[center]) >= two_dx)
+        {
+            /* Reset w_init and recompute window function.                    */
+            w_init = tau->w_km_vals[center];
+            nw_pts = 2UL*((size_t)(w_init / two_dx)) + 1UL;
+            w_func = rssringoccs_Diffraction_Correction_Newton_Window(
+                tau, &buffer, &capacity, center, w_init, nw_pts
+            );
+
+            if (!w_func)
+            {
+                free(buffer);
+                return tmpl_False;
+            }
+        }
+
+        /*  Compute the fresnel tranform about the current point.             */
+        if (NewtonFresT)
+            NewtonFresT(tau, w_func, nw_pts, center, warm);
+        else
+            FresT(tau, w_func, nw_pts, center);
+    }
+
+    /*  Free variables allocated by malloc.                                   */
+    free(buffer);
+    return tmpl_True;
+}
+
 void rssringoccs_Diffraction_Correction_Newton(rssringoccs_TAUObj *tau)
 {
-    /*  Variables for indexing. nw_pts is the number of points in the window. */
-    size_t i, j, offset, nw_pts, center;
+    /*  Twice the sample spacing, used for the window reset rule.             */
+    double dx, two_dx;
 
-    /*  Some variables needed for reconstruction.                             */
-    double w_init, dx, two_dx;
-    double *w_func;
+    /*  Number of threads used, and a flag for malloc failures.               */
+    unsigned int n, n_threads;
+    int failed = 0;
 
-    /*  Declare a function pointer for the transform function.                */
+    /*  Declare a function pointer for the transform function. The transforms *
+     *  using the batched Newton solver are called through NewtonFresT.       */
     rssringoccs_FresT FresT;
+    rssringoccs_Newton_FresT NewtonFresT;
+    rssringoccs_Newton_Task_Data data;
 
     /*  Check that the pointers to the data are not NULL.                     */
     rssringoccs_Tau_Check_Data(tau);
@@ -54,15 +364,9 @@ void rssringoccs_Diffraction_Correction_Newton(rssringoccs_TAUObj *tau)
     if (tau->error_occurred)
         return;
 
-    /* Compute first window width and window function. */
-    center = tau->start;
-
     /*  Compute some more variables.                                          */
-    w_init = tau->w_km_vals[center];
-    dx     = tau->rho_km_vals[center+1] - tau->rho_km_vals[center];
+    dx     = tau->rho_km_vals[tau->start+1] - tau->rho_km_vals[tau->start];
     two_dx = 2.0*dx;
-    nw_pts = 2UL*((size_t)(w_init / two_dx)) + 1UL;
-    offset = center - (nw_pts - 1UL) / 2UL;
 
     /* Check to ensure you have enough data to the left.                      */
     rssringoccs_Tau_Check_Data_Range(tau);
@@ -71,101 +375,75 @@ void rssringoccs_Diffraction_Correction_Newton(rssringoccs_TAUObj *tau)
         return;
 
     /*  Set the correct function pointer.                                     */
-    if (tau->use_norm)
-    {
-        if (tau->psinum == rssringoccs_DR_Newton)
-            FresT = rssringoccs_Fresnel_Transform_Newton_Norm;
-        else if (tau->psinum == rssringoccs_DR_NewtonD)
-            FresT = rssringoccs_Fresnel_Transform_Newton_D_Norm;
-        else if (tau->psinum == rssringoccs_DR_NewtonDPhi)
-            FresT = rssringoccs_Fresnel_Transform_Newton_dD_dphi_Norm;
-        else if (tau->psinum == rssringoccs_DR_NewtonPerturb)
-            FresT = rssringoccs_Fresnel_Transform_Perturbed_Newton_Norm;
-        else if (tau->psinum == rssringoccs_DR_NewtonElliptical)
-            FresT = rssringoccs_Fresnel_Transform_Newton_Elliptical_Norm;
-        else if (tau->psinum == rssringoccs_DR_NewtonQuadratic)
-            FresT = rssringoccs_Fresnel_Transform_Newton_Quadratic_Norm;
-        else if (tau->psinum == rssringoccs_DR_NewtonQuartic)
-            FresT = rssringoccs_Fresnel_Transform_Newton_Quartic_Norm;
-        else if (tau->psinum == rssringoccs_DR_NewtonD)
-            FresT = rssringoccs_Fresnel_Transform_Newton_D_Quartic_Norm;
-        else
-            FresT = rssringoccs_Fresnel_Transform_Newton_D_Old_Norm;
-    }
-    else
-    {
-        if (tau->psinum == rssringoccs_DR_Newton)
-            FresT = rssringoccs_Fresnel_Transform_Newton;
-        else if (tau->psinum == rssringoccs_DR_NewtonD)
-            FresT = rssringoccs_Fresnel_Transform_Newton_D;
-        else if (tau->psinum == rssringoccs_DR_NewtonDPhi)
-            FresT = rssringoccs_Fresnel_Transform_Newton_dD_dphi;
-        else if (tau->psinum == rssringoccs_DR_NewtonPerturb)
-            FresT = rssringoccs_Fresnel_Transform_Perturbed_Newton;
-        else if (tau->psinum == rssringoccs_DR_NewtonElliptical)
-            FresT = rssringoccs_Fresnel_Transform_Newton_Elliptical;
-        else if (tau->psinum == rssringoccs_DR_NewtonQuadratic)
-            FresT = rssringoccs_Fresnel_Transform_Newton_Quadratic;
-        else if (tau->psinum == rssringoccs_DR_NewtonQuartic)
-            FresT = rssringoccs_Fresnel_Transform_Newton_Quartic;
-        else if (tau->psinum == rssringoccs_DR_NewtonD)
-            FresT = rssringoccs_Fresnel_Transform_Newton_D_Quartic;
-        else
-            FresT = rssringoccs_Fresnel_Transform_Newton_D_Old;
-    }
+    for (n = 0U; n < RSSRINGOCCS_NEWTON_DISPATCH_SIZE; ++n)
+        if (rssringoccs_newton_dispatch[n].psinum == tau->psinum)
+            break;
 
-    /*  Allocate memory for these required variables.                         */
-    w_func = malloc(sizeof(*w_func) * nw_pts);
-
-    if (!(w_func))
+    if (n == RSSRINGOCCS_NEWTON_DISPATCH_SIZE)
     {
         tau->error_occurred = tmpl_True;
         tau->error_message = tmpl_strdup(
             "\n\rError Encountered: rss_ringoccs\n\n"
-            "\r\tDiffractionCorrectionFresnel\n\n"
-            "\rMalloc failed and returned NULL for w_func. Returning.\n\n"
+            "\r\trssringoccs_Diffraction_Correction_Newton\n\n"
+            "\rtau->psinum is not a Newton-Raphson psitype. Returning.\n\n"
         );
+
         return;
     }
 
-    /*  Compute the rho and phi variables, and the window function.           */
-    for (j=0; j<nw_pts; ++j)
-        w_func[j] = tau->window_func(
-            tau->rho_km_vals[offset+j] - tau->rho_km_vals[center], w_init
-        );
+    if (tau->use_norm)
+    {
+        FresT = rssringoccs_newton_dispatch[n].fres_norm;
+        NewtonFresT = rssringoccs_newton_dispatch[n].newton_fres_norm;
+    }
+    else
+    {
+        FresT = rssringoccs_newton_dispatch[n].fres;
+        NewtonFresT = rssringoccs_newton_dispatch[n].newton_fres;
+    }
 
-    /*  Check tau->use_norm outside of the inner for loop to prevent          *
-     *  redundantly checking an if-then statement over and over again.        */
+    n_threads = rssringoccs_Tau_Thread_Count(tau);
 
-    /*  Run diffraction correction point by point.                        */
-    for (i=0; i < tau->n_used; ++i)
+    /*  Warm starts only carry over between centers of one thread.            */
+    data.warm = malloc(sizeof(*data.warm) * n_threads);
+
+    if (!data.warm)
+        failed = 1;
+
+    else
     {
-        /*  If the window width changes significantly, recompute w_func.  */
-        if (fabs(w_init - tau->w_km_vals[center]) >= two_dx)
+        for (n = 0U; n < n_threads; ++n)
+            rssringoccs_Newton_Warm_Start_Init(data.warm + n);
+
+        data.FresT = FresT;
+        data.NewtonFresT = NewtonFresT;
+        data.two_dx = two_dx;
+
+        if (!rssringoccs_Tau_Schedule(
+                tau, tau->start, tau->start + tau->n_used, two_dx, 0.0,
+                rssringoccs_Diffraction_Correction_Newton_Block, &data,
+                n_threads))
+            failed = 1;
+
+        for (n = 0U; n < n_threads; ++n)
         {
-            /* Reset w_init and recompute window function.                */
-            w_init = tau->w_km_vals[center];
-            nw_pts = 2*((size_t)(w_init / (2.0 * dx))) + 1UL;
-            offset = center - (nw_pts - 1UL) / 2UL;
-
-            /*  Reallocate memory since the sizes have changed.           */
-            w_func = realloc(w_func, sizeof(*w_func) * nw_pts);
-
-            /*  Recompute rho, phi, and the window function.              */
-            for (j=0; j<nw_pts; ++j)
-                w_func[j] = tau->window_func(
-                    tau->rho_km_vals[offset+j] - tau->rho_km_vals[center],
-                    w_init
-                );
+            rssringoccs_Newton_Warm_Start_Destroy(data.warm + n);
+            tau->newton_iterations += data.warm[n].n_iterations;
+            tau->newton_samples += data.warm[n].n_samples;
+            tau->newton_warm_samples += data.warm[n].n_warm;
         }
 
-        /*  Compute the fresnel tranform about the current point.         */
-        FresT(tau, w_func, nw_pts, center);
-
-        /*  Increment pointers using pointer arithmetic.                  */
-        center += 1;
+        free(data.warm);
     }
 
-    /*  Free variables allocated by malloc.                                   */
-    free(w_func);
+    /*  A cancelled run has set its own error message.                        */
+    if (failed && !tau->error_occurred)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n\n"
+            "\r\trssringoccs_Diffraction_Correction_Newton\n\n"
+            "\rMalloc failed and returned NULL. Returning.\n\n"
+        );
+    }
 }
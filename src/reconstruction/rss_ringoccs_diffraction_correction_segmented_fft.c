@@ -0,0 +1,423 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                    Diffraction Correction: Segmented FFT                   *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Computes the Newton-Raphson reconstruction with one FFT convolution   *
+ *      per segment of the data, stitching neighboring segments together.     *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  rssringoccs_Diffraction_Correction_SimpleFFT builds a single kernel at    *
+ *  the center of the data set and uses it everywhere. This is only correct   *
+ *  if the geometry does not change across the occultation. Here the range    *
+ *  is split into segments a few window widths long. Each segment gets its    *
+ *  own kernel, computed with the Newton-Raphson method (with the D           *
+ *  correction) at the center of the segment, exactly as                      *
+ *  rssringoccs_Fresnel_Transform_Newton_D does for that point. Elsewhere in  *
+ *  the segment the kernel is an approximation, but the geometry only changes *
+ *  by a few window widths worth.                                             *
+ *                                                                            *
+ *  Every segment is computed a little past both of its ends. Around each     *
+ *  boundary between two segments the two results are combined with a linear  *
+ *  cross-fade, so there are no jumps where the kernel changes.               *
+ *                                                                            *
+ *  The segment length is RSSRINGOCCS_SEGMENTED_FFT_WINDOWS windows. Shorter  *
+ *  segments follow the geometry more closely but need more FFTs, and more    *
+ *  Newton-Raphson solves for the kernels.                                    *
+ ******************************************************************************/
+
+/*  malloc and free are found here.                                           */
+#include <stdlib.h>
+
+/*  Complex numbers, FFTs, and the Fresnel geometry are provided by libtmpl.  */
+#include <libtmpl/include/tmpl.h>
+
+/*  Prototypes for the reconstruction functions.                              */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  Length of a segment, in units of the number of points in the window.      */
+#ifndef RSSRINGOCCS_SEGMENTED_FFT_WINDOWS
+#define RSSRINGOCCS_SEGMENTED_FFT_WINDOWS (4U)
+#endif
+
+/*  A segment [first, last) of the reconstruction. The cross-fades extend     *
+ *  blend_left points to the left of first, and blend_right points to the     *
+ *  right of last. The values in the cross-fade regions are kept in head and  *
+ *  tail until both neighboring segments have been computed.                  */
+typedef struct rssringoccs_Segmented_FFT_Segment_Def {
+    size_t first;
+    size_t last;
+    size_t blend_left;
+    size_t blend_right;
+    tmpl_ComplexDouble *head;
+    tmpl_ComplexDouble *tail;
+} rssringoccs_Segmented_FFT_Segment;
+
+/*  Half the number of points in the window at a given point.                 */
+static size_t
+rssringoccs_Segmented_FFT_Half_Width(const rssringoccs_TAUObj *tau, size_t n)
+{
+    return (size_t)(tau->w_km_vals[n] / (2.0*tau->dx_km));
+}
+
+/*  Splits [start, start + n_used) into segments. The segments are returned   *
+ *  in *segments_ptr, which must be freed by the caller, and their number in  *
+ *  *n_segments_ptr. Returns false if realloc fails.                          */
+static tmpl_Bool
+rssringoccs_Segmented_FFT_Plan(const rssringoccs_TAUObj *tau,
+                               rssringoccs_Segmented_FFT_Segment **segments_ptr,
+                               size_t *n_segments_ptr)
+{
+    size_t first, last, hop, blend, n_segments, capacity;
+    const size_t end = tau->start + tau->n_used;
+    rssringoccs_Segmented_FFT_Segment *segments = NULL;
+    rssringoccs_Segmented_FFT_Segment *tmp;
+
+    *segments_ptr = NULL;
+    *n_segments_ptr = 0U;
+    n_segments = 0U;
+    capacity = 0U;
+    first = tau->start;
+    blend = 0U;
+
+    while (first < end)
+    {
+        hop = RSSRINGOCCS_SEGMENTED_FFT_WINDOWS *
+              (2U*rssringoccs_Segmented_FFT_Half_Width(tau, first) + 1U);
+
+        /*  Absorb a short remainder into the last segment.                   */
+        if (end - first < hop + hop/2U)
+            last = end;
+        else
+            last = first + hop;
+
+        if (n_segments == capacity)
+        {
+            capacity = (capacity == 0U ? 64U : 2U*capacity);
+            tmp = realloc(segments, sizeof(*segments)*capacity);
+
+            if (!tmp)
+            {
+                free(segments);
+                return tmpl_False;
+            }
+
+            segments = tmp;
+        }
+
+        segments[n_segments].first = first;
+        segments[n_segments].last = last;
+        segments[n_segments].blend_left = blend;
+        segments[n_segments].head = NULL;
+        segments[n_segments].tail = NULL;
+
+        /*  The cross-fade is half a window on either side of the boundary.   *
+         *  It is capped so that the cross-fades at the two ends of a segment *
+         *  never overlap.                                                    */
+        if (last == end)
+            blend = 0U;
+        else
+        {
+            blend = rssringoccs_Segmented_FFT_Half_Width(tau, last)/2U + 1U;
+
+            if (blend > hop/4U)
+                blend = hop/4U;
+
+            if (blend > (end - last)/4U)
+                blend = (end - last)/4U;
+        }
+
+        segments[n_segments].blend_right = blend;
+        ++n_segments;
+        first = last;
+    }
+
+    *segments_ptr = segments;
+    *n_segments_ptr = n_segments;
+    return tmpl_True;
+}
+
+/*  Computes a segment. Returns false if malloc fails.                        */
+static tmpl_Bool
+rssringoccs_Segmented_FFT_Compute(rssringoccs_TAUObj *tau,
+                                  rssringoccs_Segmented_FFT_Segment *segment)
+{
+    size_t n, m, K, N, M, lo, hi, center, length, head_end, tail_start;
+    double phi, psi, D, x, weight, factor;
+    tmpl_ComplexDouble *kernel, *fft_in, value, norm, scale;
+
+    /*  The segment, extended by the cross-fade regions at both ends.         */
+    lo = segment->first - segment->blend_left;
+    hi = segment->last + segment->blend_right;
+    length = hi - lo;
+    head_end = segment->first + segment->blend_left;
+    tail_start = segment->last - segment->blend_right;
+
+    /*  The kernel is computed at the center of the extended segment.         */
+    center = lo + length/2U;
+    K = rssringoccs_Segmented_FFT_Half_Width(tau, center);
+
+    /*  The convolution needs K points of data on either side.                */
+    M = length + 2U*K;
+    N = 1U;
+
+    while (N < M)
+        N <<= 1;
+
+    kernel = malloc(sizeof(*kernel)*N);
+    fft_in = malloc(sizeof(*fft_in)*N);
+    segment->head = malloc(sizeof(*segment->head)*(2U*segment->blend_left+1U));
+    segment->tail = malloc(sizeof(*segment->tail)*(2U*segment->blend_right+1U));
+
+    if (!kernel || !fft_in || !segment->head || !segment->tail)
+    {
+        free(kernel);
+        free(fft_in);
+        return tmpl_False;
+    }
+
+    for (n = 0U; n < N; ++n)
+        kernel[n] = tmpl_CDouble_Zero;
+
+    /*  Kernel for the point m = center + d, stored at index -d mod N so that *
+     *  the circular convolution gives the sum over d of kernel(d) T(n + d).  */
+    norm = tmpl_CDouble_Zero;
+
+    for (n = 0U; n <= 2U*K; ++n)
+    {
+        m = center + n - K;
+
+        if (m >= tau->arr_size)
+            break;
+
+        x = tau->rho_km_vals[m] - tau->rho_km_vals[center];
+        weight = tau->window_func(x, tau->w_km_vals[center]);
+
+        phi = tmpl_Double_Stationary_Cyl_Fresnel_Psi_D_Newton(
+            tau->k_vals[center],        /* Wavenumber. */
+            tau->rho_km_vals[center],   /* Dummy ring radius. */
+            tau->rho_km_vals[m],        /* Ring radius. */
+            tau->phi_deg_vals[m],       /* Dummy azimuth angle. */
+            tau->phi_deg_vals[m],       /* Ring azimuth angle. */
+            tau->B_deg_vals[center],    /* Ring opening angle. */
+            tau->rx_km_vals[center],    /* Cassini x coordinate. */
+            tau->ry_km_vals[center],    /* Cassini y coordinate. */
+            tau->rz_km_vals[center],    /* Cassini z coordinate. */
+            tau->EPS,                   /* Allowed error. */
+            tau->toler                  /* Maximum number of iterations. */
+        );
+
+        D = tmpl_Double_Cyl_Fresnel_Observer_Distance(
+            tau->rho_km_vals[m],        /* Ring radius. */
+            phi,                        /* Stationary azimuth angle. */
+            tau->rx_km_vals[center],    /* Cassini x coordinate. */
+            tau->ry_km_vals[center],    /* Cassini y coordinate. */
+            tau->rz_km_vals[center]     /* Cassini z coordinate. */
+        );
+
+        psi = tmpl_Double_Cyl_Fresnel_Psi(
+            tau->k_vals[center],        /* Wavenumber. */
+            tau->rho_km_vals[center],   /* Dummy ring radius. */
+            tau->rho_km_vals[m],        /* Ring radius. */
+            phi,                        /* Stationary azimuth angle. */
+            tau->phi_deg_vals[m],       /* Ring azimuth angle. */
+            tau->B_deg_vals[center],    /* Ring opening angle. */
+            D                           /* Observer distance. */
+        );
+
+        value = tmpl_CDouble_Polar(weight, -psi);
+        tmpl_CDouble_AddTo(&norm, &value);
+        kernel[(N + K - n) % N] = value;
+    }
+
+    /*  Data for the extended segment, zero outside of the arrays.            */
+    for (n = 0U; n < M; ++n)
+    {
+        if ((lo + n >= K) && (lo + n - K < tau->arr_size))
+            fft_in[n] = tau->T_in[lo + n - K];
+        else
+            fft_in[n] = tmpl_CDouble_Zero;
+    }
+
+    for (n = M; n < N; ++n)
+        fft_in[n] = tmpl_CDouble_Zero;
+
+    tmpl_CDouble_FFT(kernel, kernel, N);
+    tmpl_CDouble_FFT(fft_in, fft_in, N);
+
+    for (n = 0U; n < N; ++n)
+        fft_in[n] = tmpl_CDouble_Multiply(kernel[n], fft_in[n]);
+
+    tmpl_CDouble_IFFT(fft_in, fft_in, N);
+
+    /*  With normalization, the factor is the same for the entire segment.    */
+    factor = 0.5*tmpl_Sqrt_Two / tmpl_CDouble_Abs(norm);
+
+    for (n = 0U; n < length; ++n)
+    {
+        m = lo + n;
+
+        if (!tau->use_norm)
+            factor = 0.5*tau->dx_km / tau->F_km_vals[m];
+
+        scale = tmpl_CDouble_Rect(factor, factor);
+        value = tmpl_CDouble_Multiply(scale, fft_in[n + K]);
+
+        if (m < head_end)
+            segment->head[m - lo] = value;
+        else if (m >= tail_start)
+            segment->tail[m - tail_start] = value;
+        else
+            tau->T_out[m] = value;
+    }
+
+    free(kernel);
+    free(fft_in);
+    return tmpl_True;
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Diffraction_Correction_Segmented_FFT                      *
+ *  Purpose:                                                                  *
+ *      Compute the Newton-Raphson reconstruction with one FFT per segment.   *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object with the diffracted data and geometry.             *
+ *  Output:                                                                   *
+ *      None (void).                                                          *
+ *  Notes:                                                                    *
+ *      1.) At the center of a segment the result agrees with the "newtond"   *
+ *          method. Away from it the error depends on how quickly the         *
+ *          geometry changes over a few window widths.                        *
+ *      2.) Segments are independent and are distributed over                 *
+ *          tau->num_threads threads if the library is built with OpenMP.     *
+ *      3.) Progress is added as each segment is finished, and a cancel       *
+ *          request is honored before the next segment is started.            *
+ ******************************************************************************/
+void rssringoccs_Diffraction_Correction_Segmented_FFT(rssringoccs_TAUObj *tau)
+{
+    size_t n, m, blend, n_segments;
+    double t;
+    unsigned int n_threads;
+    int failed = 0;
+    int cancelled = 0;
+    tmpl_ComplexDouble left, right;
+    rssringoccs_Segmented_FFT_Segment *segments;
+
+    /*  Check that the pointers to the data are not NULL.                     */
+    rssringoccs_Tau_Check_Data(tau);
+
+    if (tau->error_occurred)
+        return;
+
+    /* Check to ensure you have enough data to the left and right.            */
+    rssringoccs_Tau_Check_Data_Range(tau);
+
+    if (tau->error_occurred)
+        return;
+
+    /*  The range [start, start + n_used) is empty, nothing to compute.       */
+    if (tau->n_used == 0U)
+        return;
+
+    if (!rssringoccs_Segmented_FFT_Plan(tau, &segments, &n_segments))
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Diffraction_Correction_Segmented_FFT\n\n"
+            "\rrealloc failed and returned NULL for segments. Returning.\n\n"
+        );
+        return;
+    }
+
+    n_threads = rssringoccs_Tau_Thread_Count(tau);
+    (void)n_threads;
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(n_threads) schedule(dynamic, 1) \
+    reduction(|:failed, cancelled)
+#endif
+    for (n = 0U; n < n_segments; ++n)
+    {
+        /*  The loop can not be left early, skip the remaining segments.      */
+        if (rssringoccs_Tau_Cancel_Requested(tau))
+            cancelled = 1;
+
+        else if (!rssringoccs_Segmented_FFT_Compute(tau, &segments[n]))
+            failed = 1;
+
+        else
+            rssringoccs_Tau_Add_Progress(
+                tau, (unsigned long)(segments[n].last - segments[n].first)
+            );
+    }
+
+    /*  Cross-fade from the tail of one segment to the head of the next.      */
+    for (n = 1U; n < n_segments; ++n)
+    {
+        blend = segments[n].blend_left;
+
+        if (failed || cancelled)
+            break;
+
+        for (m = 0U; m < 2U*blend; ++m)
+        {
+            t = ((double)m + 0.5) / (double)(2U*blend);
+            left = tmpl_CDouble_Multiply_Real(1.0 - t, segments[n-1U].tail[m]);
+            right = tmpl_CDouble_Multiply_Real(t, segments[n].head[m]);
+            tau->T_out[segments[n].first - blend + m] =
+                tmpl_CDouble_Add(left, right);
+        }
+    }
+
+    for (n = 0U; n < n_segments; ++n)
+    {
+        free(segments[n].head);
+        free(segments[n].tail);
+    }
+
+    free(segments);
+
+    /*  Segments left undone leave part of T_out unset, which is an error.    */
+    if (cancelled)
+    {
+        if (!tau->error_occurred)
+        {
+            tau->error_occurred = tmpl_True;
+            tau->error_message = tmpl_strdup(
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Diffraction_Correction_Segmented_FFT\n\n"
+                "\rThe reconstruction was cancelled.\n\n"
+            );
+        }
+    }
+    else if (failed)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Diffraction_Correction_Segmented_FFT\n\n"
+            "\rmalloc failed and returned NULL. Returning.\n\n"
+        );
+    }
+}
+/*  End of rssringoccs_Diffraction_Correction_Segmented_FFT.                  */
@@ -6,12 +6,51 @@
 #include <libtmpl/include/tmpl_complex.h>
 #include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
 
+/*  Sets the error if the reconstruction was cancelled before a pass started. *
+ *  Cancelling during a pass is handled by rssringoccs_Tau_Schedule.          */
+static tmpl_Bool rssringoccs_Reconstruction_Cancelled(rssringoccs_TAUObj *tau)
+{
+    if (!rssringoccs_Tau_Cancel_Requested(tau))
+        return tmpl_False;
+
+    if (!tau->error_occurred)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction\n\n"
+            "\rThe reconstruction was cancelled.\n\n"
+        );
+    }
+
+    return tmpl_True;
+}
+
+void rssringoccs_Reconstruction_Dispatch(rssringoccs_TAUObj *tau)
+{
+    if      (tau->psinum == rssringoccs_DR_Fresnel)
+        rssringoccs_Diffraction_Correction_Fresnel(tau);
+    else if (tau->psinum == rssringoccs_DR_FresnelFFT)
+        rssringoccs_Diffraction_Correction_Fresnel_FFT(tau);
+    else if (tau->psinum == rssringoccs_DR_Legendre)
+        rssringoccs_Diffraction_Correction_Legendre(tau);
+    else if (tau->psinum == rssringoccs_DR_NewtonSimpleFFT)
+        rssringoccs_Diffraction_Correction_SimpleFFT(tau);
+    else if (tau->psinum == rssringoccs_DR_NewtonSegmentedFFT)
+        rssringoccs_Diffraction_Correction_Segmented_FFT(tau);
+    else
+        rssringoccs_Diffraction_Correction_Newton(tau);
+}
+/*  End of rssringoccs_Reconstruction_Dispatch.                               */
+
 void rssringoccs_Reconstruction(rssringoccs_TAUObj *tau)
 {
     tmpl_ComplexDouble *temp_T_in;
     tmpl_Bool temp_fwd;
     size_t n, temp_start, temp_n_used, nw_pts;
+    unsigned long total;
     double w_left, w_right, w_max;
+    double *k_vals, *k_fwd;
 
     if (tau == NULL)
         return;
@@ -24,47 +63,107 @@ void rssringoccs_Reconstruction(rssringoccs_TAUObj *tau)
     rssringoccs_Tau_Get_Window_Width(tau);
     rssringoccs_Tau_Check_Data_Range(tau);
 
-    tau->T_out = calloc(tau->arr_size, sizeof(*tau->T_out));
+    tau->T_out = rssringoccs_Tau_Calloc_Slot(tau, rssringoccs_Tau_Slot_T_Out);
     rssringoccs_Tau_Check_Data(tau);
 
+    /*  The arena holds every array, so its size is the peak footprint.       */
+    if (tau->verbose && tau->arena != NULL)
+        printf("\tTau arena: %lu bytes.\n", (unsigned long)tau->arena_bytes);
+
+    /*  Progress is counted in points, over both passes if use_fwd is set.    */
+    nw_pts = 0;
+    total = (unsigned long)tau->n_used + 1UL;
+
+    /*  The forward model is run over n_used - 2*nw_pts + 1 points.           */
+    if (tau->use_fwd && !tau->error_occurred)
+    {
+        w_left  = tau->w_km_vals[tau->start];
+        w_right = tau->w_km_vals[tau->start + tau->n_used];
+
+        if (w_left < w_right)
+            w_max = w_right;
+        else
+            w_max = w_left;
+
+        nw_pts = (size_t) (w_max / (tau->dx_km * 2.0));
+
+        if (tau->n_used > 2*nw_pts)
+            total += (unsigned long)(tau->n_used - 2*nw_pts) + 1UL;
+    }
+
+    rssringoccs_Tau_Set_Progress(tau, 0UL, total);
+
+    if (rssringoccs_Reconstruction_Cancelled(tau))
+        return;
+
+    /*  The fused pass computes T_out and T_fwd together, in one pass.        */
+    if (tau->use_fwd && tau->use_fused && !tau->error_occurred &&
+        rssringoccs_Reconstruction_Fused(tau, nw_pts))
+    {
+        rssringoccs_Tau_Get_Progress(tau, NULL, &total);
+        rssringoccs_Tau_Set_Progress(tau, total, total);
+        rssringoccs_Tau_Finish(tau);
+        return;
+    }
+
     temp_fwd = tau->use_fwd;
     tau->use_fwd = tmpl_False;
 
-    if      (tau->psinum == rssringoccs_DR_Fresnel)
-        rssringoccs_Diffraction_Correction_Fresnel(tau);
-    else if (tau->psinum == rssringoccs_DR_Legendre)
-        rssringoccs_Diffraction_Correction_Legendre(tau);
-    else if (tau->psinum == rssringoccs_DR_NewtonSimpleFFT)
-        rssringoccs_Diffraction_Correction_SimpleFFT(tau);
-    else
-        rssringoccs_Diffraction_Correction_Newton(tau);
+    rssringoccs_Reconstruction_Dispatch(tau);
 
     tau->use_fwd = temp_fwd;
 
-    if (tau->use_fwd)
+    /*  The methods that do not use rssringoccs_Tau_Schedule only report      *
+     *  their progress here, once they are done.                              */
+    rssringoccs_Tau_Set_Progress(tau, (unsigned long)tau->n_used + 1UL, total);
+
+    if (tau->use_fwd && !rssringoccs_Reconstruction_Cancelled(tau) &&
+        !tau->error_occurred)
     {
         temp_T_in  = tau->T_in;
         tau->T_in  = tau->T_out;
-        tau->T_out = calloc(tau->arr_size, sizeof(*tau->T_out));
+        tau->T_out = rssringoccs_Tau_Calloc_Slot(tau,
+                                                 rssringoccs_Tau_Slot_T_Fwd);
 
-        /*  If forward tranform is set, negate the k_vals variable. This has  *
-         *  the equivalent effect of computing the forward calculation later. */
-        for (n = 0; n <= tau->n_used; ++n)
-            tau->k_vals[tau->start + n] *= -1.0;
+        /*  The forward model is the transform with k negated. This is done   *
+         *  on a copy, so that k_vals may be shared with other threads.       */
+        k_vals = tau->k_vals;
+        k_fwd = malloc(sizeof(*k_fwd) * tau->arr_size);
 
-        w_left  = tau->w_km_vals[tau->start];
-        w_right = tau->w_km_vals[tau->start + tau->n_used];
+        if (k_fwd)
+        {
+            for (n = 0; n < tau->arr_size; ++n)
+                k_fwd[n] = k_vals[n];
 
-        if (w_left < w_right)
-            w_max = w_right;
-        else
-            w_max = w_left;
+            for (n = 0; n <= tau->n_used; ++n)
+                k_fwd[tau->start + n] *= -1.0;
+
+            tau->k_vals = k_fwd;
+        }
 
-        nw_pts = (size_t) (w_max / (tau->dx_km * 2.0));
         temp_start = tau->start;
         temp_n_used = tau->n_used;
 
-        if (tau->n_used <= 2*nw_pts)
+        if (!tau->T_out)
+        {
+            tau->error_occurred = tmpl_True;
+            tau->error_message = tmpl_strdup(
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Reconstruction\n\n"
+                "\rCalloc failed and returned NULL for T_fwd. With use_arena\n"
+                "\rset, use_fwd must be set before tau is allocated.\n\n"
+            );
+        }
+        else if (!k_fwd)
+        {
+            tau->error_occurred = tmpl_True;
+            tau->error_message = tmpl_strdup(
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Reconstruction\n\n"
+                "\rMalloc failed and returned NULL for k_fwd.\n\n"
+            );
+        }
+        else if (tau->n_used <= 2*nw_pts)
         {
             tau->error_occurred = tmpl_True;
             tau->error_message = tmpl_strdup(
@@ -78,27 +177,29 @@ void rssringoccs_Reconstruction(rssringoccs_TAUObj *tau)
         {
             tau->start = tau->start + nw_pts;
             tau->n_used = tau->n_used - 2*nw_pts;
-            if      (tau->psinum == rssringoccs_DR_Fresnel)
-                rssringoccs_Diffraction_Correction_Fresnel(tau);
-            else if (tau->psinum == rssringoccs_DR_Legendre)
-                rssringoccs_Diffraction_Correction_Legendre(tau);
-            else if (tau->psinum == rssringoccs_DR_NewtonSimpleFFT)
-                rssringoccs_Diffraction_Correction_SimpleFFT(tau);
-            else
-                rssringoccs_Diffraction_Correction_Newton(tau);
+            rssringoccs_Reconstruction_Dispatch(tau);
 
             tau->start = temp_start;
             tau->n_used = temp_n_used;
         }
 
-        /*  Unnegate k_vals to its original values.                           */
-        for (n = 0; n <= tau->n_used; ++n)
-            tau->k_vals[tau->start + n] *= -1.0;
+        tau->k_vals = k_vals;
+        free(k_fwd);
 
         tau->T_fwd = tau->T_out;
         tau->T_out = tau->T_in;
         tau->T_in  = temp_T_in;
+        rssringoccs_Tau_Set_Progress(tau, total, total);
+    }
 
+    /*  Report how effective the window function cache has been.              */
+    if (tau->verbose && tau->use_window_cache)
+    {
+        unsigned long hits, misses;
+        size_t n_bytes;
+        rssringoccs_Window_Cache_Stats(&hits, &misses, &n_bytes);
+        printf("\tWindow cache: %lu hits, %lu misses, %lu bytes.\n",
+               hits, misses, (unsigned long)n_bytes);
     }
 
     rssringoccs_Tau_Finish(tau);
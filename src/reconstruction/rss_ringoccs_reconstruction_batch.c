@@ -0,0 +1,657 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                       Batch Diffraction Correction                         *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Reconstructs one data set at several resolutions and with several     *
+ *      window types in one pass, sharing the Fresnel kernel between them.    *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  Searching for the best resolution runs the same reconstruction many       *
+ *  times, changing only the resolution and the window type. Neither changes  *
+ *  the stationary Fresnel kernel psi at a given sample about a given center, *
+ *  only which samples are summed over and how they are weighted. Here every  *
+ *  center is visited once: psi, and exp(-i psi) times the data, are computed *
+ *  across the widest window of all combinations, and each combination then   *
+ *  sums over its own part of this with its own window function. For the      *
+ *  Newton methods, where solving for psi dominates, the cost of the whole    *
+ *  batch is close to that of its widest reconstruction.                      *
+ *                                                                            *
+ *  Each combination uses the window widths it would have on its own, and     *
+ *  rebuilds its window at the points the serial loop would (see              *
+ *  rssringoccs_Window_Anchor), so each row of the output equals the          *
+ *  corresponding single reconstruction to round-off. The points are split    *
+ *  into tasks by rssringoccs_Tau_Schedule, using the widest window of each   *
+ *  point as its cost.                                                        *
+ *                                                                            *
+ *  This is possible for the psitypes whose kernel does not depend on the     *
+ *  window: fresnel and the non-interpolated Newton methods (newton, newtond, *
+ *  newtondold, newtondphi, and ellipse). The interpolated psitypes fit psi   *
+ *  to nodes placed across the window, the perturbed kernel and the Legendre  *
+ *  expansion are not written per sample, and the FFT methods never form the  *
+ *  window sums, so these return an error.                                    *
+ ******************************************************************************/
+
+/*  malloc, realloc, calloc, and free are found here.                         */
+#include <stdlib.h>
+
+/*  fabs is declared here.                                                    */
+#include <math.h>
+
+/*  memcpy is found here.                                                     */
+#include <string.h>
+
+/*  Complex numbers, constants, and tmpl_strdup are found here.               */
+#include <libtmpl/include/tmpl.h>
+
+/*  rssringoccs_Newton_Interp_Psi is declared here.                           */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  Function prototype and the scheduler are found here.                      */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  One combination of resolution and window type.                            */
+typedef struct rssringoccs_Batch_Window_Def {
+
+    /*  The window widths of this combination, arr_size long.                 */
+    double *w_km_vals;
+
+    /*  The first point this combination would reconstruct on its own.        */
+    size_t start;
+
+    /*  The window function of the window type.                               */
+    rssringoccs_Window_Function window_func;
+} rssringoccs_Batch_Window;
+
+/*  The window a task is currently using for one combination.                 */
+typedef struct rssringoccs_Batch_Window_State_Def {
+    double w_init;
+    size_t half;
+    double *w_func;
+    size_t capacity;
+} rssringoccs_Batch_Window_State;
+
+/*  The arguments of rssringoccs_Reconstruction_Batch_Block that are the same *
+ *  for every task.                                                           */
+typedef struct rssringoccs_Batch_Task_Data_Def {
+    const rssringoccs_Batch_Window *windows;
+    size_t n_windows;
+    tmpl_ComplexDouble *T_out;
+    size_t first;
+    size_t n_pts;
+    tmpl_Bool is_fresnel;
+} rssringoccs_Batch_Task_Data;
+
+/*  Grows an array to hold at least n_pts entries. Returns false if realloc   *
+ *  fails, in which case the array is left as it was.                         */
+static tmpl_Bool
+rssringoccs_Batch_Reserve(void **ptr, size_t *capacity,
+                          size_t n_pts, size_t size)
+{
+    void *tmp;
+
+    if (*capacity >= n_pts)
+        return tmpl_True;
+
+    tmp = realloc(*ptr, size * n_pts);
+
+    if (!tmp)
+        return tmpl_False;
+
+    *ptr = tmp;
+    *capacity = n_pts;
+    return tmpl_True;
+}
+
+/*  Builds the window of a combination at anchor. The quadratic Fresnel sum   *
+ *  uses the left half of the window, half = w/(2 dx) + 1 points, and the     *
+ *  Newton sums use the whole window, 2 half + 1 points with half = w/(2 dx). */
+static tmpl_Bool
+rssringoccs_Batch_Window_Reset(const rssringoccs_TAUObj *tau,
+                               const rssringoccs_Batch_Window *window,
+                               rssringoccs_Batch_Window_State *state,
+                               size_t anchor,
+                               tmpl_Bool is_fresnel)
+{
+    size_t m, n_pts, offset;
+    void *w_func = state->w_func;
+    const double dx = tau->dx_km;
+
+    state->w_init = window->w_km_vals[anchor];
+    state->half = (size_t)(state->w_init / (2.0*dx));
+
+    if (is_fresnel)
+    {
+        state->half += 1UL;
+        n_pts = state->half;
+    }
+    else
+        n_pts = 2UL*state->half + 1UL;
+
+    if (!rssringoccs_Batch_Reserve(&w_func, &state->capacity,
+                                   n_pts, sizeof(*state->w_func)))
+        return tmpl_False;
+
+    state->w_func = w_func;
+
+    if (is_fresnel)
+    {
+        for (m = 0; m < n_pts; ++m)
+            state->w_func[m] = window->window_func(
+                ((double)m - (double)n_pts)*dx, state->w_init
+            );
+    }
+    else
+    {
+        offset = anchor - state->half;
+
+        for (m = 0; m < n_pts; ++m)
+            state->w_func[m] = window->window_func(
+                tau->rho_km_vals[offset + m] - tau->rho_km_vals[anchor],
+                state->w_init
+            );
+    }
+
+    return tmpl_True;
+}
+
+/*  Computes exp(-i psi) and exp(-i psi) times the data about center, out to  *
+ *  half samples on either side. For the quadratic Fresnel kernel, which is   *
+ *  even, entry n is for the pair center -/+ n, otherwise entry j is for the  *
+ *  sample center - half + j.                                                 */
+static void
+rssringoccs_Batch_Kernel(const rssringoccs_TAUObj *tau,
+                         size_t center,
+                         size_t half,
+                         tmpl_Bool is_fresnel,
+                         tmpl_ComplexDouble *exp_psi,
+                         tmpl_ComplexDouble *kernel)
+{
+    size_t n, offset;
+    double x, rcpr_F2, psi;
+    tmpl_ComplexDouble data;
+
+    if (is_fresnel)
+    {
+        rcpr_F2 = 1.0 / (tau->F_km_vals[center]*tau->F_km_vals[center]);
+
+        for (n = 1; n <= half; ++n)
+        {
+            /*  pi/2 ((rho - rho0)/F)^2, as the Fresnel window computes it.   */
+            x = -(double)n*tau->dx_km;
+            x *= tmpl_Pi_By_Two*x;
+            exp_psi[n] = tmpl_CDouble_Polar(1.0, -x*rcpr_F2);
+
+            data = tmpl_CDouble_Add(tau->T_in[center - n],
+                                    tau->T_in[center + n]);
+            kernel[n] = tmpl_CDouble_Multiply(exp_psi[n], data);
+        }
+    }
+    else
+    {
+        offset = center - half;
+
+        for (n = 0; n <= 2UL*half; ++n)
+        {
+            psi = rssringoccs_Newton_Interp_Psi(tau, center, offset + n);
+            exp_psi[n] = tmpl_CDouble_Polar(1.0, -psi);
+            kernel[n] = tmpl_CDouble_Multiply(exp_psi[n],
+                                              tau->T_in[offset + n]);
+        }
+    }
+}
+
+/*  Sums the kernel over the window of one combination and scales the result  *
+ *  as the single reconstruction does, with or without normalization.         */
+static tmpl_ComplexDouble
+rssringoccs_Batch_Sum(const rssringoccs_TAUObj *tau,
+                      const rssringoccs_Batch_Window_State *state,
+                      size_t center,
+                      size_t half,
+                      tmpl_Bool is_fresnel,
+                      const tmpl_ComplexDouble *exp_psi,
+                      const tmpl_ComplexDouble *kernel)
+{
+    size_t m, n_pts, index;
+    double factor;
+    tmpl_ComplexDouble sum, norm, term;
+
+    norm = tmpl_CDouble_Zero;
+
+    if (is_fresnel)
+    {
+        sum = tau->T_in[center];
+        n_pts = state->half;
+    }
+    else
+    {
+        sum = tmpl_CDouble_Zero;
+        n_pts = 2UL*state->half + 1UL;
+    }
+
+    for (m = 0; m < n_pts; ++m)
+    {
+        /*  The left half-window runs from the outermost pair inwards.        */
+        if (is_fresnel)
+            index = state->half - m;
+        else
+            index = half - state->half + m;
+
+        term = tmpl_CDouble_Multiply_Real(state->w_func[m], kernel[index]);
+        tmpl_CDouble_AddTo(&sum, &term);
+
+        if (tau->use_norm)
+        {
+            term = tmpl_CDouble_Multiply_Real(state->w_func[m],
+                                              exp_psi[index]);
+            tmpl_CDouble_AddTo(&norm, &term);
+        }
+    }
+
+    if (tau->use_norm)
+    {
+        /*  The half-window sum counts each pair once, and the center is one. */
+        if (is_fresnel)
+        {
+            norm = tmpl_CDouble_Multiply_Real(2.0, norm);
+            tmpl_CDouble_AddTo_Real(&norm, 1.0);
+        }
+
+        factor = 0.5 * tmpl_Sqrt_Two / tmpl_CDouble_Abs(norm);
+    }
+    else
+        factor = 0.5 * tau->dx_km / tau->F_km_vals[center];
+
+    term = tmpl_CDouble_Rect(factor, factor);
+    return tmpl_CDouble_Multiply(term, sum);
+}
+
+/*  Reconstructs the points of a task for every combination. Returns false if *
+ *  malloc fails.                                                             */
+static tmpl_Bool
+rssringoccs_Reconstruction_Batch_Block(rssringoccs_TAUObj *tau,
+                                       void *data,
+                                       unsigned int worker,
+                                       const rssringoccs_Tau_Task *task)
+{
+    size_t k, center, half, n_kernel, anchor;
+    size_t kernel_capacity = 0;
+    size_t exp_capacity = 0;
+    void *kernel = NULL;
+    void *exp_psi = NULL;
+    rssringoccs_Batch_Window_State *state;
+    tmpl_Bool ok = tmpl_True;
+
+    const rssringoccs_Batch_Task_Data *args = data;
+    const rssringoccs_Batch_Window *windows = args->windows;
+    const size_t n_windows = args->n_windows;
+    const tmpl_Bool is_fresnel = args->is_fresnel;
+    const double two_dx = 2.0*tau->dx_km;
+
+    /*  Every task has its own buffers, so the thread does not matter.        */
+    (void)worker;
+
+    state = malloc(sizeof(*state) * n_windows);
+
+    if (!state)
+        return tmpl_False;
+
+    for (k = 0; k < n_windows; ++k)
+    {
+        state[k].w_func = NULL;
+        state[k].capacity = 0;
+    }
+
+    /*  Each combination starts with the window it would be using on its own. */
+    for (k = 0; ok && k < n_windows; ++k)
+    {
+        anchor = rssringoccs_Window_Anchor(windows[k].w_km_vals,
+                                           windows[k].start,
+                                           task->first, two_dx);
+
+        ok = rssringoccs_Batch_Window_Reset(tau, &windows[k], &state[k],
+                                            anchor, is_fresnel);
+    }
+
+    for (center = task->first; ok && center < task->last; ++center)
+    {
+        /*  Rebuild windows that drifted, and find the widest one.            */
+        half = 0;
+
+        for (k = 0; ok && k < n_windows; ++k)
+        {
+            if (fabs(state[k].w_init - windows[k].w_km_vals[center]) >= two_dx)
+                ok = rssringoccs_Batch_Window_Reset(tau, &windows[k],
+                                                    &state[k], center,
+                                                    is_fresnel);
+
+            if (state[k].half > half)
+                half = state[k].half;
+        }
+
+        if (is_fresnel)
+            n_kernel = half + 1UL;
+        else
+            n_kernel = 2UL*half + 1UL;
+
+        if (ok)
+            ok = rssringoccs_Batch_Reserve(&kernel, &kernel_capacity,
+                                           n_kernel,
+                                           sizeof(tmpl_ComplexDouble));
+
+        if (ok)
+            ok = rssringoccs_Batch_Reserve(&exp_psi, &exp_capacity,
+                                           n_kernel,
+                                           sizeof(tmpl_ComplexDouble));
+
+        if (!ok)
+            break;
+
+        /*  The kernel is computed once, across the widest window.            */
+        rssringoccs_Batch_Kernel(tau, center, half, is_fresnel,
+                                 exp_psi, kernel);
+
+        for (k = 0; k < n_windows; ++k)
+            args->T_out[k*args->n_pts + center - args->first] =
+                rssringoccs_Batch_Sum(tau, &state[k], center, half,
+                                      is_fresnel, exp_psi, kernel);
+    }
+
+    for (k = 0; k < n_windows; ++k)
+        free(state[k].w_func);
+
+    free(state);
+    free(kernel);
+    free(exp_psi);
+    return ok;
+}
+
+/*  Sets the error message of the batch function.                             */
+static void
+rssringoccs_Reconstruction_Batch_Error(rssringoccs_TAUObj *tau,
+                                       const char *message)
+{
+    if (tau->error_occurred)
+        return;
+
+    tau->error_occurred = tmpl_True;
+    tau->error_message = tmpl_strdup(message);
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Reconstruction_Batch                                      *
+ *  Purpose:                                                                  *
+ *      Reconstructs the data for every combination of resolution and window  *
+ *      type, sharing the Fresnel kernel between them.                        *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object, set up as for rssringoccs_Reconstruction. Its res *
+ *          and window type are not used, and use_fwd is ignored.             *
+ *      res (const double *):                                                 *
+ *          The resolutions, in km, with any scale factor already applied.    *
+ *      n_res (size_t):                                                       *
+ *          The number of resolutions.                                        *
+ *      wtypes (const char * const *):                                        *
+ *          The window types, as for rssringoccs_Tau_Set_Window_Type.         *
+ *      n_wtypes (size_t):                                                    *
+ *          The number of window types.                                       *
+ *  Outputs:                                                                  *
+ *      T_out (tmpl_ComplexDouble *):                                         *
+ *          n_res * n_wtypes rows of tau->n_used points each. Row             *
+ *          i * n_wtypes + j is the reconstruction with res[i] and wtypes[j]. *
+ *          NULL is returned, with tau->error_occurred set, on error.         *
+ *  Notes:                                                                    *
+ *      1.) On return tau->start and tau->n_used are the points every         *
+ *          combination can reconstruct, which the rows cover. These are the  *
+ *          points of the widest windows. tau->w_km_vals is left NULL, and    *
+ *          tau->res, the window type, and tau->rng_list are restored.        *
+ *      2.) The row of a combination equals, to round-off, the output of      *
+ *          rssringoccs_Reconstruction with the same settings over these      *
+ *          points. The Newton kernels are found with the scalar solvers, so  *
+ *          use_simd and use_warm_start have no effect.                       *
+ *      3.) Progress and cancellation work as for rssringoccs_Reconstruction, *
+ *          with one point counted for all combinations.                      *
+ ******************************************************************************/
+tmpl_ComplexDouble *
+rssringoccs_Reconstruction_Batch(rssringoccs_TAUObj *tau,
+                                 const double *res,
+                                 size_t n_res,
+                                 const char * const *wtypes,
+                                 size_t n_wtypes)
+{
+    size_t n, k, n_windows, first, last;
+    double *w_max = NULL;
+    double *w_copy;
+    tmpl_ComplexDouble *T_out = NULL;
+    tmpl_ComplexDouble *T_out_tau;
+    rssringoccs_Batch_Window *windows;
+    rssringoccs_Batch_Task_Data data;
+    tmpl_Bool is_fresnel;
+
+    /*  The settings of tau that each combination overwrites.                 */
+    double res_tau, normeq_tau, rng_tau[2];
+    rssringoccs_Window_Function window_func_tau;
+
+    if (tau == NULL)
+        return NULL;
+
+    if (tau->error_occurred)
+        return NULL;
+
+    if (!res || !wtypes || n_res == 0 || n_wtypes == 0)
+    {
+        rssringoccs_Reconstruction_Batch_Error(tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Batch\n\n"
+            "\rNo resolutions or no window types were given.\n\n"
+        );
+        return NULL;
+    }
+
+    is_fresnel = (tau->psinum == rssringoccs_DR_Fresnel);
+
+    if (!is_fresnel &&
+        tau->psinum != rssringoccs_DR_Newton &&
+        tau->psinum != rssringoccs_DR_NewtonD &&
+        tau->psinum != rssringoccs_DR_NewtonDOld &&
+        tau->psinum != rssringoccs_DR_NewtonDPhi &&
+        tau->psinum != rssringoccs_DR_NewtonElliptical)
+    {
+        rssringoccs_Reconstruction_Batch_Error(tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Batch\n\n"
+            "\rThe Fresnel kernel of this psitype depends on the window.\n"
+            "\rAllowed psitypes are fresnel, newton, newtond, newtondold,\n"
+            "\rnewtondphi, and ellipse.\n\n"
+        );
+        return NULL;
+    }
+
+    /*  The window widths of every combination are computed here.             */
+    if (tau->w_km_vals != NULL)
+    {
+        rssringoccs_Reconstruction_Batch_Error(tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Batch\n\n"
+            "\rtau->w_km_vals is not NULL. The window widths have already\n"
+            "\rbeen computed.\n\n"
+        );
+        return NULL;
+    }
+
+    rssringoccs_Tau_Check_Occ_Type(tau);
+
+    n_windows = n_res * n_wtypes;
+    windows = malloc(sizeof(*windows) * n_windows);
+
+    if (!windows)
+    {
+        rssringoccs_Reconstruction_Batch_Error(tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Batch\n\n"
+            "\rMalloc failed and returned NULL for windows.\n\n"
+        );
+        return NULL;
+    }
+
+    for (n = 0; n < n_windows; ++n)
+        windows[n].w_km_vals = NULL;
+
+    res_tau = tau->res;
+    normeq_tau = tau->normeq;
+    window_func_tau = tau->window_func;
+    rng_tau[0] = tau->rng_list[0];
+    rng_tau[1] = tau->rng_list[1];
+
+    first = 0;
+    last = tau->arr_size;
+
+    /*  Find the window widths of every combination, as the single            *
+     *  reconstruction would.                                                 */
+    for (n = 0; n < n_windows && !tau->error_occurred; ++n)
+    {
+        tau->rng_list[0] = rng_tau[0];
+        tau->rng_list[1] = rng_tau[1];
+        tau->res = res[n / n_wtypes];
+
+        rssringoccs_Tau_Set_Window_Type(wtypes[n % n_wtypes], tau);
+        rssringoccs_Tau_Check_Keywords(tau);
+        rssringoccs_Tau_Get_Window_Width(tau);
+
+        /*  An arena has one slot for the window widths, which the next call  *
+         *  reuses, so they are copied out of it.                             */
+        if (tau->arena != NULL && tau->w_km_vals != NULL)
+        {
+            w_copy = malloc(sizeof(*w_copy) * tau->arr_size);
+
+            if (w_copy)
+                memcpy(w_copy, tau->w_km_vals, sizeof(*w_copy)*tau->arr_size);
+            else
+                rssringoccs_Reconstruction_Batch_Error(tau,
+                    "\n\rError Encountered: rss_ringoccs\n"
+                    "\r\trssringoccs_Reconstruction_Batch\n\n"
+                    "\rMalloc failed and returned NULL for w_copy.\n\n"
+                );
+
+            tau->w_km_vals = w_copy;
+        }
+
+        windows[n].w_km_vals = tau->w_km_vals;
+        windows[n].start = tau->start;
+        windows[n].window_func = tau->window_func;
+        tau->w_km_vals = NULL;
+
+        if (tau->start > first)
+            first = tau->start;
+
+        if (tau->start + tau->n_used < last)
+            last = tau->start + tau->n_used;
+    }
+
+    tau->res = res_tau;
+    tau->normeq = normeq_tau;
+    tau->window_func = window_func_tau;
+    tau->rng_list[0] = rng_tau[0];
+    tau->rng_list[1] = rng_tau[1];
+
+    if (!tau->error_occurred && first >= last)
+        rssringoccs_Reconstruction_Batch_Error(tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Batch\n\n"
+            "\rNo point can be reconstructed with every combination.\n\n"
+        );
+
+    if (!tau->error_occurred)
+    {
+        w_max = calloc(tau->arr_size, sizeof(*w_max));
+        T_out = calloc(n_windows * (last - first), sizeof(*T_out));
+
+        if (!w_max || !T_out)
+        {
+            free(w_max);
+            w_max = NULL;
+            rssringoccs_Reconstruction_Batch_Error(tau,
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Reconstruction_Batch\n\n"
+                "\rMalloc failed and returned NULL for w_max or T_out.\n\n"
+            );
+        }
+        else
+        {
+            /*  The widest window of each point sets the cost and the range.  */
+            for (n = first; n < last; ++n)
+                for (k = 0; k < n_windows; ++k)
+                    if (windows[k].w_km_vals[n] > w_max[n])
+                        w_max[n] = windows[k].w_km_vals[n];
+
+            tau->w_km_vals = w_max;
+            tau->start = first;
+            tau->n_used = last - first;
+
+            /*  T_out is not used here, the block stands in for it.           */
+            T_out_tau = tau->T_out;
+            tau->T_out = T_out;
+            rssringoccs_Tau_Check_Data(tau);
+            tau->T_out = T_out_tau;
+            rssringoccs_Tau_Check_Data_Range(tau);
+        }
+
+        if (!tau->error_occurred)
+        {
+            rssringoccs_Tau_Set_Progress(tau, 0UL, (unsigned long)tau->n_used);
+
+            data.windows = windows;
+            data.n_windows = n_windows;
+            data.T_out = T_out;
+            data.first = first;
+            data.n_pts = last - first;
+            data.is_fresnel = is_fresnel;
+
+            if (!rssringoccs_Tau_Schedule(
+                    tau, first, last, 2.0*tau->dx_km, 0.0,
+                    rssringoccs_Reconstruction_Batch_Block, &data,
+                    rssringoccs_Tau_Thread_Count(tau)))
+                rssringoccs_Reconstruction_Batch_Error(tau,
+                    "\n\rError Encountered: rss_ringoccs\n"
+                    "\r\trssringoccs_Reconstruction_Batch\n\n"
+                    "\rMalloc failed and returned NULL for the window or\n"
+                    "\rkernel buffers.\n\n"
+                );
+        }
+
+        tau->w_km_vals = NULL;
+        free(w_max);
+    }
+
+    for (n = 0; n < n_windows; ++n)
+        free(windows[n].w_km_vals);
+
+    free(windows);
+
+    if (tau->error_occurred)
+    {
+        free(T_out);
+        return NULL;
+    }
+
+    return T_out;
+}
+/*  End of rssringoccs_Reconstruction_Batch.                                  */
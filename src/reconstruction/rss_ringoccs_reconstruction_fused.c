@@ -0,0 +1,505 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                    Fused Inverse and Forward Transforms                    *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Computes the diffraction corrected profile and the forward model of   *
+ *      it in one pass, computing the Fresnel kernel of each window once.     *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  With the window weights w and the Fresnel kernel psi about center, the    *
+ *  inverse transform is                                                      *
+ *                                                                            *
+ *      T_out[center] = c (1 + i) sum_j w_j exp(-i psi_j) T_in[j],            *
+ *                                                                            *
+ *  and the forward model sums the conjugate kernel against T_out,            *
+ *                                                                            *
+ *      T_fwd[center] = c (1 + i) sum_j w_j exp(+i psi_j) T_out[j],           *
+ *                                                                            *
+ *  with the same factor c, since the norm of the window has the same modulus *
+ *  either way. This is what the second pass of rssringoccs_Reconstruction,   *
+ *  with k_vals negated, computes, except that the kernel is not solved for   *
+ *  again.                                                                    *
+ *                                                                            *
+ *  The forward model at center needs T_out across its window, so each task   *
+ *  keeps the kernels of its last centers in a ring and sums one once T_out   *
+ *  is known up to the end of its window. T_out is computed locally for up to *
+ *  the widest half window on either side of the task, as the neighbouring    *
+ *  tasks have not necessarily computed it yet. The local values are the      *
+ *  same as those of the task owning the points, since the windows are built  *
+ *  at the same anchors (see rssringoccs_Window_Anchor).                      *
+ *                                                                            *
+ *  The windows of the forward model are those of the inverse transform at    *
+ *  the same point. The second pass starts its own window reset chain, so     *
+ *  its widths may differ from these by less than 2 dx, and so T_fwd may      *
+ *  differ slightly where the width varies. The fused pass is thus opt-in,    *
+ *  with tau->use_fused.                                                      *
+ *                                                                            *
+ *  This is used for the fresnel psitype and the Newton psitypes that         *
+ *  rssringoccs_Newton_Interp_Psi and rssringoccs_Newton_Interp_Init handle,  *
+ *  and only if the ring of a task fits in RSSRINGOCCS_FUSED_MAX_BYTES. The   *
+ *  kernels are computed with the scalar routines, so use_simd,               *
+ *  use_warm_start, and use_window_cache have no effect here.                 *
+ ******************************************************************************/
+
+/*  malloc, realloc, calloc, and free are found here.                         */
+#include <stdlib.h>
+
+/*  Complex numbers, constants, and tmpl_strdup are found here.               */
+#include <libtmpl/include/tmpl.h>
+
+/*  rssringoccs_Newton_Interp_Psi and the interpolation routines.             */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  Function prototype and the scheduler are found here.                      */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  The ways the kernel is computed.                                          */
+typedef enum rssringoccs_Fused_Kernel_Type_Def {
+    rssringoccs_Fused_Fresnel,
+    rssringoccs_Fused_Newton,
+    rssringoccs_Fused_Newton_Interp
+} rssringoccs_Fused_Kernel_Type;
+
+/*  The arguments of rssringoccs_Fused_Block that are the same for every      *
+ *  task. The forward model is computed for fwd_first <= center < fwd_last.   */
+typedef struct rssringoccs_Fused_Task_Data_Def {
+    rssringoccs_Fused_Kernel_Type type;
+    size_t half_max;
+    size_t fwd_first;
+    size_t fwd_last;
+} rssringoccs_Fused_Task_Data;
+
+/*  A kernel waiting for T_out across its window.                             */
+typedef struct rssringoccs_Fused_Pending_Def {
+    size_t center;
+    size_t half;
+    double factor;
+    tmpl_ComplexDouble *kernel;
+} rssringoccs_Fused_Pending;
+
+/*  The buffers of a task.                                                    */
+typedef struct rssringoccs_Fused_Buffers_Def {
+    double *w_func;
+    tmpl_ComplexDouble *kernel;
+    tmpl_ComplexDouble *ring_data;
+    rssringoccs_Fused_Pending *ring;
+    tmpl_ComplexDouble *T_loc;
+} rssringoccs_Fused_Buffers;
+
+/*  Builds the window about anchor. The window has 2 half + 1 weights, the    *
+ *  center being at index half.                                               */
+static size_t
+rssringoccs_Fused_Window(const rssringoccs_TAUObj *tau,
+                         rssringoccs_Fused_Kernel_Type type,
+                         size_t anchor,
+                         double *w_func)
+{
+    size_t m, half;
+    double x;
+    const double w_init = tau->w_km_vals[anchor];
+    const double dx = tau->dx_km;
+
+    /*  The Fresnel window is symmetric, as in rssringoccs_Tau_Reset_Window.  */
+    if (type == rssringoccs_Fused_Fresnel)
+    {
+        half = (size_t)(w_init / (2.0*dx)) + 1UL;
+
+        for (m = 0; m < half; ++m)
+        {
+            x = ((double)m - (double)half)*dx;
+            w_func[m] = tau->window_func(x, w_init);
+            w_func[2UL*half - m] = w_func[m];
+        }
+
+        w_func[half] = 1.0;
+        return half;
+    }
+
+    half = (size_t)(w_init / (2.0*dx));
+
+    for (m = 0; m <= 2UL*half; ++m)
+        w_func[m] = tau->window_func(
+            tau->rho_km_vals[anchor - half + m] - tau->rho_km_vals[anchor],
+            w_init
+        );
+
+    return half;
+}
+
+/*  Computes the kernel w_j exp(-i psi_j) about center and returns the factor *
+ *  c of the transform, without the (1 + i).                                  */
+static double
+rssringoccs_Fused_Kernel(const rssringoccs_TAUObj *tau,
+                         rssringoccs_Fused_Kernel_Type type,
+                         size_t center,
+                         size_t half,
+                         const double *w_func,
+                         tmpl_ComplexDouble *kernel)
+{
+    size_t m;
+    double x, psi, rcpr_F2;
+    rssringoccs_Newton_Interp interp;
+    tmpl_ComplexDouble norm = tmpl_CDouble_Zero;
+    const size_t offset = center - half;
+
+    if (type == rssringoccs_Fused_Fresnel)
+    {
+        rcpr_F2 = 1.0 / (tau->F_km_vals[center]*tau->F_km_vals[center]);
+
+        for (m = 0; m < half; ++m)
+        {
+            /*  pi/2 ((rho - rho0)/F)^2, as the Fresnel window computes it.   */
+            x = ((double)m - (double)half)*tau->dx_km;
+            x *= tmpl_Pi_By_Two*x;
+            kernel[m] = tmpl_CDouble_Polar(w_func[m], -x*rcpr_F2);
+            kernel[2UL*half - m] = kernel[m];
+        }
+
+        kernel[half] = tmpl_CDouble_One;
+    }
+    else if (type == rssringoccs_Fused_Newton)
+    {
+        for (m = 0; m <= 2UL*half; ++m)
+        {
+            psi = rssringoccs_Newton_Interp_Psi(tau, center, offset + m);
+            kernel[m] = tmpl_CDouble_Polar(w_func[m], -psi);
+        }
+    }
+    else
+    {
+        rssringoccs_Newton_Interp_Init(tau, center, 2UL*half + 1UL, &interp);
+
+        for (m = 0; m <= 2UL*half; ++m)
+        {
+            x = tau->rho_km_vals[offset + m] - tau->rho_km_vals[center];
+            psi = rssringoccs_Newton_Interp_Eval(&interp, x);
+            kernel[m] = tmpl_CDouble_Polar(w_func[m], -psi);
+        }
+    }
+
+    if (!tau->use_norm)
+        return 0.5 * tau->dx_km / tau->F_km_vals[center];
+
+    for (m = 0; m <= 2UL*half; ++m)
+        tmpl_CDouble_AddTo(&norm, &kernel[m]);
+
+    return 0.5 * tmpl_Sqrt_Two / tmpl_CDouble_Abs(norm);
+}
+
+/*  Sums the conjugate of a kernel against T_out. T_out is zero outside of    *
+ *  the points being reconstructed, first_pt <= j <= last_pt, and T_loc holds *
+ *  it from index offset on.                                                  */
+static tmpl_ComplexDouble
+rssringoccs_Fused_Forward(const rssringoccs_Fused_Pending *pending,
+                          const tmpl_ComplexDouble *T_loc,
+                          size_t offset,
+                          size_t first_pt,
+                          size_t last_pt)
+{
+    size_t m, j;
+    tmpl_ComplexDouble sum, term;
+
+    sum = tmpl_CDouble_Zero;
+
+    for (m = 0; m <= 2UL*pending->half; ++m)
+    {
+        j = pending->center - pending->half + m;
+
+        if (j < first_pt || j > last_pt)
+            continue;
+
+        term = tmpl_CDouble_Multiply(tmpl_CDouble_Conjugate(pending->kernel[m]),
+                                     T_loc[j - offset]);
+        tmpl_CDouble_AddTo(&sum, &term);
+    }
+
+    term = tmpl_CDouble_Rect(pending->factor, pending->factor);
+    return tmpl_CDouble_Multiply(term, sum);
+}
+
+static void rssringoccs_Fused_Free(rssringoccs_Fused_Buffers *buffers)
+{
+    free(buffers->w_func);
+    free(buffers->kernel);
+    free(buffers->ring_data);
+    free(buffers->ring);
+    free(buffers->T_loc);
+}
+
+/*  Reconstructs the points of a task, and the forward model at those of them *
+ *  in the forward range. Returns false if malloc fails.                      */
+static tmpl_Bool
+rssringoccs_Fused_Block(rssringoccs_TAUObj *tau,
+                        void *data,
+                        unsigned int worker,
+                        const rssringoccs_Tau_Task *task)
+{
+    size_t m, n, center, half, lo, hi, fwd_lo, fwd_hi, anchor;
+    size_t n_ring, ring_front, n_pending;
+    double w_init, factor;
+    tmpl_ComplexDouble sum, term;
+    rssringoccs_Fused_Buffers buffers;
+    rssringoccs_Fused_Pending *slot;
+
+    const rssringoccs_Fused_Task_Data *args = data;
+    const size_t half_max = args->half_max;
+    const size_t n_max = 2UL*half_max + 1UL;
+    const size_t first_pt = tau->start;
+    const size_t last_pt = tau->start + tau->n_used;
+    const double two_dx = 2.0*tau->dx_km;
+
+    /*  Every task has its own buffers, so the thread does not matter.        */
+    (void)worker;
+
+    /*  The points of the task that get a forward model.                      */
+    fwd_lo = task->first;
+    fwd_hi = task->last;
+
+    if (fwd_lo < args->fwd_first)
+        fwd_lo = args->fwd_first;
+
+    if (fwd_hi > args->fwd_last)
+        fwd_hi = args->fwd_last;
+
+    /*  These need T_out over half_max more points on either side.            */
+    lo = task->first;
+    hi = task->last;
+
+    if (fwd_lo < fwd_hi)
+    {
+        if (fwd_lo < first_pt + half_max)
+            lo = first_pt;
+        else if (fwd_lo - half_max < lo)
+            lo = fwd_lo - half_max;
+
+        if (fwd_hi + half_max > last_pt + 1UL)
+            hi = last_pt + 1UL;
+        else if (fwd_hi + half_max > hi)
+            hi = fwd_hi + half_max;
+    }
+
+    /*  A center waits at most half_max points for its window of T_out.       */
+    n_ring = half_max + 1UL;
+    buffers.w_func = malloc(sizeof(*buffers.w_func) * n_max);
+    buffers.kernel = malloc(sizeof(*buffers.kernel) * n_max);
+    buffers.ring_data = malloc(sizeof(*buffers.ring_data) * n_max * n_ring);
+    buffers.ring = malloc(sizeof(*buffers.ring) * n_ring);
+    buffers.T_loc = malloc(sizeof(*buffers.T_loc) * (hi - lo));
+
+    if (!buffers.w_func || !buffers.kernel || !buffers.ring_data ||
+        !buffers.ring || !buffers.T_loc)
+    {
+        rssringoccs_Fused_Free(&buffers);
+        return tmpl_False;
+    }
+
+    for (n = 0; n < n_ring; ++n)
+        buffers.ring[n].kernel = buffers.ring_data + n*n_max;
+
+    anchor = rssringoccs_Window_Anchor(tau->w_km_vals, tau->start, lo, two_dx);
+    w_init = tau->w_km_vals[anchor];
+    half = rssringoccs_Fused_Window(tau, args->type, anchor, buffers.w_func);
+    ring_front = 0;
+    n_pending = 0;
+
+    for (center = lo; center < hi; ++center)
+    {
+        /*  If the window width has deviated more the 2*dx, reset values.     */
+        if (tmpl_Double_Abs(w_init - tau->w_km_vals[center]) >= two_dx)
+        {
+            w_init = tau->w_km_vals[center];
+            half = rssringoccs_Fused_Window(tau, args->type, center,
+                                            buffers.w_func);
+        }
+
+        /*  The inverse transform, shared by the task owning the point.       */
+        factor = rssringoccs_Fused_Kernel(tau, args->type, center, half,
+                                          buffers.w_func, buffers.kernel);
+
+        sum = tmpl_CDouble_Zero;
+
+        for (m = 0; m <= 2UL*half; ++m)
+        {
+            term = tmpl_CDouble_Multiply(buffers.kernel[m],
+                                         tau->T_in[center - half + m]);
+            tmpl_CDouble_AddTo(&sum, &term);
+        }
+
+        term = tmpl_CDouble_Rect(factor, factor);
+        buffers.T_loc[center - lo] = tmpl_CDouble_Multiply(term, sum);
+
+        if (task->first <= center && center < task->last)
+            tau->T_out[center] = buffers.T_loc[center - lo];
+
+        /*  Keep the kernel until T_out is known across the window.           */
+        if (fwd_lo <= center && center < fwd_hi)
+        {
+            slot = &buffers.ring[(ring_front + n_pending) % n_ring];
+            slot->center = center;
+            slot->half = half;
+            slot->factor = factor;
+
+            for (m = 0; m <= 2UL*half; ++m)
+                slot->kernel[m] = buffers.kernel[m];
+
+            ++n_pending;
+        }
+
+        /*  The last point computed flushes the ring.                         */
+        while (n_pending > 0)
+        {
+            slot = &buffers.ring[ring_front];
+
+            if (slot->center + slot->half > center && center + 1UL < hi)
+                break;
+
+            tau->T_fwd[slot->center] = rssringoccs_Fused_Forward(
+                slot, buffers.T_loc, lo, first_pt, last_pt
+            );
+
+            ring_front = (ring_front + 1UL) % n_ring;
+            --n_pending;
+        }
+    }
+
+    rssringoccs_Fused_Free(&buffers);
+    return tmpl_True;
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Reconstruction_Fused                                      *
+ *  Purpose:                                                                  *
+ *      Runs the inverse transform and the forward model in one pass, for     *
+ *      the psitypes that support it.                                         *
+ *  Arguments:                                                                *
+ *      tau (rssringoccs_TAUObj *):                                           *
+ *          The Tau object, with T_out allocated and the data checked.        *
+ *      nw_pts (size_t):                                                      *
+ *          The number of points left out of the forward model on either      *
+ *          side of the reconstructed range.                                  *
+ *  Outputs:                                                                  *
+ *      fused (tmpl_Bool):                                                    *
+ *          False if the psitype is not supported or the buffers would be too *
+ *          large, in which case nothing is done. True otherwise, with any    *
+ *          error stored in tau.                                              *
+ ******************************************************************************/
+tmpl_Bool
+rssringoccs_Reconstruction_Fused(rssringoccs_TAUObj *tau, size_t nw_pts)
+{
+    size_t n, half_max;
+    double w_max, n_bytes;
+    rssringoccs_Fused_Task_Data data;
+    tmpl_Bool success;
+    const rssringoccs_Psitype_Enum psinum = tau->psinum;
+
+    if (psinum == rssringoccs_DR_Fresnel)
+        data.type = rssringoccs_Fused_Fresnel;
+    else if (psinum == rssringoccs_DR_Newton ||
+             psinum == rssringoccs_DR_NewtonD ||
+             psinum == rssringoccs_DR_NewtonDOld ||
+             psinum == rssringoccs_DR_NewtonDPhi ||
+             psinum == rssringoccs_DR_NewtonElliptical)
+        data.type = rssringoccs_Fused_Newton;
+    else if ((psinum > rssringoccs_DR_Newton &&
+              psinum < rssringoccs_DR_NewtonPerturb) ||
+             (psinum > rssringoccs_DR_NewtonElliptical &&
+              psinum <= rssringoccs_DR_NewtonEllipticalOctic))
+        data.type = rssringoccs_Fused_Newton_Interp;
+    else
+        return tmpl_False;
+
+    /*  The widest window in the range bounds the halo and the ring.          */
+    w_max = 0.0;
+
+    for (n = 0; n <= tau->n_used; ++n)
+        if (tau->w_km_vals[tau->start + n] > w_max)
+            w_max = tau->w_km_vals[tau->start + n];
+
+    half_max = (size_t)(w_max / (2.0*tau->dx_km)) + 1UL;
+    n_bytes = (double)(half_max + 1UL) * (double)(2UL*half_max + 1UL) *
+              (double)sizeof(tmpl_ComplexDouble);
+
+    if (n_bytes > (double)RSSRINGOCCS_FUSED_MAX_BYTES)
+        return tmpl_False;
+
+    tau->T_fwd = rssringoccs_Tau_Calloc_Slot(tau, rssringoccs_Tau_Slot_T_Fwd);
+
+    if (!tau->T_fwd)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Fused\n\n"
+            "\rCalloc failed and returned NULL for T_fwd. With use_arena\n"
+            "\rset, use_fwd must be set before tau is allocated.\n\n"
+        );
+        return tmpl_True;
+    }
+
+    /*  The forward model leaves nw_pts points out on either side, as the     *
+     *  second pass of rssringoccs_Reconstruction does.                       */
+    if (tau->n_used > 2UL*nw_pts)
+    {
+        data.fwd_first = tau->start + nw_pts;
+        data.fwd_last = tau->start + tau->n_used - nw_pts + 1UL;
+    }
+    else
+    {
+        data.fwd_first = 0;
+        data.fwd_last = 0;
+    }
+
+    data.half_max = half_max;
+
+    /*  Progress is counted over one pass.                                    */
+    rssringoccs_Tau_Set_Progress(tau, 0UL, (unsigned long)tau->n_used + 1UL);
+
+    success = rssringoccs_Tau_Schedule(
+        tau, tau->start, tau->start + tau->n_used + 1UL, 2.0*tau->dx_km, 0.0,
+        rssringoccs_Fused_Block, &data, rssringoccs_Tau_Thread_Count(tau)
+    );
+
+    /*  A cancelled run has set its own error message.                        */
+    if (!success && !tau->error_occurred)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Fused\n\n"
+            "\rMalloc failed and returned NULL for the task buffers.\n\n"
+        );
+    }
+
+    if (!tau->error_occurred && tau->n_used <= 2UL*nw_pts)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction\n\n"
+            "\rNot enough data available to perform the forward model.\n"
+            "\rReturning with T_fwd pointer set to an array of zeroes.\n"
+        );
+    }
+
+    return tmpl_True;
+}
+/*  End of rssringoccs_Reconstruction_Fused.                                  */
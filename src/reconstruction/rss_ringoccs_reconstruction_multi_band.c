@@ -0,0 +1,538 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                      Multi-Band Diffraction Correction                     *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Reconstructs the S, X, and Ka band profiles of one occultation        *
+ *      together, solving for the stationary azimuth angles once.             *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The bands of an occultation share the ring radii, azimuth angles, ring    *
+ *  opening angle, and spacecraft position, and differ in the wavenumber k,   *
+ *  the Fresnel scale, and the data. The Fresnel kernel of the Newton methods *
+ *  is k times a function of the geometry alone,                              *
+ *                                                                            *
+ *      psi(k, rho, rho0, phi) = k f(rho, rho0, phi),                         *
+ *                                                                            *
+ *  so the stationary azimuth, the root of d psi / d phi, is the same for     *
+ *  every band. It is found once per sample of the widest window, with the    *
+ *  band of largest k (whose convergence test |d psi / d phi| < EPS is the    *
+ *  strictest) as the reference, and the kernel of band b is then             *
+ *                                                                            *
+ *      psi_b = psi_ref k_b(rho0) / k_ref(rho0).                              *
+ *                                                                            *
+ *  Each band keeps its own window widths, window rebuild points (see         *
+ *  rssringoccs_Window_Anchor), and range, the points start to                *
+ *  start + n_used - 1 as in rssringoccs_Diffraction_Correction_Newton, so    *
+ *  its output matches the single band reconstruction to within the Newton    *
+ *  tolerance. The points are split into tasks by rssringoccs_Tau_Schedule    *
+ *  on the reference band.                                                    *
+ *                                                                            *
+ *  This applies to the non-interpolated Newton psitypes (newton, newtond,    *
+ *  newtondold, newtondphi, and ellipse) without forward modeling, when all   *
+ *  bands use the same psitype and their geometry agrees. Otherwise, and for  *
+ *  a single band, each band is reconstructed on its own with                 *
+ *  rssringoccs_Reconstruction.                                               *
+ ******************************************************************************/
+
+/*  malloc, realloc, calloc, and free are found here.                         */
+#include <stdlib.h>
+
+/*  fabs is declared here.                                                    */
+#include <math.h>
+
+/*  Complex numbers, constants, and tmpl_strdup are found here.               */
+#include <libtmpl/include/tmpl.h>
+
+/*  rssringoccs_Newton_Interp_Psi is declared here.                           */
+#include <rss_ringoccs/include/rss_ringoccs_fresnel_transform.h>
+
+/*  Function prototype and the scheduler are found here.                      */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  One band, and the range of points it reconstructs.                        */
+typedef struct rssringoccs_Band_Def {
+    rssringoccs_TAUObj *tau;
+    const double *w_km_vals;
+    size_t start;
+    size_t end;
+} rssringoccs_Band;
+
+/*  The window a task is currently using for one band.                        */
+typedef struct rssringoccs_Band_State_Def {
+    tmpl_Bool active;
+    double w_init;
+    size_t half;
+    double *w_func;
+    size_t capacity;
+} rssringoccs_Band_State;
+
+/*  The arguments of rssringoccs_Multi_Band_Block that are the same for every *
+ *  task.                                                                     */
+typedef struct rssringoccs_Multi_Band_Task_Data_Def {
+    const rssringoccs_Band *bands;
+    size_t n_bands;
+} rssringoccs_Multi_Band_Task_Data;
+
+/*  Whether the geometry of two bands agrees to within the relative           *
+ *  tolerance RSSRINGOCCS_MULTI_BAND_TOLERANCE.                               */
+static tmpl_Bool
+rssringoccs_Multi_Band_Same(const double *x, const double *y, size_t n)
+{
+    size_t k;
+    double scale;
+
+    if (x == NULL || y == NULL)
+        return tmpl_False;
+
+    for (k = 0; k < n; ++k)
+    {
+        scale = fabs(x[k]) + fabs(y[k]) + 1.0;
+
+        if (fabs(x[k] - y[k]) > RSSRINGOCCS_MULTI_BAND_TOLERANCE * scale)
+            return tmpl_False;
+    }
+
+    return tmpl_True;
+}
+
+/*  Whether the bands can share the stationary azimuth angles.                */
+static tmpl_Bool
+rssringoccs_Multi_Band_Shareable(rssringoccs_TAUObj * const *taus,
+                                 size_t n_bands)
+{
+    size_t b, n;
+    const rssringoccs_TAUObj *ref = taus[0];
+    const rssringoccs_Psitype_Enum psinum = ref->psinum;
+
+    if (psinum != rssringoccs_DR_Newton &&
+        psinum != rssringoccs_DR_NewtonD &&
+        psinum != rssringoccs_DR_NewtonDOld &&
+        psinum != rssringoccs_DR_NewtonDPhi &&
+        psinum != rssringoccs_DR_NewtonElliptical)
+        return tmpl_False;
+
+    for (b = 0; b < n_bands; ++b)
+    {
+        const rssringoccs_TAUObj *tau = taus[b];
+        n = tau->arr_size;
+
+        if (tau->error_occurred || tau->use_fwd || tau->psinum != psinum)
+            return tmpl_False;
+
+        if (n != ref->arr_size || tau->EPS != ref->EPS ||
+            tau->toler != ref->toler || tau->ecc != ref->ecc ||
+            tau->peri != ref->peri)
+            return tmpl_False;
+
+        if (b == 0)
+            continue;
+
+        if (!rssringoccs_Multi_Band_Same(tau->rho_km_vals,
+                                         ref->rho_km_vals, n) ||
+            !rssringoccs_Multi_Band_Same(tau->phi_deg_vals,
+                                         ref->phi_deg_vals, n) ||
+            !rssringoccs_Multi_Band_Same(tau->B_deg_vals,
+                                         ref->B_deg_vals, n) ||
+            !rssringoccs_Multi_Band_Same(tau->D_km_vals,
+                                         ref->D_km_vals, n) ||
+            !rssringoccs_Multi_Band_Same(tau->rx_km_vals,
+                                         ref->rx_km_vals, n) ||
+            !rssringoccs_Multi_Band_Same(tau->ry_km_vals,
+                                         ref->ry_km_vals, n) ||
+            !rssringoccs_Multi_Band_Same(tau->rz_km_vals,
+                                         ref->rz_km_vals, n))
+            return tmpl_False;
+    }
+
+    return tmpl_True;
+}
+
+/*  Builds the window of a band about anchor, as the Newton loop does.        */
+static tmpl_Bool
+rssringoccs_Multi_Band_Window(const rssringoccs_Band *band,
+                              rssringoccs_Band_State *state,
+                              size_t anchor)
+{
+    size_t m, n_pts, offset;
+    double *tmp;
+    const rssringoccs_TAUObj *tau = band->tau;
+
+    state->w_init = band->w_km_vals[anchor];
+    state->half = (size_t)(state->w_init / (2.0*tau->dx_km));
+    n_pts = 2UL*state->half + 1UL;
+
+    if (state->capacity < n_pts)
+    {
+        tmp = realloc(state->w_func, sizeof(*tmp) * n_pts);
+
+        if (!tmp)
+            return tmpl_False;
+
+        state->w_func = tmp;
+        state->capacity = n_pts;
+    }
+
+    offset = anchor - state->half;
+
+    for (m = 0; m < n_pts; ++m)
+        state->w_func[m] = tau->window_func(
+            tau->rho_km_vals[offset + m] - tau->rho_km_vals[anchor],
+            state->w_init
+        );
+
+    return tmpl_True;
+}
+
+/*  Reconstructs the points of a task for every band covering them. The       *
+ *  first band is the reference. Returns false if malloc fails.               */
+static tmpl_Bool
+rssringoccs_Multi_Band_Block(rssringoccs_TAUObj *ref,
+                             void *data,
+                             unsigned int worker,
+                             const rssringoccs_Tau_Task *task)
+{
+    size_t b, m, center, half, offset, n_pts, capacity = 0;
+    double ratio, factor;
+    double *psi = NULL;
+    double *tmp;
+    tmpl_ComplexDouble sum, norm, exp_psi, term;
+    rssringoccs_Band_State *state;
+    tmpl_Bool ok = tmpl_True;
+
+    const rssringoccs_Multi_Band_Task_Data *args = data;
+    const rssringoccs_Band *bands = args->bands;
+    const size_t n_bands = args->n_bands;
+    const double two_dx = 2.0*ref->dx_km;
+
+    /*  Every task has its own buffers, so the thread does not matter.        */
+    (void)worker;
+
+    state = malloc(sizeof(*state) * n_bands);
+
+    if (!state)
+        return tmpl_False;
+
+    for (b = 0; b < n_bands; ++b)
+    {
+        state[b].active = tmpl_False;
+        state[b].w_func = NULL;
+        state[b].capacity = 0;
+    }
+
+    for (center = task->first; ok && center < task->last; ++center)
+    {
+        /*  Bring the window of every band covering center up to date.        */
+        half = 0;
+
+        for (b = 0; ok && b < n_bands; ++b)
+        {
+            if (center < bands[b].start || center >= bands[b].end)
+                continue;
+
+            if (!state[b].active)
+            {
+                state[b].active = tmpl_True;
+                ok = rssringoccs_Multi_Band_Window(
+                    &bands[b], &state[b],
+                    rssringoccs_Window_Anchor(bands[b].w_km_vals,
+                                              bands[b].start, center, two_dx)
+                );
+            }
+            else if (fabs(state[b].w_init - bands[b].w_km_vals[center]) >=
+                     two_dx)
+                ok = rssringoccs_Multi_Band_Window(&bands[b], &state[b],
+                                                   center);
+
+            if (state[b].half > half)
+                half = state[b].half;
+        }
+
+        n_pts = 2UL*half + 1UL;
+
+        if (ok && capacity < n_pts)
+        {
+            tmp = realloc(psi, sizeof(*tmp) * n_pts);
+
+            if (!tmp)
+                ok = tmpl_False;
+            else
+            {
+                psi = tmp;
+                capacity = n_pts;
+            }
+        }
+
+        if (!ok)
+            break;
+
+        /*  The stationary azimuth is solved for once, with the reference.    */
+        offset = center - half;
+
+        for (m = 0; m < n_pts; ++m)
+            psi[m] = rssringoccs_Newton_Interp_Psi(ref, center, offset + m);
+
+        for (b = 0; b < n_bands; ++b)
+        {
+            const rssringoccs_TAUObj *tau = bands[b].tau;
+
+            if (center < bands[b].start || center >= bands[b].end)
+                continue;
+
+            ratio = tau->k_vals[center] / ref->k_vals[center];
+            offset = center - state[b].half;
+            sum = tmpl_CDouble_Zero;
+            norm = tmpl_CDouble_Zero;
+
+            for (m = 0; m <= 2UL*state[b].half; ++m)
+            {
+                exp_psi = tmpl_CDouble_Polar(
+                    state[b].w_func[m], -ratio*psi[half - state[b].half + m]
+                );
+
+                term = tmpl_CDouble_Multiply(exp_psi, tau->T_in[offset + m]);
+                tmpl_CDouble_AddTo(&sum, &term);
+                tmpl_CDouble_AddTo(&norm, &exp_psi);
+            }
+
+            /*  The same scale factors as the single band transforms.         */
+            if (tau->use_norm)
+                factor = 0.5 * tmpl_Sqrt_Two / tmpl_CDouble_Abs(norm);
+            else
+                factor = 0.5 * tau->dx_km / tau->F_km_vals[center];
+
+            term = tmpl_CDouble_Rect(factor, factor);
+            tau->T_out[center] = tmpl_CDouble_Multiply(term, sum);
+        }
+    }
+
+    for (b = 0; b < n_bands; ++b)
+        free(state[b].w_func);
+
+    free(state);
+    free(psi);
+    return ok;
+}
+
+/*  Runs the shared pass over the bands that are free of errors. The first    *
+ *  band of the array is the reference.                                       */
+static void
+rssringoccs_Multi_Band_Run(rssringoccs_Band *bands, size_t n_bands)
+{
+    size_t b, n, first, last;
+    size_t start_ref, n_used_ref;
+    unsigned long done_ref, total_ref;
+    double *w_ref, *w_max;
+    rssringoccs_Multi_Band_Task_Data data;
+    tmpl_Bool success;
+    rssringoccs_TAUObj *ref = bands[0].tau;
+
+    first = bands[0].start;
+    last = bands[0].end;
+
+    for (b = 1; b < n_bands; ++b)
+    {
+        if (bands[b].start < first)
+            first = bands[b].start;
+
+        if (bands[b].end > last)
+            last = bands[b].end;
+    }
+
+    /*  The widest window of each point sets its cost.                        */
+    w_max = calloc(ref->arr_size, sizeof(*w_max));
+
+    if (!w_max)
+    {
+        ref->error_occurred = tmpl_True;
+        ref->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Multi_Band\n\n"
+            "\rMalloc failed and returned NULL for w_max.\n\n"
+        );
+        return;
+    }
+
+    for (b = 0; b < n_bands; ++b)
+        for (n = bands[b].start; n < bands[b].end; ++n)
+            if (bands[b].w_km_vals[n] > w_max[n])
+                w_max[n] = bands[b].w_km_vals[n];
+
+    /*  The scheduler runs on the reference, over the union of the ranges.    */
+    w_ref = ref->w_km_vals;
+    start_ref = ref->start;
+    n_used_ref = ref->n_used;
+    ref->w_km_vals = w_max;
+    ref->start = first;
+    ref->n_used = last - first;
+    rssringoccs_Tau_Get_Progress(ref, &done_ref, &total_ref);
+    rssringoccs_Tau_Set_Progress(ref, done_ref, (unsigned long)(last - first));
+
+    data.bands = bands;
+    data.n_bands = n_bands;
+
+    success = rssringoccs_Tau_Schedule(
+        ref, first, last, 2.0*ref->dx_km, 0.0,
+        rssringoccs_Multi_Band_Block, &data, rssringoccs_Tau_Thread_Count(ref)
+    );
+
+    ref->w_km_vals = w_ref;
+    ref->start = start_ref;
+    ref->n_used = n_used_ref;
+    rssringoccs_Tau_Get_Progress(ref, &done_ref, NULL);
+    rssringoccs_Tau_Set_Progress(ref, done_ref, total_ref);
+    free(w_max);
+
+    /*  A cancelled run has set its own error message.                        */
+    if (!success && !ref->error_occurred)
+    {
+        ref->error_occurred = tmpl_True;
+        ref->error_message = tmpl_strdup(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Multi_Band\n\n"
+            "\rMalloc failed and returned NULL for w_func or psi.\n\n"
+        );
+    }
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Reconstruction_Multi_Band                                 *
+ *  Purpose:                                                                  *
+ *      Reconstructs several bands of the same occultation, solving for the   *
+ *      stationary azimuth angles once for all of them.                       *
+ *  Arguments:                                                                *
+ *      taus (rssringoccs_TAUObj **):                                         *
+ *          The Tau objects of the bands, set up as for                       *
+ *          rssringoccs_Reconstruction.                                       *
+ *      n_bands (size_t):                                                     *
+ *          The number of bands.                                              *
+ *  Outputs:                                                                  *
+ *      None (void).                                                          *
+ *  Notes:                                                                    *
+ *      1.) Each Tau object ends as rssringoccs_Reconstruction leaves it,     *
+ *          with its own errors. An error of the shared pass, including a     *
+ *          cancellation, is given to every band.                             *
+ *      2.) Progress is reported, and cancellation requested, on the band of  *
+ *          largest k at the start of the data.                               *
+ *      3.) The kernels are found with the scalar Newton solvers, so use_simd *
+ *          and use_warm_start have no effect in the shared pass.             *
+ ******************************************************************************/
+void
+rssringoccs_Reconstruction_Multi_Band(rssringoccs_TAUObj **taus,
+                                      size_t n_bands)
+{
+    size_t b, n_ok, ref;
+    unsigned long total;
+    rssringoccs_Band *bands;
+    rssringoccs_Band swap;
+    rssringoccs_TAUObj *tau;
+
+    if (taus == NULL || n_bands == 0)
+        return;
+
+    for (b = 0; b < n_bands; ++b)
+        if (taus[b] == NULL)
+            return;
+
+    /*  Bands that cannot share anything are reconstructed one at a time.     */
+    bands = NULL;
+
+    if (n_bands > 1 && rssringoccs_Multi_Band_Shareable(taus, n_bands))
+        bands = malloc(sizeof(*bands) * n_bands);
+
+    if (!bands)
+    {
+        for (b = 0; b < n_bands; ++b)
+            rssringoccs_Reconstruction(taus[b]);
+
+        return;
+    }
+
+    /*  Find the window widths and ranges, as rssringoccs_Reconstruction.     */
+    n_ok = 0;
+
+    for (b = 0; b < n_bands; ++b)
+    {
+        tau = taus[b];
+        rssringoccs_Tau_Check_Keywords(tau);
+        rssringoccs_Tau_Check_Occ_Type(tau);
+        rssringoccs_Tau_Get_Window_Width(tau);
+        rssringoccs_Tau_Check_Data_Range(tau);
+
+        tau->T_out = rssringoccs_Tau_Calloc_Slot(tau,
+                                                 rssringoccs_Tau_Slot_T_Out);
+        rssringoccs_Tau_Check_Data(tau);
+
+        rssringoccs_Tau_Set_Progress(tau, 0UL, (unsigned long)tau->n_used);
+
+        if (tau->error_occurred)
+            continue;
+
+        bands[n_ok].tau = tau;
+        bands[n_ok].w_km_vals = tau->w_km_vals;
+        bands[n_ok].start = tau->start;
+        bands[n_ok].end = tau->start + tau->n_used;
+        ++n_ok;
+    }
+
+    if (n_ok > 0)
+    {
+        /*  The band of largest k is the reference, moved to the front.       */
+        ref = 0;
+
+        for (b = 1; b < n_ok; ++b)
+        {
+            const size_t n = bands[0].start;
+
+            if (bands[b].tau->k_vals[n] > bands[ref].tau->k_vals[n])
+                ref = b;
+        }
+
+        swap = bands[0];
+        bands[0] = bands[ref];
+        bands[ref] = swap;
+
+        rssringoccs_Multi_Band_Run(bands, n_ok);
+
+        for (b = 1; b < n_ok; ++b)
+        {
+            tau = bands[b].tau;
+
+            if (bands[0].tau->error_occurred)
+            {
+                tau->error_occurred = tmpl_True;
+                tau->error_message = tmpl_strdup(bands[0].tau->error_message);
+            }
+        }
+
+        for (b = 0; b < n_ok; ++b)
+        {
+            rssringoccs_Tau_Get_Progress(bands[b].tau, NULL, &total);
+            rssringoccs_Tau_Set_Progress(bands[b].tau, total, total);
+        }
+    }
+
+    for (b = 0; b < n_bands; ++b)
+        rssringoccs_Tau_Finish(taus[b]);
+
+    free(bands);
+}
+/*  End of rssringoccs_Reconstruction_Multi_Band.                             */
@@ -0,0 +1,653 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                      Streaming Diffraction Correction                      *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Reconstructs an occultation that is read and written in chunks, so    *
+ *      that the whole of it never has to be held in memory.                  *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The arrays of tau are used as a buffer holding the points that are still  *
+ *  needed. Each chunk read from the source is converted as                   *
+ *  rssringoccs_Tau_Create_From_DLP would convert it, appended, and given its *
+ *  window widths. The points whose windows now lie within the buffer are     *
+ *  reconstructed with rssringoccs_Reconstruction_Dispatch and sunk, and the  *
+ *  points before them that no later window can reach are dropped.            *
+ *                                                                            *
+ *  The points reconstructed are those rssringoccs_Tau_Get_Window_Width       *
+ *  selects for the whole data set, and the window widths are the same. The   *
+ *  window reset chain (see rssringoccs_Window_Anchor) starts again with each *
+ *  group of points, so where the width varies the windows used may differ    *
+ *  from those of rssringoccs_Reconstruction by less than 2 dx.               *
+ *                                                                            *
+ *  Points are kept for twice the widest half window in the buffer behind the *
+ *  first point not yet reconstructed. If the width grows faster than this    *
+ *  allows, an error is set rather than using a truncated window.             *
+ ******************************************************************************/
+
+/*  malloc, realloc, calloc, and free are found here.                         */
+#include <stdlib.h>
+
+/*  memcpy and memmove are found here.                                        */
+#include <string.h>
+
+/*  Complex numbers, constants, and tmpl_strdup are found here.               */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototype and rssringoccs_Reconstruction_Dispatch found here.    */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  The real arrays of the Tau object the buffer is made of.                  */
+#define RSSRINGOCCS_STREAM_N_ARRAYS (17)
+
+/*  Sets the error of tau, if one has not been set already.                   */
+static void rssringoccs_Stream_Error(rssringoccs_TAUObj *tau, const char *mes)
+{
+    if (tau->error_occurred)
+        return;
+
+    tau->error_occurred = tmpl_True;
+    tau->error_message = tmpl_strdup(mes);
+}
+/*  End of rssringoccs_Stream_Error.                                          */
+
+/*  Addresses of the real arrays of tau that the buffer keeps.                */
+static void
+rssringoccs_Stream_Arrays(rssringoccs_TAUObj *tau, double ***arrays)
+{
+    arrays[0] = &tau->rho_km_vals;
+    arrays[1] = &tau->F_km_vals;
+    arrays[2] = &tau->phi_deg_vals;
+    arrays[3] = &tau->k_vals;
+    arrays[4] = &tau->rho_dot_kms_vals;
+    arrays[5] = &tau->B_deg_vals;
+    arrays[6] = &tau->D_km_vals;
+    arrays[7] = &tau->w_km_vals;
+    arrays[8] = &tau->t_oet_spm_vals;
+    arrays[9] = &tau->t_ret_spm_vals;
+    arrays[10] = &tau->t_set_spm_vals;
+    arrays[11] = &tau->rho_corr_pole_km_vals;
+    arrays[12] = &tau->rho_corr_timing_km_vals;
+    arrays[13] = &tau->phi_rl_deg_vals;
+    arrays[14] = &tau->rx_km_vals;
+    arrays[15] = &tau->ry_km_vals;
+    arrays[16] = &tau->rz_km_vals;
+}
+/*  End of rssringoccs_Stream_Arrays.                                         */
+
+/*  Addresses of the arrays of a DLP object.                                  */
+static void
+rssringoccs_Stream_DLP_Arrays(rssringoccs_DLPObj *dlp, double ***arrays)
+{
+    arrays[0] = &dlp->rho_km_vals;
+    arrays[1] = &dlp->phi_deg_vals;
+    arrays[2] = &dlp->B_deg_vals;
+    arrays[3] = &dlp->D_km_vals;
+    arrays[4] = &dlp->f_sky_hz_vals;
+    arrays[5] = &dlp->rho_dot_kms_vals;
+    arrays[6] = &dlp->t_oet_spm_vals;
+    arrays[7] = &dlp->t_ret_spm_vals;
+    arrays[8] = &dlp->t_set_spm_vals;
+    arrays[9] = &dlp->rho_corr_pole_km_vals;
+    arrays[10] = &dlp->rho_corr_timing_km_vals;
+    arrays[11] = &dlp->phi_rl_deg_vals;
+    arrays[12] = &dlp->p_norm_vals;
+    arrays[13] = &dlp->phase_deg_vals;
+    arrays[14] = &dlp->raw_tau_threshold_vals;
+    arrays[15] = &dlp->rx_km_vals;
+    arrays[16] = &dlp->ry_km_vals;
+    arrays[17] = &dlp->rz_km_vals;
+}
+/*  End of rssringoccs_Stream_DLP_Arrays.                                     */
+
+/*  Frees the arrays of the chunk DLP object.                                 */
+static void rssringoccs_Stream_DLP_Free(rssringoccs_DLPObj *dlp)
+{
+    double **arrays[18];
+    size_t n;
+
+    rssringoccs_Stream_DLP_Arrays(dlp, arrays);
+
+    for (n = 0; n < 18; ++n)
+    {
+        free(*arrays[n]);
+        *arrays[n] = NULL;
+    }
+
+    if (dlp->error_message != NULL)
+    {
+        free(dlp->error_message);
+        dlp->error_message = NULL;
+    }
+}
+/*  End of rssringoccs_Stream_DLP_Free.                                       */
+
+/*  Allocates the arrays of the chunk DLP object. Returns false on failure.   */
+static tmpl_Bool
+rssringoccs_Stream_DLP_Malloc(rssringoccs_DLPObj *dlp, size_t n_pts)
+{
+    double **arrays[18];
+    size_t n;
+    tmpl_Bool ok = tmpl_True;
+
+    dlp->arr_size = n_pts;
+    dlp->error_occurred = tmpl_False;
+    dlp->error_message = NULL;
+    rssringoccs_Stream_DLP_Arrays(dlp, arrays);
+
+    for (n = 0; n < 18; ++n)
+    {
+        *arrays[n] = malloc(sizeof(**arrays[n]) * n_pts);
+
+        if (*arrays[n] == NULL)
+            ok = tmpl_False;
+    }
+
+    return ok;
+}
+/*  End of rssringoccs_Stream_DLP_Malloc.                                     */
+
+/*  Makes room for cap points in the buffer. Returns false on failure.        */
+static tmpl_Bool
+rssringoccs_Stream_Reserve(rssringoccs_TAUObj *tau, size_t cap)
+{
+    double **arrays[RSSRINGOCCS_STREAM_N_ARRAYS];
+    tmpl_ComplexDouble *T_in;
+    double *tmp;
+    size_t n;
+
+    rssringoccs_Stream_Arrays(tau, arrays);
+
+    for (n = 0; n < RSSRINGOCCS_STREAM_N_ARRAYS; ++n)
+    {
+        tmp = realloc(*arrays[n], sizeof(*tmp) * cap);
+
+        if (tmp == NULL)
+            return tmpl_False;
+
+        *arrays[n] = tmp;
+    }
+
+    T_in = realloc(tau->T_in, sizeof(*T_in) * cap);
+
+    if (T_in == NULL)
+        return tmpl_False;
+
+    tau->T_in = T_in;
+    return tmpl_True;
+}
+/*  End of rssringoccs_Stream_Reserve.                                        */
+
+/*  Removes the first n_drop points from the buffer.                          */
+static void rssringoccs_Stream_Drop(rssringoccs_TAUObj *tau, size_t n_drop)
+{
+    double **arrays[RSSRINGOCCS_STREAM_N_ARRAYS];
+    const size_t n_keep = tau->arr_size - n_drop;
+    size_t n;
+
+    rssringoccs_Stream_Arrays(tau, arrays);
+
+    for (n = 0; n < RSSRINGOCCS_STREAM_N_ARRAYS; ++n)
+        memmove(*arrays[n], *arrays[n] + n_drop, sizeof(double) * n_keep);
+
+    memmove(tau->T_in, tau->T_in + n_drop, sizeof(*tau->T_in) * n_keep);
+    tau->arr_size = n_keep;
+}
+/*  End of rssringoccs_Stream_Drop.                                           */
+
+/*  Converts the n_pts points of the chunk, appending them to the buffer.     */
+static void
+rssringoccs_Stream_Append(rssringoccs_TAUObj *tau,
+                          rssringoccs_DLPObj *chunk,
+                          size_t n_pts)
+{
+    double **arrays[RSSRINGOCCS_STREAM_N_ARRAYS];
+    double **chunk_arrays[RSSRINGOCCS_STREAM_N_ARRAYS];
+    rssringoccs_TAUObj chunk_tau;
+    const size_t offset = tau->arr_size;
+    size_t n;
+
+    rssringoccs_Tau_Init(&chunk_tau);
+    chunk_tau.arr_size = n_pts;
+    chunk->arr_size = n_pts;
+
+    rssringoccs_Tau_Malloc_Members(&chunk_tau);
+    rssringoccs_Tau_Copy_DLP_Members(&chunk_tau, chunk);
+    rssringoccs_Tau_Compute_Data_From_DLP_Members(&chunk_tau, chunk);
+
+    if (chunk_tau.error_occurred)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = chunk_tau.error_message;
+        chunk_tau.error_message = NULL;
+        rssringoccs_Tau_Destroy_Members(&chunk_tau);
+        return;
+    }
+
+    rssringoccs_Stream_Arrays(tau, arrays);
+    rssringoccs_Stream_Arrays(&chunk_tau, chunk_arrays);
+
+    /*  The window widths are computed once the points are in the buffer.     */
+    for (n = 0; n < RSSRINGOCCS_STREAM_N_ARRAYS; ++n)
+        if (*chunk_arrays[n] != NULL)
+            memcpy(*arrays[n] + offset, *chunk_arrays[n],
+                   sizeof(double) * n_pts);
+
+    memcpy(tau->T_in + offset, chunk_tau.T_in, sizeof(*tau->T_in) * n_pts);
+    tau->arr_size += n_pts;
+    rssringoccs_Tau_Destroy_Members(&chunk_tau);
+}
+/*  End of rssringoccs_Stream_Append.                                         */
+
+/*  Checks the points from first on are in increasing radius and from one     *
+ *  side of the occultation, as rssringoccs_Tau_Check_Occ_Type would, and     *
+ *  sets rho_dot_kms_vals to its absolute value. sign is the sign of drho/dt, *
+ *  zero until it is known.                                                   */
+static void
+rssringoccs_Stream_Check_Occ_Type(rssringoccs_TAUObj *tau,
+                                  size_t first, double *sign)
+{
+    size_t n;
+
+    for (n = first; n < tau->arr_size; ++n)
+    {
+        const double rho_dot = tau->rho_dot_kms_vals[n];
+
+        if (n > 0 && tau->rho_km_vals[n] <= tau->rho_km_vals[n - 1])
+        {
+            rssringoccs_Stream_Error(
+                tau,
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Reconstruction_Stream\n\n"
+                "\rThe source must give rho_km_vals in increasing order.\n"
+            );
+            return;
+        }
+
+        if (rho_dot == 0.0 || rho_dot * *sign < 0.0)
+        {
+            rssringoccs_Stream_Error(
+                tau,
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Reconstruction_Stream\n\n"
+                "\r\tdrho/dt has zero valued elements or changes sign.\n"
+                "\r\tYour input file is probably a chord occultation.\n"
+                "\r\tDiffraction Correction can only be performed for\n"
+                "\r\tone event at a time. That is, ingress or egress.\n\n"
+            );
+            return;
+        }
+
+        *sign = (rho_dot > 0.0 ? 1.0 : -1.0);
+        tau->rho_dot_kms_vals[n] = tmpl_Double_Abs(rho_dot);
+    }
+}
+/*  End of rssringoccs_Stream_Check_Occ_Type.                                 */
+
+/*  Computes the window widths of the points from first on, with the          *
+ *  formulas of rssringoccs_Tau_Get_Window_Width.                             */
+static void
+rssringoccs_Stream_Window_Width(rssringoccs_TAUObj *tau, size_t first)
+{
+    size_t n;
+    double F, omega, alpha, P;
+
+    for (n = first; n < tau->arr_size; ++n)
+    {
+        F = tau->F_km_vals[n];
+
+        if (tau->bfac)
+        {
+            omega = tmpl_Speed_Of_Light_KMS * tau->k_vals[n];
+            alpha = omega * tau->sigma;
+            alpha *= alpha * 0.5 / tau->rho_dot_kms_vals[n];
+            P = tau->res / (alpha*F*F);
+
+            if (P > 1.0)
+                tau->w_km_vals[n] = tau->normeq *
+                    tmpl_Double_Resolution_Inverse(P) / alpha;
+            else
+                tau->w_km_vals[n] = 0.0;
+        }
+        else
+            tau->w_km_vals[n] = 2.0*F*F*tau->normeq/tau->res;
+    }
+}
+/*  End of rssringoccs_Stream_Window_Width.                                   */
+
+/*  Largest number of points in half a window over the buffer.                */
+static size_t rssringoccs_Stream_Max_Half(const rssringoccs_TAUObj *tau)
+{
+    size_t n, half;
+    size_t max_half = 0;
+    const double rcpr_two_dx = 0.5 / tau->dx_km;
+
+    for (n = 0; n < tau->arr_size; ++n)
+    {
+        half = (size_t)(tau->w_km_vals[n] * rcpr_two_dx) + 1;
+
+        if (half > max_half)
+            max_half = half;
+    }
+
+    return max_half;
+}
+/*  End of rssringoccs_Stream_Max_Half.                                       */
+
+/*  The state of a stream between chunks.                                     */
+typedef struct rssringoccs_Stream_State_Def {
+
+    /*  Smallest radius in the data, and the index of the next point of the   *
+     *  buffer to be reconstructed or skipped.                                */
+    double rho_min;
+    size_t cursor;
+
+    /*  Whether a point has been reconstructed, and whether the last one has. */
+    tmpl_Bool started;
+    tmpl_Bool finished;
+} rssringoccs_Stream_State;
+
+/*  The value of tau->n_used for which rssringoccs_Reconstruction_Dispatch    *
+ *  computes the n_pts points from tau->start on. The Fresnel methods compute *
+ *  start to start + n_used inclusive, the others stop before start + n_used. */
+static size_t
+rssringoccs_Stream_N_Used(const rssringoccs_TAUObj *tau, size_t n_pts)
+{
+    if (tau->psinum == rssringoccs_DR_Fresnel ||
+        tau->psinum == rssringoccs_DR_FresnelFFT)
+        return n_pts - 1;
+
+    return n_pts;
+}
+/*  End of rssringoccs_Stream_N_Used.                                         */
+
+/*  Reconstructs and sinks the points whose windows are in the buffer.        *
+ *  exhausted is true if the buffer ends with the last point of the data.     */
+static void
+rssringoccs_Stream_Process(rssringoccs_TAUObj *tau,
+                           rssringoccs_Stream_State *state,
+                           tmpl_Bool exhausted,
+                           rssringoccs_Tau_Sink sink,
+                           void *sink_data)
+{
+    size_t first, half, n_pts;
+    double rho, w;
+    const double rho_max = tau->rho_km_vals[tau->arr_size - 1];
+    const double rcpr_two_dx = 0.5 / tau->dx_km;
+    unsigned long done, total;
+
+    /*  Points before the requested range, or without enough data to their    *
+     *  left, are not reconstructed.                                          */
+    while (!state->started && state->cursor < tau->arr_size)
+    {
+        rho = tau->rho_km_vals[state->cursor];
+        w = tau->w_km_vals[state->cursor];
+
+        if (rho >= tau->rng_list[0] && rho - 0.5*w > state->rho_min)
+            state->started = tmpl_True;
+        else
+            ++state->cursor;
+    }
+
+    first = state->cursor;
+
+    /*  As in rssringoccs_Tau_Get_Window_Width, the points run up to the      *
+     *  first past rng_list[1] and the last with enough data to its right.    */
+    while (!state->finished && state->cursor < tau->arr_size)
+    {
+        rho = tau->rho_km_vals[state->cursor];
+        w = tau->w_km_vals[state->cursor];
+
+        if (rho + 0.5*w >= rho_max)
+        {
+            if (exhausted)
+                state->finished = tmpl_True;
+
+            break;
+        }
+
+        half = (size_t)(w * rcpr_two_dx) + 1;
+
+        if (state->cursor < half || state->cursor + half >= tau->arr_size)
+        {
+            rssringoccs_Stream_Error(
+                tau,
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Reconstruction_Stream\n\n"
+                "\rThe window width grew faster than the points kept for it.\n"
+                "\rUse a larger chunk_size. Returning.\n"
+            );
+            return;
+        }
+
+        ++state->cursor;
+
+        if (rho > tau->rng_list[1])
+            state->finished = tmpl_True;
+    }
+
+    if (state->cursor == first)
+        return;
+
+    n_pts = state->cursor - first;
+    tau->start = first;
+    tau->n_used = rssringoccs_Stream_N_Used(tau, n_pts);
+    tau->T_out = calloc(tau->arr_size, sizeof(*tau->T_out));
+
+    rssringoccs_Tau_Check_Data_Range(tau);
+    rssringoccs_Tau_Check_Data(tau);
+    rssringoccs_Reconstruction_Dispatch(tau);
+
+    if (!tau->error_occurred &&
+        !sink(sink_data, tau, first, n_pts))
+        rssringoccs_Stream_Error(
+            tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Stream\n\n"
+            "\rThe output sink failed. Returning.\n"
+        );
+
+    rssringoccs_Tau_Get_Progress(tau, &done, &total);
+    done += (unsigned long)n_pts;
+    rssringoccs_Tau_Set_Progress(tau, done, total);
+    free(tau->T_out);
+    tau->T_out = NULL;
+}
+/*  End of rssringoccs_Stream_Process.                                        */
+
+void
+rssringoccs_Reconstruction_Stream(rssringoccs_TAUObj *tau,
+                                  rssringoccs_DLP_Source source,
+                                  void *source_data,
+                                  rssringoccs_Tau_Sink sink,
+                                  void *sink_data,
+                                  size_t chunk_size)
+{
+    rssringoccs_DLPObj chunk;
+    rssringoccs_Stream_State state;
+    size_t n_read, first, cap, keep;
+    unsigned long done;
+    double sign = 0.0;
+    tmpl_Bool exhausted = tmpl_False;
+
+    if (tau == NULL)
+        return;
+
+    if (tau->error_occurred)
+        return;
+
+    if (source == NULL || sink == NULL || chunk_size < 2)
+    {
+        rssringoccs_Stream_Error(
+            tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Stream\n\n"
+            "\rsource and sink must not be NULL and chunk_size must be at\n"
+            "\rleast 2. Returning.\n"
+        );
+        return;
+    }
+
+    if (tau->use_fwd)
+    {
+        rssringoccs_Stream_Error(
+            tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Stream\n\n"
+            "\rThe forward model is not available when streaming.\n"
+        );
+        return;
+    }
+
+    if (tau->arr_size != 0 || tau->rho_km_vals != NULL)
+    {
+        rssringoccs_Stream_Error(
+            tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Stream\n\n"
+            "\rtau already has data. Streaming requires a Tau object\n"
+            "\rholding only settings. Returning.\n"
+        );
+        return;
+    }
+
+    rssringoccs_Tau_Check_Keywords(tau);
+
+    if (tau->error_occurred)
+        return;
+
+    if (!rssringoccs_Stream_DLP_Malloc(&chunk, chunk_size))
+    {
+        rssringoccs_Stream_DLP_Free(&chunk);
+        rssringoccs_Stream_Error(
+            tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Stream\n\n"
+            "\rMalloc failed and returned NULL for the chunk. Returning.\n"
+        );
+        return;
+    }
+
+    cap = 0;
+    state.rho_min = 0.0;
+    state.cursor = 0;
+    state.started = tmpl_False;
+    state.finished = tmpl_False;
+    tau->start = 0;
+    tau->n_used = 0;
+    tau->dx_km = 0.0;
+    rssringoccs_Tau_Set_Progress(tau, 0UL, 0UL);
+
+    while (!state.finished && !exhausted && !tau->error_occurred)
+    {
+        if (rssringoccs_Tau_Cancel_Requested(tau))
+        {
+            rssringoccs_Stream_Error(
+                tau,
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Reconstruction_Stream\n\n"
+                "\rThe reconstruction was cancelled.\n\n"
+            );
+            break;
+        }
+
+        chunk.arr_size = chunk_size;
+        n_read = source(source_data, &chunk, chunk_size);
+
+        if (chunk.error_occurred)
+        {
+            tau->error_occurred = tmpl_True;
+            tau->error_message = chunk.error_message;
+            chunk.error_message = NULL;
+            break;
+        }
+
+        if (n_read > chunk_size)
+            n_read = chunk_size;
+
+        exhausted = (n_read == 0);
+
+        if (!exhausted)
+        {
+            /*  Drop the points no window can reach any more before growing.  */
+            if (tau->arr_size > 0)
+            {
+                keep = 2*rssringoccs_Stream_Max_Half(tau);
+
+                if (state.cursor > keep)
+                {
+                    rssringoccs_Stream_Drop(tau, state.cursor - keep);
+                    state.cursor = keep;
+                }
+            }
+
+            if (tau->arr_size + n_read > cap)
+            {
+                cap = tau->arr_size + n_read;
+
+                if (!rssringoccs_Stream_Reserve(tau, cap))
+                {
+                    rssringoccs_Stream_Error(
+                        tau,
+                        "\n\rError Encountered: rss_ringoccs\n"
+                        "\r\trssringoccs_Reconstruction_Stream\n\n"
+                        "\rRealloc failed and returned NULL. Returning.\n"
+                    );
+                    break;
+                }
+            }
+
+            first = tau->arr_size;
+            rssringoccs_Stream_Append(tau, &chunk, n_read);
+
+            if (first == 0 && !tau->error_occurred)
+                state.rho_min = tau->rho_km_vals[0];
+
+            rssringoccs_Stream_Check_Occ_Type(tau, first, &sign);
+
+            if (tau->error_occurred)
+                break;
+
+            if (tau->dx_km == 0.0 && tau->arr_size > 1)
+                tau->dx_km = tau->rho_km_vals[1] - tau->rho_km_vals[0];
+
+            rssringoccs_Stream_Window_Width(tau, first);
+        }
+
+        if (tau->arr_size > 1)
+            rssringoccs_Stream_Process(tau, &state, exhausted,
+                                       sink, sink_data);
+    }
+
+    rssringoccs_Tau_Get_Progress(tau, &done, NULL);
+
+    if (!tau->error_occurred && done == 0UL)
+        rssringoccs_Stream_Error(
+            tau,
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Reconstruction_Stream\n\n"
+            "\rNo point in the requested range has enough data on both\n"
+            "\rsides of its window. Nothing was reconstructed.\n"
+        );
+
+    rssringoccs_Tau_Set_Progress(tau, done, done);
+    rssringoccs_Stream_DLP_Free(&chunk);
+}
+/*  End of rssringoccs_Reconstruction_Stream.                                 */
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                        Streaming Sources and Sinks                         *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a source reading from a DLP object in memory and a sink      *
+ *      writing to a file, for use with rssringoccs_Reconstruction_Stream.    *
+ ******************************************************************************/
+
+/*  FILE and fprintf are found here.                                          */
+#include <stdio.h>
+
+/*  memcpy is found here.                                                     */
+#include <string.h>
+
+/*  Complex numbers are found here.                                           */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototypes and rssringoccs_DLP_Array_Source found here.          */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  Copies n_pts values of the source DLP, from index next, into dlp.         */
+#define COPY_DLP_VAR(var)                                                      \
+    memcpy(dlp->var, src->dlp->var + src->next, sizeof(double) * n_pts);
+
+size_t
+rssringoccs_DLP_Array_Source_Read(void *data,
+                                  rssringoccs_DLPObj *dlp,
+                                  size_t max_pts)
+{
+    rssringoccs_DLP_Array_Source *src = data;
+    size_t n_pts;
+
+    if (src->next >= src->dlp->arr_size)
+        return 0;
+
+    n_pts = src->dlp->arr_size - src->next;
+
+    if (n_pts > max_pts)
+        n_pts = max_pts;
+
+    COPY_DLP_VAR(rho_km_vals)
+    COPY_DLP_VAR(phi_deg_vals)
+    COPY_DLP_VAR(B_deg_vals)
+    COPY_DLP_VAR(D_km_vals)
+    COPY_DLP_VAR(f_sky_hz_vals)
+    COPY_DLP_VAR(rho_dot_kms_vals)
+    COPY_DLP_VAR(t_oet_spm_vals)
+    COPY_DLP_VAR(t_ret_spm_vals)
+    COPY_DLP_VAR(t_set_spm_vals)
+    COPY_DLP_VAR(rho_corr_pole_km_vals)
+    COPY_DLP_VAR(rho_corr_timing_km_vals)
+    COPY_DLP_VAR(phi_rl_deg_vals)
+    COPY_DLP_VAR(p_norm_vals)
+    COPY_DLP_VAR(phase_deg_vals)
+    COPY_DLP_VAR(raw_tau_threshold_vals)
+    COPY_DLP_VAR(rx_km_vals)
+    COPY_DLP_VAR(ry_km_vals)
+    COPY_DLP_VAR(rz_km_vals)
+
+    src->next += n_pts;
+    return n_pts;
+}
+/*  End of rssringoccs_DLP_Array_Source_Read.                                 */
+
+#undef COPY_DLP_VAR
+
+tmpl_Bool
+rssringoccs_Tau_File_Sink_Write(void *data,
+                                const rssringoccs_TAUObj *tau,
+                                size_t first,
+                                size_t n_pts)
+{
+    FILE *fp = data;
+    size_t n;
+
+    for (n = first; n < first + n_pts; ++n)
+    {
+        if (fprintf(fp, "%.16e,%.16e,%.16e\n", tau->rho_km_vals[n],
+                    tmpl_CDouble_Real_Part(tau->T_out[n]),
+                    tmpl_CDouble_Imag_Part(tau->T_out[n])) < 0)
+            return tmpl_False;
+    }
+
+    return tmpl_True;
+}
+/*  End of rssringoccs_Tau_File_Sink_Write.                                   */
@@ -207,6 +207,12 @@ void rssringoccs_Tau_Check_Occ_Type(rssringoccs_TAUObj *tau)
      *  in rss_ringoccs_math.h.                                               */
     else if (tau->dx_km < 0.0)
     {
+        /*  Borrowed DLP members are read-only. Copy them before reversing.   */
+        rssringoccs_Tau_Own_DLP_Members(tau);
+
+        if (tau->error_occurred)
+            return;
+
         tmpl_Double_Array_Reverse(tau->rho_km_vals,      tau->arr_size);
         tmpl_Double_Array_Reverse(tau->phi_deg_vals,     tau->arr_size);
         tmpl_Double_Array_Reverse(tau->B_deg_vals,       tau->arr_size);
@@ -34,6 +34,10 @@ static void resize_carray(tmpl_ComplexDouble **ptr, size_t start, size_t len)
     *ptr = temp;
 }
 
+/*  Moves an array the tau object did not allocate on its own forward to the  *
+ *  start of the range.                                                       */
+#define OFFSET_ARRAY(var) if (tau->var != NULL) tau->var += tau->start;
+
 #if 1
 
 void rssringoccs_Tau_Finish(rssringoccs_TAUObj* tau)
@@ -44,22 +48,61 @@ void rssringoccs_Tau_Finish(rssringoccs_TAUObj* tau)
     if (tau->error_occurred)
         return;
 
+    /*  Arrays in an arena, or borrowed from a DLP object, are trimmed        *
+     *  without copying, by moving the pointers forward. The unused points    *
+     *  are freed with the arena, or left to the DLP object.                  */
+    if (tau->dlp_storage == rssringoccs_Tau_DLP_Owned)
+    {
+        resize_array(&tau->rho_km_vals, tau->start, tau->n_used);
+        resize_array(&tau->phi_deg_vals, tau->start, tau->n_used);
+        resize_array(&tau->B_deg_vals, tau->start, tau->n_used);
+        resize_array(&tau->D_km_vals, tau->start, tau->n_used);
+        resize_array(&tau->t_oet_spm_vals, tau->start, tau->n_used);
+        resize_array(&tau->t_ret_spm_vals, tau->start, tau->n_used);
+        resize_array(&tau->t_set_spm_vals, tau->start, tau->n_used);
+        resize_array(&tau->rho_corr_pole_km_vals, tau->start, tau->n_used);
+        resize_array(&tau->rho_corr_timing_km_vals, tau->start, tau->n_used);
+        resize_array(&tau->phi_rl_deg_vals, tau->start, tau->n_used);
+        resize_array(&tau->rx_km_vals, tau->start, tau->n_used);
+        resize_array(&tau->ry_km_vals, tau->start, tau->n_used);
+        resize_array(&tau->rz_km_vals, tau->start, tau->n_used);
+    }
+    else
+    {
+        OFFSET_ARRAY(rho_km_vals)
+        OFFSET_ARRAY(phi_deg_vals)
+        OFFSET_ARRAY(B_deg_vals)
+        OFFSET_ARRAY(D_km_vals)
+        OFFSET_ARRAY(t_oet_spm_vals)
+        OFFSET_ARRAY(t_ret_spm_vals)
+        OFFSET_ARRAY(t_set_spm_vals)
+        OFFSET_ARRAY(rho_corr_pole_km_vals)
+        OFFSET_ARRAY(rho_corr_timing_km_vals)
+        OFFSET_ARRAY(phi_rl_deg_vals)
+        OFFSET_ARRAY(rx_km_vals)
+        OFFSET_ARRAY(ry_km_vals)
+        OFFSET_ARRAY(rz_km_vals)
+    }
+
+    if (tau->arena != NULL)
+    {
+        OFFSET_ARRAY(T_in)
+        OFFSET_ARRAY(T_out)
+        OFFSET_ARRAY(T_fwd)
+        OFFSET_ARRAY(F_km_vals)
+        OFFSET_ARRAY(k_vals)
+        OFFSET_ARRAY(rho_dot_kms_vals)
+        OFFSET_ARRAY(w_km_vals)
+        tau->arr_size = tau->n_used;
+        return;
+    }
+
     resize_carray(&tau->T_in, tau->start, tau->n_used);
     resize_carray(&tau->T_out, tau->start, tau->n_used);
-    resize_array(&tau->rho_km_vals, tau->start, tau->n_used);
     resize_array(&tau->F_km_vals, tau->start, tau->n_used);
-    resize_array(&tau->phi_deg_vals, tau->start, tau->n_used);
     resize_array(&tau->k_vals, tau->start, tau->n_used);
     resize_array(&tau->rho_dot_kms_vals, tau->start, tau->n_used);
-    resize_array(&tau->B_deg_vals, tau->start, tau->n_used);
-    resize_array(&tau->D_km_vals, tau->start, tau->n_used);
     resize_array(&tau->w_km_vals, tau->start, tau->n_used);
-    resize_array(&tau->t_oet_spm_vals, tau->start, tau->n_used);
-    resize_array(&tau->t_ret_spm_vals, tau->start, tau->n_used);
-    resize_array(&tau->t_set_spm_vals, tau->start, tau->n_used);
-    resize_array(&tau->rho_corr_pole_km_vals, tau->start, tau->n_used);
-    resize_array(&tau->rho_corr_timing_km_vals, tau->start, tau->n_used);
-    resize_array(&tau->phi_rl_deg_vals, tau->start, tau->n_used);
     tau->arr_size = tau->n_used;
 
     if (tau->use_fwd)
@@ -145,3 +188,5 @@ void rssringoccs_Tau_Finish(rssringoccs_TAUObj* tau)
 }
 
 #endif
+
+#undef OFFSET_ARRAY
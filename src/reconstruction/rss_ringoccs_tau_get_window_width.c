@@ -111,8 +111,9 @@ void rssringoccs_Tau_Get_Window_Width(rssringoccs_TAUObj* tau)
 
     /*  Use calloc to both allocate memory for tau.w_km_vals (like malloc)    *
      *  and initialize the data to zero (unlike malloc). This is similar to   *
-     *  numpy.zeros(tau.arr_size) in Python.                                  */
-    tau->w_km_vals = calloc(tau->arr_size, sizeof(double));
+     *  numpy.zeros(tau.arr_size) in Python. An arena has a slot for this.    */
+    tau->w_km_vals = rssringoccs_Tau_Calloc_Slot(tau,
+                                                 rssringoccs_Tau_Slot_W_Km);
 
     if (tau->bfac)
     {
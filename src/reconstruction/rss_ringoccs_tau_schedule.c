@@ -0,0 +1,397 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                          Reconstruction Scheduler                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Distributes the points of a reconstruction over threads, balancing    *
+ *      their estimated cost with work stealing.                              *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The window width grows as F^2, so across a Rev the cost of a point can    *
+ *  vary by an order of magnitude or more, and equal blocks of points leave   *
+ *  most threads idle while one finishes the widest windows. Here the cost    *
+ *  of a point is estimated as                                                *
+ *                                                                            *
+ *      cost = point_cost + w_km_vals[center] / (2 dx),                       *
+ *                                                                            *
+ *  the number of samples in the window plus a fixed per-point cost given by  *
+ *  the caller, and the range is cut into RSSRINGOCCS_TAU_TASKS_PER_THREAD    *
+ *  contiguous tasks per thread of about equal cost.                          *
+ *                                                                            *
+ *  Each thread starts out owning a contiguous run of tasks and works         *
+ *  through it from the front, so consecutive centers stay on one thread      *
+ *  (the Newton warm starts depend on this). A thread with nothing left       *
+ *  steals the last task of the next thread that still has some. Since the    *
+ *  estimate is only an estimate, this also absorbs the error in it.          *
+ *                                                                            *
+ *  Each task starts from the window the serial loop would be using at its    *
+ *  first point (see rssringoccs_Tau_Window_Anchor), so the output does not   *
+ *  depend on the number of threads or on which thread ran which task.        *
+ *                                                                            *
+ *  The number of tasks, points, and estimated cost each thread handled, and  *
+ *  the time it spent in tasks, are stored in tau->worker_stats and printed   *
+ *  if tau->verbose is set.                                                   *
+ *                                                                            *
+ *  The points of every finished task are added to tau->progress_done, and    *
+ *  no new task is started once a cancel is requested. Both may be used from  *
+ *  another thread, through the functions of rss_ringoccs_tau_progress.c, so  *
+ *  a single thread runs the tasks one after the other too, rather than the   *
+ *  whole range at once.                                                      *
+ ******************************************************************************/
+
+/*  malloc, realloc, and free found here.                                     */
+#include <stdlib.h>
+
+/*  printf found here.                                                        */
+#include <stdio.h>
+
+/*  clock found here, for builds without OpenMP.                              */
+#include <time.h>
+
+/*  tmpl_Double_Abs and tmpl_strdup found here.                               */
+#include <libtmpl/include/tmpl.h>
+
+/*  Function prototype and the task typedefs.                                 */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  OpenMP locks and omp_get_wtime are declared here.                         */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*  Wall clock time in seconds, used for the utilization of the threads.      */
+static double rssringoccs_Tau_Schedule_Time(void)
+{
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+/*  Cuts first <= center < last into at most n_max tasks of about equal cost. *
+ *  Returns the number of tasks. The cost of each task is stored in cost.     */
+static size_t
+rssringoccs_Tau_Schedule_Split(const rssringoccs_TAUObj *tau,
+                               size_t first,
+                               size_t last,
+                               double two_dx,
+                               double point_cost,
+                               size_t n_max,
+                               rssringoccs_Tau_Task *tasks,
+                               double *cost)
+{
+    size_t center, start, anchor;
+    size_t n_tasks = 0U;
+    double total = 0.0, sum = 0.0, target, w_init;
+
+    for (center = first; center < last; ++center)
+        total += point_cost + tau->w_km_vals[center] / two_dx;
+
+    target = total / (double)n_max;
+
+    /*  Replay the window reset rule to find the anchor of each task.         */
+    anchor = rssringoccs_Tau_Window_Anchor(tau, first, two_dx);
+    w_init = tau->w_km_vals[anchor];
+    start = first;
+
+    for (center = first; center < last; ++center)
+    {
+        if (tmpl_Double_Abs(w_init - tau->w_km_vals[center]) >= two_dx)
+        {
+            w_init = tau->w_km_vals[center];
+            anchor = center;
+        }
+
+        if (center == start)
+            tasks[n_tasks].anchor = anchor;
+
+        sum += point_cost + tau->w_km_vals[center] / two_dx;
+
+        if ((sum >= target && n_tasks + 1U < n_max) || center + 1U == last)
+        {
+            tasks[n_tasks].first = start;
+            tasks[n_tasks].last = center + 1U;
+            cost[n_tasks] = sum;
+            ++n_tasks;
+
+            start = center + 1U;
+            sum = 0.0;
+        }
+    }
+
+    return n_tasks;
+}
+
+/*  Prints the statistics of the last run.                                    */
+static void rssringoccs_Tau_Schedule_Print(const rssringoccs_TAUObj *tau)
+{
+    unsigned int n;
+    const rssringoccs_Tau_Worker_Stats *stats;
+
+    for (n = 0U; n < tau->n_workers; ++n)
+    {
+        stats = tau->worker_stats + n;
+
+        printf("\tThread %u: %lu tasks (%lu stolen), %lu points, "
+               "%.1f%% busy.\n", n, stats->n_tasks, stats->n_stolen,
+               stats->n_points, stats->wall_seconds > 0.0 ?
+                   100.0 * stats->busy_seconds / stats->wall_seconds : 100.0);
+    }
+}
+
+/*  Adds the points of a finished task to the progress of the Tau object.     */
+static void
+rssringoccs_Tau_Schedule_Progress(rssringoccs_TAUObj *tau,
+                                  const rssringoccs_Tau_Task *task)
+{
+    const unsigned long n_points = (unsigned long)(task->last - task->first);
+    rssringoccs_Tau_Add_Progress(tau, n_points);
+}
+
+tmpl_Bool
+rssringoccs_Tau_Schedule(rssringoccs_TAUObj *tau,
+                         size_t first,
+                         size_t last,
+                         double two_dx,
+                         double point_cost,
+                         rssringoccs_Tau_Task_Func func,
+                         void *data,
+                         unsigned int n_threads)
+{
+    unsigned int n;
+    size_t k, n_tasks, n_max;
+    int failed = 0;
+    tmpl_Bool cancelled = tmpl_False;
+    double t_start, t_end, t0;
+    rssringoccs_Tau_Worker_Stats *stats;
+    rssringoccs_Tau_Task *tasks;
+    double *cost;
+
+    if (first >= last)
+        return tmpl_True;
+
+    /*  Without OpenMP everything is done by the calling thread.              */
+#ifdef _OPENMP
+    if (n_threads == 0U)
+        n_threads = 1U;
+#else
+    n_threads = 1U;
+#endif
+
+    /*  The statistics of the previous run are replaced.                      */
+    if (tau->n_workers != n_threads)
+    {
+        stats = realloc(tau->worker_stats, sizeof(*stats) * n_threads);
+
+        if (!stats)
+            return tmpl_False;
+
+        tau->worker_stats = stats;
+        tau->n_workers = n_threads;
+    }
+
+    for (n = 0U; n < n_threads; ++n)
+    {
+        tau->worker_stats[n].n_tasks = 0UL;
+        tau->worker_stats[n].n_stolen = 0UL;
+        tau->worker_stats[n].n_points = 0UL;
+        tau->worker_stats[n].cost = 0.0;
+        tau->worker_stats[n].busy_seconds = 0.0;
+    }
+
+    n_max = (size_t)n_threads * RSSRINGOCCS_TAU_TASKS_PER_THREAD;
+
+    if (n_max > last - first)
+        n_max = last - first;
+
+    tasks = malloc(sizeof(*tasks) * n_max);
+    cost = malloc(sizeof(*cost) * n_max);
+
+    if (!tasks || !cost)
+    {
+        free(tasks);
+        free(cost);
+        return tmpl_False;
+    }
+
+    n_tasks = rssringoccs_Tau_Schedule_Split(
+        tau, first, last, two_dx, point_cost, n_max, tasks, cost
+    );
+
+    t_start = rssringoccs_Tau_Schedule_Time();
+
+    /*  A single thread does the tasks in order.                              */
+    if (n_threads == 1U)
+    {
+        stats = tau->worker_stats;
+
+        for (k = 0U; k < n_tasks && !rssringoccs_Tau_Cancel_Requested(tau); ++k)
+        {
+            t0 = rssringoccs_Tau_Schedule_Time();
+
+            if (!func(tau, data, 0U, &tasks[k]))
+                failed = 1;
+
+            stats->busy_seconds += rssringoccs_Tau_Schedule_Time() - t0;
+            stats->n_tasks += 1UL;
+            stats->n_points += (unsigned long)(tasks[k].last - tasks[k].first);
+            stats->cost += cost[k];
+            rssringoccs_Tau_Schedule_Progress(tau, &tasks[k]);
+        }
+
+        cancelled = (k < n_tasks);
+    }
+
+#ifdef _OPENMP
+    else
+    {
+        /*  The tasks owned by thread n are tasks[head[n]] to tasks[tail[n]-1]*
+         *  The owner takes from the head, thieves take from the tail.        */
+        size_t *head, *tail;
+        omp_lock_t *lock;
+
+        head = malloc(sizeof(*head) * n_threads);
+        tail = malloc(sizeof(*tail) * n_threads);
+        lock = malloc(sizeof(*lock) * n_threads);
+
+        if (!head || !tail || !lock)
+        {
+            free(tasks);
+            free(cost);
+            free(head);
+            free(tail);
+            free(lock);
+            return tmpl_False;
+        }
+
+        for (n = 0U; n < n_threads; ++n)
+        {
+            head[n] = (n_tasks * n) / n_threads;
+            tail[n] = (n_tasks * (n + 1U)) / n_threads;
+            omp_init_lock(&lock[n]);
+        }
+
+#pragma omp parallel num_threads(n_threads) reduction(|:failed)
+        {
+            unsigned int victim, steps;
+            size_t m;
+            tmpl_Bool stolen;
+            double t1;
+
+            const unsigned int self = (unsigned int)omp_get_thread_num();
+            rssringoccs_Tau_Worker_Stats *mine = tau->worker_stats + self;
+
+            while (!rssringoccs_Tau_Cancel_Requested(tau))
+            {
+                /*  Take the next task of this thread, or steal one.          */
+                m = n_tasks;
+                stolen = tmpl_False;
+
+                omp_set_lock(&lock[self]);
+
+                if (head[self] < tail[self])
+                {
+                    m = head[self];
+                    head[self] += 1U;
+                }
+
+                omp_unset_lock(&lock[self]);
+
+                for (steps = 1U; m == n_tasks && steps < n_threads; ++steps)
+                {
+                    victim = (self + steps) % n_threads;
+                    omp_set_lock(&lock[victim]);
+
+                    if (head[victim] < tail[victim])
+                    {
+                        tail[victim] -= 1U;
+                        m = tail[victim];
+                        stolen = tmpl_True;
+                    }
+
+                    omp_unset_lock(&lock[victim]);
+                }
+
+                /*  Tasks are never added, so if none were found we are done. */
+                if (m == n_tasks)
+                    break;
+
+                t1 = rssringoccs_Tau_Schedule_Time();
+
+                if (!func(tau, data, self, &tasks[m]))
+                    failed = 1;
+
+                mine->busy_seconds += rssringoccs_Tau_Schedule_Time() - t1;
+                mine->n_tasks += 1UL;
+                mine->n_points += (unsigned long)(tasks[m].last -
+                                                  tasks[m].first);
+                mine->cost += cost[m];
+                rssringoccs_Tau_Schedule_Progress(tau, &tasks[m]);
+
+                if (stolen)
+                    mine->n_stolen += 1UL;
+            }
+        }
+
+        for (n = 0U; n < n_threads; ++n)
+        {
+            if (head[n] < tail[n])
+                cancelled = tmpl_True;
+
+            omp_destroy_lock(&lock[n]);
+        }
+
+        free(head);
+        free(tail);
+        free(lock);
+    }
+#endif
+
+    free(tasks);
+    free(cost);
+
+    t_end = rssringoccs_Tau_Schedule_Time();
+
+    for (n = 0U; n < n_threads; ++n)
+        tau->worker_stats[n].wall_seconds = t_end - t_start;
+
+    if (tau->verbose)
+        rssringoccs_Tau_Schedule_Print(tau);
+
+    /*  Tasks left undone leave part of T_out unset, which is an error.       */
+    if (cancelled)
+    {
+        if (!tau->error_occurred)
+        {
+            tau->error_occurred = tmpl_True;
+            tau->error_message = tmpl_strdup(
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Tau_Schedule\n\n"
+                "\rThe reconstruction was cancelled.\n\n"
+            );
+        }
+
+        return tmpl_False;
+    }
+
+    return (failed ? tmpl_False : tmpl_True);
+}
+/*  End of rssringoccs_Tau_Schedule.                                          */
@@ -0,0 +1,42 @@
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Tau_Thread_Count                                          *
+ *  Purpose:                                                                  *
+ *      Determine how many threads a reconstruction loop should use.          *
+ *  Arguments:                                                                *
+ *      tau (const rssringoccs_TAUObj *):                                     *
+ *          The Tau object. num_threads and n_used are read.                  *
+ *  Output:                                                                   *
+ *      n_threads (unsigned int):                                             *
+ *          The number of threads, at least one and at most n_used.           *
+ *  Notes:                                                                    *
+ *      1.) If the library was built without OpenMP this always returns one.  *
+ *      2.) tau->num_threads = 0 means use the thread pool, whose size is the *
+ *          OpenMP default unless set by rssringoccs_Thread_Pool_Configure.   *
+ ******************************************************************************/
+unsigned int rssringoccs_Tau_Thread_Count(const rssringoccs_TAUObj *tau)
+{
+#ifdef _OPENMP
+    unsigned int n_threads;
+
+    if (tau->num_threads == 0U)
+        n_threads = rssringoccs_Thread_Pool_Size();
+    else
+        n_threads = tau->num_threads;
+
+    /*  There is no point in having idle threads, and blocks must be nonempty.*/
+    if ((size_t)n_threads > tau->n_used)
+        n_threads = (unsigned int)tau->n_used;
+
+    if (n_threads == 0U)
+        n_threads = 1U;
+
+    return n_threads;
+#else
+    (void)tau;
+    return 1U;
+#endif
+}
+/*  End of rssringoccs_Tau_Thread_Count.                                      */
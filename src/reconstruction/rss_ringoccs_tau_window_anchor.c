@@ -0,0 +1,65 @@
+#include <math.h>
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Window_Anchor                                             *
+ *  Purpose:                                                                  *
+ *      Find the index of the point at which the window function in use at    *
+ *      a given center was last recomputed by the serial reconstruction loop. *
+ *  Arguments:                                                                *
+ *      w_km_vals (const double *):                                           *
+ *          The window widths, as set by rssringoccs_Tau_Get_Window_Width.    *
+ *      start (size_t):                                                       *
+ *          The first point of the reconstruction, tau->start.                *
+ *      center (size_t):                                                      *
+ *          The index of the point being reconstructed. Must satisfy          *
+ *          start <= center.                                                  *
+ *      two_dx (double):                                                      *
+ *          Twice the sample spacing used by the reconstruction loop.         *
+ *  Output:                                                                   *
+ *      anchor (size_t):                                                      *
+ *          The index at which the window in effect at center was built.      *
+ *  Notes:                                                                    *
+ *      1.) The serial loops start with the window at start and rebuild it    *
+ *          whenever the window width drifts by 2*dx or more from the width   *
+ *          the current window was built with. Since the window depends on    *
+ *          the point it was built at, a block of points that does not start  *
+ *          at start must replay this rule to reproduce the serial            *
+ *          result exactly. This is a linear scan over w_km_vals, which is    *
+ *          negligible next to the cost of a single window sum.               *
+ ******************************************************************************/
+size_t
+rssringoccs_Window_Anchor(const double *w_km_vals, size_t start,
+                          size_t center, double two_dx)
+{
+    /*  Index for the scan and the index of the last reset.                   */
+    size_t n;
+    size_t anchor = start;
+
+    /*  The window width the current window was built with.                   */
+    double w_init = w_km_vals[anchor];
+
+    /*  Replay the reset rule of the serial loop up to, and including, center.*/
+    for (n = start + 1UL; n <= center; ++n)
+    {
+        if (fabs(w_init - w_km_vals[n]) >= two_dx)
+        {
+            w_init = w_km_vals[n];
+            anchor = n;
+        }
+    }
+
+    return anchor;
+}
+/*  End of rssringoccs_Window_Anchor.                                         */
+
+/*  The same, for the window widths and starting index of a Tau object.       */
+size_t
+rssringoccs_Tau_Window_Anchor(const rssringoccs_TAUObj *tau,
+                              size_t center, double two_dx)
+{
+    return rssringoccs_Window_Anchor(tau->w_km_vals, tau->start,
+                                     center, two_dx);
+}
+/*  End of rssringoccs_Tau_Window_Anchor.                                     */
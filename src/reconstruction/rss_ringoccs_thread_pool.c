@@ -0,0 +1,306 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                        Reconstruction Thread Pool                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides the process-wide pool of threads the reconstructions run on. *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The threads themselves belong to the OpenMP runtime, which keeps the      *
+ *  workers of a parallel region alive and hands them to the next region      *
+ *  started from the same thread. What costs time is the first region, which  *
+ *  creates the threads, and regions asking for more threads than any before  *
+ *  them. The pool fixes the number of threads once for the whole process,    *
+ *  creates them the first time a reconstruction asks for them (or when the   *
+ *  pool is configured), and optionally pins each worker to a CPU. Every      *
+ *  reconstruction with tau->num_threads = 0 then runs on the same threads,   *
+ *  so batches of small reconstructions do not pay for thread creation.       *
+ *                                                                            *
+ *  Pinning uses sched_setaffinity and is only available on Linux. Worker n   *
+ *  is pinned to the n-th CPU (modulo their number) the process was allowed   *
+ *  to run on when the pool started. The calling thread takes part in every   *
+ *  region too but is left alone, since it belongs to the application.        *
+ *  Configuring the pool again with pinning off restores the original CPU     *
+ *  sets of the workers.                                                      *
+ *                                                                            *
+ *  Since OpenMP keeps a separate team for every thread that starts parallel  *
+ *  regions, the pool is the team of the thread that started it, the owner.   *
+ *  Reconstructions started from other threads, such as those of              *
+ *  reconstruct_async in the Python wrapper, use the same number of threads   *
+ *  but get a team of their own, which is neither pinned nor shared. Only     *
+ *  the reconstructions started by the owner are counted as uses of the pool. *
+ *                                                                            *
+ *  The state is guarded by a named OpenMP critical section. Configuring the  *
+ *  pool while a reconstruction is running is allowed, the new settings take  *
+ *  effect with the next reconstruction.                                      *
+ ******************************************************************************/
+
+/*  CPU affinity (sched.h) is a GNU extension. This has no effect if a libc   *
+ *  header was included before this file, as in the single translation unit   *
+ *  build, and pinning is then unavailable.                                   */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+/*  Function prototypes and tmpl_Bool are found here.                         */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  omp_get_max_threads and omp_get_thread_num are declared here.             */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*  The identity of the calling thread, used to tell the owner of the pool.   */
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+typedef pthread_t rssringoccs_Thread_Pool_Thread_Id;
+#define RSSRINGOCCS_THREAD_POOL_SELF() pthread_self()
+#define RSSRINGOCCS_THREAD_POOL_SAME(a, b) pthread_equal(a, b)
+#elif defined(_WIN32)
+#include <windows.h>
+typedef DWORD rssringoccs_Thread_Pool_Thread_Id;
+#define RSSRINGOCCS_THREAD_POOL_SELF() GetCurrentThreadId()
+#define RSSRINGOCCS_THREAD_POOL_SAME(a, b) ((a) == (b))
+#else
+typedef int rssringoccs_Thread_Pool_Thread_Id;
+#define RSSRINGOCCS_THREAD_POOL_SELF() 0
+#define RSSRINGOCCS_THREAD_POOL_SAME(a, b) ((a) == (b))
+#endif
+
+/*  sched_setaffinity and the cpu_set_t macros are declared here.             */
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/*  Pinning is possible if OpenMP is used and the CPU set macros exist.       */
+#if defined(_OPENMP) && defined(__linux__) && defined(CPU_SET)
+#define RSSRINGOCCS_THREAD_POOL_HAS_PINNING 1
+#else
+#define RSSRINGOCCS_THREAD_POOL_HAS_PINNING 0
+#endif
+
+/*  Requested number of threads (0 = OpenMP default) and pinning.             */
+static unsigned int rssringoccs_thread_pool_requested = 0U;
+static tmpl_Bool rssringoccs_thread_pool_pin = tmpl_False;
+
+/*  Number of threads of the running pool, zero if it has not started yet.    */
+static unsigned int rssringoccs_thread_pool_size = 0U;
+
+/*  Whether the workers of the running pool are pinned.                       */
+static tmpl_Bool rssringoccs_thread_pool_pinned = tmpl_False;
+
+/*  The thread whose OpenMP team is the pool. Valid once the pool started.    */
+static rssringoccs_Thread_Pool_Thread_Id rssringoccs_thread_pool_owner;
+
+/*  Number of reconstructions the owner has started on the pool.              */
+static unsigned long rssringoccs_thread_pool_uses = 0UL;
+
+#if RSSRINGOCCS_THREAD_POOL_HAS_PINNING
+/*  The CPUs the process could run on before anything was pinned.             */
+static cpu_set_t rssringoccs_thread_pool_cpus;
+static tmpl_Bool rssringoccs_thread_pool_has_cpus = tmpl_False;
+
+/*  Pins the calling worker, or restores its original CPU set if pin is       *
+ *  false. Returns false if the kernel refused.                               */
+static tmpl_Bool
+rssringoccs_Thread_Pool_Pin_Worker(unsigned int worker, tmpl_Bool pin)
+{
+    cpu_set_t cpus;
+    size_t n;
+    int count;
+    unsigned int target;
+
+    if (!pin)
+        return !sched_setaffinity(0, sizeof(cpus),
+                                  &rssringoccs_thread_pool_cpus);
+
+    count = CPU_COUNT(&rssringoccs_thread_pool_cpus);
+
+    if (count <= 0)
+        return tmpl_False;
+
+    /*  Find the (worker mod count)-th allowed CPU.                           */
+    target = worker % (unsigned int)count;
+
+    for (n = 0U; n < (size_t)CPU_SETSIZE; ++n)
+    {
+        if (!CPU_ISSET(n, &rssringoccs_thread_pool_cpus))
+            continue;
+
+        if (target == 0U)
+            break;
+
+        --target;
+    }
+
+    CPU_ZERO(&cpus);
+    CPU_SET(n, &cpus);
+    return !sched_setaffinity(0, sizeof(cpus), &cpus);
+}
+#endif
+
+/*  Creates the threads of the pool. Called inside the critical section.      */
+static void rssringoccs_Thread_Pool_Start(void)
+{
+#ifdef _OPENMP
+    unsigned int n_threads;
+    int pinned = 1;
+
+#if RSSRINGOCCS_THREAD_POOL_HAS_PINNING
+    const tmpl_Bool pin = rssringoccs_thread_pool_pin;
+    const tmpl_Bool unpin = (!pin && rssringoccs_thread_pool_pinned);
+
+    if (!rssringoccs_thread_pool_has_cpus)
+    {
+        if (sched_getaffinity(0, sizeof(rssringoccs_thread_pool_cpus),
+                              &rssringoccs_thread_pool_cpus) == 0)
+            rssringoccs_thread_pool_has_cpus = tmpl_True;
+    }
+#endif
+
+    if (rssringoccs_thread_pool_requested == 0U)
+        n_threads = (unsigned int)omp_get_max_threads();
+    else
+        n_threads = rssringoccs_thread_pool_requested;
+
+    if (n_threads == 0U)
+        n_threads = 1U;
+
+    /*  An empty region creates the workers, which then wait for the next.    */
+#pragma omp parallel num_threads(n_threads) reduction(&:pinned)
+    {
+#if RSSRINGOCCS_THREAD_POOL_HAS_PINNING
+        const unsigned int self = (unsigned int)omp_get_thread_num();
+
+        if (self > 0U && rssringoccs_thread_pool_has_cpus && (pin || unpin))
+            pinned = (int)rssringoccs_Thread_Pool_Pin_Worker(self, pin);
+        else
+            pinned = 1;
+#else
+        pinned = 1;
+#endif
+    }
+
+    rssringoccs_thread_pool_size = n_threads;
+    rssringoccs_thread_pool_owner = RSSRINGOCCS_THREAD_POOL_SELF();
+
+#if RSSRINGOCCS_THREAD_POOL_HAS_PINNING
+    rssringoccs_thread_pool_pinned = (pin && pinned &&
+                                      rssringoccs_thread_pool_has_cpus);
+#else
+    (void)pinned;
+    rssringoccs_thread_pool_pinned = tmpl_False;
+#endif
+
+#else
+    rssringoccs_thread_pool_size = 1U;
+    rssringoccs_thread_pool_pinned = tmpl_False;
+    rssringoccs_thread_pool_owner = RSSRINGOCCS_THREAD_POOL_SELF();
+#endif
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Thread_Pool_Configure                                     *
+ *  Purpose:                                                                  *
+ *      Sets the number of threads of the pool and whether they are pinned,   *
+ *      and (re)starts the pool with these settings.                          *
+ *  Arguments:                                                                *
+ *      n_threads (unsigned int):                                             *
+ *          The number of threads, zero for the OpenMP default.               *
+ *      pin (tmpl_Bool):                                                      *
+ *          Whether to pin each worker to its own CPU.                        *
+ ******************************************************************************/
+void rssringoccs_Thread_Pool_Configure(unsigned int n_threads, tmpl_Bool pin)
+{
+#ifdef _OPENMP
+#pragma omp critical(rssringoccs_thread_pool)
+#endif
+    {
+        rssringoccs_thread_pool_requested = n_threads;
+        rssringoccs_thread_pool_pin = pin;
+        rssringoccs_Thread_Pool_Start();
+    }
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Thread_Pool_Size                                          *
+ *  Purpose:                                                                  *
+ *      Returns the number of threads of the pool, starting it if needed.     *
+ *      The call counts as a use of the pool if made by its owner.            *
+ *  Output:                                                                   *
+ *      n_threads (unsigned int):                                             *
+ *          The number of threads, one if built without OpenMP.               *
+ ******************************************************************************/
+unsigned int rssringoccs_Thread_Pool_Size(void)
+{
+    unsigned int n_threads;
+
+#ifdef _OPENMP
+#pragma omp critical(rssringoccs_thread_pool)
+#endif
+    {
+        if (rssringoccs_thread_pool_size == 0U)
+            rssringoccs_Thread_Pool_Start();
+
+        /*  Other threads get OpenMP teams of their own, not the pool.        */
+        if (RSSRINGOCCS_THREAD_POOL_SAME(rssringoccs_thread_pool_owner,
+                                         RSSRINGOCCS_THREAD_POOL_SELF()))
+            ++rssringoccs_thread_pool_uses;
+        n_threads = rssringoccs_thread_pool_size;
+    }
+
+    return n_threads;
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Thread_Pool_Info                                          *
+ *  Purpose:                                                                  *
+ *      Reports the state of the pool without starting it.                    *
+ *  Arguments:                                                                *
+ *      n_threads (unsigned int *):                                           *
+ *          The number of threads, zero if the pool has not started.          *
+ *      pinned (tmpl_Bool *):                                                 *
+ *          Whether the workers are pinned.                                   *
+ *      uses (unsigned long *):                                               *
+ *          The number of reconstructions that have run on the pool, that is, *
+ *          that were started by the thread owning it.                        *
+ ******************************************************************************/
+void
+rssringoccs_Thread_Pool_Info(unsigned int *n_threads,
+                             tmpl_Bool *pinned,
+                             unsigned long *uses)
+{
+#ifdef _OPENMP
+#pragma omp critical(rssringoccs_thread_pool)
+#endif
+    {
+        *n_threads = rssringoccs_thread_pool_size;
+        *pinned = rssringoccs_thread_pool_pinned;
+        *uses = rssringoccs_thread_pool_uses;
+    }
+}
+/*  End of rssringoccs_Thread_Pool_Info.                                      */
+
+#undef RSSRINGOCCS_THREAD_POOL_HAS_PINNING
+#undef RSSRINGOCCS_THREAD_POOL_SELF
+#undef RSSRINGOCCS_THREAD_POOL_SAME
@@ -0,0 +1,292 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                          Window Function Cache                             *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides a process-wide cache of tabulated window functions. The      *
+ *      reconstruction loops rebuild their window every time the window width *
+ *      drifts by 2*dx, and the Kaiser-Bessel windows require a Bessel I0     *
+ *      evaluation per sample. For long occultations with slowly varying F    *
+ *      the same window is rebuilt thousands of times. With the cache each    *
+ *      (window function, window size) pair is tabulated once.                *
+ *  Notes:                                                                    *
+ *      1.) All of the window functions depend only on the ratio x / W. A     *
+ *          table is indexed by the half-width k = (nw_pts - 1) / 2 of the    *
+ *          symmetric window (nw_pts = 2k+1), and stores                      *
+ *                                                                            *
+ *              table[n] = fw(n - (k+1), 2k+1),    n = 0, 1, ..., 2k+2.       *
+ *                                                                            *
+ *          That is, x is measured in units of dx and the window width is the *
+ *          nominal width (2k+1)*dx. The full symmetric window used by the    *
+ *          Newton transforms is table[1], ..., table[2k+1], and the left     *
+ *          half-window used by the Fresnel and Legendre transforms is        *
+ *          table[0], ..., table[k].                                          *
+ *      2.) Since the nominal width replaces the exact width (which may be    *
+ *          anywhere in [2k*dx, (2k+2)*dx)), results differ from the direct   *
+ *          computation at the level of the 2*dx tolerance the loops already  *
+ *          accept when reusing a window. This is why the cache is opt-in via *
+ *          tau->use_window_cache.                                            *
+ *      3.) Tables are never modified after insertion, and are only freed by  *
+ *          rssringoccs_Window_Cache_Clear. Lookups and insertions are        *
+ *          serialized with a process-wide mutex, a pthread mutex on POSIX    *
+ *          systems and an SRW lock on Windows, whether or not the library    *
+ *          is built with OpenMP. Several reconstructions may run at once     *
+ *          from different threads. On other systems there is no lock,        *
+ *          and rssringoccs_Window_Cache_Get always returns NULL.             *
+ *      4.) The total size is capped by RSSRINGOCCS_WINDOW_CACHE_MAX_BYTES.   *
+ *          Once the cap is reached new tables are not stored and lookups of  *
+ *          uncached tables return NULL, in which case the caller computes    *
+ *          the window itself.                                                *
+ ******************************************************************************/
+
+/*  malloc and free are found here.                                           */
+#include <stdlib.h>
+
+/*  The mutex guarding the cache. Statically initialized, so no setup call.   */
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+static pthread_mutex_t
+rssringoccs_window_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define RSSRINGOCCS_WINDOW_CACHE_HAS_LOCK 1
+#define RSSRINGOCCS_WINDOW_CACHE_LOCK()                                        \
+    pthread_mutex_lock(&rssringoccs_window_cache_mutex)
+#define RSSRINGOCCS_WINDOW_CACHE_UNLOCK()                                      \
+    pthread_mutex_unlock(&rssringoccs_window_cache_mutex)
+#elif defined(_WIN32)
+#include <windows.h>
+static SRWLOCK rssringoccs_window_cache_mutex = SRWLOCK_INIT;
+#define RSSRINGOCCS_WINDOW_CACHE_HAS_LOCK 1
+#define RSSRINGOCCS_WINDOW_CACHE_LOCK()                                        \
+    AcquireSRWLockExclusive(&rssringoccs_window_cache_mutex)
+#define RSSRINGOCCS_WINDOW_CACHE_UNLOCK()                                      \
+    ReleaseSRWLockExclusive(&rssringoccs_window_cache_mutex)
+#else
+#define RSSRINGOCCS_WINDOW_CACHE_HAS_LOCK 0
+#define RSSRINGOCCS_WINDOW_CACHE_LOCK()
+#define RSSRINGOCCS_WINDOW_CACHE_UNLOCK()
+#endif
+
+/*  Function prototypes and the window function typedef are here.             */
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+
+/*  Number of buckets in the hash table. The key is the half-width k.         */
+#define RSSRINGOCCS_WINDOW_CACHE_BUCKETS (256U)
+
+/*  A single cached table, stored as a node in a singly linked list.          */
+typedef struct rssringoccs_Window_Cache_Entry_Def {
+    rssringoccs_Window_Function fw;
+    size_t half_width;
+    double *table;
+    struct rssringoccs_Window_Cache_Entry_Def *next;
+} rssringoccs_Window_Cache_Entry;
+
+/*  The state of the cache. Only accessed with the mutex held.                */
+static rssringoccs_Window_Cache_Entry
+*rssringoccs_window_cache_buckets[RSSRINGOCCS_WINDOW_CACHE_BUCKETS];
+
+static unsigned long rssringoccs_window_cache_hits = 0UL;
+static unsigned long rssringoccs_window_cache_misses = 0UL;
+static size_t rssringoccs_window_cache_bytes = 0U;
+
+/*  Searches a bucket for a table. Must be called with the mutex held.        */
+static double *
+rssringoccs_Window_Cache_Find(rssringoccs_Window_Function fw, size_t k)
+{
+    const size_t bucket = k % RSSRINGOCCS_WINDOW_CACHE_BUCKETS;
+    rssringoccs_Window_Cache_Entry *entry;
+    entry = rssringoccs_window_cache_buckets[bucket];
+
+    while (entry)
+    {
+        if ((entry->fw == fw) && (entry->half_width == k))
+            return entry->table;
+
+        entry = entry->next;
+    }
+
+    return NULL;
+}
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Window_Cache_Get                                          *
+ *  Purpose:                                                                  *
+ *      Returns the tabulated window for a given window function and size,    *
+ *      computing and storing it if it is not in the cache yet.               *
+ *  Arguments:                                                                *
+ *      fw (rssringoccs_Window_Function):                                     *
+ *          The window function, as set by rssringoccs_Tau_Set_Window_Type.   *
+ *      half_width (size_t):                                                  *
+ *          The half-width k of the window, nw_pts = 2k+1.                    *
+ *  Output:                                                                   *
+ *      table (const double *):                                               *
+ *          Read-only array with 2k+3 elements (see the notes at the top of   *
+ *          this file). NULL if malloc fails, the cache is full, or there is  *
+ *          no mutex on this system.                                          *
+ ******************************************************************************/
+const double *
+rssringoccs_Window_Cache_Get(rssringoccs_Window_Function fw, size_t half_width)
+{
+    double *table;
+    double *computed;
+    size_t n;
+    const size_t len = 2U*half_width + 3U;
+    const double width = (double)(2U*half_width + 1U);
+    const double shift = (double)(half_width + 1U);
+    rssringoccs_Window_Cache_Entry *entry;
+    tmpl_Bool is_full;
+
+    /*  Without a mutex the cache cannot be shared between threads safely.    *
+     *  The caller computes the window itself.                                */
+    if (!RSSRINGOCCS_WINDOW_CACHE_HAS_LOCK)
+        return NULL;
+
+    RSSRINGOCCS_WINDOW_CACHE_LOCK();
+    table = rssringoccs_Window_Cache_Find(fw, half_width);
+
+    if (table)
+        ++rssringoccs_window_cache_hits;
+    else
+        ++rssringoccs_window_cache_misses;
+
+    is_full = (rssringoccs_window_cache_bytes + len*sizeof(*table) >
+               RSSRINGOCCS_WINDOW_CACHE_MAX_BYTES);
+    RSSRINGOCCS_WINDOW_CACHE_UNLOCK();
+
+    if (table)
+        return table;
+
+    /*  Refuse to grow beyond the cap. The caller computes the window itself. */
+    if (is_full)
+        return NULL;
+
+    /*  Compute the table without holding the mutex so that other threads     *
+     *  may use the cache while the window function is evaluated.             */
+    computed = malloc(sizeof(*computed) * len);
+    entry = malloc(sizeof(*entry));
+
+    if (!computed || !entry)
+    {
+        free(computed);
+        free(entry);
+        return NULL;
+    }
+
+    for (n = 0U; n < len; ++n)
+        computed[n] = fw((double)n - shift, width);
+
+    RSSRINGOCCS_WINDOW_CACHE_LOCK();
+
+    /*  Another thread may have inserted the same table in the meantime.      */
+    table = rssringoccs_Window_Cache_Find(fw, half_width);
+
+    if (!table)
+    {
+        n = half_width % RSSRINGOCCS_WINDOW_CACHE_BUCKETS;
+        entry->fw = fw;
+        entry->half_width = half_width;
+        entry->table = computed;
+        entry->next = rssringoccs_window_cache_buckets[n];
+        rssringoccs_window_cache_buckets[n] = entry;
+        rssringoccs_window_cache_bytes += len*sizeof(*computed);
+        table = computed;
+        computed = NULL;
+        entry = NULL;
+    }
+
+    RSSRINGOCCS_WINDOW_CACHE_UNLOCK();
+
+    /*  These are NULL unless another thread won the race.                    */
+    free(computed);
+    free(entry);
+    return table;
+}
+/*  End of rssringoccs_Window_Cache_Get.                                      */
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Window_Cache_Stats                                        *
+ *  Purpose:                                                                  *
+ *      Reports the number of cache hits and misses since the last clear,     *
+ *      and the number of bytes held by the cache.                            *
+ *  Arguments:                                                                *
+ *      hits (unsigned long *), misses (unsigned long *), n_bytes (size_t *): *
+ *          Pointers the statistics are written to. Any may be NULL.          *
+ ******************************************************************************/
+void
+rssringoccs_Window_Cache_Stats(unsigned long *hits,
+                               unsigned long *misses,
+                               size_t *n_bytes)
+{
+    RSSRINGOCCS_WINDOW_CACHE_LOCK();
+
+    if (hits)
+        *hits = rssringoccs_window_cache_hits;
+
+    if (misses)
+        *misses = rssringoccs_window_cache_misses;
+
+    if (n_bytes)
+        *n_bytes = rssringoccs_window_cache_bytes;
+
+    RSSRINGOCCS_WINDOW_CACHE_UNLOCK();
+}
+/*  End of rssringoccs_Window_Cache_Stats.                                    */
+
+/******************************************************************************
+ *  Function:                                                                 *
+ *      rssringoccs_Window_Cache_Clear                                        *
+ *  Purpose:                                                                  *
+ *      Frees every cached table and resets the statistics.                   *
+ *  Notes:                                                                    *
+ *      Pointers previously returned by rssringoccs_Window_Cache_Get are      *
+ *      invalidated. Do not call this while a reconstruction is running.      *
+ ******************************************************************************/
+void rssringoccs_Window_Cache_Clear(void)
+{
+    unsigned int n;
+    rssringoccs_Window_Cache_Entry *entry, *next;
+
+    RSSRINGOCCS_WINDOW_CACHE_LOCK();
+
+    for (n = 0U; n < RSSRINGOCCS_WINDOW_CACHE_BUCKETS; ++n)
+    {
+        entry = rssringoccs_window_cache_buckets[n];
+
+        while (entry)
+        {
+            next = entry->next;
+            free(entry->table);
+            free(entry);
+            entry = next;
+        }
+
+        rssringoccs_window_cache_buckets[n] = NULL;
+    }
+
+    rssringoccs_window_cache_hits = 0UL;
+    rssringoccs_window_cache_misses = 0UL;
+    rssringoccs_window_cache_bytes = 0U;
+    RSSRINGOCCS_WINDOW_CACHE_UNLOCK();
+}
+/*  End of rssringoccs_Window_Cache_Clear.                                    */
+
+#undef RSSRINGOCCS_WINDOW_CACHE_HAS_LOCK
+#undef RSSRINGOCCS_WINDOW_CACHE_LOCK
+#undef RSSRINGOCCS_WINDOW_CACHE_UNLOCK
@@ -0,0 +1,251 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                               Tau Arena                                    *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Places the arrays of a Tau object in one block of memory.             *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  The arena holds one slot per array, in the order                          *
+ *                                                                            *
+ *      T_in, T_out, F_km_vals, k_vals, w_km_vals, rho_dot_kms_vals,          *
+ *      rho_km_vals, phi_deg_vals, ..., rz_km_vals, T_fwd                     *
+ *                                                                            *
+ *  with the members copied from the DLP object in the order of               *
+ *  rssringoccs_TAUObj. tau_threshold_vals is left out, since it is not       *
+ *  computed. Every slot is rounded up to a multiple of                       *
+ *  RSSRINGOCCS_TAU_ARENA_ALIGN bytes, and the first starts on a boundary.    *
+ *  The DLP slots are left out if the DLP members are borrowed, and T_fwd is  *
+ *  last so that it may be left out too. The offsets of the other slots only  *
+ *  depend on arr_size.                                                       *
+ ******************************************************************************/
+
+/*  malloc, calloc, and NULL are found here.                                  */
+#include <stdlib.h>
+
+/*  memset is found here.                                                     */
+#include <string.h>
+
+/*  Booleans and complex numbers provided here.                               */
+#include <libtmpl/include/tmpl.h>
+
+/*  Header file with the Tau definition and function prototypes.              */
+#include <rss_ringoccs/include/rss_ringoccs_tau.h>
+
+/*  Alignment, in bytes, of every slot of the arena.                          */
+#define RSSRINGOCCS_TAU_ARENA_ALIGN (64)
+
+/*  Number of double slots, with and without the DLP members, and the index   *
+ *  of w_km_vals among them.                                                  */
+#define RSSRINGOCCS_TAU_ARENA_N_DOUBLES (17)
+#define RSSRINGOCCS_TAU_ARENA_N_OWNED (4)
+#define RSSRINGOCCS_TAU_ARENA_W_KM (2)
+
+/*  Rounds n up to a multiple of RSSRINGOCCS_TAU_ARENA_ALIGN.                 */
+static size_t rssringoccs_Tau_Arena_Round(size_t n)
+{
+    const size_t align = RSSRINGOCCS_TAU_ARENA_ALIGN;
+    return ((n + align - 1) / align) * align;
+}
+/*  End of rssringoccs_Tau_Arena_Round.                                       */
+
+/*  Returns the first aligned byte of the arena. The conversion of a pointer  *
+ *  to an integer is implementation defined, but is the address everywhere    *
+ *  this library is built.                                                    */
+static unsigned char *
+rssringoccs_Tau_Arena_Base(const rssringoccs_TAUObj *tau)
+{
+    const size_t align = RSSRINGOCCS_TAU_ARENA_ALIGN;
+    unsigned char *arena = tau->arena;
+    const size_t misalign = (size_t)arena % align;
+
+    if (misalign == 0)
+        return arena;
+
+    return arena + (align - misalign);
+}
+/*  End of rssringoccs_Tau_Arena_Base.                                        */
+
+/*  Sets a double member to its slot of the arena.                            */
+#define SET_ARENA_VAR(var, n)                                                  \
+    tau->var = (double *)(base + 2*c_size + (n)*d_size);
+
+/*  Function for allocating the members of a Tau object in one block.         */
+void rssringoccs_Tau_Malloc_Arena(rssringoccs_TAUObj *tau)
+{
+    unsigned char *base;
+    size_t c_size, d_size, n_doubles, n_bytes;
+
+    /*  Twice the number of complex slots, plus the double slots, bounds the  *
+     *  arena by this many doubles per point.                                 */
+    const size_t per_point = 6 + RSSRINGOCCS_TAU_ARENA_N_DOUBLES;
+    const size_t padding = RSSRINGOCCS_TAU_ARENA_ALIGN * per_point;
+    const size_t max_size = ((size_t)-1 - padding) /
+                            (sizeof(double) * per_point);
+
+    if (!tau)
+        return;
+
+    if (tau->error_occurred)
+        return;
+
+    if (tau->arena != NULL || tau->rho_km_vals != NULL || tau->T_in != NULL)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_String_Duplicate(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Tau_Malloc_Arena\n\n"
+            "\rThe members of tau are not NULL. It is likely you've already\n"
+            "\rset the data for this tau object. Returning.\n"
+        );
+        return;
+    }
+
+    if (tau->arr_size > max_size)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_String_Duplicate(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Tau_Malloc_Arena\n\n"
+            "\rInput tau has arr_size too large for an arena. Returning.\n\n"
+        );
+        return;
+    }
+
+    c_size = rssringoccs_Tau_Arena_Round(sizeof(tmpl_ComplexDouble) *
+                                         tau->arr_size);
+    d_size = rssringoccs_Tau_Arena_Round(sizeof(double) * tau->arr_size);
+
+    if (tau->borrow_dlp)
+        n_doubles = RSSRINGOCCS_TAU_ARENA_N_OWNED;
+    else
+        n_doubles = RSSRINGOCCS_TAU_ARENA_N_DOUBLES;
+
+    /*  The extra RSSRINGOCCS_TAU_ARENA_ALIGN bytes leave room to align.      */
+    n_bytes = 2*c_size + n_doubles*d_size + RSSRINGOCCS_TAU_ARENA_ALIGN;
+
+    if (tau->use_fwd)
+        n_bytes += c_size;
+
+    tau->arena = malloc(n_bytes);
+
+    if (tau->arena == NULL)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_String_Duplicate(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Tau_Malloc_Arena\n\n"
+            "\rMalloc failed and returned NULL for the arena. Returning.\n\n"
+        );
+        return;
+    }
+
+    tau->arena_bytes = n_bytes;
+    base = rssringoccs_Tau_Arena_Base(tau);
+
+    /*  T_out, T_fwd, and w_km_vals are handed out by                         *
+     *  rssringoccs_Tau_Calloc_Slot when they are needed.                     */
+    tau->T_in = (tmpl_ComplexDouble *)base;
+    SET_ARENA_VAR(F_km_vals, 0)
+    SET_ARENA_VAR(k_vals, 1)
+    SET_ARENA_VAR(rho_dot_kms_vals, 3)
+
+    /*  Borrowed members are set by rssringoccs_Tau_Copy_DLP_Members.         */
+    if (tau->borrow_dlp)
+    {
+        tau->dlp_storage = rssringoccs_Tau_DLP_Borrowed;
+        return;
+    }
+
+    SET_ARENA_VAR(rho_km_vals, 4)
+    SET_ARENA_VAR(phi_deg_vals, 5)
+    SET_ARENA_VAR(B_deg_vals, 6)
+    SET_ARENA_VAR(D_km_vals, 7)
+    SET_ARENA_VAR(t_oet_spm_vals, 8)
+    SET_ARENA_VAR(t_ret_spm_vals, 9)
+    SET_ARENA_VAR(t_set_spm_vals, 10)
+    SET_ARENA_VAR(rho_corr_pole_km_vals, 11)
+    SET_ARENA_VAR(rho_corr_timing_km_vals, 12)
+    SET_ARENA_VAR(phi_rl_deg_vals, 13)
+    SET_ARENA_VAR(rx_km_vals, 14)
+    SET_ARENA_VAR(ry_km_vals, 15)
+    SET_ARENA_VAR(rz_km_vals, 16)
+    tau->dlp_storage = rssringoccs_Tau_DLP_In_Arena;
+}
+/*  End of rssringoccs_Tau_Malloc_Arena.                                      */
+
+#undef SET_ARENA_VAR
+
+/*  Function for allocating T_out, T_fwd, or w_km_vals.                       */
+void *
+rssringoccs_Tau_Calloc_Slot(rssringoccs_TAUObj *tau,
+                            rssringoccs_Tau_Slot_Enum slot)
+{
+    unsigned char *base, *ptr;
+    size_t c_size, d_size, n_doubles, size, offset;
+
+    if (!tau)
+        return NULL;
+
+    if (slot == rssringoccs_Tau_Slot_W_Km)
+        size = sizeof(double);
+    else
+        size = sizeof(tmpl_ComplexDouble);
+
+    if (tau->arena == NULL)
+        return calloc(tau->arr_size, size);
+
+    c_size = rssringoccs_Tau_Arena_Round(sizeof(tmpl_ComplexDouble) *
+                                         tau->arr_size);
+    d_size = rssringoccs_Tau_Arena_Round(sizeof(double) * tau->arr_size);
+
+    if (slot == rssringoccs_Tau_Slot_T_Out)
+        offset = c_size;
+
+    else if (slot == rssringoccs_Tau_Slot_W_Km)
+        offset = 2*c_size + RSSRINGOCCS_TAU_ARENA_W_KM*d_size;
+
+    else
+    {
+        /*  The DLP slots are only there if the members were put in them.     *
+         *  Members owned later by rssringoccs_Tau_Own_DLP_Members are not.   */
+        if (tau->dlp_storage == rssringoccs_Tau_DLP_In_Arena)
+            n_doubles = RSSRINGOCCS_TAU_ARENA_N_DOUBLES;
+        else
+            n_doubles = RSSRINGOCCS_TAU_ARENA_N_OWNED;
+
+        offset = 2*c_size + n_doubles*d_size;
+
+        /*  The T_fwd slot is only there if use_fwd was set in time.          */
+        if (offset + c_size + RSSRINGOCCS_TAU_ARENA_ALIGN > tau->arena_bytes)
+            return NULL;
+    }
+
+    base = rssringoccs_Tau_Arena_Base(tau);
+    ptr = base + offset;
+    memset(ptr, 0, size * tau->arr_size);
+    return ptr;
+}
+/*  End of rssringoccs_Tau_Calloc_Slot.                                       */
+
+#undef RSSRINGOCCS_TAU_ARENA_ALIGN
+#undef RSSRINGOCCS_TAU_ARENA_N_DOUBLES
+#undef RSSRINGOCCS_TAU_ARENA_N_OWNED
+#undef RSSRINGOCCS_TAU_ARENA_W_KM
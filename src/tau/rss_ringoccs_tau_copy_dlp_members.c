@@ -66,6 +66,30 @@ rssringoccs_Tau_Copy_DLP_Members(rssringoccs_TAUObj *tau,
         return;
     }
 
+    /*  Borrowed members reference the arrays of the DLP object. Only         *
+     *  rho_dot_kms_vals, which may be modified, is copied.                   */
+    if (tau->dlp_storage == rssringoccs_Tau_DLP_Borrowed)
+    {
+        tau->rho_km_vals = dlp->rho_km_vals;
+        tau->phi_deg_vals = dlp->phi_deg_vals;
+        tau->B_deg_vals = dlp->B_deg_vals;
+        tau->D_km_vals = dlp->D_km_vals;
+        tau->t_oet_spm_vals = dlp->t_oet_spm_vals;
+        tau->t_ret_spm_vals = dlp->t_ret_spm_vals;
+        tau->t_set_spm_vals = dlp->t_set_spm_vals;
+        tau->rho_corr_pole_km_vals = dlp->rho_corr_pole_km_vals;
+        tau->rho_corr_timing_km_vals = dlp->rho_corr_timing_km_vals;
+        tau->phi_rl_deg_vals = dlp->phi_rl_deg_vals;
+        tau->rx_km_vals = dlp->rx_km_vals;
+        tau->ry_km_vals = dlp->ry_km_vals;
+        tau->rz_km_vals = dlp->rz_km_vals;
+
+        for (n = zero; n < tau->arr_size; ++n)
+            tau->rho_dot_kms_vals[n] = dlp->rho_dot_kms_vals[n];
+
+        return;
+    }
+
     /*  Copy the data from the DLP object to the Tau object.                  */
     for (n = zero; n < tau->arr_size; ++n)
     {
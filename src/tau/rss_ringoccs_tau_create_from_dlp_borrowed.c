@@ -0,0 +1,102 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                     Tau Create From DLP, Borrowed                          *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Creates a Tau object that references the members of a DLP object.     *
+ ******************************************************************************/
+
+/*  NULL pointers are given here.                                             */
+#include <stdlib.h>
+
+/*  Booleans provided by this library.                                        */
+#include <libtmpl/include/tmpl.h>
+
+/*  Header file with the Tau definition and function prototype.               */
+#include <rss_ringoccs/include/rss_ringoccs_tau.h>
+
+/*  Function for creating a Tau object that borrows the data of a DLP.        */
+rssringoccs_TAUObj *
+rssringoccs_Tau_Create_From_DLP_Borrowed(const rssringoccs_DLPObj *dlp,
+                                         double res)
+{
+    /*  Try to allocate memory for a new tau object.                          */
+    rssringoccs_TAUObj *tau = malloc(sizeof(*tau));
+
+    /*  malloc returns NULL on failure. Check for this.                       */
+    if (!tau)
+        return NULL;
+
+    /*  Initialize all values to the zero values or their defaults.           */
+    rssringoccs_Tau_Init(tau);
+
+    /*  Reference the DLP members instead of copying them.                    */
+    tau->borrow_dlp = tmpl_True;
+
+    /*  Check if the input dlp is NULL. This is treated as an error.          */
+    if (!dlp)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_String_Duplicate(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Tau_Create_From_DLP_Borrowed\n\n"
+            "\rInput dlp is NULL. Returning.\n"
+        );
+
+        return tau;
+    }
+
+    /*  Check if the input dlp has its error_occurred member set to true.     *
+     *  Again, this is treated as an error for the Tau object.                */
+    if (dlp->error_occurred)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_String_Duplicate(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Tau_Create_From_DLP_Borrowed\n\n"
+            "\rInput dlp has error_occurred set to true. Returning.\n"
+        );
+
+        return tau;
+    }
+
+    /*  Set the resolution variable to the user-provided input.               */
+    tau->res = res;
+
+    /*  Check that the resolution is a legal value.                           */
+    if (tau->res <= 0.0)
+    {
+        tau->error_occurred = tmpl_True;
+        tau->error_message = tmpl_String_Duplicate(
+            "\n\rError Encountered: rss_ringoccs\n"
+            "\r\trssringoccs_Tau_Create_From_DLP_Borrowed\n\n"
+            "\rInput res is not positive. Returning.\n"
+        );
+
+        return tau;
+    }
+
+    /*  Most of the variables for the Tau object can be computed directly     *
+     *  from the data in the DLP object. The only variables that are not set  *
+     *  after this function is called (and are still their zero values or     *
+     *  NULL) are the reconstruction and forward modeling variables.          */
+    rssringoccs_Tau_Copy_DLP_Data(dlp, tau);
+    return tau;
+}
+/*  End of rssringoccs_Tau_Create_From_DLP_Borrowed.                          */
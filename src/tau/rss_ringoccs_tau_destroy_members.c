@@ -26,6 +26,9 @@
 /*  Macro for freeing and nullifying the members of the geo CSV structs.      */
 #define DESTROY_TAU_VAR(var) if (var != NULL){free(var); var = NULL;}
 
+/*  Macro for nullifying the members of a tau object it did not allocate.     */
+#define FORGET_TAU_VAR(var) var = NULL;
+
 /*  Function for freeing all member of a tau object except the error message. */
 void rssringoccs_Tau_Destroy_Members(rssringoccs_TAUObj *tau)
 {
@@ -33,6 +36,40 @@ void rssringoccs_Tau_Destroy_Members(rssringoccs_TAUObj *tau)
     if (tau == NULL)
         return;
 
+    /*  The DLP members are only freed if they were allocated one at a time.  *
+     *  Otherwise they belong to the arena or to the DLP object.              */
+    if (tau->dlp_storage != rssringoccs_Tau_DLP_Owned)
+    {
+        FORGET_TAU_VAR(tau->rho_km_vals)
+        FORGET_TAU_VAR(tau->phi_deg_vals)
+        FORGET_TAU_VAR(tau->B_deg_vals)
+        FORGET_TAU_VAR(tau->D_km_vals)
+        FORGET_TAU_VAR(tau->t_oet_spm_vals)
+        FORGET_TAU_VAR(tau->t_ret_spm_vals)
+        FORGET_TAU_VAR(tau->t_set_spm_vals)
+        FORGET_TAU_VAR(tau->rho_corr_pole_km_vals)
+        FORGET_TAU_VAR(tau->rho_corr_timing_km_vals)
+        FORGET_TAU_VAR(tau->phi_rl_deg_vals)
+        FORGET_TAU_VAR(tau->rx_km_vals)
+        FORGET_TAU_VAR(tau->ry_km_vals)
+        FORGET_TAU_VAR(tau->rz_km_vals)
+        tau->dlp_storage = rssringoccs_Tau_DLP_Owned;
+    }
+
+    /*  The arrays of an arena are freed together, with the arena itself.     */
+    if (tau->arena != NULL)
+    {
+        FORGET_TAU_VAR(tau->F_km_vals)
+        FORGET_TAU_VAR(tau->k_vals)
+        FORGET_TAU_VAR(tau->rho_dot_kms_vals)
+        FORGET_TAU_VAR(tau->w_km_vals)
+        FORGET_TAU_VAR(tau->T_in)
+        FORGET_TAU_VAR(tau->T_out)
+        FORGET_TAU_VAR(tau->T_fwd)
+        DESTROY_TAU_VAR(tau->arena)
+        tau->arena_bytes = 0;
+    }
+
     /*  Use the DESTROY_TAU_VAR macro to free and NULLify all pointers.       */
     DESTROY_TAU_VAR(tau->rho_km_vals)
     DESTROY_TAU_VAR(tau->F_km_vals)
@@ -55,5 +92,10 @@ void rssringoccs_Tau_Destroy_Members(rssringoccs_TAUObj *tau)
     DESTROY_TAU_VAR(tau->T_in)
     DESTROY_TAU_VAR(tau->T_out)
     DESTROY_TAU_VAR(tau->T_fwd)
+    DESTROY_TAU_VAR(tau->worker_stats)
+    tau->n_workers = 0U;
 }
 /*  End of rssringoccs_Tau_Destroy_Members.                                   */
+
+#undef DESTROY_TAU_VAR
+#undef FORGET_TAU_VAR
@@ -44,11 +44,21 @@ void rssringoccs_Tau_Init(rssringoccs_TAUObj *tau)
     tau->rx_km_vals = NULL;
     tau->ry_km_vals = NULL;
     tau->rz_km_vals = NULL;
+    tau->worker_stats = NULL;
+    tau->arena = NULL;
+
+    /*  With every array NULL, there is nothing borrowed.                     */
+    tau->dlp_storage = rssringoccs_Tau_DLP_Owned;
 
     /*  Set the indexing variables to be zero as well.                        */
     tau->arr_size = zero;
     tau->start = zero;
     tau->n_used = zero;
+    tau->n_workers = 0U;
+    tau->arena_bytes = zero;
+    tau->progress_done = 0UL;
+    tau->progress_total = 0UL;
+    tau->cancel_requested = tmpl_False;
 
     /*  Set the remaining variables to their defaults.                        */
     rssringoccs_Tau_Set_Default_Values(tau);
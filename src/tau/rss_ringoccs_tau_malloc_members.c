@@ -64,14 +64,34 @@ void rssringoccs_Tau_Malloc_Members(rssringoccs_TAUObj *tau)
         return;
     }
 
+    /*  The members may instead be placed in one block of memory.             */
+    if (tau->use_arena)
+    {
+        rssringoccs_Tau_Malloc_Arena(tau);
+        return;
+    }
+
     /*  The MALLOC_TAU_VAR macro ends with an if statement and so has         *
      *  braces {}. Because of this, we do not need a semi-colon at the end.   *
      *  This macro allocates memory for the members of the tau object and     *
      *  checks for errors.                                                    */
-    MALLOC_TAU_VAR(rho_km_vals)
-    MALLOC_TAU_VAR(phi_deg_vals)
+    MALLOC_TAU_VAR(T_in)
+    MALLOC_TAU_VAR(F_km_vals)
     MALLOC_TAU_VAR(k_vals)
+
+    /*  rho_dot_kms_vals is always copied since it is modified for ingress    *
+     *  occultations, see rssringoccs_Tau_Check_Occ_Type.                     */
     MALLOC_TAU_VAR(rho_dot_kms_vals)
+
+    /*  Borrowed members are set by rssringoccs_Tau_Copy_DLP_Members.         */
+    if (tau->borrow_dlp)
+    {
+        tau->dlp_storage = rssringoccs_Tau_DLP_Borrowed;
+        return;
+    }
+
+    MALLOC_TAU_VAR(rho_km_vals)
+    MALLOC_TAU_VAR(phi_deg_vals)
     MALLOC_TAU_VAR(B_deg_vals)
     MALLOC_TAU_VAR(D_km_vals)
     MALLOC_TAU_VAR(t_oet_spm_vals)
@@ -83,8 +103,7 @@ void rssringoccs_Tau_Malloc_Members(rssringoccs_TAUObj *tau)
     MALLOC_TAU_VAR(rx_km_vals)
     MALLOC_TAU_VAR(ry_km_vals)
     MALLOC_TAU_VAR(rz_km_vals)
-    MALLOC_TAU_VAR(T_in)
-    MALLOC_TAU_VAR(F_km_vals)
+    tau->dlp_storage = rssringoccs_Tau_DLP_Owned;
 }
 /*  End of rssringoccs_Tau_Malloc_Members.                                    */
 
@@ -0,0 +1,101 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                          Tau Own DLP Members                               *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Replaces the borrowed DLP members of a Tau object with copies.        *
+ ******************************************************************************/
+
+/*  malloc, free, and NULL are found here.                                    */
+#include <stdlib.h>
+
+/*  memcpy is found here.                                                     */
+#include <string.h>
+
+/*  Booleans provided here.                                                   */
+#include <libtmpl/include/tmpl.h>
+
+/*  Header file with the Tau definition and function prototypes.              */
+#include <rss_ringoccs/include/rss_ringoccs_tau.h>
+
+/*  Number of members that may be borrowed from a DLP object.                 */
+#define RSSRINGOCCS_TAU_N_BORROWED (13)
+
+/*  Function for copying the borrowed members of a Tau object.                */
+void rssringoccs_Tau_Own_DLP_Members(rssringoccs_TAUObj *tau)
+{
+    double **arrays[RSSRINGOCCS_TAU_N_BORROWED];
+    double *copies[RSSRINGOCCS_TAU_N_BORROWED];
+    size_t n, m;
+
+    if (!tau)
+        return;
+
+    if (tau->error_occurred)
+        return;
+
+    if (tau->dlp_storage != rssringoccs_Tau_DLP_Borrowed)
+        return;
+
+    arrays[0] = &tau->rho_km_vals;
+    arrays[1] = &tau->phi_deg_vals;
+    arrays[2] = &tau->B_deg_vals;
+    arrays[3] = &tau->D_km_vals;
+    arrays[4] = &tau->t_oet_spm_vals;
+    arrays[5] = &tau->t_ret_spm_vals;
+    arrays[6] = &tau->t_set_spm_vals;
+    arrays[7] = &tau->rho_corr_pole_km_vals;
+    arrays[8] = &tau->rho_corr_timing_km_vals;
+    arrays[9] = &tau->phi_rl_deg_vals;
+    arrays[10] = &tau->rx_km_vals;
+    arrays[11] = &tau->ry_km_vals;
+    arrays[12] = &tau->rz_km_vals;
+
+    /*  Allocate every copy before touching tau so that, on failure, the      *
+     *  members are still the borrowed arrays and nothing leaks.              */
+    for (n = 0; n < RSSRINGOCCS_TAU_N_BORROWED; ++n)
+    {
+        copies[n] = malloc(sizeof(double) * tau->arr_size);
+
+        if (copies[n] == NULL)
+        {
+            for (m = 0; m < n; ++m)
+                free(copies[m]);
+
+            tau->error_occurred = tmpl_True;
+            tau->error_message = tmpl_String_Duplicate(
+                "\n\rError Encountered: rss_ringoccs\n"
+                "\r\trssringoccs_Tau_Own_DLP_Members\n\n"
+                "\rMalloc failed and returned NULL. Returning.\n\n"
+            );
+            return;
+        }
+    }
+
+    for (n = 0; n < RSSRINGOCCS_TAU_N_BORROWED; ++n)
+    {
+        memcpy(copies[n], *arrays[n], sizeof(double) * tau->arr_size);
+        *arrays[n] = copies[n];
+    }
+
+    tau->dlp_storage = rssringoccs_Tau_DLP_Owned;
+}
+/*  End of rssringoccs_Tau_Own_DLP_Members.                                   */
+
+#undef RSSRINGOCCS_TAU_N_BORROWED
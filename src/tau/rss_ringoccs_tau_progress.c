@@ -0,0 +1,143 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************
+ *                             Tau Progress                                   *
+ ******************************************************************************
+ *  Purpose:                                                                  *
+ *      Provides access to the progress and cancel request of a Tau object    *
+ *      that is safe while the reconstruction runs on another thread.         *
+ ******************************************************************************
+ *                               DESCRIPTION                                  *
+ ******************************************************************************
+ *  Every access is made with a process-wide mutex held, a pthread mutex on   *
+ *  POSIX systems and an SRW lock on Windows, whether or not the library is   *
+ *  built with OpenMP. The members are only touched once per task of          *
+ *  rssringoccs_Tau_Schedule, so one mutex shared by every Tau object costs   *
+ *  nothing measurable. On other systems there is no mutex, and a Tau object  *
+ *  must not be used from several threads at once.                            *
+ ******************************************************************************/
+
+/*  NULL is found here.                                                       */
+#include <stdlib.h>
+
+/*  Booleans provided here.                                                   */
+#include <libtmpl/include/tmpl.h>
+
+/*  Header file with the Tau definition and function prototypes.              */
+#include <rss_ringoccs/include/rss_ringoccs_tau.h>
+
+/*  The mutex guarding the progress. Statically initialized.                  */
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+static pthread_mutex_t
+rssringoccs_tau_progress_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define RSSRINGOCCS_TAU_PROGRESS_LOCK()                                        \
+    pthread_mutex_lock(&rssringoccs_tau_progress_mutex)
+#define RSSRINGOCCS_TAU_PROGRESS_UNLOCK()                                      \
+    pthread_mutex_unlock(&rssringoccs_tau_progress_mutex)
+#elif defined(_WIN32)
+#include <windows.h>
+static SRWLOCK rssringoccs_tau_progress_mutex = SRWLOCK_INIT;
+#define RSSRINGOCCS_TAU_PROGRESS_LOCK()                                        \
+    AcquireSRWLockExclusive(&rssringoccs_tau_progress_mutex)
+#define RSSRINGOCCS_TAU_PROGRESS_UNLOCK()                                      \
+    ReleaseSRWLockExclusive(&rssringoccs_tau_progress_mutex)
+#else
+#define RSSRINGOCCS_TAU_PROGRESS_LOCK()
+#define RSSRINGOCCS_TAU_PROGRESS_UNLOCK()
+#endif
+
+/*  Function for reading the progress of a Tau object.                        */
+void
+rssringoccs_Tau_Get_Progress(const rssringoccs_TAUObj *tau,
+                             unsigned long *done,
+                             unsigned long *total)
+{
+    if (!tau)
+        return;
+
+    RSSRINGOCCS_TAU_PROGRESS_LOCK();
+
+    if (done)
+        *done = tau->progress_done;
+
+    if (total)
+        *total = tau->progress_total;
+
+    RSSRINGOCCS_TAU_PROGRESS_UNLOCK();
+}
+/*  End of rssringoccs_Tau_Get_Progress.                                      */
+
+/*  Function for setting the progress of a Tau object.                        */
+void
+rssringoccs_Tau_Set_Progress(rssringoccs_TAUObj *tau,
+                             unsigned long done,
+                             unsigned long total)
+{
+    if (!tau)
+        return;
+
+    RSSRINGOCCS_TAU_PROGRESS_LOCK();
+    tau->progress_done = done;
+    tau->progress_total = total;
+    RSSRINGOCCS_TAU_PROGRESS_UNLOCK();
+}
+/*  End of rssringoccs_Tau_Set_Progress.                                      */
+
+/*  Function for adding the points of a finished task to the progress.        */
+void
+rssringoccs_Tau_Add_Progress(rssringoccs_TAUObj *tau, unsigned long n_points)
+{
+    if (!tau)
+        return;
+
+    RSSRINGOCCS_TAU_PROGRESS_LOCK();
+    tau->progress_done += n_points;
+    RSSRINGOCCS_TAU_PROGRESS_UNLOCK();
+}
+/*  End of rssringoccs_Tau_Add_Progress.                                      */
+
+/*  Function for asking a reconstruction to stop.                             */
+void rssringoccs_Tau_Request_Cancel(rssringoccs_TAUObj *tau)
+{
+    if (!tau)
+        return;
+
+    RSSRINGOCCS_TAU_PROGRESS_LOCK();
+    tau->cancel_requested = tmpl_True;
+    RSSRINGOCCS_TAU_PROGRESS_UNLOCK();
+}
+/*  End of rssringoccs_Tau_Request_Cancel.                                    */
+
+/*  Function for checking if a reconstruction was asked to stop.              */
+tmpl_Bool rssringoccs_Tau_Cancel_Requested(const rssringoccs_TAUObj *tau)
+{
+    tmpl_Bool cancelled;
+
+    if (!tau)
+        return tmpl_False;
+
+    RSSRINGOCCS_TAU_PROGRESS_LOCK();
+    cancelled = tau->cancel_requested;
+    RSSRINGOCCS_TAU_PROGRESS_UNLOCK();
+    return cancelled;
+}
+/*  End of rssringoccs_Tau_Cancel_Requested.                                  */
+
+#undef RSSRINGOCCS_TAU_PROGRESS_LOCK
+#undef RSSRINGOCCS_TAU_PROGRESS_UNLOCK
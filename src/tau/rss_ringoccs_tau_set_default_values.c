@@ -67,6 +67,12 @@ void rssringoccs_Tau_Set_Default_Values(rssringoccs_TAUObj* tau)
      *  Set this to zero.                                                     */
     tau->order = 0U;
 
+    /*  Number of threads used by the reconstruction loops when the library  *
+     *  is built with OpenMP support. Zero means use the OpenMP default,      *
+     *  which is usually the number of available cores (or OMP_NUM_THREADS). *
+     *  Setting this to one forces the serial code path.                      */
+    tau->num_threads = 0U;
+
     /*  Boolean for normalizing the reconstruction by the width of the window.*/
     tau->use_norm = tmpl_True;
 
@@ -94,6 +100,54 @@ void rssringoccs_Tau_Set_Default_Values(rssringoccs_TAUObj* tau)
      *  the verbose Boolean is set to True. Default is silent, set to False.  */
     tau->verbose = tmpl_False;
 
+    /*  Boolean for looking up window functions in a process-wide table cache *
+     *  instead of evaluating them every time the window width changes. The  *
+     *  cached tables use the nominal window width for a given number of      *
+     *  points, so the result differs slightly from the direct computation.   *
+     *  Default is off so that results are unchanged.                         */
+    tau->use_window_cache = tmpl_False;
+
+    /*  Boolean for using the SSE2 / AVX2 / AVX-512 versions of the Fresnel   *
+     *  and Legendre transforms, chosen at run time by what the CPU supports. *
+     *  These agree with the scalar transforms up to round-off.               */
+    tau->use_simd = tmpl_True;
+
+    /*  Boolean for starting Newton's method about each center from the       *
+     *  stationary angles found about the previous one. Results change by no  *
+     *  more than the Newton tolerance, so the default is off.                */
+    tau->use_warm_start = tmpl_False;
+
+    /*  Boolean for computing T_out and T_fwd together in one pass, solving   *
+     *  for each kernel once, see rssringoccs_Reconstruction_Fused. Where the *
+     *  window width varies, T_fwd differs slightly from the second pass, so  *
+     *  the default is off.                                                   */
+    tau->use_fused = tmpl_False;
+
+    /*  Boolean for placing the arrays in one block of memory, which lets     *
+     *  rssringoccs_Tau_Finish trim them without copying. Default is off, as  *
+     *  the arrays of an arena cannot be freed one at a time.                 */
+    tau->use_arena = tmpl_False;
+
+    /*  Boolean for referencing the members of the DLP object instead of      *
+     *  copying them. Default is off, since the DLP object must then outlive  *
+     *  the tau object. See rssringoccs_Tau_Create_From_DLP_Borrowed.         */
+    tau->borrow_dlp = tmpl_False;
+
+    /*  Largest difference between the FFT based Fresnel reconstruction and   *
+     *  the direct sum, measured at a few points per block. Only set if the   *
+     *  psitype is "fresnelfft".                                              */
+    tau->fft_max_deviation = 0.0;
+
+    /*  Largest allowed error, in radians, of the interpolated Fresnel kernel *
+     *  for the "adaptive" psitype. Smaller values solve for more samples.    */
+    tau->interp_tol = 1.0E-4;
+
+    /*  Newton steps taken, samples solved, and samples started from the      *
+     *  previous center, summed over every Newton based transform run on tau. */
+    tau->newton_iterations = 0UL;
+    tau->newton_samples = 0UL;
+    tau->newton_warm_samples = 0UL;
+
     /*  Boolean for keeping track of errors. This starts as false. Every      *
      *  function that takes in a Tau object will check if this is True and    *
      *  abort the computation if so.                                          */
@@ -6,7 +6,7 @@
 #include <rss_ringoccs/include/rss_ringoccs_tau.h>
 
 /*  Error message for an invalid input string.                                */
-static const char rssringoccs_psi_err_mes[744] =
+static const char rssringoccs_psi_err_mes[] =
     "\n\rError Encountered: rss_ringoccs\n"
     "\r\trssringoccs_Tau_Set_Psi_Type\n\n"
     "\rIllegal string for psitype. Allowed strings:\n"
@@ -15,14 +15,65 @@ static const char rssringoccs_psi_err_mes[744] =
     "\r\tnewtondold: Newton-Raphson with the old D algorithm.\n"
     "\r\tnewtondphi: Newton-Raphson with dD/dphi perturbation.\n"
     "\r\tsimplefft:  A single FFT of the entire data set.\n"
-    "\r\tquadratic:  Quadratic interpolation of newton-raphson."
-    "\r\tcubic:      Cubic interpolation of newton-raphson."
-    "\r\tquartic:    Quartic interpolation of newton-raphson."
-    "\r\tquarticd:   Quartic interpolation with D perturbation."
+    "\r\tsegmentedfft: One FFT per segment, with a Newton kernel for each.\n"
+    "\r\tadaptive:   Newton-Raphson on an adaptive grid, interpolated.\n"
+    "\r\tquadratic:  Quadratic interpolation of newton-raphson.\n"
+    "\r\tquartic:    Quartic interpolation of newton-raphson.\n"
+    "\r\tsextic:     Sextic interpolation of newton-raphson.\n"
+    "\r\toctic:      Octic interpolation of newton-raphson.\n"
+    "\r\t            Append d, dold, dphi, or ellipse to any of these four\n"
+    "\r\t            to interpolate that method instead (quarticd).\n"
     "\r\tellipse:    Newton-Raphson with elliptical perturbation.\n"
     "\r\tfresnel:    Quadratic Fresnel approximation\n"
+    "\r\tfresnelfft: Quadratic Fresnel approximation using FFTs\n"
     "\r\tfresneln:   Legendre polynomial approximation with 1<n<256\n";
 
+/*  The polynomial interpolations of the Newton-Raphson methods. The name is  *
+ *  the order followed by the method, "quartic" plus "d" for NewtonDQuartic.  */
+typedef struct rssringoccs_Psi_Type_Name_Def {
+    const char *name;
+    rssringoccs_Psitype_Enum psinum;
+} rssringoccs_Psi_Type_Name;
+
+static const rssringoccs_Psi_Type_Name rssringoccs_psi_interp[] = {
+    {"quadratic", rssringoccs_DR_NewtonQuadratic},
+    {"quartic", rssringoccs_DR_NewtonQuartic},
+    {"sextic", rssringoccs_DR_NewtonSextic},
+    {"octic", rssringoccs_DR_NewtonOctic},
+    {"quadraticd", rssringoccs_DR_NewtonDQuadratic},
+    {"quarticd", rssringoccs_DR_NewtonDQuartic},
+    {"sexticd", rssringoccs_DR_NewtonDSextic},
+    {"octicd", rssringoccs_DR_NewtonDOctic},
+    {"quadraticdold", rssringoccs_DR_NewtonDOldQuadratic},
+    {"quarticdold", rssringoccs_DR_NewtonDOldQuartic},
+    {"sexticdold", rssringoccs_DR_NewtonDOldSextic},
+    {"octicdold", rssringoccs_DR_NewtonDOldOctic},
+    {"quadraticdphi", rssringoccs_DR_NewtonDPhiQuadratic},
+    {"quarticdphi", rssringoccs_DR_NewtonDPhiQuartic},
+    {"sexticdphi", rssringoccs_DR_NewtonDPhiSextic},
+    {"octicdphi", rssringoccs_DR_NewtonDPhiOctic},
+    {"quadraticellipse", rssringoccs_DR_NewtonEllipticalQuadratic},
+    {"quarticellipse", rssringoccs_DR_NewtonEllipticalQuartic},
+    {"sexticellipse", rssringoccs_DR_NewtonEllipticalSextic},
+    {"octicellipse", rssringoccs_DR_NewtonEllipticalOctic}
+};
+
+#define RSSRINGOCCS_PSI_INTERP_NAMES \
+    (sizeof(rssringoccs_psi_interp)/sizeof(rssringoccs_psi_interp[0]))
+
+/*  Returns the psitype for an interpolation, or rssringoccs_DR_None.         */
+static rssringoccs_Psitype_Enum
+rssringoccs_Psi_Type_Interp(const char *psitype)
+{
+    size_t n;
+
+    for (n = 0; n < RSSRINGOCCS_PSI_INTERP_NAMES; ++n)
+        if (tmpl_String_Are_Equal(rssringoccs_psi_interp[n].name, psitype))
+            return rssringoccs_psi_interp[n].psinum;
+
+    return rssringoccs_DR_None;
+}
+
 void
 rssringoccs_Tau_Set_Psi_Type(const char *psitype, rssringoccs_TAUObj* tau)
 {
@@ -110,22 +161,30 @@ rssringoccs_Tau_Set_Psi_Type(const char *psitype, rssringoccs_TAUObj* tau)
     else if (tmpl_String_Are_Equal(tau_psitype, "simplefft"))
         tau->psinum = rssringoccs_DR_NewtonSimpleFFT;
 
-    /*  Quadratic interpolation to the Newton-Raphson method.                 */
-    else if (tmpl_String_Are_Equal(tau_psitype, "quadratic"))
-        tau->psinum = rssringoccs_DR_NewtonQuadratic;
+    /*  Newton-Raphson with a separate FFT for each segment of the data. The  *
+     *  kernel is recomputed every few window widths, so changes in geometry  *
+     *  across the occultation are followed.                                  */
+    else if (tmpl_String_Are_Equal(tau_psitype, "segmentedfft"))
+        tau->psinum = rssringoccs_DR_NewtonSegmentedFFT;
 
-    /*  Quartic interpolation to the Newton-Raphson method.                   */
-    else if (tmpl_String_Are_Equal(tau_psitype, "quartic"))
-        tau->psinum = rssringoccs_DR_NewtonQuartic;
+    /*  Newton-Raphson at a few samples, with cubic splines in between. The   *
+     *  grid is refined until the splines are accurate to tau->interp_tol.    */
+    else if (tmpl_String_Are_Equal(tau_psitype, "adaptive"))
+        tau->psinum = rssringoccs_DR_NewtonAdaptive;
 
-    /*  Quartic interpolation to the Newton-Raphson method with D correction. */
-    else if (tmpl_String_Are_Equal(tau_psitype, "quarticd"))
-        tau->psinum = rssringoccs_DR_NewtonDQuartic;
+    /*  Polynomial interpolations to any of the Newton-Raphson methods.       */
+    else if (rssringoccs_Psi_Type_Interp(tau_psitype) != rssringoccs_DR_None)
+        tau->psinum = rssringoccs_Psi_Type_Interp(tau_psitype);
 
     /*  Standard quadratic Fresnel approximation.                             */
     else if (tmpl_String_Are_Equal(tau_psitype, "fresnel"))
         tau->psinum = rssringoccs_DR_Fresnel;
 
+    /*  Quadratic Fresnel approximation computed with blocked FFTs. This must *
+     *  be checked before the "fresneln" case below.                          */
+    else if (tmpl_String_Are_Equal(tau_psitype, "fresnelfft"))
+        tau->psinum = rssringoccs_DR_FresnelFFT;
+
     /*  strncmp is a C standard library function that compares the first n    *
      *  elements of two strings. If the first seven elements of tau.psitype   *
      *  are "fresnel", but the string is not exactly "fresnel", try to parse  *
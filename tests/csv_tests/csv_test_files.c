@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+/*  Writers of the test files shared by the CSV tests.                        */
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+#include <stdio.h>
+#include "csv_test_files.h"
+
+void csv_test_write_row(FILE *fp, const double *row, size_t n_columns)
+{
+    size_t m;
+
+    for (m = 0; m < n_columns; ++m)
+        fprintf(fp, (m == 0 ? "%18.6f" : ",%18.6f"), row[m]);
+
+    fputc('\n', fp);
+}
+
+int csv_test_write_geo(const char *filename)
+{
+    FILE *fp = fopen(filename, "w");
+    double row[19];
+    double t;
+    size_t n, m;
+
+    if (fp == NULL)
+        return 0;
+
+    for (n = 0; n < 600; ++n)
+    {
+        t = 990.0 + 10.0*(double)n;
+        row[0] = t;
+        row[1] = t - 1.0;
+        row[2] = t - 2.0;
+        row[3] = 70000.0 + 5.0*(t - 1000.0);
+
+        for (m = 4; m < 19; ++m)
+            row[m] = (double)m*100.0 + 0.01*(double)(n*n % 97);
+
+        csv_test_write_row(fp, row, 19);
+    }
+
+    return fclose(fp) == 0;
+}
+
+int csv_test_write_cal(const char *filename)
+{
+    FILE *fp = fopen(filename, "w");
+    double row[4];
+    double t;
+    size_t n;
+
+    if (fp == NULL)
+        return 0;
+
+    for (n = 0; n < 300; ++n)
+    {
+        t = 980.0 + 20.0*(double)n;
+        row[0] = t;
+        row[1] = 8.4E9 + 0.5*t + (double)(n % 7);
+        row[2] = 0.001*t;
+        row[3] = 1.0;
+        csv_test_write_row(fp, row, 4);
+    }
+
+    return fclose(fp) == 0;
+}
+
+void csv_test_csv_columns(const rssringoccs_CSVData *csv, double **columns)
+{
+    columns[0] = csv->B_deg_vals;
+    columns[1] = csv->D_km_vals;
+    columns[2] = csv->f_sky_hz_vals;
+    columns[3] = csv->p_norm_vals;
+    columns[4] = csv->raw_tau_vals;
+    columns[5] = csv->phase_deg_vals;
+    columns[6] = csv->phi_deg_vals;
+    columns[7] = csv->phi_rl_deg_vals;
+    columns[8] = csv->raw_tau_threshold_vals;
+    columns[9] = csv->rho_corr_pole_km_vals;
+    columns[10] = csv->rho_corr_timing_km_vals;
+    columns[11] = csv->rho_dot_kms_vals;
+    columns[12] = csv->rho_km_vals;
+    columns[13] = csv->rx_km_vals;
+    columns[14] = csv->ry_km_vals;
+    columns[15] = csv->rz_km_vals;
+    columns[16] = csv->t_oet_spm_vals;
+    columns[17] = csv->t_ret_spm_vals;
+    columns[18] = csv->t_set_spm_vals;
+    columns[19] = csv->tau_phase;
+    columns[20] = csv->tau_power;
+    columns[21] = csv->tau_vals;
+}
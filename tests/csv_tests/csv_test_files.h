@@ -0,0 +1,45 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+/*  Writers of small GEO, CAL, DLP, and TAU files for the CSV tests, and a    *
+ *  way to walk the columns of a CSV object. Compile the tests that include   *
+ *  this with csv_test_files.c.                                               */
+#ifndef RSS_RINGOCCS_CSV_TEST_FILES_H
+#define RSS_RINGOCCS_CSV_TEST_FILES_H
+
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+#include <stdio.h>
+
+/*  Writes the n_columns values of row, comma separated, on one line. Each    *
+ *  value has a fixed width, so changing one digit keeps the file size.       */
+extern void
+csv_test_write_row(FILE *fp, const double *row, size_t n_columns);
+
+/*  Writes a GEO file for an egress occultation, with the radius              *
+ *  70000 + 5 (t - 1000) km, for t from 990 to 6980 seconds.                  */
+extern int csv_test_write_geo(const char *filename);
+
+/*  Writes a CAL file for t from 980 to 6960 seconds.                         */
+extern int csv_test_write_cal(const char *filename);
+
+/*  The 22 columns of a CSV object, in the order of the members.              */
+extern void
+csv_test_csv_columns(const rssringoccs_CSVData *csv, double **columns);
+
+#endif
+/*  End of include guard.                                                     */
@@ -0,0 +1,214 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+
+/*  Checks that rssringoccs_Extract_CSV_Data_Cached gives the same data as    *
+ *  parsing, and that a change to a source file is noticed: a new size, and   *
+ *  new contents of the same size with a new modification time. A file that   *
+ *  is only touched, or a damaged cache, must not cause trouble either. The   *
+ *  modification times are set with utime, so this test needs POSIX. Compile  *
+ *  with csv_test_files.c.                                                    */
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utime.h>
+#include "csv_test_files.h"
+
+#define GEO_FILE "cache_test_GEO.TAB"
+#define CAL_FILE "cache_test_CAL.TAB"
+#define DLP_FILE "cache_test_DLP.TAB"
+#define CACHE_FILE "cache_test.cache"
+
+/*  Row of the DLP file whose power write_dlp may change.                     */
+#define CHANGED_ROW (1234)
+
+static int test_fail(const char *message)
+{
+    printf("Error Encountered: rss_ringoccs\n"
+           "\ttest_csv_cache\n\n%s\n", message);
+    return -1;
+}
+
+/*  n_rows DLP rows, 0.25 km apart. If changed is set, the power of one row   *
+ *  is different, with the same number of characters. The modification time   *
+ *  is then set to mtime.                                                     */
+static int write_dlp(size_t n_rows, int changed, long mtime)
+{
+    struct utimbuf times;
+    FILE *fp = fopen(DLP_FILE, "w");
+    double row[13];
+    double t;
+    size_t n;
+
+    if (fp == NULL)
+        return 0;
+
+    for (n = 0; n < n_rows; ++n)
+    {
+        row[0] = 70010.0 + 0.25*(double)n;
+        t = 1000.0 + (row[0] - 70000.0)/5.0;
+        row[1] = 0.0;
+        row[2] = 0.0;
+        row[3] = 120.0;
+        row[4] = 121.0;
+        row[5] = (changed && n == CHANGED_ROW ? 0.75 : 0.5);
+        row[6] = 0.3;
+        row[7] = 10.0;
+        row[8] = 2.0;
+        row[9] = t;
+        row[10] = t - 1.0;
+        row[11] = t - 2.0;
+        row[12] = 25.0;
+        csv_test_write_row(fp, row, 13);
+    }
+
+    if (fclose(fp) != 0)
+        return 0;
+
+    times.actime = (time_t)mtime;
+    times.modtime = (time_t)mtime;
+    return utime(DLP_FILE, &times) == 0;
+}
+
+/*  Loads the files through the cache and compares the result with parsing    *
+ *  them. from_cache says whether the cache should have been used.            */
+static int check_load(int from_cache, const char *what)
+{
+    rssringoccs_CSVData *cached, *parsed;
+    double *a[22], *b[22];
+    size_t m;
+    int ok;
+
+    cached = rssringoccs_Extract_CSV_Data_Cached(GEO_FILE, CAL_FILE, DLP_FILE,
+                                                 NULL, tmpl_False, CACHE_FILE);
+    parsed = rssringoccs_Extract_CSV_Data(GEO_FILE, CAL_FILE, DLP_FILE,
+                                          NULL, tmpl_False);
+
+    ok = (cached != NULL && parsed != NULL &&
+          !cached->error_occurred && !parsed->error_occurred &&
+          cached->n_elements == parsed->n_elements);
+
+    if (ok && from_cache != (cached->cache.data != NULL))
+    {
+        printf("%s: the cache was %s.\n", what,
+               (from_cache ? "not used" : "used"));
+        ok = 0;
+    }
+
+    if (ok)
+    {
+        csv_test_csv_columns(cached, a);
+        csv_test_csv_columns(parsed, b);
+
+        for (m = 0; m < 22; ++m)
+        {
+            if ((a[m] == NULL) != (b[m] == NULL) ||
+                (a[m] != NULL && memcmp(a[m], b[m],
+                                        sizeof(double)*parsed->n_elements)))
+            {
+                printf("%s: column %lu differs from the parsed data.\n",
+                       what, (unsigned long)m);
+                ok = 0;
+            }
+        }
+    }
+
+    rssringoccs_Destroy_CSV(&cached);
+    rssringoccs_Destroy_CSV(&parsed);
+    return ok;
+}
+
+int main(void)
+{
+    rssringoccs_CSVData *csv;
+    FILE *fp;
+    int status = 0;
+    const long mtime = 1500000000L;
+
+    remove(CACHE_FILE);
+
+    if (!csv_test_write_geo(GEO_FILE) || !csv_test_write_cal(CAL_FILE) ||
+        !write_dlp(20000, 0, mtime))
+        return test_fail("Could not write the test files.");
+
+    /*  The first load writes the cache, and the second uses it.              */
+    if (!check_load(0, "first load") || !check_load(1, "second load"))
+        status = test_fail("The cache was not written, or is wrong.");
+
+    /*  Same size, new contents, new time. The checksum must differ.          */
+    if (!write_dlp(20000, 1, mtime + 100L) ||
+        !check_load(0, "changed contents"))
+        status = test_fail("A changed DLP file of the same size was not "
+                           "noticed.");
+
+    csv = rssringoccs_Extract_CSV_Data_Cached(GEO_FILE, CAL_FILE, DLP_FILE,
+                                              NULL, tmpl_False, CACHE_FILE);
+
+    if (csv == NULL || csv->error_occurred || csv->cache.data == NULL ||
+        csv->p_norm_vals[CHANGED_ROW] != 0.75)
+        status = test_fail("The cache does not hold the changed data.");
+
+    rssringoccs_Destroy_CSV(&csv);
+
+    /*  Same contents, new time, as after a copy. The checksum matches.       */
+    if (!write_dlp(20000, 1, mtime + 200L) || !check_load(1, "touched"))
+        status = test_fail("A touched DLP file invalidated the cache.");
+
+    /*  The new time was written to the cache, so the next load trusts it and *
+     *  does not checksum the file. A change that keeps both the size and the *
+     *  time is then not seen, which shows that the time was recorded.        */
+    if (!write_dlp(20000, 0, mtime + 200L))
+        status = test_fail("Could not write the test files.");
+
+    csv = rssringoccs_Extract_CSV_Data_Cached(GEO_FILE, CAL_FILE, DLP_FILE,
+                                              NULL, tmpl_False, CACHE_FILE);
+
+    if (csv == NULL || csv->error_occurred || csv->cache.data == NULL ||
+        csv->p_norm_vals[CHANGED_ROW] != 0.75)
+        status = test_fail("The time of a touched DLP file was not written "
+                           "to the cache.");
+
+    rssringoccs_Destroy_CSV(&csv);
+
+    /*  A different size, with the same modification time.                    */
+    if (!write_dlp(20001, 1, mtime + 200L) || !check_load(0, "new size"))
+        status = test_fail("A DLP file with a new size was not noticed.");
+
+    /*  A cache cut short is rebuilt.                                         */
+    fp = fopen(CACHE_FILE, "wb");
+
+    if (fp == NULL)
+        status = test_fail("Could not damage the cache file.");
+    else
+    {
+        fputs("RSSCSV", fp);
+        fclose(fp);
+
+        if (!check_load(0, "damaged cache") || !check_load(1, "rebuilt"))
+            status = test_fail("A damaged cache was not rebuilt.");
+    }
+
+    remove(GEO_FILE);
+    remove(CAL_FILE);
+    remove(DLP_FILE);
+    remove(CACHE_FILE);
+    return status;
+}
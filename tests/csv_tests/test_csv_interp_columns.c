@@ -0,0 +1,235 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+
+/*  Checks that rssringoccs_CSV_Interp_Columns gives, for several columns at  *
+ *  once, the same values as one column at a time, for every method and for   *
+ *  output points in any order. The linear values are compared with those of  *
+ *  tmpl_Double_Sorted_Interp1d, which was used for each column before.       */
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_PTS (1000)
+#define N_COLUMNS (5)
+
+/*  With N_COLUMNS, enough values for the columns to be done in parallel.     */
+#define N_OUT (60000)
+
+static int test_fail(const char *message)
+{
+    printf("Error Encountered: rss_ringoccs\n"
+           "\ttest_csv_interp_columns\n\n%s\n", message);
+    return -1;
+}
+
+/*  A linear congruential generator, so that every platform gets the same     *
+ *  points. Returns a number between 0 and 1.                                 */
+static double next_random(unsigned long *state)
+{
+    *state = (*state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return (double)(*state) / 2147483648.0;
+}
+
+/*  Interpolates all of the columns together and one at a time, and checks    *
+ *  that the values are the same.                                             */
+static int check_batch(const double *x, const double * const *y,
+                       const double *x_out, double **batch, double **single,
+                       rssringoccs_Interp_Enum method, const char *what)
+{
+    size_t k;
+
+    if (!rssringoccs_CSV_Interp_Columns(x, y, N_PTS, x_out, batch, N_OUT,
+                                        N_COLUMNS, method))
+    {
+        printf("%s: rssringoccs_CSV_Interp_Columns failed.\n", what);
+        return 0;
+    }
+
+    for (k = 0; k < N_COLUMNS; ++k)
+    {
+        if (!rssringoccs_CSV_Interp_Columns(x, y + k, N_PTS, x_out,
+                                            single + k, N_OUT, 1, method))
+        {
+            printf("%s: rssringoccs_CSV_Interp_Columns failed.\n", what);
+            return 0;
+        }
+
+        if (memcmp(batch[k], single[k], sizeof(double)*N_OUT) != 0)
+        {
+            printf("%s: column %lu differs.\n", what, (unsigned long)k);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int main(void)
+{
+    const rssringoccs_Interp_Enum methods[3] = {
+        rssringoccs_Interp_Linear,
+        rssringoccs_Interp_Cubic,
+        rssringoccs_Interp_Monotone
+    };
+    const char *names[3] = {"linear", "cubic", "monotone"};
+    const char *orders[3] = {"increasing", "decreasing", "random"};
+    double *x, *x_out, *x_in, *memory;
+    double *y[N_COLUMNS], *batch[N_COLUMNS], *single[N_COLUMNS];
+    double *old;
+    double dx, scale, tmp;
+    unsigned long state = 1UL;
+    size_t n, k, m, order, n_in;
+    char what[64];
+    int status = 0;
+
+    memory = malloc(sizeof(*memory) *
+                    (N_PTS*(N_COLUMNS + 1) + N_OUT*(2*N_COLUMNS + 3)));
+
+    if (memory == NULL)
+        return test_fail("malloc failed.");
+
+    x = memory;
+    x_out = x + N_PTS;
+    x_in = x_out + N_OUT;
+    old = x_in + N_OUT;
+
+    for (k = 0; k < N_COLUMNS; ++k)
+    {
+        y[k] = old + N_OUT + k*N_PTS;
+        batch[k] = y[0] + N_COLUMNS*N_PTS + k*N_OUT;
+        single[k] = batch[0] + N_COLUMNS*N_OUT + k*N_OUT;
+    }
+
+    /*  Unevenly spaced points, and columns of different shapes, including a  *
+     *  constant one and one with a jump.                                     */
+    x[0] = 70000.0;
+
+    for (n = 1; n < N_PTS; ++n)
+        x[n] = x[n-1] + 0.5 + next_random(&state);
+
+    for (n = 0; n < N_PTS; ++n)
+    {
+        y[0][n] = 0.001*x[n];
+        y[1][n] = (double)(n*n % 37) - 18.0;
+        y[2][n] = 1.0;
+        y[3][n] = (n < N_PTS/2 ? 0.0 : 1.0);
+        y[4][n] = next_random(&state);
+    }
+
+    /*  The output points start and end outside of x.                         */
+    dx = (x[N_PTS-1] - x[0] + 20.0) / (double)(N_OUT - 1);
+
+    for (order = 0; order < 3; ++order)
+    {
+        for (n = 0; n < N_OUT; ++n)
+        {
+            if (order == 0)
+                x_out[n] = x[0] - 10.0 + dx*(double)n;
+            else if (order == 1)
+                x_out[n] = x[N_PTS-1] + 10.0 - dx*(double)n;
+            else
+                x_out[n] = x[0] - 10.0 +
+                           (x[N_PTS-1] - x[0] + 20.0)*next_random(&state);
+        }
+
+        /*  Some of the points are points of x.                               */
+        for (n = 0; n < N_OUT; n += 97)
+            x_out[n] = x[(n*31) % N_PTS];
+
+        for (m = 0; m < 3; ++m)
+        {
+            sprintf(what, "%s, %s", names[m], orders[order]);
+
+            if (!check_batch(x, (const double * const *)y, x_out, batch,
+                             single, methods[m], what))
+                status = test_fail("The columns interpolated together differ "
+                                   "from those interpolated one at a time.");
+        }
+    }
+
+    /*  The last linear values, for points in random order, against the old   *
+     *  way, for which the points inside of x must be sorted.                 */
+    n_in = 0;
+
+    for (n = 0; n < N_OUT; ++n)
+        if (x[0] < x_out[n] && x_out[n] < x[N_PTS-1])
+            x_in[n_in++] = x_out[n];
+
+    for (n = 1; n < n_in; ++n)
+    {
+        tmp = x_in[n];
+
+        for (m = n; m > 0 && x_in[m-1] > tmp; --m)
+            x_in[m] = x_in[m-1];
+
+        x_in[m] = tmp;
+    }
+
+    if (!rssringoccs_CSV_Interp_Columns(x, (const double * const *)y, N_PTS,
+                                        x_in, batch, n_in, N_COLUMNS,
+                                        rssringoccs_Interp_Linear))
+        status = test_fail("rssringoccs_CSV_Interp_Columns failed.");
+
+    for (k = 0; k < N_COLUMNS; ++k)
+    {
+        tmpl_Double_Sorted_Interp1d(x, y[k], N_PTS, x_in, old, n_in);
+
+        for (n = 0; n < n_in; ++n)
+        {
+            scale = tmpl_Double_Abs(old[n]) + 1.0;
+
+            if (tmpl_Double_Abs(batch[k][n] - old[n]) > 1.0E-12*scale)
+            {
+                printf("linear, column %lu, x = %.16e: %.16e and %.16e\n",
+                       (unsigned long)k, x_in[n], batch[k][n], old[n]);
+                status = test_fail("The linear values differ from those of "
+                                   "tmpl_Double_Sorted_Interp1d.");
+                break;
+            }
+        }
+    }
+
+    /*  Points outside of x take the value at the nearest end.                */
+    for (m = 0; m < 3; ++m)
+    {
+        x_out[0] = x[0] - 5.0;
+        x_out[1] = x[N_PTS-1] + 5.0;
+
+        if (!rssringoccs_CSV_Interp_Columns(x, (const double * const *)y,
+                                            N_PTS, x_out, batch, 2, N_COLUMNS,
+                                            methods[m]))
+            status = test_fail("rssringoccs_CSV_Interp_Columns failed.");
+
+        for (k = 0; k < N_COLUMNS; ++k)
+            if (batch[k][0] != y[k][0] || batch[k][1] != y[k][N_PTS-1])
+                status = test_fail("A point outside of x did not take the "
+                                   "value at the nearest end.");
+    }
+
+    /*  No data is an error.                                                  */
+    if (rssringoccs_CSV_Interp_Columns(x, (const double * const *)y, 0,
+                                       x_out, batch, 2, N_COLUMNS,
+                                       rssringoccs_Interp_Linear))
+        status = test_fail("rssringoccs_CSV_Interp_Columns accepted no data.");
+
+    free(memory);
+    return status;
+}
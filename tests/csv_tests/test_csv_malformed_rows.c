@@ -0,0 +1,179 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+
+/*  Checks that files with rows of the wrong length, and files with no data,  *
+ *  are reported as errors, with the number of the first bad row, rather      *
+ *  than read as zeros. The large file is parsed in pieces by several         *
+ *  threads if OpenMP is available, and must give the same row.               */
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int test_fail(const char *message)
+{
+    printf("Error Encountered: rss_ringoccs\n"
+           "\ttest_csv_malformed_rows\n\n%s\n", message);
+    return -1;
+}
+
+/*  Writes n_rows rows of n_columns columns, except that row bad_row,         *
+ *  counted from one, has bad_columns columns. A bad_row of zero is none.     */
+static int write_table(const char *name, size_t n_columns, size_t n_rows,
+                       size_t bad_row, size_t bad_columns)
+{
+    FILE *fp = fopen(name, "w");
+    size_t m, n, n_fields;
+
+    if (fp == NULL)
+        return 0;
+
+    for (n = 1; n <= n_rows; ++n)
+    {
+        n_fields = (n == bad_row ? bad_columns : n_columns);
+
+        for (m = 0; m < n_fields; ++m)
+            fprintf(fp, (m == 0 ? "%14.6f" : ",%14.6f"),
+                    (double)n + 0.25*(double)m);
+
+        fputc('\n', fp);
+    }
+
+    return fclose(fp) == 0;
+}
+
+/*  Reads the file with the columns in mask, and checks that it fails with a  *
+ *  message naming the row, or with no particular message if row is zero.     */
+static int expect_error(const char *name, unsigned long mask, size_t row)
+{
+    rssringoccs_CSV_Columns csv;
+    char expected[64];
+    int ok;
+
+    rssringoccs_CSV_Read_Selected(&csv, name, NULL, mask);
+
+    ok = csv.error_occurred && csv.error_message != NULL && csv.data == NULL;
+
+    if (ok && row > 0)
+    {
+        sprintf(expected, "Row %lu does not have", (unsigned long)row);
+        ok = (strstr(csv.error_message, expected) != NULL);
+    }
+
+    if (!ok && csv.error_message != NULL)
+        printf("%s: %s\n", name, csv.error_message);
+
+    /*  The error message is not freed with the columns.                      */
+    rssringoccs_Destroy_CSV_Columns_Members(&csv);
+    free(csv.error_message);
+    return ok;
+}
+
+int main(void)
+{
+    rssringoccs_GeoCSV *geo;
+    rssringoccs_CalCSV *cal;
+    rssringoccs_DLPCSV *dlp;
+    FILE *fp;
+    int status = 0;
+
+    /*  A short row, and a long one, in a small file.                         */
+    if (!write_table("malformed_short.TAB", 5, 10, 4, 4) ||
+        !write_table("malformed_long.TAB", 5, 10, 2, 6) ||
+        !write_table("malformed_large.TAB", 5, 150000, 120000, 3) ||
+        !write_table("malformed_geo.TAB", 5, 10, 0, 0) ||
+        !write_table("malformed_dlp.TAB", 13, 10, 0, 0) ||
+        !write_table("malformed_cal.TAB", 4, 10, 7, 3))
+        return test_fail("Could not write the test files.");
+
+    if (!expect_error("malformed_short.TAB", ~0UL, 4))
+        status = test_fail("A short row was not reported.");
+
+    if (!expect_error("malformed_long.TAB", ~0UL, 2))
+        status = test_fail("A long row was not reported.");
+
+    /*  Columns that are skipped are still counted.                           */
+    if (!expect_error("malformed_short.TAB", 1UL, 4))
+        status = test_fail("A short row was not reported when reading "
+                           "only the first column.");
+
+    if (!expect_error("malformed_large.TAB", ~0UL, 120000))
+        status = test_fail("A short row in a large file was not reported.");
+
+    /*  Files with no rows, and files that do not exist.                      */
+    fp = fopen("malformed_empty.TAB", "w");
+
+    if (fp == NULL)
+        return test_fail("Could not write the test files.");
+
+    fclose(fp);
+
+    fp = fopen("malformed_blank.TAB", "w");
+
+    if (fp == NULL)
+        return test_fail("Could not write the test files.");
+
+    fputs("\n  \n\r\n", fp);
+    fclose(fp);
+
+    if (!expect_error("malformed_empty.TAB", ~0UL, 0))
+        status = test_fail("An empty file was not reported.");
+
+    if (!expect_error("malformed_blank.TAB", ~0UL, 0))
+        status = test_fail("A file of blank lines was not reported.");
+
+    if (!expect_error("malformed_missing.TAB", ~0UL, 0))
+        status = test_fail("A missing file was not reported.");
+
+    /*  The Get functions check the number of columns of their format, and    *
+     *  pass on the errors of the reader.                                     */
+    geo = rssringoccs_Get_Geo("malformed_geo.TAB", tmpl_False);
+
+    if (geo == NULL || !geo->error_occurred || geo->error_message == NULL)
+        status = test_fail("rssringoccs_Get_Geo accepted 5 columns.");
+
+    rssringoccs_Destroy_GeoCSV(&geo);
+
+    dlp = rssringoccs_Get_DLP("malformed_dlp.TAB", tmpl_True);
+
+    if (dlp == NULL || !dlp->error_occurred || dlp->error_message == NULL)
+        status = test_fail("rssringoccs_Get_DLP accepted 13 columns with "
+                           "use_deprecated set.");
+
+    rssringoccs_Destroy_DLPCSV(&dlp);
+
+    cal = rssringoccs_Get_Cal("malformed_cal.TAB");
+
+    if (cal == NULL || !cal->error_occurred || cal->error_message == NULL ||
+        strstr(cal->error_message, "Row 7 does not have") == NULL)
+        status = test_fail("rssringoccs_Get_Cal did not report row 7.");
+
+    rssringoccs_Destroy_CalCSV(&cal);
+
+    remove("malformed_short.TAB");
+    remove("malformed_long.TAB");
+    remove("malformed_large.TAB");
+    remove("malformed_geo.TAB");
+    remove("malformed_dlp.TAB");
+    remove("malformed_cal.TAB");
+    remove("malformed_empty.TAB");
+    remove("malformed_blank.TAB");
+    return status;
+}
@@ -0,0 +1,319 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+
+/*  Checks that the one-pass reader gives the same numbers as the reader it   *
+ *  replaced, which split each line with strtok and converted it with atof.   *
+ *  Large enough files are parsed in pieces by several threads, so the GEO    *
+ *  file is made big enough for that.                                         */
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int test_fail(const char *message)
+{
+    printf("Error Encountered: rss_ringoccs\n"
+           "\ttest_csv_parse_equivalence\n\n%s\n", message);
+    return -1;
+}
+
+/*  Writes a table of n_rows rows and n_columns columns, formatting the       *
+ *  values in the ways found in the PDS files, and a few that are not: more   *
+ *  than 15 digits, large exponents, and line breaks with carriage returns.   */
+static int write_table(const char *name, size_t n_columns, size_t n_rows)
+{
+    FILE *fp = fopen(name, "w");
+    size_t m, n;
+    double x;
+
+    if (fp == NULL)
+        return 0;
+
+    for (n = 0; n < n_rows; ++n)
+    {
+        for (m = 0; m < n_columns; ++m)
+        {
+            x = 1.0E3*(double)n + 0.37*(double)m + 1.0E-4*(double)(n % 977);
+
+            if (m > 0)
+                fputc(',', fp);
+
+            switch ((n + m) % 7)
+            {
+                case 0:
+                    fprintf(fp, "%14.6f", x);
+                    break;
+                case 1:
+                    fprintf(fp, "%.16E", -x);
+                    break;
+                case 2:
+                    fprintf(fp, "  %+.9e", x);
+                    break;
+                case 3:
+                    fprintf(fp, "%g", x);
+                    break;
+                case 4:
+                    fprintf(fp, "%.20f", x);
+                    break;
+                case 5:
+                    fprintf(fp, "%.12e", x*1.0E-250);
+                    break;
+                default:
+                    fprintf(fp, "%lu", (unsigned long)n);
+                    break;
+            }
+        }
+
+        fputs((n % 5 == 0 ? "\r\n" : "\n"), fp);
+    }
+
+    return fclose(fp) == 0;
+}
+
+/*  The old reader. ref[m][n] is column m of row n.                           */
+static int read_old(const char *name, size_t n_columns, size_t n_rows,
+                    double **ref)
+{
+    char buffer[1024];
+    char *record;
+    size_t m, n = 0;
+    FILE *fp = fopen(name, "r");
+
+    if (fp == NULL)
+        return 0;
+
+    while (n < n_rows && fgets(buffer, sizeof(buffer), fp) != NULL)
+    {
+        record = strtok(buffer, ",");
+
+        for (m = 0; m < n_columns && record != NULL; ++m)
+        {
+            ref[m][n] = atof(record);
+            record = strtok(NULL, ",");
+        }
+
+        ++n;
+    }
+
+    fclose(fp);
+    return n == n_rows;
+}
+
+/*  Compares the columns of a Get function with those of the old reader.      */
+static int same_columns(double **columns, double **ref,
+                        size_t n_columns, size_t n_rows)
+{
+    size_t m;
+
+    for (m = 0; m < n_columns; ++m)
+        if (columns[m] == NULL ||
+            memcmp(columns[m], ref[m], sizeof(double)*n_rows) != 0)
+            return 0;
+
+    return 1;
+}
+
+int main(void)
+{
+    const char *strings[] = {
+        "0", "-0.0", "1e5", "1E+05", "  42", "3.14159265358979",
+        "123456789012345678", "1.7976931348623157e308", "4.9e-324",
+        "0.000000000000000000001", ".5", "5.", "-.25e-3", "1e", "2e+",
+        "9007199254740993", "1.00000000000000011102230246251565e0", "inf"
+    };
+    const size_t n_rows = 20000;
+    double *ref[19], *columns[19];
+    double parsed, expected;
+    const char *end;
+    rssringoccs_CSV_Columns csv;
+    rssringoccs_GeoCSV *geo;
+    rssringoccs_CalCSV *cal;
+    rssringoccs_DLPCSV *dlp;
+    rssringoccs_TauCSV *tau;
+    size_t m;
+    int status = 0;
+
+    /*  rssringoccs_CSV_Parse_Double against strtod, which atof calls.        */
+    for (m = 0; m < sizeof(strings)/sizeof(strings[0]); ++m)
+    {
+        end = strings[m] + strlen(strings[m]);
+        rssringoccs_CSV_Parse_Double(strings[m], end, &parsed);
+        expected = strtod(strings[m], NULL);
+
+        if (memcmp(&parsed, &expected, sizeof(parsed)) != 0)
+        {
+            printf("%s parsed as %.17g, strtod gives %.17g.\n",
+                   strings[m], parsed, expected);
+            return test_fail("rssringoccs_CSV_Parse_Double differs from "
+                             "strtod.");
+        }
+    }
+
+    for (m = 0; m < 19; ++m)
+    {
+        ref[m] = malloc(sizeof(double)*n_rows);
+
+        if (ref[m] == NULL)
+            return test_fail("malloc failed.");
+    }
+
+    if (!write_table("parse_test_GEO.TAB", 19, n_rows) ||
+        !write_table("parse_test_CAL.TAB", 4, n_rows) ||
+        !write_table("parse_test_DLP.TAB", 13, n_rows))
+        return test_fail("Could not write the test files.");
+
+    /*  The generic reader, on the largest file.                              */
+    if (!read_old("parse_test_GEO.TAB", 19, n_rows, ref))
+        return test_fail("Could not read parse_test_GEO.TAB.");
+
+    rssringoccs_CSV_Read_Columns(&csv, "parse_test_GEO.TAB");
+
+    if (csv.error_occurred)
+        status = test_fail(csv.error_message);
+    else if (csv.n_columns != 19 || csv.n_rows != n_rows ||
+             !same_columns(csv.data, ref, 19, n_rows))
+        status = test_fail("rssringoccs_CSV_Read_Columns differs from the "
+                           "old reader.");
+
+    rssringoccs_Destroy_CSV_Columns_Members(&csv);
+
+    /*  GEO.TAB, with its columns in the order of the members.                */
+    geo = rssringoccs_Get_Geo("parse_test_GEO.TAB", tmpl_False);
+
+    if (geo == NULL || geo->error_occurred || geo->n_elements != n_rows)
+        status = test_fail("rssringoccs_Get_Geo failed.");
+    else
+    {
+        columns[0] = geo->t_oet_spm_vals;
+        columns[1] = geo->t_ret_spm_vals;
+        columns[2] = geo->t_set_spm_vals;
+        columns[3] = geo->rho_km_vals;
+        columns[4] = geo->phi_rl_deg_vals;
+        columns[5] = geo->phi_ora_deg_vals;
+        columns[6] = geo->B_deg_vals;
+        columns[7] = geo->D_km_vals;
+        columns[8] = geo->rho_dot_kms_vals;
+        columns[9] = geo->phi_rl_dot_kms_vals;
+        columns[10] = geo->F_km_vals;
+        columns[11] = geo->R_imp_km_vals;
+        columns[12] = geo->rx_km_vals;
+        columns[13] = geo->ry_km_vals;
+        columns[14] = geo->rz_km_vals;
+        columns[15] = geo->vx_kms_vals;
+        columns[16] = geo->vy_kms_vals;
+        columns[17] = geo->vz_kms_vals;
+        columns[18] = geo->obs_spacecract_lat_deg_vals;
+
+        if (!same_columns(columns, ref, 19, n_rows))
+            status = test_fail("rssringoccs_Get_Geo differs from the old "
+                               "reader.");
+    }
+
+    rssringoccs_Destroy_GeoCSV(&geo);
+
+    /*  CAL.TAB.                                                              */
+    if (!read_old("parse_test_CAL.TAB", 4, n_rows, ref))
+        return test_fail("Could not read parse_test_CAL.TAB.");
+
+    cal = rssringoccs_Get_Cal("parse_test_CAL.TAB");
+
+    if (cal == NULL || cal->error_occurred || cal->n_elements != n_rows)
+        status = test_fail("rssringoccs_Get_Cal failed.");
+    else
+    {
+        columns[0] = cal->t_oet_spm_vals;
+        columns[1] = cal->f_sky_pred_vals;
+        columns[2] = cal->f_sky_resid_fit_vals;
+        columns[3] = cal->p_free_vals;
+
+        if (!same_columns(columns, ref, 4, n_rows))
+            status = test_fail("rssringoccs_Get_Cal differs from the old "
+                               "reader.");
+    }
+
+    rssringoccs_Destroy_CalCSV(&cal);
+
+    /*  DLP.TAB and TAU.TAB have the same layout.                             */
+    if (!read_old("parse_test_DLP.TAB", 13, n_rows, ref))
+        return test_fail("Could not read parse_test_DLP.TAB.");
+
+    dlp = rssringoccs_Get_DLP("parse_test_DLP.TAB", tmpl_False);
+
+    if (dlp == NULL || dlp->error_occurred || dlp->n_elements != n_rows)
+        status = test_fail("rssringoccs_Get_DLP failed.");
+    else
+    {
+        columns[0] = dlp->rho_km_vals;
+        columns[1] = dlp->rho_corr_pole_km_vals;
+        columns[2] = dlp->rho_corr_timing_km_vals;
+        columns[3] = dlp->phi_rl_deg_vals;
+        columns[4] = dlp->phi_ora_deg_vals;
+        columns[5] = dlp->p_norm_vals;
+        columns[6] = dlp->raw_tau_vals;
+        columns[7] = dlp->phase_deg_vals;
+        columns[8] = dlp->raw_tau_threshold_vals;
+        columns[9] = dlp->t_oet_spm_vals;
+        columns[10] = dlp->t_ret_spm_vals;
+        columns[11] = dlp->t_set_spm_vals;
+        columns[12] = dlp->B_deg_vals;
+
+        if (!same_columns(columns, ref, 13, n_rows))
+            status = test_fail("rssringoccs_Get_DLP differs from the old "
+                               "reader.");
+    }
+
+    rssringoccs_Destroy_DLPCSV(&dlp);
+
+    tau = rssringoccs_Get_Tau("parse_test_DLP.TAB", tmpl_False);
+
+    if (tau == NULL || tau->error_occurred || tau->n_elements != n_rows)
+        status = test_fail("rssringoccs_Get_Tau failed.");
+    else
+    {
+        columns[0] = tau->rho_km_vals;
+        columns[1] = tau->rho_corr_pole_km_vals;
+        columns[2] = tau->rho_corr_timing_km_vals;
+        columns[3] = tau->phi_rl_deg_vals;
+        columns[4] = tau->phi_ora_deg_vals;
+        columns[5] = tau->power_vals;
+        columns[6] = tau->tau_vals;
+        columns[7] = tau->phase_deg_vals;
+        columns[8] = tau->tau_threshold_vals;
+        columns[9] = tau->t_oet_spm_vals;
+        columns[10] = tau->t_ret_spm_vals;
+        columns[11] = tau->t_set_spm_vals;
+        columns[12] = tau->B_deg_vals;
+
+        if (!same_columns(columns, ref, 13, n_rows))
+            status = test_fail("rssringoccs_Get_Tau differs from the old "
+                               "reader.");
+    }
+
+    rssringoccs_Destroy_TauCSV(&tau);
+
+    for (m = 0; m < 19; ++m)
+        free(ref[m]);
+
+    remove("parse_test_GEO.TAB");
+    remove("parse_test_CAL.TAB");
+    remove("parse_test_DLP.TAB");
+
+    return status;
+}
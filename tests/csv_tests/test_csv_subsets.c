@@ -0,0 +1,528 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+
+/*  Checks that the readers of parts of the files, by a range of radii or by  *
+ *  a mask of columns, give the same values as reading everything and then    *
+ *  keeping the part asked for, and that the columns not asked for are NULL.  *
+ *  Compile with csv_test_files.c.                                            */
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_csv_tools.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "csv_test_files.h"
+
+#define GEO_FILE "subset_test_GEO.TAB"
+#define CAL_FILE "subset_test_CAL.TAB"
+#define DLP_FILE "subset_test_DLP.TAB"
+#define DLP_INGRESS_FILE "subset_test_DLP_ingress.TAB"
+#define TAU_FILE "subset_test_TAU.TAB"
+
+#define DLP_ROWS (20000)
+#define TAU_ROWS (5100)
+
+/*  The range used. Both ends are radii of rows of the DLP and TAU files, so  *
+ *  that the TAU values at the ends are found the same way in both loads.     */
+#define RHO_MIN (71234.0)
+#define RHO_MAX (73456.0)
+
+static int test_fail(const char *message)
+{
+    printf("Error Encountered: rss_ringoccs\n"
+           "\ttest_csv_subsets\n\n%s\n", message);
+    return -1;
+}
+
+/*  An egress occultation, with the radius 70000 + 5 (t - 1000) km. The DLP   *
+ *  rows are 0.25 km apart, and the TAU rows 1 km. The TAU values are small   *
+ *  multiples of 1/8, so that linear interpolation onto the DLP radii is      *
+ *  exact. The ingress DLP file has the DLP rows in reverse order.            */
+static int write_files(void)
+{
+    FILE *fp, *ingress;
+    double row[13], ingress_row[13];
+    double value;
+    size_t n;
+
+    if (!csv_test_write_geo(GEO_FILE) || !csv_test_write_cal(CAL_FILE))
+        return 0;
+
+    fp = fopen(TAU_FILE, "w");
+
+    if (fp == NULL)
+        return 0;
+
+    for (n = 0; n < TAU_ROWS; ++n)
+    {
+        value = 0.125*(double)(n % 13);
+        row[0] = 70000.0 + (double)n;
+        row[1] = 0.0;
+        row[2] = 0.0;
+        row[3] = 120.0;
+        row[4] = 121.0;
+        row[5] = 1.0 - 0.5*value;
+        row[6] = value;
+        row[7] = 10.0 + value;
+        row[8] = 2.0;
+        row[9] = 1000.0 + (row[0] - 70000.0)/5.0;
+        row[10] = row[9] - 1.0;
+        row[11] = row[9] - 2.0;
+        row[12] = 25.0;
+        csv_test_write_row(fp, row, 13);
+    }
+
+    if (fclose(fp) != 0)
+        return 0;
+
+    fp = fopen(DLP_FILE, "w");
+    ingress = fopen(DLP_INGRESS_FILE, "w");
+
+    if (fp == NULL || ingress == NULL)
+    {
+        if (fp != NULL)
+            fclose(fp);
+
+        if (ingress != NULL)
+            fclose(ingress);
+
+        return 0;
+    }
+
+    for (n = 0; n < DLP_ROWS; ++n)
+    {
+        value = 0.001*(double)(n % 101);
+        row[0] = 70010.0 + 0.25*(double)n;
+        row[1] = 0.1;
+        row[2] = 0.2;
+        row[3] = 120.0 + value;
+        row[4] = 121.0;
+        row[5] = 0.5 + value;
+        row[6] = 0.3;
+        row[7] = 10.0 - value;
+        row[8] = 2.0;
+        row[9] = 1000.0 + (row[0] - 70000.0)/5.0;
+        row[10] = row[9] - 1.0;
+        row[11] = row[9] - 2.0;
+        row[12] = 25.0;
+        csv_test_write_row(fp, row, 13);
+
+        /*  The ingress file has the rows written from the last to the first. */
+        memcpy(ingress_row, row, sizeof(row));
+        ingress_row[0] = 70010.0 + 0.25*(double)(DLP_ROWS - 1 - n);
+        ingress_row[9] = 1000.0 + 0.05*(double)n;
+        ingress_row[10] = ingress_row[9] - 1.0;
+        ingress_row[11] = ingress_row[9] - 2.0;
+        csv_test_write_row(ingress, ingress_row, 13);
+    }
+
+    if (fclose(ingress) != 0)
+    {
+        fclose(fp);
+        return 0;
+    }
+
+    return fclose(fp) == 0;
+}
+
+/*  Compares the n values of a part with those of the whole, from first on.   *
+ *  A part not read must be NULL.                                             */
+static int same_part(const double *part, const double *whole, size_t first,
+                     size_t n, int was_read)
+{
+    if (!was_read)
+        return part == NULL;
+
+    if (part == NULL || whole == NULL)
+        return 0;
+
+    return memcmp(part, whole + first, sizeof(double)*n) == 0;
+}
+
+/*  The rows of rho between RHO_MIN and RHO_MAX. Returns the count, setting   *
+ *  first to the first row in the range. The rows in it are consecutive.      */
+static size_t rows_in_range(const double *rho, size_t n_rows, size_t *first)
+{
+    size_t n, count = 0;
+
+    *first = 0;
+
+    for (n = 0; n < n_rows; ++n)
+    {
+        if (RHO_MIN <= rho[n] && rho[n] <= RHO_MAX)
+        {
+            if (count == 0)
+                *first = n;
+
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/*  The columns of a DLP object, in the order of the file.                    */
+static void get_dlp_columns(const rssringoccs_DLPCSV *dlp, double **columns)
+{
+    columns[0] = dlp->rho_km_vals;
+    columns[1] = dlp->rho_corr_pole_km_vals;
+    columns[2] = dlp->rho_corr_timing_km_vals;
+    columns[3] = dlp->phi_rl_deg_vals;
+    columns[4] = dlp->phi_ora_deg_vals;
+    columns[5] = dlp->p_norm_vals;
+    columns[6] = dlp->raw_tau_vals;
+    columns[7] = dlp->phase_deg_vals;
+    columns[8] = dlp->raw_tau_threshold_vals;
+    columns[9] = dlp->t_oet_spm_vals;
+    columns[10] = dlp->t_ret_spm_vals;
+    columns[11] = dlp->t_set_spm_vals;
+    columns[12] = dlp->B_deg_vals;
+}
+
+/*  The columns of a TAU object, in the order of the file.                    */
+static void get_tau_columns(const rssringoccs_TauCSV *tau, double **columns)
+{
+    columns[0] = tau->rho_km_vals;
+    columns[1] = tau->rho_corr_pole_km_vals;
+    columns[2] = tau->rho_corr_timing_km_vals;
+    columns[3] = tau->phi_rl_deg_vals;
+    columns[4] = tau->phi_ora_deg_vals;
+    columns[5] = tau->power_vals;
+    columns[6] = tau->tau_vals;
+    columns[7] = tau->phase_deg_vals;
+    columns[8] = tau->tau_threshold_vals;
+    columns[9] = tau->t_oet_spm_vals;
+    columns[10] = tau->t_ret_spm_vals;
+    columns[11] = tau->t_set_spm_vals;
+    columns[12] = tau->B_deg_vals;
+}
+
+/*  The columns of a GEO object, in the order of the file.                    */
+static void get_geo_columns(const rssringoccs_GeoCSV *geo, double **columns)
+{
+    columns[0] = geo->t_oet_spm_vals;
+    columns[1] = geo->t_ret_spm_vals;
+    columns[2] = geo->t_set_spm_vals;
+    columns[3] = geo->rho_km_vals;
+    columns[4] = geo->phi_rl_deg_vals;
+    columns[5] = geo->phi_ora_deg_vals;
+    columns[6] = geo->B_deg_vals;
+    columns[7] = geo->D_km_vals;
+    columns[8] = geo->rho_dot_kms_vals;
+    columns[9] = geo->phi_rl_dot_kms_vals;
+    columns[10] = geo->F_km_vals;
+    columns[11] = geo->R_imp_km_vals;
+    columns[12] = geo->rx_km_vals;
+    columns[13] = geo->ry_km_vals;
+    columns[14] = geo->rz_km_vals;
+    columns[15] = geo->vx_kms_vals;
+    columns[16] = geo->vy_kms_vals;
+    columns[17] = geo->vz_kms_vals;
+    columns[18] = geo->obs_spacecract_lat_deg_vals;
+}
+
+/*  Compares the DLP files read by range, by mask, and by both, with the      *
+ *  whole file.                                                               */
+static int check_dlp(const char *filename)
+{
+    const double range[2] = {RHO_MIN, RHO_MAX};
+    const unsigned long mask = (1UL << 0) | (1UL << 5) | (1UL << 11);
+    rssringoccs_DLPCSV *whole, *part, *selected, *both;
+    double *a[13], *b[13], *c[13], *d[13];
+    size_t m, first, count;
+    int ok;
+
+    whole = rssringoccs_Get_DLP(filename, tmpl_False);
+    part = rssringoccs_Get_DLP_Range(filename, tmpl_False, RHO_MIN, RHO_MAX);
+    selected = rssringoccs_Get_DLP_Selected(filename, tmpl_False, NULL, mask);
+    both = rssringoccs_Get_DLP_Selected(filename, tmpl_False, range, mask);
+
+    ok = (whole && part && selected && both &&
+          !whole->error_occurred && !part->error_occurred &&
+          !selected->error_occurred && !both->error_occurred);
+
+    if (ok)
+    {
+        count = rows_in_range(whole->rho_km_vals, whole->n_elements, &first);
+        ok = (count > 0 && part->n_elements == count &&
+              both->n_elements == count &&
+              selected->n_elements == whole->n_elements);
+    }
+
+    if (ok)
+    {
+        get_dlp_columns(whole, a);
+        get_dlp_columns(part, b);
+        get_dlp_columns(selected, c);
+        get_dlp_columns(both, d);
+
+        for (m = 0; m < 13; ++m)
+        {
+            if (!same_part(b[m], a[m], first, count, 1) ||
+                !same_part(c[m], a[m], 0, whole->n_elements,
+                           (int)((mask >> m) & 1UL)) ||
+                !same_part(d[m], a[m], first, count, (int)((mask >> m) & 1UL)))
+            {
+                printf("%s: column %lu differs.\n",
+                       filename, (unsigned long)m);
+                ok = 0;
+            }
+        }
+    }
+
+    rssringoccs_Destroy_DLPCSV(&whole);
+    rssringoccs_Destroy_DLPCSV(&part);
+    rssringoccs_Destroy_DLPCSV(&selected);
+    rssringoccs_Destroy_DLPCSV(&both);
+    return ok;
+}
+
+/*  As check_dlp, for the TAU file.                                           */
+static int check_tau(void)
+{
+    const double range[2] = {RHO_MIN, RHO_MAX};
+    const unsigned long mask = (1UL << 5) | (1UL << 6) | (1UL << 7);
+
+    /*  The radius is read as well, since the range is of the first column.   */
+    const unsigned long read = mask | 1UL;
+    rssringoccs_TauCSV *whole, *part, *both;
+    double *a[13], *b[13], *d[13];
+    size_t m, first, count;
+    int ok;
+
+    whole = rssringoccs_Get_Tau(TAU_FILE, tmpl_False);
+    part = rssringoccs_Get_Tau_Range(TAU_FILE, tmpl_False, RHO_MIN, RHO_MAX);
+    both = rssringoccs_Get_Tau_Selected(TAU_FILE, tmpl_False, range, mask);
+
+    ok = (whole && part && both && !whole->error_occurred &&
+          !part->error_occurred && !both->error_occurred);
+
+    if (ok)
+    {
+        count = rows_in_range(whole->rho_km_vals, whole->n_elements, &first);
+        ok = (count > 0 && part->n_elements == count &&
+              both->n_elements == count);
+    }
+
+    if (ok)
+    {
+        get_tau_columns(whole, a);
+        get_tau_columns(part, b);
+        get_tau_columns(both, d);
+
+        for (m = 0; m < 13; ++m)
+        {
+            if (!same_part(b[m], a[m], first, count, 1) ||
+                !same_part(d[m], a[m], first, count, (int)((read >> m) & 1UL)))
+            {
+                printf("%s: column %lu differs.\n",
+                       TAU_FILE, (unsigned long)m);
+                ok = 0;
+            }
+        }
+    }
+
+    rssringoccs_Destroy_TauCSV(&whole);
+    rssringoccs_Destroy_TauCSV(&part);
+    rssringoccs_Destroy_TauCSV(&both);
+    return ok;
+}
+
+/*  Compares the GEO and CAL files read by mask with the whole files.         */
+static int check_geo_and_cal(void)
+{
+    const unsigned long geo_mask = (1UL << 3) | (1UL << 7) | (1UL << 18);
+    const unsigned long cal_mask = (1UL << 1);
+    rssringoccs_GeoCSV *geo, *geo_selected;
+    rssringoccs_CalCSV *cal, *cal_selected;
+    double *a[19], *b[19];
+    size_t m;
+    int ok;
+
+    geo = rssringoccs_Get_Geo(GEO_FILE, tmpl_False);
+    geo_selected = rssringoccs_Get_Geo_Selected(GEO_FILE, tmpl_False,
+                                                geo_mask);
+    cal = rssringoccs_Get_Cal(CAL_FILE);
+    cal_selected = rssringoccs_Get_Cal_Selected(CAL_FILE, cal_mask);
+
+    ok = (geo && geo_selected && cal && cal_selected &&
+          !geo->error_occurred && !geo_selected->error_occurred &&
+          !cal->error_occurred && !cal_selected->error_occurred &&
+          geo->n_elements == geo_selected->n_elements &&
+          cal->n_elements == cal_selected->n_elements);
+
+    if (ok)
+    {
+        get_geo_columns(geo, a);
+        get_geo_columns(geo_selected, b);
+
+        for (m = 0; m < 19; ++m)
+        {
+            if (!same_part(b[m], a[m], 0, geo->n_elements,
+                           (int)((geo_mask >> m) & 1UL)))
+            {
+                printf("%s: column %lu differs.\n",
+                       GEO_FILE, (unsigned long)m);
+                ok = 0;
+            }
+        }
+
+        if (!same_part(cal_selected->t_oet_spm_vals, NULL, 0, 0, 0) ||
+            !same_part(cal_selected->f_sky_pred_vals, cal->f_sky_pred_vals,
+                       0, cal->n_elements, 1) ||
+            !same_part(cal_selected->f_sky_resid_fit_vals, NULL, 0, 0, 0) ||
+            !same_part(cal_selected->p_free_vals, NULL, 0, 0, 0))
+        {
+            printf("%s: the columns differ.\n", CAL_FILE);
+            ok = 0;
+        }
+    }
+
+    rssringoccs_Destroy_GeoCSV(&geo);
+    rssringoccs_Destroy_GeoCSV(&geo_selected);
+    rssringoccs_Destroy_CalCSV(&cal);
+    rssringoccs_Destroy_CalCSV(&cal_selected);
+    return ok;
+}
+
+/*  Compares an extraction by range, by mask, or both, with the whole one.    *
+ *  The columns are the bits of mask, and rho_km_vals.                        */
+static int check_extract(const rssringoccs_CSVData *whole,
+                         const double *range,
+                         unsigned long mask,
+                         const char *what)
+{
+    rssringoccs_CSVData *part;
+    double *a[22], *b[22];
+    size_t m, first, count;
+    int ok;
+
+    part = rssringoccs_Extract_CSV_Data_Selected(GEO_FILE, CAL_FILE, DLP_FILE,
+                                                 TAU_FILE, tmpl_False,
+                                                 range, mask);
+
+    mask |= RSSRINGOCCS_CSV_RHO_KM;
+    ok = (part != NULL && !part->error_occurred);
+
+    if (ok)
+    {
+        first = 0;
+        count = whole->n_elements;
+
+        if (range != NULL)
+            count = rows_in_range(whole->rho_km_vals, count, &first);
+
+        ok = (count > 0 && part->n_elements == count);
+    }
+
+    if (ok)
+    {
+        csv_test_csv_columns(whole, a);
+        csv_test_csv_columns(part, b);
+
+        for (m = 0; m < 22; ++m)
+        {
+            if (!same_part(b[m], a[m], first, count, (int)((mask >> m) & 1UL)))
+            {
+                printf("%s: column %lu differs.\n", what, (unsigned long)m);
+                ok = 0;
+            }
+        }
+    }
+
+    rssringoccs_Destroy_CSV(&part);
+    return ok;
+}
+
+int main(void)
+{
+    const double range[2] = {RHO_MIN, RHO_MAX};
+    const unsigned long mask = RSSRINGOCCS_CSV_B_DEG | RSSRINGOCCS_CSV_D_KM |
+                               RSSRINGOCCS_CSV_F_SKY_HZ |
+                               RSSRINGOCCS_CSV_PHI_DEG |
+                               RSSRINGOCCS_CSV_TAU_POWER;
+    rssringoccs_CSVData *whole, *part;
+    double *a[22], *b[22];
+    size_t m, first, count;
+    int status = 0;
+
+    if (!write_files())
+        return test_fail("Could not write the test files.");
+
+    if (!check_dlp(DLP_FILE))
+        status = test_fail("A part of the DLP file differs from the whole.");
+
+    if (!check_dlp(DLP_INGRESS_FILE))
+        status = test_fail("A part of the ingress DLP file differs from the "
+                           "whole.");
+
+    if (!check_tau())
+        status = test_fail("A part of the TAU file differs from the whole.");
+
+    if (!check_geo_and_cal())
+        status = test_fail("A part of the GEO or CAL file differs from the "
+                           "whole.");
+
+    whole = rssringoccs_Extract_CSV_Data(GEO_FILE, CAL_FILE, DLP_FILE,
+                                         TAU_FILE, tmpl_False);
+
+    if (whole == NULL || whole->error_occurred)
+        status = test_fail("rssringoccs_Extract_CSV_Data failed.");
+    else
+    {
+        if (!check_extract(whole, NULL, mask, "mask"))
+            status = test_fail("The selected columns differ.");
+
+        if (!check_extract(whole, range, RSSRINGOCCS_CSV_ALL_COLUMNS,
+                           "range"))
+            status = test_fail("The columns in the range differ.");
+
+        if (!check_extract(whole, range, mask, "mask and range"))
+            status = test_fail("The selected columns in the range differ.");
+
+        /*  With no halo, rssringoccs_Extract_CSV_Data_Range is the same.     */
+        part = rssringoccs_Extract_CSV_Data_Range(GEO_FILE, CAL_FILE,
+                                                  DLP_FILE, TAU_FILE,
+                                                  tmpl_False, RHO_MIN,
+                                                  RHO_MAX, 0.0);
+        count = rows_in_range(whole->rho_km_vals, whole->n_elements, &first);
+
+        if (part == NULL || part->error_occurred || part->n_elements != count)
+            status = test_fail("rssringoccs_Extract_CSV_Data_Range failed.");
+        else
+        {
+            csv_test_csv_columns(whole, a);
+            csv_test_csv_columns(part, b);
+
+            for (m = 0; m < 22; ++m)
+                if (!same_part(b[m], a[m], first, count, a[m] != NULL))
+                    status = test_fail("rssringoccs_Extract_CSV_Data_Range "
+                                       "differs from the whole.");
+        }
+
+        rssringoccs_Destroy_CSV(&part);
+    }
+
+    rssringoccs_Destroy_CSV(&whole);
+    remove(GEO_FILE);
+    remove(CAL_FILE);
+    remove(DLP_FILE);
+    remove(DLP_INGRESS_FILE);
+    remove(TAU_FILE);
+    return status;
+}
@@ -0,0 +1,280 @@
+/******************************************************************************
+ *                                 LICENSE                                    *
+ ******************************************************************************
+ *  This file is part of rss_ringoccs.                                        *
+ *                                                                            *
+ *  rss_ringoccs is free software: you can redistribute it and/or modify it   *
+ *  it under the terms of the GNU General Public License as published by      *
+ *  the Free Software Foundation, either version 3 of the License, or         *
+ *  (at your option) any later version.                                       *
+ *                                                                            *
+ *  rss_ringoccs is distributed in the hope that it will be useful,           *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ *  GNU General Public License for more details.                              *
+ *                                                                            *
+ *  You should have received a copy of the GNU General Public License         *
+ *  along with rss_ringoccs.  If not, see <https://www.gnu.org/licenses/>.    *
+ ******************************************************************************/
+
+/*  Checks that streaming an occultation through a Newton reconstruction, in  *
+ *  chunks much shorter than the data, gives the same values as a single      *
+ *  call to rssringoccs_Reconstruction, and that every point passed to the    *
+ *  sink was reconstructed.                                                   */
+#include <libtmpl/include/tmpl.h>
+#include <rss_ringoccs/include/rss_ringoccs_reconstruction.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N_POINTS (6000)
+#define CHUNK_SIZE (257)
+
+/*  The radii are RHO_0 + n DX, exact in binary, so that a point is found     *
+ *  from its radius.                                                          */
+#define RHO_0 (70000.0)
+#define DX (0.25)
+#define RES (1.0)
+#define RHO_MIN (70250.0)
+#define RHO_MAX (71250.0)
+
+#define TOLERANCE (1.0E-10)
+
+/*  The points passed to the sink, indexed as the points of the DLP object.   */
+typedef struct stream_output_def {
+    tmpl_ComplexDouble T_out[N_POINTS];
+    tmpl_Bool is_sunk[N_POINTS];
+    tmpl_Bool is_uncomputed;
+} stream_output;
+
+static int test_fail(const char *message)
+{
+    printf("Error Encountered: rss_ringoccs\n"
+           "\ttest_reconstruction_stream\n\n%s\n", message);
+    return -1;
+}
+
+/*  Prints the error of a Tau object, which may not have a message.           */
+static int tau_fail(const rssringoccs_TAUObj *tau, const char *message)
+{
+    if (tau->error_message != NULL)
+        printf("%s", tau->error_message);
+
+    return test_fail(message);
+}
+
+static size_t point_index(double rho)
+{
+    return (size_t)((rho - RHO_0) / DX + 0.5);
+}
+
+/*  A point left at the zero T_out was allocated with was not computed.       */
+static tmpl_Bool
+stream_sink(void *data, const rssringoccs_TAUObj *tau, size_t first, size_t n)
+{
+    stream_output *out = data;
+    tmpl_ComplexDouble value;
+    size_t m, index;
+
+    for (m = first; m < first + n; ++m)
+    {
+        value = tau->T_out[m];
+        index = point_index(tau->rho_km_vals[m]);
+
+        if (index >= N_POINTS)
+            return tmpl_False;
+
+        if (value.dat[0] == 0.0 && value.dat[1] == 0.0)
+            out->is_uncomputed = tmpl_True;
+
+        out->T_out[index] = value;
+        out->is_sunk[index] = tmpl_True;
+    }
+
+    return tmpl_True;
+}
+
+/*  An egress occultation with fixed geometry, so the window width is the     *
+ *  same at every point, and a varying signal.                                */
+static tmpl_Bool make_dlp(rssringoccs_DLPObj *dlp)
+{
+    double **arrays[18];
+    size_t n;
+    double x;
+    tmpl_Bool ok = tmpl_True;
+
+    arrays[0] = &dlp->rho_km_vals;
+    arrays[1] = &dlp->phi_deg_vals;
+    arrays[2] = &dlp->B_deg_vals;
+    arrays[3] = &dlp->D_km_vals;
+    arrays[4] = &dlp->f_sky_hz_vals;
+    arrays[5] = &dlp->rho_dot_kms_vals;
+    arrays[6] = &dlp->t_oet_spm_vals;
+    arrays[7] = &dlp->t_ret_spm_vals;
+    arrays[8] = &dlp->t_set_spm_vals;
+    arrays[9] = &dlp->rho_corr_pole_km_vals;
+    arrays[10] = &dlp->rho_corr_timing_km_vals;
+    arrays[11] = &dlp->phi_rl_deg_vals;
+    arrays[12] = &dlp->p_norm_vals;
+    arrays[13] = &dlp->phase_deg_vals;
+    arrays[14] = &dlp->raw_tau_threshold_vals;
+    arrays[15] = &dlp->rx_km_vals;
+    arrays[16] = &dlp->ry_km_vals;
+    arrays[17] = &dlp->rz_km_vals;
+
+    dlp->arr_size = N_POINTS;
+    dlp->error_occurred = tmpl_False;
+    dlp->error_message = NULL;
+
+    for (n = 0; n < 18; ++n)
+    {
+        *arrays[n] = calloc(N_POINTS, sizeof(double));
+
+        if (*arrays[n] == NULL)
+            ok = tmpl_False;
+    }
+
+    if (!ok)
+        return tmpl_False;
+
+    for (n = 0; n < N_POINTS; ++n)
+    {
+        x = (double)n;
+        dlp->rho_km_vals[n] = RHO_0 + x * DX;
+        dlp->phi_deg_vals[n] = 120.0;
+        dlp->phi_rl_deg_vals[n] = 120.0;
+        dlp->B_deg_vals[n] = 23.6;
+        dlp->D_km_vals[n] = 2.0E5;
+        dlp->f_sky_hz_vals[n] = 8.4E9;
+        dlp->rho_dot_kms_vals[n] = 10.0;
+        dlp->t_oet_spm_vals[n] = 1000.0 + 0.025 * x;
+        dlp->t_ret_spm_vals[n] = 999.0 + 0.025 * x;
+        dlp->t_set_spm_vals[n] = 998.0 + 0.025 * x;
+        dlp->p_norm_vals[n] = 1.0 + 0.3 * sin(0.05 * x);
+        dlp->phase_deg_vals[n] = 20.0 * cos(0.013 * x);
+        dlp->rx_km_vals[n] = -1.0E5;
+        dlp->ry_km_vals[n] = 1.5E5;
+        dlp->rz_km_vals[n] = 0.8E5;
+    }
+
+    return tmpl_True;
+}
+
+static void free_dlp(rssringoccs_DLPObj *dlp)
+{
+    free(dlp->rho_km_vals);
+    free(dlp->phi_deg_vals);
+    free(dlp->B_deg_vals);
+    free(dlp->D_km_vals);
+    free(dlp->f_sky_hz_vals);
+    free(dlp->rho_dot_kms_vals);
+    free(dlp->t_oet_spm_vals);
+    free(dlp->t_ret_spm_vals);
+    free(dlp->t_set_spm_vals);
+    free(dlp->rho_corr_pole_km_vals);
+    free(dlp->rho_corr_timing_km_vals);
+    free(dlp->phi_rl_deg_vals);
+    free(dlp->p_norm_vals);
+    free(dlp->phase_deg_vals);
+    free(dlp->raw_tau_threshold_vals);
+    free(dlp->rx_km_vals);
+    free(dlp->ry_km_vals);
+    free(dlp->rz_km_vals);
+}
+
+int main(void)
+{
+    rssringoccs_DLPObj dlp;
+    rssringoccs_DLP_Array_Source source;
+    rssringoccs_TAUObj stream_tau;
+    rssringoccs_TAUObj *tau;
+    stream_output *out;
+    tmpl_ComplexDouble diff;
+    size_t n, index;
+    double error, scale;
+    int status = 0;
+
+    out = calloc(1, sizeof(*out));
+
+    if (!make_dlp(&dlp) || out == NULL)
+    {
+        free(out);
+        free_dlp(&dlp);
+        return test_fail("Could not allocate the test data.");
+    }
+
+    /*  The whole occultation at once.                                        */
+    tau = rssringoccs_Tau_Create_From_DLP(&dlp, RES);
+
+    if (tau == NULL)
+    {
+        free(out);
+        free_dlp(&dlp);
+        return test_fail("rssringoccs_Tau_Create_From_DLP returned NULL.");
+    }
+
+    /*  Without the b factor the window width is 2 F^2 normeq / res.          */
+    rssringoccs_Tau_Set_Psi_Type("newton", tau);
+    tau->bfac = tmpl_False;
+    tau->rng_list[0] = RHO_MIN;
+    tau->rng_list[1] = RHO_MAX;
+    rssringoccs_Reconstruction(tau);
+
+    /*  The same occultation, streamed in chunks.                             */
+    rssringoccs_Tau_Init(&stream_tau);
+    stream_tau.res = RES;
+    rssringoccs_Tau_Set_Psi_Type("newton", &stream_tau);
+    stream_tau.bfac = tmpl_False;
+    stream_tau.rng_list[0] = RHO_MIN;
+    stream_tau.rng_list[1] = RHO_MAX;
+
+    source.dlp = &dlp;
+    source.next = 0;
+
+    rssringoccs_Reconstruction_Stream(&stream_tau,
+                                      rssringoccs_DLP_Array_Source_Read,
+                                      &source, stream_sink, out, CHUNK_SIZE);
+
+    if (tau->error_occurred)
+        status = tau_fail(tau, "rssringoccs_Reconstruction set an error.");
+
+    else if (stream_tau.error_occurred)
+        status = tau_fail(&stream_tau,
+                          "rssringoccs_Reconstruction_Stream set an error.");
+
+    else if (out->is_uncomputed)
+        status = test_fail("A point that was not computed was sunk.");
+
+    else
+    {
+        /*  Every point of the single reconstruction is also streamed.        */
+        for (n = 0; n < tau->arr_size; ++n)
+        {
+            index = point_index(tau->rho_km_vals[n]);
+
+            if (index >= N_POINTS || !out->is_sunk[index])
+            {
+                status = test_fail("A reconstructed point was not sunk.");
+                break;
+            }
+
+            diff = tmpl_CDouble_Subtract(tau->T_out[n], out->T_out[index]);
+            error = tmpl_CDouble_Abs(diff);
+            scale = tmpl_CDouble_Abs(tau->T_out[n]);
+
+            if (error > TOLERANCE * scale)
+            {
+                printf("rho = %f: %e vs %e\n", tau->rho_km_vals[n],
+                       scale, tmpl_CDouble_Abs(out->T_out[index]));
+                status = test_fail("The streamed values differ.");
+                break;
+            }
+        }
+    }
+
+    rssringoccs_Tau_Destroy(&tau);
+    rssringoccs_Tau_Destroy_Members(&stream_tau);
+    free(out);
+    free_dlp(&dlp);
+    return status;
+}